@@ -9,6 +9,7 @@
 #include "common_audio/channel_buffer.h"
 #include "common_audio/include/audio_util.h"
 #include "common_audio/test_utils.h"
+#include <mutex>
 
 using namespace std;
 using namespace webrtc;
@@ -73,8 +74,10 @@ class AGC2Context
     int num_channels;
     int sample_rate;
 
+    // initial config, restored by Reset()
     webrtc::AudioProcessing::Config::GainController2 def_config;
-    
+    webrtc::AudioProcessing::Config::GainController2 config;
+
 
     std::unique_ptr<webrtc::AudioBuffer> audio_buffer;
     std::unique_ptr<ChannelBuffer<float>> in_buf;
@@ -83,7 +86,13 @@ class AGC2Context
     WavWriter *out_file = nullptr;
     WavWriter *in_file = nullptr;
 
+    std::vector<uint8_t> state_snapshot;
+
 public:
+    // owner pool (see AGC2ContextPool), nullptr for AGC2_init contexts
+    void *pool = nullptr;
+    int pool_index = -1;
+
     int GetChunkSize() { return samples_per_chunk; }
 
     AGC2Context(int s_rate, int n_ch
@@ -95,11 +104,11 @@ public:
          , split_bands(subband)
          
     {
-        webrtc::AudioProcessing::Config::GainController2 config;
         config.enabled = true;
         config.fixed_digital.gain_db = fixed_digital_gain;
         config.adaptive_digital.enabled = en_adaptive_digital;
         config.adaptive_digital.vad_probability_attack = vad_pa;
+        def_config = config;
 
         // config.adaptive_digital.level_estimator =
         //     webrtc::AudioProcessing::Config::GainController2::LevelEstimator::kPeak;
@@ -133,7 +142,6 @@ public:
         , float vad_probability_attack
         )
     {
-        webrtc::AudioProcessing::Config::GainController2 config;
         config.enabled = true;
         config.fixed_digital.gain_db = gain_db;
         config.adaptive_digital.enabled = en_adaptive_digital;
@@ -142,6 +150,49 @@ public:
         gain_controller->ApplyConfig(config);
     }
 
+    // as_default: also restored by Reset(), e.g. for pooled contexts
+    void SetVadBackend(
+        webrtc::AudioProcessing::Config::GainController2::VadBackend backend,
+        bool as_default)
+    {
+        config.adaptive_digital.vad_backend = backend;
+        if (as_default)
+            def_config.adaptive_digital.vad_backend = backend;
+
+        gain_controller->ApplyConfig(config);
+    }
+
+    // back to the state right after construction.
+    // no allocation unless the config was changed by Apply() or bands are split
+    void Reset()
+    {
+        if (in_file)
+            toggle_wavout(in_file);
+        if (out_file)
+            toggle_wavout(out_file);
+
+        if (config.fixed_digital.gain_db != def_config.fixed_digital.gain_db ||
+            config.adaptive_digital.enabled != def_config.adaptive_digital.enabled ||
+            config.adaptive_digital.vad_probability_attack !=
+                def_config.adaptive_digital.vad_probability_attack ||
+            config.adaptive_digital.vad_backend !=
+                def_config.adaptive_digital.vad_backend)
+        {
+            config = def_config;
+            gain_controller->ApplyConfig(config);
+        }
+        gain_controller->Reset();
+
+        // the splitting filter keeps state between frames
+        if (split_bands)
+        {
+            audio_buffer = std::make_unique<webrtc::AudioBuffer>(
+                samples_per_chunk, num_channels,
+                samples_per_chunk, num_channels,
+                samples_per_chunk);
+        }
+    }
+
     // input: float16 ?
     void Run(std::vector<float> &chunk)
     {
@@ -162,21 +213,27 @@ public:
     }
 
     void RunFloat(std::vector<float> &chunk)
+    {
+        RunFloat(chunk.data(), chunk.size());
+    }
+
+    // in place on one interleaved chunk, no allocation
+    void RunFloat(float *chunk, size_t size)
     {
         if (in_file){
-            in_file->WriteMySamples(chunk.data(), chunk.size());
-            //out_file->WriteSamples(chunk.data(), chunk.size());
+            in_file->WriteMySamples(chunk, size);
+            //out_file->WriteSamples(chunk, size);
         }
 
-        //FloatS16ToFloat(&chunk[0], chunk.size(), &chunk[0]);
-        Deinterleave(&chunk[0], in_buf->num_frames(), in_buf->num_channels(),
+        //FloatS16ToFloat(chunk, size, chunk);
+        Deinterleave(chunk, in_buf->num_frames(), in_buf->num_channels(),
                      in_buf->channels());
 
         process(in_buf, out_buf);
 
         Interleave(out_buf->channels(), out_buf->num_frames(), out_buf->num_channels(),
-                   &chunk[0]);
-        //FloatToFloatS16(&chunk[0], chunk.size(), &chunk[0]);
+                   chunk);
+        //FloatToFloatS16(chunk, size, chunk);
 
         // if (out_file){
         //     out_file->WriteMySamples(chunk.data(), chunk.size());
@@ -214,6 +271,19 @@ public:
         gain_controller->NotifyAnalogLevel(level);
     }
 
+    // adaptation state snapshot (see GainController2::SaveState)
+    const std::vector<uint8_t> &SaveState()
+    {
+        gain_controller->SaveState(&state_snapshot);
+        return state_snapshot;
+    }
+
+    bool RestoreState(const uint8_t *data, int size)
+    {
+        return gain_controller->RestoreState(
+            rtc::ArrayView<const uint8_t>(data, size));
+    }
+
     void Debug(int id)
     {
         // save
@@ -258,6 +328,107 @@ private:  // private method
     
 };
 
+/// @brief preconstructed AGC2 contexts sharing one configuration
+/// (sample rate, channels, gains). all contexts are created up front, so
+/// Acquire() neither constructs a GainController2 nor allocates memory.
+/// Release() resets a context to its initial state before it can be acquired
+/// again. create one pool per sample rate and channel configuration.
+class AGC2ContextPool
+{
+    std::mutex mutex;
+    std::vector<std::unique_ptr<AGC2Context>> contexts;
+    // guarded by mutex
+    std::vector<AGC2Context *> free_contexts;
+    std::vector<bool> in_use;
+    // contexts that were not free when SetVadBackend() was called, they
+    // switch to vad_backend when released
+    std::vector<bool> vad_backend_pending;
+    webrtc::AudioProcessing::Config::GainController2::VadBackend vad_backend =
+        webrtc::AudioProcessing::Config::GainController2::kRnn;
+
+public:
+    AGC2ContextPool(int size, int s_rate, int n_ch
+        , float fixed_digital_gain
+        , bool en_adaptive_digital
+        , float vad_pa)
+    {
+        contexts.reserve(size);
+        free_contexts.reserve(size);
+        for (int i = 0; i < size; i++)
+        {
+            contexts.push_back(std::make_unique<AGC2Context>(s_rate, n_ch,
+                fixed_digital_gain, en_adaptive_digital, vad_pa));
+            contexts.back()->pool = this;
+            contexts.back()->pool_index = i;
+        }
+        // hand out contexts in construction order
+        for (int i = size - 1; i >= 0; i--)
+            free_contexts.push_back(contexts[i].get());
+        in_use.assign(size, false);
+        vad_backend_pending.assign(size, false);
+    }
+
+    // returns nullptr if all contexts are in use
+    AGC2Context *Acquire()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (free_contexts.empty())
+            return nullptr;
+        AGC2Context *ctx = free_contexts.back();
+        free_contexts.pop_back();
+        in_use[ctx->pool_index] = true;
+        return ctx;
+    }
+
+    // returns false if ctx is not an acquired context of this pool
+    bool Release(AGC2Context *ctx)
+    {
+        if (!ctx || ctx->pool != this)
+            return false;
+        const int index = ctx->pool_index;
+        {
+            // clearing the flag here makes concurrent releases of the same
+            // context fail, only this call resets and pushes it back
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!in_use[index])
+                return false;
+            in_use[index] = false;
+        }
+        // reset outside the lock, the context is not shared until pushed back
+        ctx->Reset();
+        std::lock_guard<std::mutex> lock(mutex);
+        if (vad_backend_pending[index])
+        {
+            ctx->SetVadBackend(vad_backend, true);
+            vad_backend_pending[index] = false;
+        }
+        free_contexts.push_back(ctx);
+        return true;
+    }
+
+    // free contexts switch now, the others when they are released
+    void SetVadBackend(
+        webrtc::AudioProcessing::Config::GainController2::VadBackend backend)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        vad_backend = backend;
+        vad_backend_pending.assign(vad_backend_pending.size(), true);
+        for (AGC2Context *ctx : free_contexts)
+        {
+            ctx->SetVadBackend(backend, true);
+            vad_backend_pending[ctx->pool_index] = false;
+        }
+    }
+
+    int NumAvailable()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return static_cast<int>(free_contexts.size());
+    }
+
+    int Size() const { return static_cast<int>(contexts.size()); }
+};
+
 Agc2Context *agc2_init(int sample_rate, int num_channels,
                        float fixed_gain_db, bool adaptive_enable);
 void agc2_process(Agc2Context *ctx, float *pcm_buffer, int num_samples);
@@ -349,12 +520,8 @@ void agc2_process_interleaved(Agc2Context *ctx, float *pcm_buffer,
     const int frames_per_chunk = ctx->samples_per_chunk;
     const int num_channels = ctx->num_channels; // 채널 수 가져오기
 
-    // 인터리브 → 디인터리브 변환 버퍼
-    std::vector<std::vector<float>> deinterleaved(num_channels);
-    for (auto &ch : deinterleaved)
-    {
-        ch.resize(frames_per_chunk);
-    }
+    // 인터리브 → 디인터리브 변환 버퍼 (agc2_init 에서 할당)
+    float *const *deinterleaved = ctx->in_buf->channels();
 
     for (int i = 0; i < num_samples; i += frames_per_chunk * num_channels)
     {
@@ -368,12 +535,7 @@ void agc2_process_interleaved(Agc2Context *ctx, float *pcm_buffer,
         }
 
         // 오디오 버퍼에 복사
-        std::vector<float *> ptrs(num_channels);
-        for (int ch = 0; ch < num_channels; ++ch)
-        {
-            ptrs[ch] = deinterleaved[ch].data();
-        }
-        ctx->audio_buffer->CopyFrom(ptrs.data(), ctx->stream_config);
+        ctx->audio_buffer->CopyFrom(deinterleaved, ctx->stream_config);
 
         // 주파수 밴드 분할 (48kHz > 16kHz)
         if (ctx->split_bands)
@@ -391,7 +553,7 @@ void agc2_process_interleaved(Agc2Context *ctx, float *pcm_buffer,
         }
 
         // 처리된 데이터 추출
-        ctx->audio_buffer->CopyTo(ctx->stream_config, ptrs.data());
+        ctx->audio_buffer->CopyTo(ctx->stream_config, deinterleaved);
 
         // 디인터리브 → 인터리브 변환
         for (int f = 0; f < frames_per_chunk; ++f)
@@ -471,31 +633,36 @@ extern "C"
     void AGC2_process(void *h, float *pcm_buffer, int bytes)
     {
         AGC2Context *ctx = (AGC2Context *)h;
-        std::vector<float> buf = std::vector<float>(pcm_buffer, pcm_buffer + bytes / sizeof(float));
+        const size_t num_samples = bytes / sizeof(float);
 #if 0 // to verify input
     // ok
     //ctx->WriteBytes(pcm_buffer, bytes);
 
     // ok
-    ctx->WriteMySamples(buf.data(), buf.size());
+    ctx->WriteMySamples(pcm_buffer, num_samples);
 
 #endif
 
+        // processed in place, no copy
         //ctx->Run(buf);
-        ctx->RunFloat(buf);
-
-        //ctx->WriteOutSamples(buf.data(), buf.size());
+        ctx->RunFloat(pcm_buffer, num_samples);
 
-        if(pcm_buffer!= buf.data())
-            memcpy(pcm_buffer, buf.data(), bytes);
+        //ctx->WriteOutSamples(pcm_buffer, num_samples);
     }
 
 
 
 
+    /// @brief destroys a context from AGC2_init.
+    /// a pooled context is released to its pool instead.
     void AGC2_destroy(void *h)
     {
         AGC2Context *ctx = (AGC2Context *)h;
+        if (ctx && ctx->pool)
+        {
+            ((AGC2ContextPool *)ctx->pool)->Release(ctx);
+            return;
+        }
         delete ctx;
     }
 
@@ -520,6 +687,25 @@ extern "C"
 
 
 
+    /// @brief selects the VAD of the adaptive digital gain:
+    /// 0: RNN (default, most accurate)
+    /// 1: GMM (much cheaper, less robust to noise)
+    /// 2: hybrid (GMM on every frame, RNN only while the GMM detects speech)
+    /// resets the adaptive state like AGC2_Apply.
+    /// @return false if backend is invalid
+    bool AGC2_SetVadBackend(void *h, int backend)
+    {
+        if (backend < webrtc::AudioProcessing::Config::GainController2::kRnn ||
+            backend > webrtc::AudioProcessing::Config::GainController2::kHybrid)
+            return false;
+        ((AGC2Context *)h)->SetVadBackend(
+            static_cast<webrtc::AudioProcessing::Config::GainController2::VadBackend>(backend),
+            false);
+        return true;
+    }
+
+
+
     void AGC2_NotifyAnalogLevel(void *h, int level)
     {
         ((AGC2Context *)h)->NotifyAnalogLevel(level);
@@ -529,6 +715,105 @@ extern "C"
     {
         ((AGC2Context *)h)->Debug(id);
     }
+
+
+
+    /// @brief saves the adaptation state (levels, gains, VAD)
+    /// @param h
+    /// @param buffer : destination, may be NULL to query the size
+    /// @param size : size of buffer in bytes
+    /// @return snapshot size in bytes, -1 if buffer is too small
+    int AGC2_SaveState(void *h, uint8_t *buffer, int size)
+    {
+        const std::vector<uint8_t> &snapshot = ((AGC2Context *)h)->SaveState();
+        const int snapshot_size = static_cast<int>(snapshot.size());
+        if (!buffer)
+            return snapshot_size;
+        if (size < snapshot_size)
+            return -1;
+        memcpy(buffer, snapshot.data(), snapshot.size());
+        return snapshot_size;
+    }
+
+
+
+    /// @brief restores a state saved by AGC2_SaveState.
+    /// call after AGC2_Apply (applying a config resets the adaptive state).
+    /// needs the same sample rate and adaptive digital setting.
+    /// @return true on success, false if the snapshot was rejected (state unchanged)
+    bool AGC2_RestoreState(void *h, const uint8_t *buffer, int size)
+    {
+        if (!buffer || size <= 0)
+            return false;
+        return ((AGC2Context *)h)->RestoreState(buffer, size);
+    }
+
+
+
+    /// @brief creates a pool of pool_size contexts, same params as AGC2_init.
+    /// construction cost is paid here instead of when a stream is admitted.
+    /// @return pool handle
+    void *AGC2_PoolCreate(int pool_size, int sample_rate, int num_channels,
+                          float fixed_gain_db, bool adaptive_enable, float vad_pa)
+    {
+        if (pool_size <= 0)
+            return nullptr;
+        return new AGC2ContextPool(pool_size, sample_rate, num_channels,
+            fixed_gain_db, adaptive_enable, vad_pa);
+    }
+
+
+
+    /// @brief admits a stream: takes a context from the pool (no allocation).
+    /// the handle is used like one from AGC2_init.
+    /// @return context handle, NULL if the pool is exhausted
+    void *AGC2_PoolAcquire(void *pool)
+    {
+        return ((AGC2ContextPool *)pool)->Acquire();
+    }
+
+
+
+    /// @brief releases a stream: resets the context to its initial state and
+    /// gives it back to the pool.
+    /// @return false if h was not acquired from this pool
+    bool AGC2_PoolRelease(void *pool, void *h)
+    {
+        return ((AGC2ContextPool *)pool)->Release((AGC2Context *)h);
+    }
+
+
+
+    /// @brief selects the VAD of all the contexts, see AGC2_SetVadBackend.
+    /// free contexts switch at once, acquired contexts keep their VAD until
+    /// they are released. the VAD is kept across releases.
+    /// @return false if backend is invalid
+    bool AGC2_PoolSetVadBackend(void *pool, int backend)
+    {
+        if (backend < webrtc::AudioProcessing::Config::GainController2::kRnn ||
+            backend > webrtc::AudioProcessing::Config::GainController2::kHybrid)
+            return false;
+        ((AGC2ContextPool *)pool)->SetVadBackend(
+            static_cast<webrtc::AudioProcessing::Config::GainController2::VadBackend>(backend));
+        return true;
+    }
+
+
+
+    /// @brief number of contexts that can be acquired
+    int AGC2_PoolAvailable(void *pool)
+    {
+        return ((AGC2ContextPool *)pool)->NumAvailable();
+    }
+
+
+
+    /// @brief destroys the pool and all its contexts.
+    /// acquired handles become invalid.
+    void AGC2_PoolDestroy(void *pool)
+    {
+        delete (AGC2ContextPool *)pool;
+    }
 }
 
 void my3_agc2(struct Agcinput *agc_input)
@@ -117,6 +117,8 @@ bool EchoCanceller3Config::Validate(EchoCanceller3Config* config) {
   res = res & Limit(&c->delay.delay_candidate_detection_threshold, 0.f, 1.f);
   res = res & Limit(&c->delay.delay_selection_thresholds.initial, 1, 250);
   res = res & Limit(&c->delay.delay_selection_thresholds.converged, 1, 250);
+  res = res & Limit(&c->delay.fft_matched_filter.smoothing, 0.f, 1.f);
+  res = res & Limit(&c->delay.fft_matched_filter.detection_threshold, 0.f, 1.f);
 
   res = res & FloorLimit(&c->filter.refined.length_blocks, 1);
   res = res & Limit(&c->filter.refined.leakage_converged, 0.f, 1000.f);
@@ -58,6 +58,14 @@ struct RTC_EXPORT EchoCanceller3Config {
     };
     AlignmentMixing render_alignment_mixing = {false, true, 10000.f, true};
     AlignmentMixing capture_alignment_mixing = {false, true, 10000.f, false};
+    // Alternative delay estimator that computes the render/capture
+    // cross-correlation for all lags via partitioned FFTs instead of running
+    // the time-domain matched filters.
+    struct FftMatchedFilter {
+      bool enabled = false;
+      float smoothing = 0.1f;
+      float detection_threshold = 0.4f;
+    } fft_matched_filter;
   } delay;
 
   struct Filter {
@@ -212,6 +212,15 @@ void Aec3ConfigFromJsonString(absl::string_view json_string,
               &cfg.delay.render_alignment_mixing);
     ReadParam(section, "capture_alignment_mixing",
               &cfg.delay.capture_alignment_mixing);
+
+    if (rtc::GetValueFromJsonObject(section, "fft_matched_filter",
+                                    &subsection)) {
+      ReadParam(subsection, "enabled", &cfg.delay.fft_matched_filter.enabled);
+      ReadParam(subsection, "smoothing",
+                &cfg.delay.fft_matched_filter.smoothing);
+      ReadParam(subsection, "detection_threshold",
+                &cfg.delay.fft_matched_filter.detection_threshold);
+    }
   }
 
   if (rtc::GetValueFromJsonObject(aec3_root, "filter", &section)) {
@@ -459,6 +468,15 @@ std::string Aec3ConfigToJsonString(const EchoCanceller3Config& config) {
       << (config.delay.capture_alignment_mixing.prefer_first_two_channels
               ? "true"
               : "false");
+  ost << "},";
+
+  ost << "\"fft_matched_filter\": {";
+  ost << "\"enabled\": "
+      << (config.delay.fft_matched_filter.enabled ? "true" : "false") << ",";
+  ost << "\"smoothing\": " << config.delay.fft_matched_filter.smoothing
+      << ",";
+  ost << "\"detection_threshold\": "
+      << config.delay.fft_matched_filter.detection_threshold;
   ost << "}";
   ost << "},";
 
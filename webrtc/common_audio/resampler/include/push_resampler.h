@@ -36,6 +36,9 @@ class PushResampler {
   // 2 channel audio gives 640 samples).
   int Resample(const T* src, size_t src_length, T* dst, size_t dst_capacity);
 
+  // Clears the resampler history while keeping the current parameters.
+  void Reset();
+
  private:
   int src_sample_rate_hz_;
   int dst_sample_rate_hz_;
@@ -104,6 +104,13 @@ int PushResampler<T>::InitializeIfNeeded(int src_sample_rate_hz,
   return 0;
 }
 
+template <typename T>
+void PushResampler<T>::Reset() {
+  for (auto& channel_resampler : channel_resamplers_) {
+    channel_resampler.resampler->Reset();
+  }
+}
+
 template <typename T>
 int PushResampler<T>::Resample(const T* src,
                                size_t src_length,
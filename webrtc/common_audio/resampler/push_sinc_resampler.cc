@@ -30,6 +30,11 @@ PushSincResampler::PushSincResampler(size_t source_frames,
 
 PushSincResampler::~PushSincResampler() {}
 
+void PushSincResampler::Reset() {
+  resampler_->Flush();
+  first_pass_ = true;
+}
+
 size_t PushSincResampler::Resample(const int16_t* source,
                                    size_t source_length,
                                    int16_t* destination,
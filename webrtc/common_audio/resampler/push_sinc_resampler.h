@@ -47,6 +47,10 @@ class PushSincResampler : public SincResamplerCallback {
                   float* destination,
                   size_t destination_capacity);
 
+  // Clears the buffered input so that the next call to Resample() behaves as
+  // the first one after construction.
+  void Reset();
+
   // Delay due to the filter kernel. Essentially, the time after which an input
   // sample will appear in the resampled output.
   static float AlgorithmicDelaySeconds(int source_rate_hz) {
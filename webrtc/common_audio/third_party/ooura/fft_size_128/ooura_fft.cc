@@ -23,20 +23,27 @@
 
 #include "common_audio/third_party/ooura/fft_size_128/ooura_fft.h"
 
+#include <array>
+
 #include "common_audio/third_party/ooura/fft_size_128/ooura_fft_tables_common.h"
 #include "rtc_base/system/arch.h"
+#include "rtc_base/checks.h"
 #include "system_wrappers/include/cpu_features_wrapper.h"
 
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#include <emmintrin.h>
+#endif
+
 namespace webrtc {
 
 namespace {
 
-#if !(defined(MIPS_FPU_LE) || defined(WEBRTC_HAS_NEON))
-static void cft1st_128_C(float* a) {
+template <typename T>
+void cft1st_128_C(T* a) {
   const int n = 128;
   int j, k1, k2;
   float wk1r, wk1i, wk2r, wk2i, wk3r, wk3i;
-  float x0r, x0i, x1r, x1i, x2r, x2i, x3r, x3i;
+  T x0r, x0i, x1r, x1i, x2r, x2i, x3r, x3i;
 
   // The processing of the first set of elements was simplified in C to avoid
   // some operations (multiplication by zero or one, addition of two elements
@@ -139,13 +146,14 @@ static void cft1st_128_C(float* a) {
   }
 }
 
-static void cftmdl_128_C(float* a) {
+template <typename T>
+void cftmdl_128_C(T* a) {
   const int l = 8;
   const int n = 128;
   const int m = 32;
   int j0, j1, j2, j3, k, k1, k2, m2;
   float wk1r, wk1i, wk2r, wk2i, wk3r, wk3i;
-  float x0r, x0i, x1r, x1i, x2r, x2i, x3r, x3i;
+  T x0r, x0i, x1r, x1i, x2r, x2i, x3r, x3i;
 
   for (j0 = 0; j0 < l; j0 += 2) {
     j1 = j0 + 8;
@@ -266,10 +274,12 @@ static void cftmdl_128_C(float* a) {
   }
 }
 
-static void rftfsub_128_C(float* a) {
+template <typename T>
+void rftfsub_128_C(T* a) {
   const float* c = rdft_w + 32;
   int j1, j2, k1, k2;
-  float wkr, wki, xr, xi, yr, yi;
+  float wkr, wki;
+  T xr, xi, yr, yi;
 
   for (j1 = 1, j2 = 2; j2 < 64; j1 += 1, j2 += 2) {
     k2 = 128 - j2;
@@ -287,10 +297,12 @@ static void rftfsub_128_C(float* a) {
   }
 }
 
-static void rftbsub_128_C(float* a) {
+template <typename T>
+void rftbsub_128_C(T* a) {
   const float* c = rdft_w + 32;
   int j1, j2, k1, k2;
-  float wkr, wki, xr, xi, yr, yi;
+  float wkr, wki;
+  T xr, xi, yr, yi;
 
   a[1] = -a[1];
   for (j1 = 1, j2 = 2; j2 < 64; j1 += 1, j2 += 2) {
@@ -309,169 +321,67 @@ static void rftbsub_128_C(float* a) {
   }
   a[65] = -a[65];
 }
-#endif
-
-}  // namespace
-
-OouraFft::OouraFft(bool sse2_available) {
-#if defined(WEBRTC_ARCH_X86_FAMILY)
-  use_sse2_ = sse2_available;
-#else
-  use_sse2_ = false;
-#endif
-}
-
-OouraFft::OouraFft() {
-#if defined(WEBRTC_ARCH_X86_FAMILY)
-  use_sse2_ = (GetCPUInfo(kSSE2) != 0);
-#else
-  use_sse2_ = false;
-#endif
-}
-
-OouraFft::~OouraFft() = default;
-
-void OouraFft::Fft(float* a) const {
-  float xi;
-  bitrv2_128(a);
-  cftfsub_128(a);
-  rftfsub_128(a);
-  xi = a[0] - a[1];
-  a[0] += a[1];
-  a[1] = xi;
-}
-void OouraFft::InverseFft(float* a) const {
-  a[1] = 0.5f * (a[0] - a[1]);
-  a[0] -= a[1];
-  rftbsub_128(a);
-  bitrv2_128(a);
-  cftbsub_128(a);
-}
 
-void OouraFft::cft1st_128(float* a) const {
-#if defined(MIPS_FPU_LE)
-  cft1st_128_mips(a);
-#elif defined(WEBRTC_HAS_NEON)
-  cft1st_128_neon(a);
-#elif defined(WEBRTC_ARCH_X86_FAMILY)
-  if (use_sse2_) {
-    cft1st_128_SSE2(a);
-  } else {
-    cft1st_128_C(a);
-  }
-#else
-  cft1st_128_C(a);
-#endif
-}
-void OouraFft::cftmdl_128(float* a) const {
-#if defined(MIPS_FPU_LE)
-  cftmdl_128_mips(a);
-#elif defined(WEBRTC_HAS_NEON)
-  cftmdl_128_neon(a);
-#elif defined(WEBRTC_ARCH_X86_FAMILY)
-  if (use_sse2_) {
-    cftmdl_128_SSE2(a);
-  } else {
-    cftmdl_128_C(a);
-  }
-#else
-  cftmdl_128_C(a);
-#endif
-}
-void OouraFft::rftfsub_128(float* a) const {
-#if defined(MIPS_FPU_LE)
-  rftfsub_128_mips(a);
-#elif defined(WEBRTC_HAS_NEON)
-  rftfsub_128_neon(a);
-#elif defined(WEBRTC_ARCH_X86_FAMILY)
-  if (use_sse2_) {
-    rftfsub_128_SSE2(a);
-  } else {
-    rftfsub_128_C(a);
-  }
-#else
-  rftfsub_128_C(a);
-#endif
-}
-
-void OouraFft::rftbsub_128(float* a) const {
-#if defined(MIPS_FPU_LE)
-  rftbsub_128_mips(a);
-#elif defined(WEBRTC_HAS_NEON)
-  rftbsub_128_neon(a);
-#elif defined(WEBRTC_ARCH_X86_FAMILY)
-  if (use_sse2_) {
-    rftbsub_128_SSE2(a);
-  } else {
-    rftbsub_128_C(a);
-  }
-#else
-  rftbsub_128_C(a);
-#endif
-}
-
-void OouraFft::cftbsub_128(float* a) const {
+template <typename T>
+void cftfsub_128_last_C(T* a) {
   int j, j1, j2, j3, l;
-  float x0r, x0i, x1r, x1i, x2r, x2i, x3r, x3i;
+  T x0r, x0i, x1r, x1i, x2r, x2i, x3r, x3i;
 
-  cft1st_128(a);
-  cftmdl_128(a);
   l = 32;
-
   for (j = 0; j < l; j += 2) {
     j1 = j + l;
     j2 = j1 + l;
     j3 = j2 + l;
     x0r = a[j] + a[j1];
-    x0i = -a[j + 1] - a[j1 + 1];
+    x0i = a[j + 1] + a[j1 + 1];
     x1r = a[j] - a[j1];
-    x1i = -a[j + 1] + a[j1 + 1];
+    x1i = a[j + 1] - a[j1 + 1];
     x2r = a[j2] + a[j3];
     x2i = a[j2 + 1] + a[j3 + 1];
     x3r = a[j2] - a[j3];
     x3i = a[j2 + 1] - a[j3 + 1];
     a[j] = x0r + x2r;
-    a[j + 1] = x0i - x2i;
+    a[j + 1] = x0i + x2i;
     a[j2] = x0r - x2r;
-    a[j2 + 1] = x0i + x2i;
+    a[j2 + 1] = x0i - x2i;
     a[j1] = x1r - x3i;
-    a[j1 + 1] = x1i - x3r;
+    a[j1 + 1] = x1i + x3r;
     a[j3] = x1r + x3i;
-    a[j3 + 1] = x1i + x3r;
+    a[j3 + 1] = x1i - x3r;
   }
 }
 
-void OouraFft::cftfsub_128(float* a) const {
+template <typename T>
+void cftbsub_128_last_C(T* a) {
   int j, j1, j2, j3, l;
-  float x0r, x0i, x1r, x1i, x2r, x2i, x3r, x3i;
+  T x0r, x0i, x1r, x1i, x2r, x2i, x3r, x3i;
 
-  cft1st_128(a);
-  cftmdl_128(a);
   l = 32;
   for (j = 0; j < l; j += 2) {
     j1 = j + l;
     j2 = j1 + l;
     j3 = j2 + l;
     x0r = a[j] + a[j1];
-    x0i = a[j + 1] + a[j1 + 1];
+    x0i = -a[j + 1] - a[j1 + 1];
     x1r = a[j] - a[j1];
-    x1i = a[j + 1] - a[j1 + 1];
+    x1i = -a[j + 1] + a[j1 + 1];
     x2r = a[j2] + a[j3];
     x2i = a[j2 + 1] + a[j3 + 1];
     x3r = a[j2] - a[j3];
     x3i = a[j2 + 1] - a[j3 + 1];
     a[j] = x0r + x2r;
-    a[j + 1] = x0i + x2i;
+    a[j + 1] = x0i - x2i;
     a[j2] = x0r - x2r;
-    a[j2 + 1] = x0i - x2i;
+    a[j2 + 1] = x0i + x2i;
     a[j1] = x1r - x3i;
-    a[j1 + 1] = x1i + x3r;
+    a[j1 + 1] = x1i - x3r;
     a[j3] = x1r + x3i;
-    a[j3 + 1] = x1i - x3r;
+    a[j3 + 1] = x1i + x3r;
   }
 }
 
-void OouraFft::bitrv2_128(float* a) const {
+template <typename T>
+void bitrv2_128_C(T* a) {
   /*
       Following things have been attempted but are no faster:
       (a) Storing the swap indexes in a LUT (index calculations are done
@@ -486,7 +396,7 @@ void OouraFft::bitrv2_128(float* a) const {
   */
 
   unsigned int j, j1, k, k1;
-  float xr, xi, yr, yi;
+  T xr, xi, yr, yi;
 
   const int ip[4] = {0, 64, 32, 96};
   for (k = 0; k < 4; k++) {
@@ -545,4 +455,328 @@ void OouraFft::bitrv2_128(float* a) const {
   }
 }
 
+
+// Complete transforms built from the C kernels, used for the batched
+// transforms where T holds one value of each transform of the batch.
+template <typename T>
+void Fft_C(T* a) {
+  bitrv2_128_C(a);
+  cft1st_128_C(a);
+  cftmdl_128_C(a);
+  cftfsub_128_last_C(a);
+  rftfsub_128_C(a);
+  const T xi = a[0] - a[1];
+  a[0] += a[1];
+  a[1] = xi;
+}
+
+template <typename T>
+void InverseFft_C(T* a) {
+  a[1] = 0.5f * (a[0] - a[1]);
+  a[0] -= a[1];
+  rftbsub_128_C(a);
+  bitrv2_128_C(a);
+  cft1st_128_C(a);
+  cftmdl_128_C(a);
+  cftbsub_128_last_C(a);
+}
+
+constexpr size_t kFftSize = 128;
+
+// Holds one value for each of the OouraFft::kMaxBatchSize transforms of a
+// batch.
+struct FloatBatch {
+  FloatBatch& operator+=(const FloatBatch& b) {
+    for (size_t m = 0; m < OouraFft::kMaxBatchSize; ++m) {
+      v[m] += b.v[m];
+    }
+    return *this;
+  }
+  FloatBatch& operator-=(const FloatBatch& b) {
+    for (size_t m = 0; m < OouraFft::kMaxBatchSize; ++m) {
+      v[m] -= b.v[m];
+    }
+    return *this;
+  }
+  float v[OouraFft::kMaxBatchSize];
+};
+
+FloatBatch operator+(FloatBatch a, const FloatBatch& b) {
+  return a += b;
+}
+
+FloatBatch operator-(FloatBatch a, const FloatBatch& b) {
+  return a -= b;
+}
+
+FloatBatch operator-(const FloatBatch& a) {
+  FloatBatch r;
+  for (size_t m = 0; m < OouraFft::kMaxBatchSize; ++m) {
+    r.v[m] = -a.v[m];
+  }
+  return r;
+}
+
+FloatBatch operator*(float a, const FloatBatch& b) {
+  FloatBatch r;
+  for (size_t m = 0; m < OouraFft::kMaxBatchSize; ++m) {
+    r.v[m] = a * b.v[m];
+  }
+  return r;
+}
+
+// Transposes the batch so that x[i] holds sample i of all the transforms.
+void LoadBatch(float* const* a, FloatBatch* x) {
+  for (size_t i = 0; i < kFftSize; ++i) {
+    for (size_t m = 0; m < OouraFft::kMaxBatchSize; ++m) {
+      x[i].v[m] = a[m][i];
+    }
+  }
+}
+
+void StoreBatch(const FloatBatch* x, float* const* a) {
+  for (size_t i = 0; i < kFftSize; ++i) {
+    for (size_t m = 0; m < OouraFft::kMaxBatchSize; ++m) {
+      a[m][i] = x[i].v[m];
+    }
+  }
+}
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+// SSE2 counterpart of FloatBatch with one transform in each lane.
+struct FloatBatchSse2 {
+  FloatBatchSse2() = default;
+  explicit FloatBatchSse2(__m128 v) : v(v) {}
+  FloatBatchSse2& operator+=(const FloatBatchSse2& b) {
+    v = _mm_add_ps(v, b.v);
+    return *this;
+  }
+  FloatBatchSse2& operator-=(const FloatBatchSse2& b) {
+    v = _mm_sub_ps(v, b.v);
+    return *this;
+  }
+  __m128 v;
+};
+static_assert(OouraFft::kMaxBatchSize == 4, "");
+
+FloatBatchSse2 operator+(FloatBatchSse2 a, const FloatBatchSse2& b) {
+  return a += b;
+}
+
+FloatBatchSse2 operator-(FloatBatchSse2 a, const FloatBatchSse2& b) {
+  return a -= b;
+}
+
+FloatBatchSse2 operator-(const FloatBatchSse2& a) {
+  return FloatBatchSse2(_mm_xor_ps(a.v, _mm_set1_ps(-0.f)));
+}
+
+FloatBatchSse2 operator*(float a, const FloatBatchSse2& b) {
+  return FloatBatchSse2(_mm_mul_ps(_mm_set1_ps(a), b.v));
+}
+
+void LoadBatchSse2(float* const* a, FloatBatchSse2* x) {
+  for (size_t i = 0; i < kFftSize; i += 4) {
+    __m128 r0 = _mm_loadu_ps(a[0] + i);
+    __m128 r1 = _mm_loadu_ps(a[1] + i);
+    __m128 r2 = _mm_loadu_ps(a[2] + i);
+    __m128 r3 = _mm_loadu_ps(a[3] + i);
+    _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+    x[i + 0].v = r0;
+    x[i + 1].v = r1;
+    x[i + 2].v = r2;
+    x[i + 3].v = r3;
+  }
+}
+
+void StoreBatchSse2(const FloatBatchSse2* x, float* const* a) {
+  for (size_t i = 0; i < kFftSize; i += 4) {
+    __m128 r0 = x[i + 0].v;
+    __m128 r1 = x[i + 1].v;
+    __m128 r2 = x[i + 2].v;
+    __m128 r3 = x[i + 3].v;
+    _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+    _mm_storeu_ps(a[0] + i, r0);
+    _mm_storeu_ps(a[1] + i, r1);
+    _mm_storeu_ps(a[2] + i, r2);
+    _mm_storeu_ps(a[3] + i, r3);
+  }
+}
+#endif
+
+}  // namespace
+
+OouraFft::OouraFft(bool sse2_available)
+    : OouraFft(sse2_available, /*avx2_available=*/false) {}
+
+OouraFft::OouraFft(bool sse2_available, bool avx2_available) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  use_sse2_ = sse2_available;
+  use_avx2_ = avx2_available;
+#else
+  use_sse2_ = false;
+  use_avx2_ = false;
+#endif
+}
+
+OouraFft::OouraFft() {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  use_sse2_ = (GetCPUInfo(kSSE2) != 0);
+  use_avx2_ = (GetCPUInfo(kAVX2) != 0);
+#else
+  use_sse2_ = false;
+  use_avx2_ = false;
+#endif
+}
+
+OouraFft::~OouraFft() = default;
+
+void OouraFft::Fft(float* a) const {
+  float xi;
+  bitrv2_128(a);
+  cftfsub_128(a);
+  rftfsub_128(a);
+  xi = a[0] - a[1];
+  a[0] += a[1];
+  a[1] = xi;
+}
+void OouraFft::InverseFft(float* a) const {
+  a[1] = 0.5f * (a[0] - a[1]);
+  a[0] -= a[1];
+  rftbsub_128(a);
+  bitrv2_128(a);
+  cftbsub_128(a);
+}
+
+void OouraFft::FftBatch(float* const* a, size_t batch_size) const {
+  ProcessBatch(a, batch_size, /*inverse=*/false);
+}
+
+void OouraFft::InverseFftBatch(float* const* a, size_t batch_size) const {
+  ProcessBatch(a, batch_size, /*inverse=*/true);
+}
+
+void OouraFft::ProcessBatch(float* const* a,
+                            size_t batch_size,
+                            bool inverse) const {
+  RTC_DCHECK(a);
+  // Lanes without a transform are fed with, and write to, a dummy array.
+  std::array<float, kFftSize> unused_lane;
+  unused_lane.fill(0.f);
+  for (size_t first = 0; first < batch_size; first += kMaxBatchSize) {
+    float* lanes[kMaxBatchSize];
+    for (size_t m = 0; m < kMaxBatchSize; ++m) {
+      lanes[m] = first + m < batch_size ? a[first + m] : unused_lane.data();
+      RTC_DCHECK(lanes[m]);
+    }
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+    if (use_sse2_) {
+      FloatBatchSse2 x[kFftSize];
+      LoadBatchSse2(lanes, x);
+      if (inverse) {
+        InverseFft_C(x);
+      } else {
+        Fft_C(x);
+      }
+      StoreBatchSse2(x, lanes);
+      continue;
+    }
+#endif
+    FloatBatch x[kFftSize];
+    LoadBatch(lanes, x);
+    if (inverse) {
+      InverseFft_C(x);
+    } else {
+      Fft_C(x);
+    }
+    StoreBatch(x, lanes);
+  }
+}
+
+void OouraFft::cft1st_128(float* a) const {
+#if defined(MIPS_FPU_LE)
+  cft1st_128_mips(a);
+#elif defined(WEBRTC_HAS_NEON)
+  cft1st_128_neon(a);
+#elif defined(WEBRTC_ARCH_X86_FAMILY)
+  if (use_avx2_) {
+    cft1st_128_AVX2(a);
+  } else if (use_sse2_) {
+    cft1st_128_SSE2(a);
+  } else {
+    cft1st_128_C(a);
+  }
+#else
+  cft1st_128_C(a);
+#endif
+}
+void OouraFft::cftmdl_128(float* a) const {
+#if defined(MIPS_FPU_LE)
+  cftmdl_128_mips(a);
+#elif defined(WEBRTC_HAS_NEON)
+  cftmdl_128_neon(a);
+#elif defined(WEBRTC_ARCH_X86_FAMILY)
+  if (use_avx2_) {
+    cftmdl_128_AVX2(a);
+  } else if (use_sse2_) {
+    cftmdl_128_SSE2(a);
+  } else {
+    cftmdl_128_C(a);
+  }
+#else
+  cftmdl_128_C(a);
+#endif
+}
+void OouraFft::rftfsub_128(float* a) const {
+#if defined(MIPS_FPU_LE)
+  rftfsub_128_mips(a);
+#elif defined(WEBRTC_HAS_NEON)
+  rftfsub_128_neon(a);
+#elif defined(WEBRTC_ARCH_X86_FAMILY)
+  if (use_avx2_) {
+    rftfsub_128_AVX2(a);
+  } else if (use_sse2_) {
+    rftfsub_128_SSE2(a);
+  } else {
+    rftfsub_128_C(a);
+  }
+#else
+  rftfsub_128_C(a);
+#endif
+}
+
+void OouraFft::rftbsub_128(float* a) const {
+#if defined(MIPS_FPU_LE)
+  rftbsub_128_mips(a);
+#elif defined(WEBRTC_HAS_NEON)
+  rftbsub_128_neon(a);
+#elif defined(WEBRTC_ARCH_X86_FAMILY)
+  if (use_avx2_) {
+    rftbsub_128_AVX2(a);
+  } else if (use_sse2_) {
+    rftbsub_128_SSE2(a);
+  } else {
+    rftbsub_128_C(a);
+  }
+#else
+  rftbsub_128_C(a);
+#endif
+}
+
+void OouraFft::cftbsub_128(float* a) const {
+  cft1st_128(a);
+  cftmdl_128(a);
+  cftbsub_128_last_C(a);
+}
+
+void OouraFft::cftfsub_128(float* a) const {
+  cft1st_128(a);
+  cftmdl_128(a);
+  cftfsub_128_last_C(a);
+}
+
+void OouraFft::bitrv2_128(float* a) const {
+  bitrv2_128_C(a);
+}
+
 }  // namespace webrtc
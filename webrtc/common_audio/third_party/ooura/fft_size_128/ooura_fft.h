@@ -11,6 +11,8 @@
 #ifndef MODULES_AUDIO_PROCESSING_UTILITY_OOURA_FFT_H_
 #define MODULES_AUDIO_PROCESSING_UTILITY_OOURA_FFT_H_
 
+#include <stddef.h>
+
 #include "rtc_base/system/arch.h"
 
 namespace webrtc {
@@ -20,6 +22,10 @@ void cft1st_128_SSE2(float* a);
 void cftmdl_128_SSE2(float* a);
 void rftfsub_128_SSE2(float* a);
 void rftbsub_128_SSE2(float* a);
+void cft1st_128_AVX2(float* a);
+void cftmdl_128_AVX2(float* a);
+void rftfsub_128_AVX2(float* a);
+void rftbsub_128_AVX2(float* a);
 #endif
 
 #if defined(MIPS_FPU_LE)
@@ -41,13 +47,28 @@ class OouraFft {
   // Ctor allowing the availability of SSE2 support to be specified.
   explicit OouraFft(bool sse2_available);
 
+  // Ctor allowing the availability of SSE2 and AVX2 support to be specified.
+  OouraFft(bool sse2_available, bool avx2_available);
+
   // Deprecated: This Ctor will soon be removed.
   OouraFft();
   ~OouraFft();
   void Fft(float* a) const;
   void InverseFft(float* a) const;
 
+  // Maximum number of transforms that are computed in lockstep.
+  static constexpr size_t kMaxBatchSize = 4;
+
+  // Batched versions of Fft() and InverseFft() for the |batch_size| arrays
+  // pointed to by |a|. The transforms are computed in groups of
+  // kMaxBatchSize, with one transform in each SIMD lane, using the same
+  // sequence of operations as the C version of Fft() and InverseFft().
+  void FftBatch(float* const* a, size_t batch_size) const;
+  void InverseFftBatch(float* const* a, size_t batch_size) const;
+
  private:
+  void ProcessBatch(float* const* a, size_t batch_size, bool inverse) const;
+
   void cft1st_128(float* a) const;
   void cftmdl_128(float* a) const;
   void rftfsub_128(float* a) const;
@@ -57,6 +78,7 @@ class OouraFft {
   void cftbsub_128(float* a) const;
   void bitrv2_128(float* a) const;
   bool use_sse2_;
+  bool use_avx2_;
 };
 
 }  // namespace webrtc
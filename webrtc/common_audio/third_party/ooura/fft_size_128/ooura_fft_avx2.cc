@@ -0,0 +1,344 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <immintrin.h>
+
+#include "common_audio/third_party/ooura/fft_size_128/ooura_fft.h"
+#include "common_audio/third_party/ooura/fft_size_128/ooura_fft_tables_common.h"
+#include "common_audio/third_party/ooura/fft_size_128/ooura_fft_tables_neon_sse2.h"
+#include "rtc_base/system/arch.h"
+
+namespace webrtc {
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+
+namespace {
+
+// Loads four values from |lo| into the lower lane and four values from |hi|
+// into the upper lane.
+__m256 LoadLanes(const float* lo, const float* hi) {
+  return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(lo)),
+                              _mm_loadu_ps(hi), 1);
+}
+
+void StoreLanes(__m256 v, float* lo, float* hi) {
+  _mm_storeu_ps(lo, _mm256_castps256_ps128(v));
+  _mm_storeu_ps(hi, _mm256_extractf128_ps(v, 1));
+}
+
+// Loads the two complex values at |lo| and at |hi| such that each lane holds
+// one complex value from |lo| followed by one from |hi|. This is the layout
+// that the SSE2 code forms from two 64 bit loads, for two consecutive
+// iterations.
+__m256 LoadPairs(const float* lo, const float* hi) {
+  return _mm256_castpd_ps(_mm256_permute4x64_pd(
+      _mm256_castps_pd(LoadLanes(lo, hi)), _MM_SHUFFLE(3, 1, 2, 0)));
+}
+
+void StorePairs(__m256 v, float* lo, float* hi) {
+  StoreLanes(_mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(v),
+                                                    _MM_SHUFFLE(3, 1, 2, 0))),
+             lo, hi);
+}
+
+// Swaps the real and imaginary parts of the complex values in v.
+__m256 SwapReIm(__m256 v) {
+  return _mm256_permute_ps(v, _MM_SHUFFLE(2, 3, 0, 1));
+}
+
+// Reverses the order of the eight values in v.
+__m256 Reverse(__m256 v) {
+  return _mm256_permutevar8x32_ps(v, _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0));
+}
+
+// Splits the values at a[0], ..., a[15] into those with even and odd indexes.
+void Deinterleave(const float* a, __m256* even, __m256* odd) {
+  const __m256 a_0 = _mm256_loadu_ps(&a[0]);
+  const __m256 a_8 = _mm256_loadu_ps(&a[8]);
+  const __m256i order = _mm256_setr_epi32(0, 1, 4, 5, 2, 3, 6, 7);
+  *even = _mm256_permutevar8x32_ps(
+      _mm256_shuffle_ps(a_0, a_8, _MM_SHUFFLE(2, 0, 2, 0)), order);
+  *odd = _mm256_permutevar8x32_ps(
+      _mm256_shuffle_ps(a_0, a_8, _MM_SHUFFLE(3, 1, 3, 1)), order);
+}
+
+// Inverse of Deinterleave().
+void Interleave(__m256 even, __m256 odd, float* a) {
+  const __m256 lo = _mm256_unpacklo_ps(even, odd);
+  const __m256 hi = _mm256_unpackhi_ps(even, odd);
+  _mm256_storeu_ps(&a[0], _mm256_permute2f128_ps(lo, hi, 0x20));
+  _mm256_storeu_ps(&a[8], _mm256_permute2f128_ps(lo, hi, 0x31));
+}
+
+}  // namespace
+
+// The AVX2 kernels follow the SSE2 ones in ooura_fft_sse2.cc, with two
+// iterations of the SSE2 loops in the two lanes of each AVX register and with
+// the complex multiplications done using FMA.
+void cft1st_128_AVX2(float* a) {
+  const __m256 mm_swap_sign = _mm256_broadcast_ps(
+      reinterpret_cast<const __m128*>(k_swap_sign));
+  int j, k2;
+
+  for (k2 = 0, j = 0; j < 128; j += 32, k2 += 8) {
+    __m256 a00v = LoadLanes(&a[j + 0], &a[j + 16]);
+    __m256 a04v = LoadLanes(&a[j + 4], &a[j + 20]);
+    __m256 a08v = LoadLanes(&a[j + 8], &a[j + 24]);
+    __m256 a12v = LoadLanes(&a[j + 12], &a[j + 28]);
+    __m256 a01v = _mm256_shuffle_ps(a00v, a08v, _MM_SHUFFLE(1, 0, 1, 0));
+    __m256 a23v = _mm256_shuffle_ps(a00v, a08v, _MM_SHUFFLE(3, 2, 3, 2));
+    __m256 a45v = _mm256_shuffle_ps(a04v, a12v, _MM_SHUFFLE(1, 0, 1, 0));
+    __m256 a67v = _mm256_shuffle_ps(a04v, a12v, _MM_SHUFFLE(3, 2, 3, 2));
+
+    const __m256 wk1rv = _mm256_loadu_ps(&rdft_wk1r[k2]);
+    const __m256 wk1iv = _mm256_loadu_ps(&rdft_wk1i[k2]);
+    const __m256 wk2rv = _mm256_loadu_ps(&rdft_wk2r[k2]);
+    const __m256 wk2iv = _mm256_loadu_ps(&rdft_wk2i[k2]);
+    const __m256 wk3rv = _mm256_loadu_ps(&rdft_wk3r[k2]);
+    const __m256 wk3iv = _mm256_loadu_ps(&rdft_wk3i[k2]);
+    __m256 x0v = _mm256_add_ps(a01v, a23v);
+    const __m256 x1v = _mm256_sub_ps(a01v, a23v);
+    const __m256 x2v = _mm256_add_ps(a45v, a67v);
+    const __m256 x3v = _mm256_sub_ps(a45v, a67v);
+    a01v = _mm256_add_ps(x0v, x2v);
+    x0v = _mm256_sub_ps(x0v, x2v);
+    a45v = _mm256_fmadd_ps(wk2rv, x0v, _mm256_mul_ps(wk2iv, SwapReIm(x0v)));
+
+    const __m256 x3s = _mm256_mul_ps(mm_swap_sign, SwapReIm(x3v));
+    x0v = _mm256_add_ps(x1v, x3s);
+    a23v = _mm256_fmadd_ps(wk1rv, x0v, _mm256_mul_ps(wk1iv, SwapReIm(x0v)));
+    x0v = _mm256_sub_ps(x1v, x3s);
+    a67v = _mm256_fmadd_ps(wk3rv, x0v, _mm256_mul_ps(wk3iv, SwapReIm(x0v)));
+
+    a00v = _mm256_shuffle_ps(a01v, a23v, _MM_SHUFFLE(1, 0, 1, 0));
+    a04v = _mm256_shuffle_ps(a45v, a67v, _MM_SHUFFLE(1, 0, 1, 0));
+    a08v = _mm256_shuffle_ps(a01v, a23v, _MM_SHUFFLE(3, 2, 3, 2));
+    a12v = _mm256_shuffle_ps(a45v, a67v, _MM_SHUFFLE(3, 2, 3, 2));
+    StoreLanes(a00v, &a[j + 0], &a[j + 16]);
+    StoreLanes(a04v, &a[j + 4], &a[j + 20]);
+    StoreLanes(a08v, &a[j + 8], &a[j + 24]);
+    StoreLanes(a12v, &a[j + 12], &a[j + 28]);
+  }
+}
+
+void cftmdl_128_AVX2(float* a) {
+  const int l = 8;
+  const __m256 mm_swap_sign = _mm256_broadcast_ps(
+      reinterpret_cast<const __m128*>(k_swap_sign));
+  // Negates the real part of the second complex value in each lane.
+  const __m256 mm_negate_2 = _mm256_setr_ps(1.f, 1.f, -1.f, 1.f, 1.f, 1.f,
+                                            -1.f, 1.f);
+  int j0;
+
+  const __m256 wk1rv_0 =
+      _mm256_broadcast_ps(reinterpret_cast<const __m128*>(cftmdl_wk1r));
+  for (j0 = 0; j0 < l; j0 += 4) {
+    const __m256 a_00_32 = LoadPairs(&a[j0 + 0], &a[j0 + 32]);
+    const __m256 a_08_40 = LoadPairs(&a[j0 + 8], &a[j0 + 40]);
+    const __m256 x0v = _mm256_add_ps(a_00_32, a_08_40);
+    const __m256 x1v = _mm256_sub_ps(a_00_32, a_08_40);
+
+    const __m256 a_16_48 = LoadPairs(&a[j0 + 16], &a[j0 + 48]);
+    const __m256 a_24_56 = LoadPairs(&a[j0 + 24], &a[j0 + 56]);
+    const __m256 x2v = _mm256_add_ps(a_16_48, a_24_56);
+    const __m256 x3v = _mm256_sub_ps(a_16_48, a_24_56);
+
+    const __m256 xx0 = _mm256_add_ps(x0v, x2v);
+    const __m256 xx1 = _mm256_sub_ps(x0v, x2v);
+
+    const __m256 x3_swapped = _mm256_mul_ps(mm_swap_sign, SwapReIm(x3v));
+    const __m256 x1_x3_add = _mm256_add_ps(x1v, x3_swapped);
+    const __m256 x1_x3_sub = _mm256_sub_ps(x1v, x3_swapped);
+
+    const __m256 yy0 =
+        _mm256_shuffle_ps(x1_x3_add, x1_x3_sub, _MM_SHUFFLE(2, 2, 2, 2));
+    const __m256 yy1 =
+        _mm256_shuffle_ps(x1_x3_add, x1_x3_sub, _MM_SHUFFLE(3, 3, 3, 3));
+    const __m256 yy3 = _mm256_fmadd_ps(mm_swap_sign, yy1, yy0);
+    const __m256 yy4 = _mm256_mul_ps(wk1rv_0, yy3);
+
+    StorePairs(xx0, &a[j0 + 0], &a[j0 + 32]);
+    StorePairs(_mm256_mul_ps(mm_negate_2,
+                             _mm256_permute_ps(xx1, _MM_SHUFFLE(2, 3, 1, 0))),
+               &a[j0 + 16], &a[j0 + 48]);
+    StorePairs(_mm256_shuffle_ps(x1_x3_add, yy4, _MM_SHUFFLE(1, 0, 1, 0)),
+               &a[j0 + 8], &a[j0 + 40]);
+    StorePairs(_mm256_shuffle_ps(x1_x3_sub, yy4, _MM_SHUFFLE(2, 3, 1, 0)),
+               &a[j0 + 24], &a[j0 + 56]);
+  }
+
+  {
+    const int k = 64;
+    const int k2 = 4;
+    const __m256 wk2rv =
+        _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&rdft_wk2r[k2]));
+    const __m256 wk2iv =
+        _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&rdft_wk2i[k2]));
+    const __m256 wk1rv =
+        _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&rdft_wk1r[k2]));
+    const __m256 wk1iv =
+        _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&rdft_wk1i[k2]));
+    const __m256 wk3rv =
+        _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&rdft_wk3r[k2]));
+    const __m256 wk3iv =
+        _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&rdft_wk3i[k2]));
+    for (j0 = k; j0 < l + k; j0 += 4) {
+      const __m256 a_00_32 = LoadPairs(&a[j0 + 0], &a[j0 + 32]);
+      const __m256 a_08_40 = LoadPairs(&a[j0 + 8], &a[j0 + 40]);
+      const __m256 x0v = _mm256_add_ps(a_00_32, a_08_40);
+      const __m256 x1v = _mm256_sub_ps(a_00_32, a_08_40);
+
+      const __m256 a_16_48 = LoadPairs(&a[j0 + 16], &a[j0 + 48]);
+      const __m256 a_24_56 = LoadPairs(&a[j0 + 24], &a[j0 + 56]);
+      const __m256 x2v = _mm256_add_ps(a_16_48, a_24_56);
+      const __m256 x3v = _mm256_sub_ps(a_16_48, a_24_56);
+
+      const __m256 xx = _mm256_add_ps(x0v, x2v);
+      const __m256 xx1 = _mm256_sub_ps(x0v, x2v);
+      const __m256 xx4 =
+          _mm256_fmadd_ps(xx1, wk2rv, _mm256_mul_ps(wk2iv, SwapReIm(xx1)));
+
+      const __m256 x3_swapped = _mm256_mul_ps(mm_swap_sign, SwapReIm(x3v));
+      const __m256 x1_x3_add = _mm256_add_ps(x1v, x3_swapped);
+      const __m256 x1_x3_sub = _mm256_sub_ps(x1v, x3_swapped);
+
+      const __m256 xx12 = _mm256_fmadd_ps(
+          x1_x3_add, wk1rv, _mm256_mul_ps(wk1iv, SwapReIm(x1_x3_add)));
+      const __m256 xx22 = _mm256_fmadd_ps(
+          x1_x3_sub, wk3rv, _mm256_mul_ps(wk3iv, SwapReIm(x1_x3_sub)));
+
+      StorePairs(xx, &a[j0 + 0], &a[j0 + 32]);
+      StorePairs(xx4, &a[j0 + 16], &a[j0 + 48]);
+      StorePairs(xx12, &a[j0 + 8], &a[j0 + 40]);
+      StorePairs(xx22, &a[j0 + 24], &a[j0 + 56]);
+    }
+  }
+}
+
+void rftfsub_128_AVX2(float* a) {
+  const float* c = rdft_w + 32;
+  int j1, j2, k1, k2;
+  float wkr, wki, xr, xi, yr, yi;
+
+  const __m256 mm_half = _mm256_set1_ps(0.5f);
+
+  // Vectorized code (eight at once).
+  //    Note: commented number are indexes for the first iteration of the loop.
+  for (j1 = 1, j2 = 2; j2 + 15 < 64; j1 += 8, j2 += 16) {
+    // Load 'wk'.
+    const __m256 wkr_ =
+        _mm256_sub_ps(mm_half, Reverse(_mm256_loadu_ps(&c[25 - j1])));
+    // 31, 30, ..., 24,
+    const __m256 wki_ = _mm256_loadu_ps(&c[j1]);  //  1,  2, ...,  8,
+    // Load and deinterleave 'a'.
+    __m256 a_j2_p0, a_j2_p1, a_k2_p0, a_k2_p1;
+    Deinterleave(&a[j2], &a_j2_p0, &a_j2_p1);
+    //   2,   4, ...,  16,
+    //   3,   5, ...,  17,
+    Deinterleave(&a[114 - j2], &a_k2_p0, &a_k2_p1);
+    a_k2_p0 = Reverse(a_k2_p0);  // 126, 124, ..., 112,
+    a_k2_p1 = Reverse(a_k2_p1);  // 127, 125, ..., 113,
+    // Calculate 'x'.
+    const __m256 xr_ = _mm256_sub_ps(a_j2_p0, a_k2_p0);
+    const __m256 xi_ = _mm256_add_ps(a_j2_p1, a_k2_p1);
+    // Calculate product into 'y'.
+    //    yr = wkr * xr - wki * xi;
+    //    yi = wkr * xi + wki * xr;
+    const __m256 yr_ = _mm256_fmsub_ps(wkr_, xr_, _mm256_mul_ps(wki_, xi_));
+    const __m256 yi_ = _mm256_fmadd_ps(wkr_, xi_, _mm256_mul_ps(wki_, xr_));
+    // Update 'a'.
+    //    a[j2 + 0] -= yr;
+    //    a[j2 + 1] -= yi;
+    //    a[k2 + 0] += yr;
+    //    a[k2 + 1] -= yi;
+    Interleave(_mm256_sub_ps(a_j2_p0, yr_), _mm256_sub_ps(a_j2_p1, yi_),
+               &a[j2]);
+    Interleave(Reverse(_mm256_add_ps(a_k2_p0, yr_)),
+               Reverse(_mm256_sub_ps(a_k2_p1, yi_)), &a[114 - j2]);
+  }
+  // Scalar code for the remaining items.
+  for (; j2 < 64; j1 += 1, j2 += 2) {
+    k2 = 128 - j2;
+    k1 = 32 - j1;
+    wkr = 0.5f - c[k1];
+    wki = c[j1];
+    xr = a[j2 + 0] - a[k2 + 0];
+    xi = a[j2 + 1] + a[k2 + 1];
+    yr = wkr * xr - wki * xi;
+    yi = wkr * xi + wki * xr;
+    a[j2 + 0] -= yr;
+    a[j2 + 1] -= yi;
+    a[k2 + 0] += yr;
+    a[k2 + 1] -= yi;
+  }
+}
+
+void rftbsub_128_AVX2(float* a) {
+  const float* c = rdft_w + 32;
+  int j1, j2, k1, k2;
+  float wkr, wki, xr, xi, yr, yi;
+
+  const __m256 mm_half = _mm256_set1_ps(0.5f);
+
+  a[1] = -a[1];
+  // Vectorized code (eight at once).
+  //    Note: commented number are indexes for the first iteration of the loop.
+  for (j1 = 1, j2 = 2; j2 + 15 < 64; j1 += 8, j2 += 16) {
+    // Load 'wk'.
+    const __m256 wkr_ =
+        _mm256_sub_ps(mm_half, Reverse(_mm256_loadu_ps(&c[25 - j1])));
+    // 31, 30, ..., 24,
+    const __m256 wki_ = _mm256_loadu_ps(&c[j1]);  //  1,  2, ...,  8,
+    // Load and deinterleave 'a'.
+    __m256 a_j2_p0, a_j2_p1, a_k2_p0, a_k2_p1;
+    Deinterleave(&a[j2], &a_j2_p0, &a_j2_p1);
+    //   2,   4, ...,  16,
+    //   3,   5, ...,  17,
+    Deinterleave(&a[114 - j2], &a_k2_p0, &a_k2_p1);
+    a_k2_p0 = Reverse(a_k2_p0);  // 126, 124, ..., 112,
+    a_k2_p1 = Reverse(a_k2_p1);  // 127, 125, ..., 113,
+    // Calculate 'x'.
+    const __m256 xr_ = _mm256_sub_ps(a_j2_p0, a_k2_p0);
+    const __m256 xi_ = _mm256_add_ps(a_j2_p1, a_k2_p1);
+    // Calculate product into 'y'.
+    //    yr = wkr * xr + wki * xi;
+    //    yi = wkr * xi - wki * xr;
+    const __m256 yr_ = _mm256_fmadd_ps(wkr_, xr_, _mm256_mul_ps(wki_, xi_));
+    const __m256 yi_ = _mm256_fmsub_ps(wkr_, xi_, _mm256_mul_ps(wki_, xr_));
+    // Update 'a'.
+    //    a[j2 + 0] = a[j2 + 0] - yr;
+    //    a[j2 + 1] = yi - a[j2 + 1];
+    //    a[k2 + 0] = yr + a[k2 + 0];
+    //    a[k2 + 1] = yi - a[k2 + 1];
+    Interleave(_mm256_sub_ps(a_j2_p0, yr_), _mm256_sub_ps(yi_, a_j2_p1),
+               &a[j2]);
+    Interleave(Reverse(_mm256_add_ps(a_k2_p0, yr_)),
+               Reverse(_mm256_sub_ps(yi_, a_k2_p1)), &a[114 - j2]);
+  }
+  // Scalar code for the remaining items.
+  for (; j2 < 64; j1 += 1, j2 += 2) {
+    k2 = 128 - j2;
+    k1 = 32 - j1;
+    wkr = 0.5f - c[k1];
+    wki = c[j1];
+    xr = a[j2 + 0] - a[k2 + 0];
+    xi = a[j2 + 1] + a[k2 + 1];
+    yr = wkr * xr + wki * xi;
+    yi = wkr * xi - wki * xr;
+    a[j2 + 0] = a[j2 + 0] - yr;
+    a[j2 + 1] = yi - a[j2 + 1];
+    a[k2 + 0] = yr + a[k2 + 0];
+    a[k2 + 1] = yi - a[k2 + 1];
+  }
+  a[65] = -a[65];
+}
+#endif
+
+}  // namespace webrtc
@@ -0,0 +1,56 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef COMMON_AUDIO_VAD_INCLUDE_MULTI_VAD_H_
+#define COMMON_AUDIO_VAD_INCLUDE_MULTI_VAD_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+
+#include "api/array_view.h"
+#include "common_audio/vad/include/vad.h"
+
+namespace webrtc {
+
+// Runs the WebRtcVad detector on many independent streams with one call, e.g.
+// to cheaply decide which of thousands of streams need further processing.
+// The detector states are stored as a structure of arrays, such that when
+// AVX2 is available eight streams are processed at once. The decisions for
+// each stream are bit-exact with those of a Vad with the same aggressiveness.
+class MultiVad {
+ public:
+  virtual ~MultiVad() = default;
+
+  virtual size_t num_streams() const = 0;
+
+  // Calculates a VAD decision for one frame of each stream, where |audio|
+  // holds a pointer to the frame of each stream. All the frames have the same
+  // sample rate and length; valid sample rates are 8000, 16000, 32000 and
+  // 48000 Hz, and the frames must be 10, 20, or 30 ms long. If they are not,
+  // all the decisions are Vad::kError.
+  virtual void VoiceActivity(rtc::ArrayView<const int16_t* const> audio,
+                             size_t num_samples,
+                             int sample_rate_hz,
+                             rtc::ArrayView<Vad::Activity> activity) = 0;
+
+  // Resets the VAD state of one or of all the streams.
+  virtual void ResetStream(size_t stream) = 0;
+  virtual void Reset() = 0;
+};
+
+// Returns a MultiVad for |num_streams| streams.
+std::unique_ptr<MultiVad> CreateMultiVad(size_t num_streams,
+                                         Vad::Aggressiveness aggressiveness);
+
+}  // namespace webrtc
+
+#endif  // COMMON_AUDIO_VAD_INCLUDE_MULTI_VAD_H_
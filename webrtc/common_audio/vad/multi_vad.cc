@@ -0,0 +1,198 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "common_audio/vad/include/multi_vad.h"
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+#include "common_audio/vad/include/webrtc_vad.h"
+#include "common_audio/vad/vad_lanes.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/system/arch.h"
+#include "system_wrappers/include/cpu_features_wrapper.h"
+
+namespace webrtc {
+namespace {
+
+// Longest frame, 30 ms at 48 kHz, and its length at 8 kHz.
+constexpr size_t kMaxFrameLength = 1440;
+constexpr size_t kMaxFrameLength8kHz = kMaxFrameLength / 6;
+constexpr size_t kFrameLength10ms48kHz = 480;
+constexpr size_t kFrameLength10ms8kHz = 80;
+
+// Input of the lanes without a stream.
+const int16_t kSilence[kMaxFrameLength] = {};
+
+bool IsAvx2Available() {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  return GetCPUInfo(kAVX2) != 0;
+#else
+  return false;
+#endif
+}
+
+int CalcVad(VadInstT* inst,
+            const int16_t* audio,
+            size_t num_samples,
+            int sample_rate_hz) {
+  switch (sample_rate_hz) {
+    case 8000:
+      return WebRtcVad_CalcVad8khz(inst, audio, num_samples);
+    case 16000:
+      return WebRtcVad_CalcVad16khz(inst, audio, num_samples);
+    case 32000:
+      return WebRtcVad_CalcVad32khz(inst, audio, num_samples);
+    default:
+      return WebRtcVad_CalcVad48khz(inst, audio, num_samples);
+  }
+}
+
+class MultiVadImpl final : public MultiVad {
+ public:
+  MultiVadImpl(size_t num_streams, Vad::Aggressiveness aggressiveness)
+      : num_streams_(num_streams), use_avx2_(IsAvx2Available()) {
+    RTC_CHECK_EQ(WebRtcVad_InitCore(&initial_state_), 0);
+    RTC_CHECK_EQ(WebRtcVad_set_mode_core(&initial_state_, aggressiveness), 0);
+    if (use_avx2_) {
+      lanes_.resize((num_streams + kVadLanes - 1) / kVadLanes);
+      resampler_states_.resize(num_streams);
+    } else {
+      instances_.resize(num_streams);
+    }
+    Reset();
+  }
+
+  MultiVadImpl(const MultiVadImpl&) = delete;
+  MultiVadImpl& operator=(const MultiVadImpl&) = delete;
+
+  size_t num_streams() const override { return num_streams_; }
+
+  void VoiceActivity(rtc::ArrayView<const int16_t* const> audio,
+                     size_t num_samples,
+                     int sample_rate_hz,
+                     rtc::ArrayView<Vad::Activity> activity) override {
+    RTC_DCHECK_EQ(audio.size(), num_streams_);
+    RTC_DCHECK_EQ(activity.size(), num_streams_);
+    if (WebRtcVad_ValidRateAndFrameLength(sample_rate_hz, num_samples) != 0) {
+      std::fill(activity.begin(), activity.end(), Vad::kError);
+      return;
+    }
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+    if (use_avx2_) {
+      VoiceActivityAvx2(audio, num_samples, sample_rate_hz, activity);
+      return;
+    }
+#endif
+    for (size_t stream = 0; stream < num_streams_; ++stream) {
+      const int vad = CalcVad(&instances_[stream], audio[stream], num_samples,
+                              sample_rate_hz);
+      activity[stream] = vad > 0 ? Vad::kActive : Vad::kPassive;
+    }
+  }
+
+  void ResetStream(size_t stream) override {
+    RTC_DCHECK_LT(stream, num_streams_);
+    if (!use_avx2_) {
+      instances_[stream] = initial_state_;
+      return;
+    }
+    StoreVadLane(initial_state_, stream % kVadLanes,
+                 &lanes_[stream / kVadLanes]);
+    resampler_states_[stream] = initial_state_.state_48_to_8;
+  }
+
+  void Reset() override {
+    std::fill(instances_.begin(), instances_.end(), initial_state_);
+    for (size_t lane = 0; lane < lanes_.size() * kVadLanes; ++lane) {
+      StoreVadLane(initial_state_, lane % kVadLanes, &lanes_[lane / kVadLanes]);
+    }
+    std::fill(resampler_states_.begin(), resampler_states_.end(),
+              initial_state_.state_48_to_8);
+  }
+
+ private:
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  void VoiceActivityAvx2(rtc::ArrayView<const int16_t* const> audio,
+                         size_t num_samples,
+                         int sample_rate_hz,
+                         rtc::ArrayView<Vad::Activity> activity) {
+    // At 48 kHz, the lanes start from the 8 kHz signal since the resampler is
+    // not vectorized.
+    const int lanes_sample_rate_hz =
+        sample_rate_hz == 48000 ? 8000 : sample_rate_hz;
+    const size_t lanes_num_samples =
+        sample_rate_hz == 48000 ? num_samples / 6 : num_samples;
+    for (size_t group = 0; group < lanes_.size(); ++group) {
+      const size_t first_stream = group * kVadLanes;
+      const size_t num_lanes =
+          std::min<size_t>(kVadLanes, num_streams_ - first_stream);
+      const int16_t* frames[kVadLanes];
+      for (size_t lane = 0; lane < kVadLanes; ++lane) {
+        frames[lane] = kSilence;
+        if (lane >= num_lanes) {
+          continue;
+        }
+        frames[lane] = audio[first_stream + lane];
+        if (sample_rate_hz == 48000) {
+          Resample48khzTo8khz(first_stream + lane, frames[lane], num_samples,
+                              resampled_[lane].data());
+          frames[lane] = resampled_[lane].data();
+        }
+      }
+      int vad[kVadLanes];
+      CalcVadLanesAvx2(initial_state_, frames, lanes_sample_rate_hz,
+                       lanes_num_samples, &lanes_[group], vad);
+      for (size_t lane = 0; lane < num_lanes; ++lane) {
+        activity[first_stream + lane] =
+            vad[lane] > 0 ? Vad::kActive : Vad::kPassive;
+      }
+    }
+  }
+#endif
+
+  // Same as the resampling in WebRtcVad_CalcVad48khz(), which resamples the
+  // first 10 ms of the frame for each 10 ms of the frame.
+  void Resample48khzTo8khz(size_t stream,
+                           const int16_t* audio,
+                           size_t num_samples,
+                           int16_t* audio_8khz) {
+    for (size_t i = 0; i < num_samples / kFrameLength10ms48kHz; ++i) {
+      WebRtcSpl_Resample48khzTo8khz(
+          audio, &audio_8khz[i * kFrameLength10ms8kHz],
+          &resampler_states_[stream], resampler_scratch_.data());
+    }
+  }
+
+  const size_t num_streams_;
+  const bool use_avx2_;
+  // Initial state, which also holds the thresholds of the aggressiveness.
+  VadInstT initial_state_;
+  // Without AVX2, the streams are processed one at a time by the scalar
+  // detector. Otherwise, their state is held in lanes, except for that of the
+  // 48 kHz resampler.
+  std::vector<VadInstT> instances_;
+  std::vector<VadLanes> lanes_;
+  std::vector<WebRtcSpl_State48khzTo8khz> resampler_states_;
+  std::array<std::array<int16_t, kMaxFrameLength8kHz>, kVadLanes> resampled_;
+  std::array<int32_t, kFrameLength10ms48kHz + 256> resampler_scratch_;
+};
+
+}  // namespace
+
+std::unique_ptr<MultiVad> CreateMultiVad(size_t num_streams,
+                                         Vad::Aggressiveness aggressiveness) {
+  return std::unique_ptr<MultiVad>(
+      new MultiVadImpl(num_streams, aggressiveness));
+}
+
+}  // namespace webrtc
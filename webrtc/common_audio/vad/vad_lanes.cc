@@ -0,0 +1,46 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "common_audio/vad/vad_lanes.h"
+
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+namespace {
+
+template <typename T, size_t N>
+void StoreArray(const T (&from)[N], size_t lane, int32_t (*to)[kVadLanes]) {
+  for (size_t i = 0; i < N; ++i) {
+    to[i][lane] = from[i];
+  }
+}
+
+}  // namespace
+
+void StoreVadLane(const VadInstT& inst, size_t lane, VadLanes* lanes) {
+  RTC_DCHECK_LT(lane, kVadLanes);
+  StoreArray(inst.downsampling_filter_states, lane,
+             lanes->downsampling_filter_states);
+  StoreArray(inst.noise_means, lane, lanes->noise_means);
+  StoreArray(inst.speech_means, lane, lanes->speech_means);
+  StoreArray(inst.noise_stds, lane, lanes->noise_stds);
+  StoreArray(inst.speech_stds, lane, lanes->speech_stds);
+  lanes->frame_counter[lane] = inst.frame_counter;
+  lanes->over_hang[lane] = inst.over_hang;
+  lanes->num_of_speech[lane] = inst.num_of_speech;
+  StoreArray(inst.index_vector, lane, lanes->index_vector);
+  StoreArray(inst.low_value_vector, lane, lanes->low_value_vector);
+  StoreArray(inst.mean_value, lane, lanes->mean_value);
+  StoreArray(inst.upper_state, lane, lanes->upper_state);
+  StoreArray(inst.lower_state, lane, lanes->lower_state);
+  StoreArray(inst.hp_filter_state, lane, lanes->hp_filter_state);
+}
+
+}  // namespace webrtc
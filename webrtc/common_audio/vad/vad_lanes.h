@@ -0,0 +1,69 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef COMMON_AUDIO_VAD_VAD_LANES_H_
+#define COMMON_AUDIO_VAD_VAD_LANES_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "rtc_base/system/arch.h"
+
+extern "C" {
+#include "common_audio/vad/vad_core.h"
+}
+
+namespace webrtc {
+
+// Number of VAD instances processed together.
+enum { kVadLanes = 8 };
+
+// Detector state of kVadLanes VAD instances stored as a structure of arrays.
+// Each field holds the VadInstT field of the same name, with the values of
+// the k-th instance in lane k. The values are widened to 32 bits so that the
+// fixed-point arithmetic can be carried out on them without repacking. The
+// state of the 48 to 8 kHz resampler and the thresholds of the aggressiveness
+// mode are kept outside.
+struct VadLanes {
+  int32_t downsampling_filter_states[4][kVadLanes];
+  int32_t noise_means[kTableSize][kVadLanes];
+  int32_t speech_means[kTableSize][kVadLanes];
+  int32_t noise_stds[kTableSize][kVadLanes];
+  int32_t speech_stds[kTableSize][kVadLanes];
+  int32_t frame_counter[kVadLanes];
+  int32_t over_hang[kVadLanes];
+  int32_t num_of_speech[kVadLanes];
+  int32_t index_vector[16 * kNumChannels][kVadLanes];
+  int32_t low_value_vector[16 * kNumChannels][kVadLanes];
+  int32_t mean_value[kNumChannels][kVadLanes];
+  int32_t upper_state[5][kVadLanes];
+  int32_t lower_state[5][kVadLanes];
+  int32_t hp_filter_state[4][kVadLanes];
+};
+
+// Copies the state of |inst| into |lane| of |lanes|.
+void StoreVadLane(const VadInstT& inst, size_t lane, VadLanes* lanes);
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+// Runs WebRtcVad_CalcVad8khz(), WebRtcVad_CalcVad16khz() or
+// WebRtcVad_CalcVad32khz(), depending on |sample_rate_hz|, on each lane of
+// |lanes| with the frame in |frames|. The thresholds of the aggressiveness
+// mode are taken from |config|. The bit-exact decisions are written to |vad|.
+void CalcVadLanesAvx2(const VadInstT& config,
+                      const int16_t* const frames[kVadLanes],
+                      int sample_rate_hz,
+                      size_t frame_length,
+                      VadLanes* lanes,
+                      int vad[kVadLanes]);
+#endif
+
+}  // namespace webrtc
+
+#endif  // COMMON_AUDIO_VAD_VAD_LANES_H_
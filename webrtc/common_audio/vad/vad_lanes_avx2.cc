@@ -0,0 +1,795 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <immintrin.h>
+
+#include "common_audio/vad/vad_lanes.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/system/arch.h"
+
+namespace webrtc {
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+
+namespace {
+
+// The code below follows vad_sp.c, vad_filterbank.c, vad_gmm.c and
+// vad_core.c line by line, with one VAD instance per 32 bit lane. Each
+// assignment to an int16_t variable in the C code is matched by a Wrap16().
+
+// Constants of vad_sp.c.
+const int16_t kAllPassCoefsQ13[2] = {5243, 1392};
+
+// Constants of vad_filterbank.c.
+const int16_t kLogConst = 24660;
+const int16_t kLogEnergyIntPart = 14336;
+const int16_t kHpZeroCoefs[3] = {6631, -13262, 6631};
+const int16_t kHpPoleCoefs[3] = {16384, -7756, 5620};
+const int16_t kAllPassCoefsQ15[2] = {20972, 5571};
+const int16_t kOffsetVector[6] = {368, 368, 272, 176, 176, 176};
+
+// Constants of vad_gmm.c.
+const int32_t kCompVar = 22005;
+const int16_t kLog2Exp = 5909;
+
+// Constants of vad_core.c.
+const int16_t kSpectrumWeight[kNumChannels] = {6, 8, 10, 12, 14, 16};
+const int16_t kNoiseUpdateConst = 655;
+const int16_t kSpeechUpdateConst = 6554;
+const int16_t kBackEta = 154;
+const int16_t kMinimumDifference[kNumChannels] = {544, 544, 576,
+                                                  576, 576, 576};
+const int16_t kMaximumSpeech[kNumChannels] = {11392, 11392, 11520,
+                                              11520, 11520, 11520};
+const int16_t kMinimumMean[kNumGaussians] = {640, 768};
+const int16_t kMaximumNoise[kNumChannels] = {9216, 9088, 8960,
+                                             8832, 8704, 8576};
+const int16_t kNoiseDataWeights[kTableSize] = {34, 62, 72, 66, 53, 25,
+                                               94, 66, 56, 62, 75, 103};
+const int16_t kSpeechDataWeights[kTableSize] = {48, 82, 45, 87, 50, 47,
+                                                80, 46, 83, 41, 78, 81};
+const int16_t kMaxSpeechFrames = 6;
+const int16_t kMinStd = 384;
+
+// Longest frame, 30 ms at 32 kHz, and its length at 16 and 8 kHz.
+const size_t kMaxFrameLength = 960;
+const size_t kMaxFrameLength16kHz = kMaxFrameLength / 2;
+const size_t kMaxFrameLength8kHz = kMaxFrameLength / 4;
+
+inline __m256i Set(int32_t x) {
+  return _mm256_set1_epi32(x);
+}
+
+inline __m256i Load(const int32_t* p) {
+  return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+}
+
+inline void Store(__m256i v, int32_t* p) {
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v);
+}
+
+// Stores the lanes of |v| selected by |mask|.
+inline void StoreIf(__m256i mask, __m256i v, int32_t* p) {
+  _mm256_maskstore_epi32(p, mask, v);
+}
+
+inline __m256i Add(__m256i a, __m256i b) {
+  return _mm256_add_epi32(a, b);
+}
+
+inline __m256i Sub(__m256i a, __m256i b) {
+  return _mm256_sub_epi32(a, b);
+}
+
+inline __m256i Mul(__m256i a, __m256i b) {
+  return _mm256_mullo_epi32(a, b);
+}
+
+inline __m256i Gt(__m256i a, __m256i b) {
+  return _mm256_cmpgt_epi32(a, b);
+}
+
+inline __m256i Eq(__m256i a, __m256i b) {
+  return _mm256_cmpeq_epi32(a, b);
+}
+
+// Returns |if_true| in the lanes selected by |mask| and |if_false| elsewhere.
+inline __m256i Select(__m256i mask, __m256i if_true, __m256i if_false) {
+  return _mm256_blendv_epi8(if_false, if_true, mask);
+}
+
+inline bool Any(__m256i mask) {
+  return !_mm256_testz_si256(mask, mask);
+}
+
+// Truncates to 16 bits and sign extends, like an assignment to an int16_t.
+inline __m256i Wrap16(__m256i v) {
+  return _mm256_srai_epi32(_mm256_slli_epi32(v, 16), 16);
+}
+
+// Returns the number of leading zeros of each positive lane of |x|.
+inline __m256i CountLeadingZerosPositive(__m256i x) {
+  // Clearing the bit below the leading one keeps the conversion to float from
+  // rounding up to the next power of two.
+  const __m256i y = _mm256_andnot_si256(_mm256_srli_epi32(x, 1), x);
+  const __m256i exponent =
+      _mm256_srli_epi32(_mm256_castps_si256(_mm256_cvtepi32_ps(y)), 23);
+  return Sub(Set(127 + 31), exponent);
+}
+
+// WebRtcSpl_NormW32() for lanes that are not negative.
+inline __m256i NormW32Positive(__m256i x) {
+  return Select(Eq(x, _mm256_setzero_si256()), _mm256_setzero_si256(),
+                Sub(CountLeadingZerosPositive(x), Set(1)));
+}
+
+// WebRtcSpl_DivW32W16() for denominators in the int16_t range. Since the
+// quotient of two such integers is at least 2^-15 away from any integer it
+// is not equal to, the truncated double division is exact.
+inline __m256i DivW32W16(__m256i num, __m256i den) {
+  const __m256d q_lo =
+      _mm256_div_pd(_mm256_cvtepi32_pd(_mm256_castsi256_si128(num)),
+                    _mm256_cvtepi32_pd(_mm256_castsi256_si128(den)));
+  const __m256d q_hi =
+      _mm256_div_pd(_mm256_cvtepi32_pd(_mm256_extracti128_si256(num, 1)),
+                    _mm256_cvtepi32_pd(_mm256_extracti128_si256(den, 1)));
+  const __m256i q = _mm256_inserti128_si256(
+      _mm256_castsi128_si256(_mm256_cvttpd_epi32(q_lo)),
+      _mm256_cvttpd_epi32(q_hi), 1);
+  return Select(Eq(den, _mm256_setzero_si256()), Set(0x7FFFFFFF), q);
+}
+
+// Computes the int16_t result of DivW32W16(num, den) if |num| is positive and
+// of -DivW32W16(-num, den) otherwise, as done in GmmProbability().
+inline __m256i SignedDivW32W16(__m256i num, __m256i den) {
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i positive = Gt(num, zero);
+  const __m256i q = Wrap16(DivW32W16(Select(positive, num, Sub(zero, num)),
+                                     den));
+  return Select(positive, q, Wrap16(Sub(zero, q)));
+}
+
+// Loads samples [offset, offset + 8) of each of the frames, such that
+// |samples[i]| holds sample |offset + i| of each lane.
+void LoadSamples(const int16_t* const frames[kVadLanes],
+                 size_t offset,
+                 __m256i samples[8]) {
+  __m128i r[8];
+  for (int k = 0; k < kVadLanes; ++k) {
+    r[k] =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(frames[k] + offset));
+  }
+  const __m128i a0 = _mm_unpacklo_epi16(r[0], r[1]);
+  const __m128i a1 = _mm_unpackhi_epi16(r[0], r[1]);
+  const __m128i a2 = _mm_unpacklo_epi16(r[2], r[3]);
+  const __m128i a3 = _mm_unpackhi_epi16(r[2], r[3]);
+  const __m128i a4 = _mm_unpacklo_epi16(r[4], r[5]);
+  const __m128i a5 = _mm_unpackhi_epi16(r[4], r[5]);
+  const __m128i a6 = _mm_unpacklo_epi16(r[6], r[7]);
+  const __m128i a7 = _mm_unpackhi_epi16(r[6], r[7]);
+  const __m128i b0 = _mm_unpacklo_epi32(a0, a2);
+  const __m128i b1 = _mm_unpackhi_epi32(a0, a2);
+  const __m128i b2 = _mm_unpacklo_epi32(a1, a3);
+  const __m128i b3 = _mm_unpackhi_epi32(a1, a3);
+  const __m128i b4 = _mm_unpacklo_epi32(a4, a6);
+  const __m128i b5 = _mm_unpackhi_epi32(a4, a6);
+  const __m128i b6 = _mm_unpacklo_epi32(a5, a7);
+  const __m128i b7 = _mm_unpackhi_epi32(a5, a7);
+  samples[0] = _mm256_cvtepi16_epi32(_mm_unpacklo_epi64(b0, b4));
+  samples[1] = _mm256_cvtepi16_epi32(_mm_unpackhi_epi64(b0, b4));
+  samples[2] = _mm256_cvtepi16_epi32(_mm_unpacklo_epi64(b1, b5));
+  samples[3] = _mm256_cvtepi16_epi32(_mm_unpackhi_epi64(b1, b5));
+  samples[4] = _mm256_cvtepi16_epi32(_mm_unpacklo_epi64(b2, b6));
+  samples[5] = _mm256_cvtepi16_epi32(_mm_unpackhi_epi64(b2, b6));
+  samples[6] = _mm256_cvtepi16_epi32(_mm_unpacklo_epi64(b3, b7));
+  samples[7] = _mm256_cvtepi16_epi32(_mm_unpackhi_epi64(b3, b7));
+}
+
+// WebRtcVad_Downsampling().
+void Downsampling(const __m256i* signal_in,
+                  __m256i* signal_out,
+                  int32_t (*filter_state)[kVadLanes],
+                  size_t in_length) {
+  const __m256i upper_coef = Set(kAllPassCoefsQ13[0]);
+  const __m256i lower_coef = Set(kAllPassCoefsQ13[1]);
+  __m256i state_1 = Load(filter_state[0]);
+  __m256i state_2 = Load(filter_state[1]);
+  for (size_t n = 0; n < in_length / 2; ++n) {
+    const __m256i x_1 = signal_in[2 * n];
+    const __m256i x_2 = signal_in[2 * n + 1];
+    const __m256i tmp_1 =
+        Wrap16(Add(_mm256_srai_epi32(state_1, 1),
+                   _mm256_srai_epi32(Mul(upper_coef, x_1), 14)));
+    state_1 = Sub(x_1, _mm256_srai_epi32(Mul(upper_coef, tmp_1), 12));
+    const __m256i tmp_2 =
+        Wrap16(Add(_mm256_srai_epi32(state_2, 1),
+                   _mm256_srai_epi32(Mul(lower_coef, x_2), 14)));
+    state_2 = Sub(x_2, _mm256_srai_epi32(Mul(lower_coef, tmp_2), 12));
+    signal_out[n] = Wrap16(Add(tmp_1, tmp_2));
+  }
+  Store(state_1, filter_state[0]);
+  Store(state_2, filter_state[1]);
+}
+
+// HighPassFilter() of vad_filterbank.c.
+void HighPassFilter(const __m256i* data_in,
+                    size_t data_length,
+                    int32_t (*filter_state)[kVadLanes],
+                    __m256i* data_out) {
+  __m256i state[4];
+  for (int i = 0; i < 4; ++i) {
+    state[i] = Load(filter_state[i]);
+  }
+  for (size_t i = 0; i < data_length; ++i) {
+    __m256i tmp32 = Mul(Set(kHpZeroCoefs[0]), data_in[i]);
+    tmp32 = Add(tmp32, Mul(Set(kHpZeroCoefs[1]), state[0]));
+    tmp32 = Add(tmp32, Mul(Set(kHpZeroCoefs[2]), state[1]));
+    state[1] = state[0];
+    state[0] = data_in[i];
+    tmp32 = Sub(tmp32, Mul(Set(kHpPoleCoefs[1]), state[2]));
+    tmp32 = Sub(tmp32, Mul(Set(kHpPoleCoefs[2]), state[3]));
+    state[3] = state[2];
+    state[2] = Wrap16(_mm256_srai_epi32(tmp32, 14));
+    data_out[i] = state[2];
+  }
+  for (int i = 0; i < 4; ++i) {
+    Store(state[i], filter_state[i]);
+  }
+}
+
+// AllPassFilter() of vad_filterbank.c.
+void AllPassFilter(const __m256i* data_in,
+                   size_t data_length,
+                   int16_t filter_coefficient,
+                   int32_t* filter_state,
+                   __m256i* data_out) {
+  const __m256i coefficient = Set(filter_coefficient);
+  __m256i state32 = _mm256_slli_epi32(Load(filter_state), 16);
+  for (size_t i = 0; i < data_length; ++i) {
+    const __m256i x = data_in[2 * i];
+    const __m256i tmp16 = Wrap16(
+        _mm256_srai_epi32(Add(state32, Mul(coefficient, x)), 16));
+    data_out[i] = tmp16;
+    state32 = _mm256_slli_epi32(
+        Sub(_mm256_slli_epi32(x, 14), Mul(coefficient, tmp16)), 1);
+  }
+  Store(Wrap16(_mm256_srai_epi32(state32, 16)), filter_state);
+}
+
+// SplitFilter() of vad_filterbank.c.
+void SplitFilter(const __m256i* data_in,
+                 size_t data_length,
+                 int32_t* upper_state,
+                 int32_t* lower_state,
+                 __m256i* hp_data_out,
+                 __m256i* lp_data_out) {
+  const size_t half_length = data_length >> 1;
+  AllPassFilter(&data_in[0], half_length, kAllPassCoefsQ15[0], upper_state,
+                hp_data_out);
+  AllPassFilter(&data_in[1], half_length, kAllPassCoefsQ15[1], lower_state,
+                lp_data_out);
+  for (size_t i = 0; i < half_length; ++i) {
+    const __m256i tmp_out = hp_data_out[i];
+    hp_data_out[i] = Wrap16(Sub(tmp_out, lp_data_out[i]));
+    lp_data_out[i] = Wrap16(Add(lp_data_out[i], tmp_out));
+  }
+}
+
+// LogOfEnergy() of vad_filterbank.c, including WebRtcSpl_Energy().
+void LogOfEnergy(const __m256i* data_in,
+                 size_t data_length,
+                 int16_t offset,
+                 __m256i* total_energy,
+                 __m256i* log_energy) {
+  const __m256i zero = _mm256_setzero_si256();
+
+  // WebRtcSpl_GetScalingSquare().
+  __m256i smax = Set(-1);
+  for (size_t i = 0; i < data_length; ++i) {
+    smax = _mm256_max_epi32(smax, Wrap16(_mm256_abs_epi32(data_in[i])));
+  }
+  const __m256i nbits = Set(WebRtcSpl_GetSizeInBits(
+      static_cast<uint32_t>(data_length)));
+  const __m256i t = NormW32Positive(Mul(smax, smax));
+  __m256i scaling = Select(Gt(t, nbits), zero, Sub(nbits, t));
+  scaling = Select(Eq(smax, zero), zero, scaling);
+
+  __m256i energy = zero;
+  for (size_t i = 0; i < data_length; ++i) {
+    energy = Add(energy,
+                 _mm256_srav_epi32(Mul(data_in[i], data_in[i]), scaling));
+  }
+  const __m256i nonzero = _mm256_xor_si256(Eq(energy, zero), Set(-1));
+
+  // WebRtcSpl_NormU32() of the energy, which is zero if the top bit is set.
+  const __m256i normalizing_rshifts = Sub(
+      Set(17),
+      Select(Gt(zero, energy), zero, CountLeadingZerosPositive(energy)));
+  const __m256i tot_rshifts = Add(scaling, normalizing_rshifts);
+  energy = Select(Gt(zero, normalizing_rshifts),
+                  _mm256_sllv_epi32(energy, Sub(zero, normalizing_rshifts)),
+                  _mm256_srlv_epi32(energy, normalizing_rshifts));
+
+  const __m256i log2_energy =
+      Add(Set(kLogEnergyIntPart),
+          _mm256_srli_epi32(_mm256_and_si256(energy, Set(0x00003FFF)), 4));
+  __m256i log = Wrap16(
+      Add(_mm256_srai_epi32(Mul(Set(kLogConst), log2_energy), 19),
+          _mm256_srai_epi32(Mul(tot_rshifts, Set(kLogConst)), 9)));
+  log = _mm256_max_epi32(log, zero);
+  log = Wrap16(Add(log, Set(offset)));
+  *log_energy = Select(nonzero, log, Set(offset));
+
+  const __m256i update = _mm256_and_si256(
+      nonzero, Gt(Set(kMinEnergy + 1), *total_energy));
+  const __m256i increment = Select(
+      Gt(zero, tot_rshifts),
+      Wrap16(_mm256_srlv_epi32(energy, Sub(zero, tot_rshifts))),
+      Set(kMinEnergy + 1));
+  *total_energy = Select(update, Wrap16(Add(*total_energy, increment)),
+                         *total_energy);
+}
+
+// WebRtcVad_CalculateFeatures().
+__m256i CalculateFeatures(VadLanes* lanes,
+                          const __m256i* data_in,
+                          size_t data_length,
+                          __m256i features[kNumChannels]) {
+  __m256i total_energy = _mm256_setzero_si256();
+  __m256i hp_120[120], lp_120[120];
+  __m256i hp_60[60], lp_60[60];
+  const size_t half_data_length = data_length >> 1;
+  size_t length = half_data_length;
+
+  RTC_DCHECK_LE(data_length, 240);
+
+  // Split at 2000 Hz and downsample.
+  SplitFilter(data_in, data_length, lanes->upper_state[0],
+              lanes->lower_state[0], hp_120, lp_120);
+
+  // For the upper band (2000 Hz - 4000 Hz) split at 3000 Hz and downsample.
+  SplitFilter(hp_120, length, lanes->upper_state[1], lanes->lower_state[1],
+              hp_60, lp_60);
+
+  // Energy in 3000 Hz - 4000 Hz and in 2000 Hz - 3000 Hz.
+  length >>= 1;
+  LogOfEnergy(hp_60, length, kOffsetVector[5], &total_energy, &features[5]);
+  LogOfEnergy(lp_60, length, kOffsetVector[4], &total_energy, &features[4]);
+
+  // For the lower band (0 Hz - 2000 Hz) split at 1000 Hz and downsample.
+  length = half_data_length;
+  SplitFilter(lp_120, length, lanes->upper_state[2], lanes->lower_state[2],
+              hp_60, lp_60);
+
+  // Energy in 1000 Hz - 2000 Hz.
+  length >>= 1;
+  LogOfEnergy(hp_60, length, kOffsetVector[3], &total_energy, &features[3]);
+
+  // For the lower band (0 Hz - 1000 Hz) split at 500 Hz and downsample.
+  SplitFilter(lp_60, length, lanes->upper_state[3], lanes->lower_state[3],
+              hp_120, lp_120);
+
+  // Energy in 500 Hz - 1000 Hz.
+  length >>= 1;
+  LogOfEnergy(hp_120, length, kOffsetVector[2], &total_energy, &features[2]);
+
+  // For the lower band (0 Hz - 500 Hz) split at 250 Hz and downsample.
+  SplitFilter(lp_120, length, lanes->upper_state[4], lanes->lower_state[4],
+              hp_60, lp_60);
+
+  // Energy in 250 Hz - 500 Hz.
+  length >>= 1;
+  LogOfEnergy(hp_60, length, kOffsetVector[1], &total_energy, &features[1]);
+
+  // Remove 0 Hz - 80 Hz, by high pass filtering the lower band, and compute
+  // the energy in 80 Hz - 250 Hz.
+  HighPassFilter(lp_60, length, lanes->hp_filter_state, hp_120);
+  LogOfEnergy(hp_120, length, kOffsetVector[0], &total_energy, &features[0]);
+
+  return total_energy;
+}
+
+// WebRtcVad_GaussianProbability().
+__m256i GaussianProbability(__m256i input,
+                            __m256i mean,
+                            __m256i std,
+                            __m256i* delta) {
+  const __m256i inv_std = Wrap16(
+      DivW32W16(Add(Set(131072), _mm256_srai_epi32(std, 1)), std));
+  __m256i tmp16 = _mm256_srai_epi32(inv_std, 2);
+  const __m256i inv_std2 = Wrap16(_mm256_srai_epi32(Mul(tmp16, tmp16), 2));
+  tmp16 = Wrap16(Sub(Wrap16(_mm256_slli_epi32(input, 3)), mean));
+  *delta = Wrap16(_mm256_srai_epi32(Mul(inv_std2, tmp16), 10));
+  const __m256i tmp32 = _mm256_srai_epi32(Mul(*delta, tmp16), 9);
+
+  tmp16 = Wrap16(_mm256_srai_epi32(Mul(Set(kLog2Exp), tmp32), 12));
+  tmp16 = Wrap16(Sub(_mm256_setzero_si256(), tmp16));
+  __m256i exp_value =
+      _mm256_or_si256(Set(0x0400), _mm256_and_si256(tmp16, Set(0x03FF)));
+  tmp16 = _mm256_xor_si256(tmp16, Set(-1));
+  tmp16 = Add(_mm256_srai_epi32(tmp16, 10), Set(1));
+  exp_value = _mm256_srav_epi32(exp_value, tmp16);
+  exp_value = Select(Gt(Set(kCompVar), tmp32), exp_value,
+                     _mm256_setzero_si256());
+
+  return Mul(inv_std, exp_value);
+}
+
+// Returns the sum of the two Gaussian |data| of a channel weighted by
+// |weights|.
+inline __m256i WeightedAverage(const int32_t (*data)[kVadLanes],
+                               const int16_t* weights) {
+  return Add(Mul(Load(data[0]), Set(weights[0])),
+             Mul(Load(data[kNumChannels]), Set(weights[kNumChannels])));
+}
+
+// Adds |offset| to the two Gaussian |data| of a channel in the lanes selected
+// by |mask|.
+inline void AddToMeans(__m256i mask, __m256i offset,
+                       int32_t (*data)[kVadLanes]) {
+  for (int k = 0; k < kNumGaussians; ++k) {
+    int32_t* p = data[k * kNumChannels];
+    StoreIf(mask, Wrap16(Add(Load(p), offset)), p);
+  }
+}
+
+// WebRtcVad_FindMinimum(), for the lanes selected by |active|.
+__m256i FindMinimum(VadLanes* lanes,
+                    __m256i active,
+                    __m256i feature_value,
+                    int channel) {
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i one = Set(1);
+  int32_t (*age_data)[kVadLanes] = &lanes->index_vector[channel << 4];
+  int32_t (*values_data)[kVadLanes] = &lanes->low_value_vector[channel << 4];
+  __m256i age[16], smallest_values[16];
+  for (int i = 0; i < 16; ++i) {
+    age[i] = Load(age_data[i]);
+    smallest_values[i] = Load(values_data[i]);
+  }
+
+  // Age the values and remove those that are too old, as done in the
+  // sequential loop of the C code.
+  for (int i = 0; i < 16; ++i) {
+    const __m256i too_old = Eq(age[i], Set(100));
+    const __m256i older = Add(age[i], one);
+    if (Any(too_old)) {
+      for (int j = i; j < 15; ++j) {
+        smallest_values[j] =
+            Select(too_old, smallest_values[j + 1], smallest_values[j]);
+        age[j] = Select(too_old, age[j + 1], age[j]);
+      }
+      age[15] = Select(too_old, Set(101), age[15]);
+      smallest_values[15] = Select(too_old, Set(10000), smallest_values[15]);
+    }
+    age[i] = Select(too_old, age[i], older);
+  }
+
+  // |smallest_values| is sorted, hence the insertion position found by the
+  // binary search of the C code is the number of values not larger than
+  // |feature_value|. No value is inserted if the position is 16.
+  __m256i position = Set(16);
+  for (int i = 0; i < 16; ++i) {
+    position = Add(position, Gt(smallest_values[i], feature_value));
+  }
+  for (int i = 15; i >= 0; --i) {
+    const __m256i index = Set(i);
+    if (i > 0) {
+      const __m256i shift = Gt(index, position);
+      smallest_values[i] =
+          Select(shift, smallest_values[i - 1], smallest_values[i]);
+      age[i] = Select(shift, age[i - 1], age[i]);
+    }
+    const __m256i insert = Eq(index, position);
+    smallest_values[i] = Select(insert, feature_value, smallest_values[i]);
+    age[i] = Select(insert, one, age[i]);
+  }
+  for (int i = 0; i < 16; ++i) {
+    StoreIf(active, age[i], age_data[i]);
+    StoreIf(active, smallest_values[i], values_data[i]);
+  }
+
+  // Get the median and smooth it.
+  const __m256i frame_counter = Load(lanes->frame_counter);
+  const __m256i counted = Gt(frame_counter, zero);
+  const __m256i current_median =
+      Select(Gt(frame_counter, Set(2)), smallest_values[2],
+             Select(counted, smallest_values[0], Set(1600)));
+  const __m256i mean_value = Load(lanes->mean_value[channel]);
+  const __m256i alpha =
+      Select(counted,
+             Select(Gt(mean_value, current_median), Set(6553), Set(32439)),
+             zero);
+  __m256i tmp32 = Mul(Add(alpha, one), mean_value);
+  tmp32 = Add(tmp32, Mul(Sub(Set(WEBRTC_SPL_WORD16_MAX), alpha),
+                         current_median));
+  tmp32 = Add(tmp32, Set(16384));
+  const __m256i median = Wrap16(_mm256_srai_epi32(tmp32, 15));
+  StoreIf(active, median, lanes->mean_value[channel]);
+  return median;
+}
+
+// GmmProbability() of vad_core.c.
+__m256i GmmProbability(const VadInstT& config,
+                       VadLanes* lanes,
+                       const __m256i features[kNumChannels],
+                       __m256i total_power,
+                       size_t frame_length) {
+  const __m256i zero = _mm256_setzero_si256();
+  const int index = frame_length == 80 ? 0 : (frame_length == 160 ? 1 : 2);
+  const __m256i overhead1 = Set(config.over_hang_max_1[index]);
+  const __m256i overhead2 = Set(config.over_hang_max_2[index]);
+  const __m256i individual_test = Set(config.individual[index]);
+  const __m256i total_test = Set(config.total[index]);
+
+  const __m256i active = Gt(total_power, Set(kMinEnergy));
+  __m256i vadflag = zero;
+  if (Any(active)) {
+    __m256i delta_n[kTableSize], delta_s[kTableSize];
+    __m256i ngprvec[kTableSize], sgprvec[kTableSize];
+    __m256i sum_log_likelihood_ratios = zero;
+    for (int channel = 0; channel < kNumChannels; ++channel) {
+      __m256i h0_test = zero;
+      __m256i h1_test = zero;
+      __m256i noise_probability_0 = zero;
+      __m256i speech_probability_0 = zero;
+      for (int k = 0; k < kNumGaussians; ++k) {
+        const int gaussian = channel + k * kNumChannels;
+        __m256i probability = Mul(
+            Set(kNoiseDataWeights[gaussian]),
+            GaussianProbability(features[channel],
+                                Load(lanes->noise_means[gaussian]),
+                                Load(lanes->noise_stds[gaussian]),
+                                &delta_n[gaussian]));
+        h0_test = Add(h0_test, probability);
+        if (k == 0) {
+          noise_probability_0 = probability;
+        }
+        probability = Mul(
+            Set(kSpeechDataWeights[gaussian]),
+            GaussianProbability(features[channel],
+                                Load(lanes->speech_means[gaussian]),
+                                Load(lanes->speech_stds[gaussian]),
+                                &delta_s[gaussian]));
+        h1_test = Add(h1_test, probability);
+        if (k == 0) {
+          speech_probability_0 = probability;
+        }
+      }
+
+      const __m256i shifts_h0 =
+          Select(Eq(h0_test, zero), Set(31), NormW32Positive(h0_test));
+      const __m256i shifts_h1 =
+          Select(Eq(h1_test, zero), Set(31), NormW32Positive(h1_test));
+      const __m256i log_likelihood_ratio = Sub(shifts_h0, shifts_h1);
+      sum_log_likelihood_ratios =
+          Add(sum_log_likelihood_ratios,
+              Mul(log_likelihood_ratio, Set(kSpectrumWeight[channel])));
+      vadflag = _mm256_or_si256(
+          vadflag,
+          Gt(_mm256_slli_epi32(log_likelihood_ratio, 2), individual_test));
+
+      const __m256i h0 = Wrap16(_mm256_srai_epi32(h0_test, 12));
+      const __m256i noise_likely = Gt(h0, zero);
+      const __m256i ngprvec_0 = Wrap16(DivW32W16(
+          _mm256_slli_epi32(
+              _mm256_and_si256(noise_probability_0, Set(0xFFFFF000)), 2),
+          h0));
+      ngprvec[channel] = Select(noise_likely, ngprvec_0, Set(16384));
+      ngprvec[channel + kNumChannels] =
+          Select(noise_likely, Wrap16(Sub(Set(16384), ngprvec_0)), zero);
+
+      const __m256i h1 = Wrap16(_mm256_srai_epi32(h1_test, 12));
+      const __m256i speech_likely = Gt(h1, zero);
+      const __m256i sgprvec_0 = Wrap16(DivW32W16(
+          _mm256_slli_epi32(
+              _mm256_and_si256(speech_probability_0, Set(0xFFFFF000)), 2),
+          h1));
+      sgprvec[channel] = Select(speech_likely, sgprvec_0, zero);
+      sgprvec[channel + kNumChannels] =
+          Select(speech_likely, Wrap16(Sub(Set(16384), sgprvec_0)), zero);
+    }
+
+    // Make a global VAD decision.
+    vadflag = _mm256_or_si256(
+        vadflag, Gt(sum_log_likelihood_ratios, Sub(total_test, Set(1))));
+    vadflag = _mm256_and_si256(vadflag, active);
+    const __m256i noise = _mm256_andnot_si256(vadflag, active);
+
+    // Update the model parameters.
+    int16_t maxspe = 12800;
+    for (int channel = 0; channel < kNumChannels; ++channel) {
+      const __m256i feature = features[channel];
+      const __m256i feature_minimum =
+          FindMinimum(lanes, active, feature, channel);
+      const __m256i noise_global_mean_q8 = Wrap16(_mm256_srai_epi32(
+          WeightedAverage(&lanes->noise_means[channel],
+                          &kNoiseDataWeights[channel]),
+          6));
+
+      for (int k = 0; k < kNumGaussians; ++k) {
+        const int gaussian = channel + k * kNumChannels;
+        const __m256i nmk = Load(lanes->noise_means[gaussian]);
+        const __m256i smk = Load(lanes->speech_means[gaussian]);
+        __m256i nsk = Load(lanes->noise_stds[gaussian]);
+        __m256i ssk = Load(lanes->speech_stds[gaussian]);
+
+        // Update the noise mean vector if the frame consists of noise only.
+        __m256i delt = Wrap16(_mm256_srai_epi32(
+            Mul(ngprvec[gaussian], delta_n[gaussian]), 11));
+        const __m256i nmk2 = Select(
+            vadflag, nmk,
+            Wrap16(Add(nmk, Wrap16(_mm256_srai_epi32(
+                                Mul(delt, Set(kNoiseUpdateConst)), 22)))));
+
+        // Long term correction of the noise mean.
+        const __m256i ndelt = Wrap16(
+            Sub(_mm256_slli_epi32(feature_minimum, 4), noise_global_mean_q8));
+        __m256i nmk3 = Wrap16(Add(
+            nmk2,
+            Wrap16(_mm256_srai_epi32(Mul(ndelt, Set(kBackEta)), 9))));
+
+        // Control that the noise mean does not drift to much.
+        nmk3 = _mm256_max_epi32(nmk3, Set((k + 5) << 7));
+        nmk3 = _mm256_min_epi32(nmk3, Set((72 + k - channel) << 7));
+        StoreIf(active, nmk3, lanes->noise_means[gaussian]);
+
+        // Update the speech mean vector.
+        delt = Wrap16(_mm256_srai_epi32(
+            Mul(sgprvec[gaussian], delta_s[gaussian]), 11));
+        __m256i tmp_s16 = Wrap16(
+            _mm256_srai_epi32(Mul(delt, Set(kSpeechUpdateConst)), 21));
+        __m256i smk2 = Wrap16(
+            Add(smk, _mm256_srai_epi32(Add(tmp_s16, Set(1)), 1)));
+        smk2 = _mm256_max_epi32(smk2, Set(kMinimumMean[k]));
+        smk2 = _mm256_min_epi32(smk2, Set(maxspe + 640));
+        StoreIf(vadflag, smk2, lanes->speech_means[gaussian]);
+
+        // Update the speech standard deviation.
+        tmp_s16 = _mm256_srai_epi32(Add(smk, Set(4)), 3);
+        tmp_s16 = Wrap16(Sub(feature, tmp_s16));
+        __m256i tmp1_s32 =
+            _mm256_srai_epi32(Mul(delta_s[gaussian], tmp_s16), 3);
+        __m256i tmp2_s32 = Sub(tmp1_s32, Set(4096));
+        tmp_s16 = _mm256_srai_epi32(sgprvec[gaussian], 2);
+        tmp1_s32 = Mul(tmp_s16, tmp2_s32);
+        tmp2_s32 = _mm256_srai_epi32(tmp1_s32, 4);
+        tmp_s16 = SignedDivW32W16(tmp2_s32, Wrap16(Mul(ssk, Set(10))));
+        tmp_s16 = Wrap16(Add(tmp_s16, Set(128)));
+        ssk = Wrap16(Add(ssk, _mm256_srai_epi32(tmp_s16, 8)));
+        ssk = _mm256_max_epi32(ssk, Set(kMinStd));
+        StoreIf(vadflag, ssk, lanes->speech_stds[gaussian]);
+
+        // Update the noise standard deviation.
+        tmp_s16 = Wrap16(Sub(feature, _mm256_srai_epi32(nmk, 3)));
+        tmp1_s32 = _mm256_srai_epi32(Mul(delta_n[gaussian], tmp_s16), 3);
+        tmp1_s32 = Sub(tmp1_s32, Set(4096));
+        tmp_s16 = Wrap16(_mm256_srai_epi32(Add(ngprvec[gaussian], Set(2)), 2));
+        tmp2_s32 = Mul(tmp_s16, tmp1_s32);
+        tmp1_s32 = _mm256_srai_epi32(tmp2_s32, 14);
+        tmp_s16 = SignedDivW32W16(tmp1_s32, nsk);
+        tmp_s16 = Wrap16(Add(tmp_s16, Set(32)));
+        nsk = Wrap16(Add(nsk, _mm256_srai_epi32(tmp_s16, 6)));
+        nsk = _mm256_max_epi32(nsk, Set(kMinStd));
+        StoreIf(noise, nsk, lanes->noise_stds[gaussian]);
+      }
+
+      // Separate models if they are too close.
+      __m256i noise_global_mean = WeightedAverage(
+          &lanes->noise_means[channel], &kNoiseDataWeights[channel]);
+      __m256i speech_global_mean = WeightedAverage(
+          &lanes->speech_means[channel], &kSpeechDataWeights[channel]);
+      const __m256i diff = Wrap16(
+          Sub(Wrap16(_mm256_srai_epi32(speech_global_mean, 9)),
+              Wrap16(_mm256_srai_epi32(noise_global_mean, 9))));
+      const __m256i too_close =
+          _mm256_and_si256(active, Gt(Set(kMinimumDifference[channel]), diff));
+      if (Any(too_close)) {
+        const __m256i tmp_s16 =
+            Wrap16(Sub(Set(kMinimumDifference[channel]), diff));
+        const __m256i tmp1_s16 =
+            Wrap16(_mm256_srai_epi32(Mul(Set(13), tmp_s16), 2));
+        const __m256i tmp2_s16 =
+            Wrap16(_mm256_srai_epi32(Mul(Set(3), tmp_s16), 2));
+        AddToMeans(too_close, tmp1_s16, &lanes->speech_means[channel]);
+        speech_global_mean = WeightedAverage(&lanes->speech_means[channel],
+                                             &kSpeechDataWeights[channel]);
+        AddToMeans(too_close, Wrap16(Sub(zero, tmp2_s16)),
+                   &lanes->noise_means[channel]);
+        noise_global_mean = WeightedAverage(&lanes->noise_means[channel],
+                                            &kNoiseDataWeights[channel]);
+      }
+
+      // Control that the speech & noise means do not drift to much.
+      maxspe = kMaximumSpeech[channel];
+      __m256i tmp2_s16 = Wrap16(_mm256_srai_epi32(speech_global_mean, 7));
+      __m256i too_high =
+          _mm256_and_si256(active, Gt(tmp2_s16, Set(maxspe)));
+      AddToMeans(too_high, Sub(Set(maxspe), tmp2_s16),
+                 &lanes->speech_means[channel]);
+
+      tmp2_s16 = Wrap16(_mm256_srai_epi32(noise_global_mean, 7));
+      too_high = _mm256_and_si256(
+          active, Gt(tmp2_s16, Set(kMaximumNoise[channel])));
+      AddToMeans(too_high, Sub(Set(kMaximumNoise[channel]), tmp2_s16),
+                 &lanes->noise_means[channel]);
+    }
+    const __m256i frame_counter = Load(lanes->frame_counter);
+    StoreIf(active, Add(frame_counter, Set(1)), lanes->frame_counter);
+  }
+
+  // Smooth with respect to transition hysteresis.
+  const __m256i over_hang = Load(lanes->over_hang);
+  const __m256i num_of_speech = Add(Load(lanes->num_of_speech), Set(1));
+  const __m256i hang = Gt(over_hang, zero);
+  const __m256i max_speech = Gt(num_of_speech, Set(kMaxSpeechFrames));
+  Store(Select(vadflag,
+               Select(max_speech, overhead2, overhead1),
+               Select(hang, Sub(over_hang, Set(1)), over_hang)),
+        lanes->over_hang);
+  Store(Select(vadflag, _mm256_min_epi32(num_of_speech, Set(kMaxSpeechFrames)),
+               zero),
+        lanes->num_of_speech);
+  return Select(vadflag, Set(1),
+                Select(hang, Add(over_hang, Set(2)), zero));
+}
+
+}  // namespace
+
+void CalcVadLanesAvx2(const VadInstT& config,
+                      const int16_t* const frames[kVadLanes],
+                      int sample_rate_hz,
+                      size_t frame_length,
+                      VadLanes* lanes,
+                      int vad[kVadLanes]) {
+  RTC_DCHECK(sample_rate_hz == 8000 || sample_rate_hz == 16000 ||
+             sample_rate_hz == 32000);
+  RTC_DCHECK_LE(frame_length, kMaxFrameLength);
+  RTC_DCHECK_EQ(0, frame_length % 8);
+  __m256i speech_wb[kMaxFrameLength16kHz];
+  __m256i speech_nb[kMaxFrameLength8kHz];
+  __m256i samples[8];
+
+  // Downsample to 8 kHz, as done by WebRtcVad_CalcVad32khz() and
+  // WebRtcVad_CalcVad16khz().
+  __m256i* const speech_8khz = sample_rate_hz == 32000 ? speech_wb : speech_nb;
+  for (size_t i = 0; i < frame_length; i += 8) {
+    if (sample_rate_hz == 8000) {
+      LoadSamples(frames, i, &speech_nb[i]);
+      continue;
+    }
+    LoadSamples(frames, i, samples);
+    Downsampling(samples, &speech_8khz[i / 2],
+                 sample_rate_hz == 32000
+                     ? &lanes->downsampling_filter_states[2]
+                     : &lanes->downsampling_filter_states[0],
+                 8);
+  }
+  size_t length = frame_length;
+  if (sample_rate_hz == 32000) {
+    length /= 2;
+    Downsampling(speech_wb, speech_nb, &lanes->downsampling_filter_states[0],
+                 length);
+  }
+  if (sample_rate_hz != 8000) {
+    length /= 2;
+  }
+
+  __m256i features[kNumChannels];
+  const __m256i total_power =
+      CalculateFeatures(lanes, speech_nb, length, features);
+  _mm256_storeu_si256(
+      reinterpret_cast<__m256i*>(vad),
+      GmmProbability(config, lanes, features, total_power, length));
+}
+
+#endif  // defined(WEBRTC_ARCH_X86_FAMILY)
+
+}  // namespace webrtc
@@ -71,6 +71,11 @@ const float kSqrtHanning128[kFftLength] = {
     0.19509032201613f, 0.17096188876030f, 0.14673047445536f, 0.12241067519922f,
     0.09801714032956f, 0.07356456359967f, 0.04906767432742f, 0.02454122852291f};
 
+// Smallest number of transforms for which a batched transform is faster than
+// separate ones. As the batched transforms always fill all the SIMD lanes,
+// smaller groups are computed one at a time.
+constexpr size_t kMinBatchSize = 3;
+
 bool IsSse2Available() {
 #if defined(WEBRTC_ARCH_X86_FAMILY)
   return GetCPUInfo(kSSE2) != 0;
@@ -79,9 +84,17 @@ bool IsSse2Available() {
 #endif
 }
 
+bool IsAvx2Available() {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  return GetCPUInfo(kAVX2) != 0;
+#else
+  return false;
+#endif
+}
+
 }  // namespace
 
-Aec3Fft::Aec3Fft() : ooura_fft_(IsSse2Available()) {}
+Aec3Fft::Aec3Fft() : ooura_fft_(IsSse2Available(), IsAvx2Available()) {}
 
 // TODO(peah): Change x to be std::array once the rest of the code allows this.
 void Aec3Fft::ZeroPaddedFft(rtc::ArrayView<const float> x,
@@ -115,30 +128,84 @@ void Aec3Fft::PaddedFft(rtc::ArrayView<const float> x,
                         Window window,
                         FftData* X) const {
   RTC_DCHECK(X);
+  std::array<float, kFftLength> fft;
+  PadAndWindow(x, x_old, window, &fft);
+  Fft(&fft, X);
+}
+
+void Aec3Fft::PadAndWindow(rtc::ArrayView<const float> x,
+                           rtc::ArrayView<const float> x_old,
+                           Window window,
+                           std::array<float, kFftLength>* fft) const {
+  RTC_DCHECK(fft);
   RTC_DCHECK_EQ(kFftLengthBy2, x.size());
   RTC_DCHECK_EQ(kFftLengthBy2, x_old.size());
-  std::array<float, kFftLength> fft;
 
   switch (window) {
     case Window::kRectangular:
-      std::copy(x_old.begin(), x_old.end(), fft.begin());
-      std::copy(x.begin(), x.end(), fft.begin() + x_old.size());
+      std::copy(x_old.begin(), x_old.end(), fft->begin());
+      std::copy(x.begin(), x.end(), fft->begin() + x_old.size());
       break;
     case Window::kHanning:
       RTC_NOTREACHED();
       break;
     case Window::kSqrtHanning:
       std::transform(x_old.begin(), x_old.end(), std::begin(kSqrtHanning128),
-                     fft.begin(), std::multiplies<float>());
+                     fft->begin(), std::multiplies<float>());
       std::transform(x.begin(), x.end(),
                      std::begin(kSqrtHanning128) + x_old.size(),
-                     fft.begin() + x_old.size(), std::multiplies<float>());
+                     fft->begin() + x_old.size(), std::multiplies<float>());
       break;
     default:
       RTC_NOTREACHED();
   }
+}
 
-  Fft(&fft, X);
+void Aec3Fft::FftBatch(rtc::ArrayView<std::array<float, kFftLength>* const> x,
+                       rtc::ArrayView<FftData* const> X) const {
+  RTC_DCHECK_EQ(x.size(), X.size());
+  size_t k = 0;
+  while (k + kMinBatchSize <= x.size()) {
+    const size_t batch_size =
+        std::min(x.size() - k, size_t{OouraFft::kMaxBatchSize});
+    float* data[OouraFft::kMaxBatchSize];
+    for (size_t m = 0; m < batch_size; ++m) {
+      RTC_DCHECK(x[k + m]);
+      data[m] = x[k + m]->data();
+    }
+    ooura_fft_.FftBatch(data, batch_size);
+    for (size_t m = 0; m < batch_size; ++m) {
+      RTC_DCHECK(X[k + m]);
+      X[k + m]->CopyFromPackedArray(*x[k + m]);
+    }
+    k += batch_size;
+  }
+  for (; k < x.size(); ++k) {
+    Fft(x[k], X[k]);
+  }
+}
+
+void Aec3Fft::IfftBatch(
+    rtc::ArrayView<const FftData* const> X,
+    rtc::ArrayView<std::array<float, kFftLength>* const> x) const {
+  RTC_DCHECK_EQ(x.size(), X.size());
+  size_t k = 0;
+  while (k + kMinBatchSize <= x.size()) {
+    const size_t batch_size =
+        std::min(x.size() - k, size_t{OouraFft::kMaxBatchSize});
+    float* data[OouraFft::kMaxBatchSize];
+    for (size_t m = 0; m < batch_size; ++m) {
+      RTC_DCHECK(X[k + m]);
+      RTC_DCHECK(x[k + m]);
+      X[k + m]->CopyToPackedArray(x[k + m]);
+      data[m] = x[k + m]->data();
+    }
+    ooura_fft_.InverseFftBatch(data, batch_size);
+    k += batch_size;
+  }
+  for (; k < x.size(); ++k) {
+    Ifft(*X[k], x[k]);
+  }
 }
 
 }  // namespace webrtc
@@ -44,6 +44,18 @@ class Aec3Fft {
     ooura_fft_.InverseFft(x->data());
   }
 
+  // Computes the Ffts of x[k] into X[k] for all k. Groups of transforms are
+  // computed in lockstep, one per SIMD lane, which gives a higher throughput
+  // than calling Fft() for each of them. Note that both the inputs and outputs
+  // are modified.
+  void FftBatch(rtc::ArrayView<std::array<float, kFftLength>* const> x,
+                rtc::ArrayView<FftData* const> X) const;
+
+  // Computes the inverse Ffts of X[k] into x[k] for all k, in the same way as
+  // FftBatch().
+  void IfftBatch(rtc::ArrayView<const FftData* const> X,
+                 rtc::ArrayView<std::array<float, kFftLength>* const> x) const;
+
   // Windows the input using a Hanning window, and then adds padding of
   // kFftLengthBy2 initial zeros before computing the Fft.
   void ZeroPaddedFft(rtc::ArrayView<const float> x,
@@ -64,6 +76,13 @@ class Aec3Fft {
                  Window window,
                  FftData* X) const;
 
+  // Forms the windowed concatenation of x_old and x that PaddedFft()
+  // transforms. Used to prepare the inputs of FftBatch().
+  void PadAndWindow(rtc::ArrayView<const float> x,
+                    rtc::ArrayView<const float> x_old,
+                    Window window,
+                    std::array<float, kFftLength>* fft) const;
+
  private:
   const OouraFft ooura_fft_;
 
@@ -0,0 +1,155 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_AUDIO_PROCESSING_AEC3_BLOCK_H_
+#define MODULES_AUDIO_PROCESSING_AEC3_BLOCK_H_
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+
+#include "api/array_view.h"
+#include "modules/audio_processing/aec3/aec3_common.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/memory/aligned_malloc.h"
+
+namespace webrtc {
+
+// Contains one or more channels of 4 milliseconds of audio data, split in one
+// or more frequency bands each sampled at 16 kHz. The samples are stored in a
+// single contiguous buffer ordered by band, then channel, and each band and
+// channel starts on a cache line boundary.
+class Block {
+ public:
+  Block(size_t num_bands, size_t num_channels, float default_value = 0.f)
+      : num_bands_(num_bands), num_channels_(num_channels) {
+    RTC_DCHECK_LT(0, num_bands_);
+    Allocate(num_bands_ * num_channels_ * kBlockSize);
+    std::fill(data_.get(), data_.get() + size_, default_value);
+  }
+
+  Block(const Block& b)
+      : num_bands_(b.num_bands_), num_channels_(b.num_channels_) {
+    Allocate(b.size_);
+    std::copy(b.data_.get(), b.data_.get() + size_, data_.get());
+  }
+
+  Block& operator=(const Block& b) {
+    if (this != &b) {
+      if (size_ != b.size_) {
+        Allocate(b.size_);
+      }
+      num_bands_ = b.num_bands_;
+      num_channels_ = b.num_channels_;
+      std::copy(b.data_.get(), b.data_.get() + size_, data_.get());
+    }
+    return *this;
+  }
+
+  Block(Block&& b)
+      : num_bands_(b.num_bands_),
+        num_channels_(b.num_channels_),
+        size_(b.size_),
+        data_(std::move(b.data_)) {
+    b.num_channels_ = 0;
+    b.size_ = 0;
+  }
+
+  Block& operator=(Block&& b) {
+    Swap(b);
+    return *this;
+  }
+
+  ~Block() = default;
+
+  // Returns the number of bands.
+  size_t NumBands() const { return num_bands_; }
+
+  // Returns the number of channels.
+  size_t NumChannels() const { return num_channels_; }
+
+  // Modifies the number of channels and sets all samples to zero.
+  void SetNumChannels(size_t num_channels) {
+    num_channels_ = num_channels;
+    const size_t size = num_bands_ * num_channels_ * kBlockSize;
+    if (size != size_) {
+      Allocate(size);
+    }
+    std::fill(data_.get(), data_.get() + size_, 0.f);
+  }
+
+  // Iterators for accessing the data of one band and channel.
+  float* begin(size_t band, size_t channel) {
+    return data_.get() + GetIndex(band, channel);
+  }
+
+  const float* begin(size_t band, size_t channel) const {
+    return data_.get() + GetIndex(band, channel);
+  }
+
+  float* end(size_t band, size_t channel) {
+    return begin(band, channel) + kBlockSize;
+  }
+
+  const float* end(size_t band, size_t channel) const {
+    return begin(band, channel) + kBlockSize;
+  }
+
+  // Access to the data of one band and channel.
+  rtc::ArrayView<float, kBlockSize> View(size_t band, size_t channel) {
+    return rtc::ArrayView<float, kBlockSize>(begin(band, channel), kBlockSize);
+  }
+
+  rtc::ArrayView<const float, kBlockSize> View(size_t band,
+                                               size_t channel) const {
+    return rtc::ArrayView<const float, kBlockSize>(begin(band, channel),
+                                                   kBlockSize);
+  }
+
+  // Lets two blocks swap their audio data without copying.
+  void Swap(Block& b) {
+    std::swap(num_bands_, b.num_bands_);
+    std::swap(num_channels_, b.num_channels_);
+    std::swap(size_, b.size_);
+    data_.swap(b.data_);
+  }
+
+ private:
+  // Alignment of the data of each band and channel, in bytes.
+  static constexpr size_t kAlignment = 64;
+
+  void Allocate(size_t size) {
+    size_ = size;
+    const size_t num_bytes = std::max<size_t>(size_, 1) * sizeof(float);
+    data_.reset(AlignedMalloc<float>(num_bytes, kAlignment));
+  }
+
+  // Returns the index of the first sample of the requested band and channel.
+  size_t GetIndex(size_t band, size_t channel) const {
+    RTC_DCHECK_LT(band, num_bands_);
+    RTC_DCHECK_LT(channel, num_channels_);
+    return (band * num_channels_ + channel) * kBlockSize;
+  }
+
+  size_t num_bands_;
+  size_t num_channels_;
+  size_t size_ = 0;
+  std::unique_ptr<float[], AlignedFreeDeleter> data_;
+};
+
+inline void swap(Block& a, Block& b) {
+  a.Swap(b);
+}
+
+}  // namespace webrtc
+
+#endif  // MODULES_AUDIO_PROCESSING_AEC3_BLOCK_H_
@@ -20,10 +20,8 @@ namespace webrtc {
 BlockFramer::BlockFramer(size_t num_bands, size_t num_channels)
     : num_bands_(num_bands),
       num_channels_(num_channels),
-      buffer_(num_bands_,
-              std::vector<std::vector<float>>(
-                  num_channels,
-                  std::vector<float>(kBlockSize, 0.f))) {
+      buffer_(num_bands_, num_channels_),
+      num_buffered_samples_(kBlockSize) {
   RTC_DCHECK_LT(0, num_bands);
   RTC_DCHECK_LT(0, num_channels);
 }
@@ -34,53 +32,39 @@ BlockFramer::~BlockFramer() = default;
 // samples for InsertBlockAndExtractSubFrame to produce a frame. In order to
 // achieve this, the InsertBlockAndExtractSubFrame and InsertBlock methods need
 // to be called in the correct order.
-void BlockFramer::InsertBlock(
-    const std::vector<std::vector<std::vector<float>>>& block) {
-  RTC_DCHECK_EQ(num_bands_, block.size());
-  for (size_t band = 0; band < num_bands_; ++band) {
-    RTC_DCHECK_EQ(num_channels_, block[band].size());
-    for (size_t channel = 0; channel < num_channels_; ++channel) {
-      RTC_DCHECK_EQ(kBlockSize, block[band][channel].size());
-      RTC_DCHECK_EQ(0, buffer_[band][channel].size());
-
-      buffer_[band][channel].insert(buffer_[band][channel].begin(),
-                                    block[band][channel].begin(),
-                                    block[band][channel].end());
-    }
-  }
+void BlockFramer::InsertBlock(const Block& block) {
+  RTC_DCHECK_EQ(num_bands_, block.NumBands());
+  RTC_DCHECK_EQ(num_channels_, block.NumChannels());
+  RTC_DCHECK_EQ(0, num_buffered_samples_);
+  buffer_ = block;
+  num_buffered_samples_ = kBlockSize;
 }
 
 void BlockFramer::InsertBlockAndExtractSubFrame(
-    const std::vector<std::vector<std::vector<float>>>& block,
+    const Block& block,
     std::vector<std::vector<rtc::ArrayView<float>>>* sub_frame) {
   RTC_DCHECK(sub_frame);
-  RTC_DCHECK_EQ(num_bands_, block.size());
+  RTC_DCHECK_EQ(num_bands_, block.NumBands());
+  RTC_DCHECK_EQ(num_channels_, block.NumChannels());
   RTC_DCHECK_EQ(num_bands_, sub_frame->size());
+  RTC_DCHECK_LE(kSubFrameLength, num_buffered_samples_ + kBlockSize);
+  RTC_DCHECK_GE(kBlockSize, num_buffered_samples_);
+  const size_t samples_to_frame = kSubFrameLength - num_buffered_samples_;
   for (size_t band = 0; band < num_bands_; ++band) {
-    RTC_DCHECK_EQ(num_channels_, block[band].size());
-    RTC_DCHECK_EQ(num_channels_, (*sub_frame)[0].size());
+    RTC_DCHECK_EQ(num_channels_, (*sub_frame)[band].size());
     for (size_t channel = 0; channel < num_channels_; ++channel) {
-      RTC_DCHECK_LE(kSubFrameLength,
-                    buffer_[band][channel].size() + kBlockSize);
-      RTC_DCHECK_EQ(kBlockSize, block[band][channel].size());
-      RTC_DCHECK_GE(kBlockSize, buffer_[band][channel].size());
       RTC_DCHECK_EQ(kSubFrameLength, (*sub_frame)[band][channel].size());
-
-      const int samples_to_frame =
-          kSubFrameLength - buffer_[band][channel].size();
-      std::copy(buffer_[band][channel].begin(), buffer_[band][channel].end(),
-                (*sub_frame)[band][channel].begin());
-      std::copy(
-          block[band][channel].begin(),
-          block[band][channel].begin() + samples_to_frame,
-          (*sub_frame)[band][channel].begin() + buffer_[band][channel].size());
-      buffer_[band][channel].clear();
-      buffer_[band][channel].insert(
-          buffer_[band][channel].begin(),
-          block[band][channel].begin() + samples_to_frame,
-          block[band][channel].end());
+      const float* buffered = buffer_.begin(band, channel);
+      const float* block_channel = block.begin(band, channel);
+      float* sub_frame_channel = (*sub_frame)[band][channel].data();
+      std::copy(buffered, buffered + num_buffered_samples_, sub_frame_channel);
+      std::copy(block_channel, block_channel + samples_to_frame,
+                sub_frame_channel + num_buffered_samples_);
+      std::copy(block_channel + samples_to_frame, block_channel + kBlockSize,
+                buffer_.begin(band, channel));
     }
   }
+  num_buffered_samples_ = kBlockSize - samples_to_frame;
 }
 
 }  // namespace webrtc
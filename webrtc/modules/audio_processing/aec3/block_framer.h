@@ -15,6 +15,7 @@
 
 #include "api/array_view.h"
 #include "modules/audio_processing/aec3/aec3_common.h"
+#include "modules/audio_processing/aec3/block.h"
 
 namespace webrtc {
 
@@ -32,16 +33,17 @@ class BlockFramer {
   BlockFramer& operator=(const BlockFramer&) = delete;
 
   // Adds a 64 sample block into the data that will form the next output frame.
-  void InsertBlock(const std::vector<std::vector<std::vector<float>>>& block);
+  void InsertBlock(const Block& block);
   // Adds a 64 sample block and extracts an 80 sample subframe.
   void InsertBlockAndExtractSubFrame(
-      const std::vector<std::vector<std::vector<float>>>& block,
+      const Block& block,
       std::vector<std::vector<rtc::ArrayView<float>>>* sub_frame);
 
  private:
   const size_t num_bands_;
   const size_t num_channels_;
-  std::vector<std::vector<std::vector<float>>> buffer_;
+  Block buffer_;
+  size_t num_buffered_samples_;
 };
 }  // namespace webrtc
 
@@ -113,10 +113,10 @@ void ProcessCaptureFrameContent(
     BlockFramer* linear_output_framer,
     BlockFramer* output_framer,
     BlockProcessor* block_processor,
-    std::vector<std::vector<std::vector<float>>>* linear_output_block,
+    Block* linear_output_block,
     std::vector<std::vector<rtc::ArrayView<float>>>*
         linear_output_sub_frame_view,
-    std::vector<std::vector<std::vector<float>>>* capture_block,
+    Block* capture_block,
     std::vector<std::vector<rtc::ArrayView<float>>>* capture_sub_frame_view) {
   FillSubFrameView(capture, sub_frame_index, capture_sub_frame_view);
 
@@ -149,8 +149,8 @@ void ProcessRemainingCaptureFrameContent(
     BlockFramer* linear_output_framer,
     BlockFramer* output_framer,
     BlockProcessor* block_processor,
-    std::vector<std::vector<std::vector<float>>>* linear_output_block,
-    std::vector<std::vector<std::vector<float>>>* block) {
+    Block* linear_output_block,
+    Block* block) {
   if (!capture_blocker->IsBlockAvailable()) {
     return;
   }
@@ -171,7 +171,7 @@ void BufferRenderFrameContent(
     size_t sub_frame_index,
     FrameBlocker* render_blocker,
     BlockProcessor* block_processor,
-    std::vector<std::vector<std::vector<float>>>* block,
+    Block* block,
     std::vector<std::vector<rtc::ArrayView<float>>>* sub_frame_view) {
   FillSubFrameView(render_frame, sub_frame_index, sub_frame_view);
   render_blocker->InsertSubFrameAndExtractBlock(*sub_frame_view, block);
@@ -181,7 +181,7 @@ void BufferRenderFrameContent(
 void BufferRemainingRenderFrameContent(
     FrameBlocker* render_blocker,
     BlockProcessor* block_processor,
-    std::vector<std::vector<std::vector<float>>>* block) {
+    Block* block) {
   if (!render_blocker->IsBlockAvailable()) {
     return;
   }
@@ -668,14 +668,8 @@ EchoCanceller3::EchoCanceller3(const EchoCanceller3Config& config,
           std::vector<std::vector<float>>(
               num_render_channels_,
               std::vector<float>(AudioBuffer::kSplitBandSize, 0.f))),
-      render_block_(
-          num_bands_,
-          std::vector<std::vector<float>>(num_render_channels_,
-                                          std::vector<float>(kBlockSize, 0.f))),
-      capture_block_(
-          num_bands_,
-          std::vector<std::vector<float>>(num_capture_channels_,
-                                          std::vector<float>(kBlockSize, 0.f))),
+      render_block_(num_bands_, num_render_channels_),
+      capture_block_(num_bands_, num_capture_channels_),
       render_sub_frame_view_(
           num_bands_,
           std::vector<rtc::ArrayView<float>>(num_render_channels_)),
@@ -699,10 +693,7 @@ EchoCanceller3::EchoCanceller3(const EchoCanceller3Config& config,
 
   if (config_.filter.export_linear_aec_output) {
     linear_output_framer_.reset(new BlockFramer(1, num_capture_channels_));
-    linear_output_block_ =
-        std::make_unique<std::vector<std::vector<std::vector<float>>>>(
-            1, std::vector<std::vector<float>>(
-                   num_capture_channels_, std::vector<float>(kBlockSize, 0.f)));
+    linear_output_block_ = std::make_unique<Block>(1, num_capture_channels_);
     linear_output_sub_frame_view_ =
         std::vector<std::vector<rtc::ArrayView<float>>>(
             1, std::vector<rtc::ArrayView<float>>(num_capture_channels_));
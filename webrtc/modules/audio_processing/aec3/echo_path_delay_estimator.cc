@@ -18,6 +18,15 @@
 #include "rtc_base/checks.h"
 
 namespace webrtc {
+namespace {
+
+float GetExcitationLimit(const EchoCanceller3Config& config) {
+  return config.delay.down_sampling_factor == 8
+             ? config.render_levels.poor_excitation_render_limit_ds8
+             : config.render_levels.poor_excitation_render_limit;
+}
+
+}  // namespace
 
 EchoPathDelayEstimator::EchoPathDelayEstimator(
     ApmDataDumper* data_dumper,
@@ -32,20 +41,35 @@ EchoPathDelayEstimator::EchoPathDelayEstimator(
                      config.delay.capture_alignment_mixing),
       capture_decimator_(down_sampling_factor_),
       matched_filter_(
+          config.delay.fft_matched_filter.enabled
+              ? nullptr
+              : new MatchedFilter(
+                    data_dumper_,
+                    DetectOptimization(),
+                    sub_block_size_,
+                    kMatchedFilterWindowSizeSubBlocks,
+                    config.delay.num_filters,
+                    kMatchedFilterAlignmentShiftSizeSubBlocks,
+                    GetExcitationLimit(config),
+                    config.delay.delay_estimate_smoothing,
+                    config.delay.delay_candidate_detection_threshold)),
+      fft_matched_filter_(
+          config.delay.fft_matched_filter.enabled
+              ? new FftMatchedFilter(
+                    data_dumper_,
+                    sub_block_size_,
+                    kMatchedFilterWindowSizeSubBlocks,
+                    config.delay.num_filters,
+                    kMatchedFilterAlignmentShiftSizeSubBlocks,
+                    GetExcitationLimit(config),
+                    config.delay.fft_matched_filter.smoothing,
+                    config.delay.fft_matched_filter.detection_threshold)
+              : nullptr),
+      matched_filter_lag_aggregator_(
           data_dumper_,
-          DetectOptimization(),
-          sub_block_size_,
-          kMatchedFilterWindowSizeSubBlocks,
-          config.delay.num_filters,
-          kMatchedFilterAlignmentShiftSizeSubBlocks,
-          config.delay.down_sampling_factor == 8
-              ? config.render_levels.poor_excitation_render_limit_ds8
-              : config.render_levels.poor_excitation_render_limit,
-          config.delay.delay_estimate_smoothing,
-          config.delay.delay_candidate_detection_threshold),
-      matched_filter_lag_aggregator_(data_dumper_,
-                                     matched_filter_.GetMaxFilterLag(),
-                                     config.delay.delay_selection_thresholds) {
+          fft_matched_filter_ ? fft_matched_filter_->GetMaxFilterLag()
+                              : matched_filter_->GetMaxFilterLag(),
+          config.delay.delay_selection_thresholds) {
   RTC_DCHECK(data_dumper);
   RTC_DCHECK(down_sampling_factor_ > 0);
 }
@@ -58,9 +82,7 @@ void EchoPathDelayEstimator::Reset(bool reset_delay_confidence) {
 
 absl::optional<DelayEstimate> EchoPathDelayEstimator::EstimateDelay(
     const DownsampledRenderBuffer& render_buffer,
-    const std::vector<std::vector<float>>& capture) {
-  RTC_DCHECK_EQ(kBlockSize, capture[0].size());
-
+    const Block& capture) {
   std::array<float, kBlockSize> downsampled_capture_data;
   rtc::ArrayView<float> downsampled_capture(downsampled_capture_data.data(),
                                             sub_block_size_);
@@ -71,11 +93,16 @@ absl::optional<DelayEstimate> EchoPathDelayEstimator::EstimateDelay(
   data_dumper_->DumpWav("aec3_capture_decimator_output",
                         downsampled_capture.size(), downsampled_capture.data(),
                         16000 / down_sampling_factor_, 1);
-  matched_filter_.Update(render_buffer, downsampled_capture);
-
-  absl::optional<DelayEstimate> aggregated_matched_filter_lag =
-      matched_filter_lag_aggregator_.Aggregate(
-          matched_filter_.GetLagEstimates());
+  absl::optional<DelayEstimate> aggregated_matched_filter_lag;
+  if (fft_matched_filter_) {
+    fft_matched_filter_->Update(render_buffer, downsampled_capture);
+    aggregated_matched_filter_lag = matched_filter_lag_aggregator_.Aggregate(
+        fft_matched_filter_->GetLagEstimates());
+  } else {
+    matched_filter_->Update(render_buffer, downsampled_capture);
+    aggregated_matched_filter_lag = matched_filter_lag_aggregator_.Aggregate(
+        matched_filter_->GetLagEstimates());
+  }
 
   // Run clockdrift detection.
   if (aggregated_matched_filter_lag &&
@@ -118,7 +145,11 @@ void EchoPathDelayEstimator::Reset(bool reset_lag_aggregator,
   if (reset_lag_aggregator) {
     matched_filter_lag_aggregator_.Reset(reset_delay_confidence);
   }
-  matched_filter_.Reset();
+  if (fft_matched_filter_) {
+    fft_matched_filter_->Reset();
+  } else {
+    matched_filter_->Reset();
+  }
   old_aggregated_lag_ = absl::nullopt;
   consistent_estimate_counter_ = 0;
 }
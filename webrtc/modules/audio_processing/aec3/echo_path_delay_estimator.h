@@ -13,12 +13,16 @@
 
 #include <stddef.h>
 
+#include <memory>
+
 #include "absl/types/optional.h"
 #include "api/array_view.h"
 #include "modules/audio_processing/aec3/alignment_mixer.h"
+#include "modules/audio_processing/aec3/block.h"
 #include "modules/audio_processing/aec3/clockdrift_detector.h"
 #include "modules/audio_processing/aec3/decimator.h"
 #include "modules/audio_processing/aec3/delay_estimate.h"
+#include "modules/audio_processing/aec3/fft_matched_filter.h"
 #include "modules/audio_processing/aec3/matched_filter.h"
 #include "modules/audio_processing/aec3/matched_filter_lag_aggregator.h"
 #include "rtc_base/constructor_magic.h"
@@ -44,12 +48,17 @@ class EchoPathDelayEstimator {
   // Produce a delay estimate if such is avaliable.
   absl::optional<DelayEstimate> EstimateDelay(
       const DownsampledRenderBuffer& render_buffer,
-      const std::vector<std::vector<float>>& capture);
+      const Block& capture);
 
   // Log delay estimator properties.
   void LogDelayEstimationProperties(int sample_rate_hz, size_t shift) const {
-    matched_filter_.LogFilterProperties(sample_rate_hz, shift,
-                                        down_sampling_factor_);
+    if (fft_matched_filter_) {
+      fft_matched_filter_->LogFilterProperties(sample_rate_hz, shift,
+                                               down_sampling_factor_);
+    } else {
+      matched_filter_->LogFilterProperties(sample_rate_hz, shift,
+                                           down_sampling_factor_);
+    }
   }
 
   // Returns the level of detected clockdrift.
@@ -63,7 +72,10 @@ class EchoPathDelayEstimator {
   const size_t sub_block_size_;
   AlignmentMixer capture_mixer_;
   Decimator capture_decimator_;
-  MatchedFilter matched_filter_;
+  // Exactly one of the time-domain and the FFT-based matched filters is
+  // active.
+  std::unique_ptr<MatchedFilter> matched_filter_;
+  std::unique_ptr<FftMatchedFilter> fft_matched_filter_;
   MatchedFilterLagAggregator matched_filter_lag_aggregator_;
   absl::optional<DelayEstimate> old_aggregated_lag_;
   size_t consistent_estimate_counter_ = 0;
@@ -92,13 +92,13 @@ void SignalTransition(rtc::ArrayView<const float> from,
   }
 }
 
-// Computes a windowed (square root Hanning) padded FFT and updates the related
-// memory.
-void WindowedPaddedFft(const Aec3Fft& fft,
-                       rtc::ArrayView<const float> v,
-                       rtc::ArrayView<float> v_old,
-                       FftData* V) {
-  fft.PaddedFft(v, v_old, Aec3Fft::Window::kSqrtHanning, V);
+// Forms the input of a windowed (square root Hanning) padded FFT and updates
+// the related memory.
+void WindowedPaddedFftInput(const Aec3Fft& fft,
+                            rtc::ArrayView<const float> v,
+                            rtc::ArrayView<float> v_old,
+                            std::array<float, kFftLength>* fft_input) {
+  fft.PadAndWindow(v, v_old, Aec3Fft::Window::kSqrtHanning, fft_input);
   std::copy(v.begin(), v.end(), v_old.begin());
 }
 
@@ -123,8 +123,8 @@ class EchoRemoverImpl final : public EchoRemover {
       bool capture_signal_saturation,
       const absl::optional<DelayEstimate>& external_delay,
       RenderBuffer* render_buffer,
-      std::vector<std::vector<std::vector<float>>>* linear_output,
-      std::vector<std::vector<std::vector<float>>>* capture) override;
+      Block* linear_output,
+      Block* capture) override;
 
   // Updates the status on whether echo leakage is detected in the output of the
   // echo remover.
@@ -159,6 +159,11 @@ class EchoRemoverImpl final : public EchoRemover {
   EchoRemoverMetrics metrics_;
   std::vector<std::array<float, kFftLengthBy2>> e_old_;
   std::vector<std::array<float, kFftLengthBy2>> y_old_;
+  // Inputs and outputs of the batched capture and error FFTs, with the
+  // capture and error signal of each channel next to each other.
+  std::vector<std::array<float, kFftLength>> fft_inputs_;
+  std::vector<std::array<float, kFftLength>*> fft_input_ptrs_;
+  std::vector<FftData*> fft_output_ptrs_;
   size_t block_counter_ = 0;
   int gain_change_hangover_ = 0;
   bool refined_filter_output_last_selected_ = true;
@@ -209,6 +214,9 @@ EchoRemoverImpl::EchoRemoverImpl(const EchoCanceller3Config& config,
       aec_state_(config_, num_capture_channels_),
       e_old_(num_capture_channels_, {0.f}),
       y_old_(num_capture_channels_, {0.f}),
+      fft_inputs_(2 * num_capture_channels_),
+      fft_input_ptrs_(2 * num_capture_channels_),
+      fft_output_ptrs_(2 * num_capture_channels_),
       e_heap_(NumChannelsOnHeap(num_capture_channels_), {0.f}),
       Y2_heap_(NumChannelsOnHeap(num_capture_channels_)),
       E2_heap_(NumChannelsOnHeap(num_capture_channels_)),
@@ -220,6 +228,9 @@ EchoRemoverImpl::EchoRemoverImpl(const EchoCanceller3Config& config,
       high_band_comfort_noise_heap_(NumChannelsOnHeap(num_capture_channels_)),
       subtractor_output_heap_(NumChannelsOnHeap(num_capture_channels_)) {
   RTC_DCHECK(ValidFullBandRate(sample_rate_hz));
+  for (size_t k = 0; k < fft_inputs_.size(); ++k) {
+    fft_input_ptrs_[k] = &fft_inputs_[k];
+  }
 }
 
 EchoRemoverImpl::~EchoRemoverImpl() = default;
@@ -236,20 +247,17 @@ void EchoRemoverImpl::ProcessCapture(
     bool capture_signal_saturation,
     const absl::optional<DelayEstimate>& external_delay,
     RenderBuffer* render_buffer,
-    std::vector<std::vector<std::vector<float>>>* linear_output,
-    std::vector<std::vector<std::vector<float>>>* capture) {
+    Block* linear_output,
+    Block* capture) {
   ++block_counter_;
-  const std::vector<std::vector<std::vector<float>>>& x =
-      render_buffer->Block(0);
-  std::vector<std::vector<std::vector<float>>>* y = capture;
+  const Block& x = render_buffer->GetBlock(0);
+  Block* y = capture;
   RTC_DCHECK(render_buffer);
   RTC_DCHECK(y);
-  RTC_DCHECK_EQ(x.size(), NumBandsForRate(sample_rate_hz_));
-  RTC_DCHECK_EQ(y->size(), NumBandsForRate(sample_rate_hz_));
-  RTC_DCHECK_EQ(x[0].size(), num_render_channels_);
-  RTC_DCHECK_EQ((*y)[0].size(), num_capture_channels_);
-  RTC_DCHECK_EQ(x[0][0].size(), kBlockSize);
-  RTC_DCHECK_EQ((*y)[0][0].size(), kBlockSize);
+  RTC_DCHECK_EQ(x.NumBands(), NumBandsForRate(sample_rate_hz_));
+  RTC_DCHECK_EQ(y->NumBands(), NumBandsForRate(sample_rate_hz_));
+  RTC_DCHECK_EQ(x.NumChannels(), num_render_channels_);
+  RTC_DCHECK_EQ(y->NumChannels(), num_capture_channels_);
 
   // Stack allocated data to use when the number of channels is low.
   std::array<std::array<float, kFftLengthBy2>, kMaxNumChannelsOnStack> e_stack;
@@ -309,11 +317,13 @@ void EchoRemoverImpl::ProcessCapture(
   }
 
   data_dumper_->DumpWav("aec3_echo_remover_capture_input", kBlockSize,
-                        &(*y)[0][0][0], 16000, 1);
+                        y->begin(/*band=*/0, /*channel=*/0), 16000, 1);
   data_dumper_->DumpWav("aec3_echo_remover_render_input", kBlockSize,
-                        &x[0][0][0], 16000, 1);
-  data_dumper_->DumpRaw("aec3_echo_remover_capture_input", (*y)[0][0]);
-  data_dumper_->DumpRaw("aec3_echo_remover_render_input", x[0][0]);
+                        x.begin(/*band=*/0, /*channel=*/0), 16000, 1);
+  data_dumper_->DumpRaw("aec3_echo_remover_capture_input",
+                        y->View(/*band=*/0, /*channel=*/0));
+  data_dumper_->DumpRaw("aec3_echo_remover_render_input",
+                        x.View(/*band=*/0, /*channel=*/0));
 
   aec_state_.UpdateCaptureSaturation(capture_signal_saturation);
 
@@ -356,14 +366,20 @@ void EchoRemoverImpl::ProcessCapture(
   }
 
   // Perform linear echo cancellation.
-  subtractor_.Process(*render_buffer, (*y)[0], render_signal_analyzer_,
+  subtractor_.Process(*render_buffer, *y, render_signal_analyzer_,
                       aec_state_, subtractor_output);
 
   // Compute spectra.
   for (size_t ch = 0; ch < num_capture_channels_; ++ch) {
     FormLinearFilterOutput(subtractor_output[ch], e[ch]);
-    WindowedPaddedFft(fft_, (*y)[0][ch], y_old_[ch], &Y[ch]);
-    WindowedPaddedFft(fft_, e[ch], e_old_[ch], &E[ch]);
+    WindowedPaddedFftInput(fft_, y->View(/*band=*/0, ch), y_old_[ch],
+                           &fft_inputs_[2 * ch]);
+    WindowedPaddedFftInput(fft_, e[ch], e_old_[ch], &fft_inputs_[2 * ch + 1]);
+    fft_output_ptrs_[2 * ch] = &Y[ch];
+    fft_output_ptrs_[2 * ch + 1] = &E[ch];
+  }
+  fft_.FftBatch(fft_input_ptrs_, fft_output_ptrs_);
+  for (size_t ch = 0; ch < num_capture_channels_; ++ch) {
     LinearEchoPower(E[ch], Y[ch], &S2_linear[ch]);
     Y[ch].Spectrum(optimization_, Y2[ch]);
     E[ch].Spectrum(optimization_, E2[ch]);
@@ -371,11 +387,11 @@ void EchoRemoverImpl::ProcessCapture(
 
   // Optionally return the linear filter output.
   if (linear_output) {
-    RTC_DCHECK_GE(1, linear_output->size());
-    RTC_DCHECK_EQ(num_capture_channels_, linear_output[0].size());
+    RTC_DCHECK_GE(1, linear_output->NumBands());
+    RTC_DCHECK_EQ(num_capture_channels_, linear_output->NumChannels());
     for (size_t ch = 0; ch < num_capture_channels_; ++ch) {
-      RTC_DCHECK_EQ(kBlockSize, (*linear_output)[0][ch].size());
-      std::copy(e[ch].begin(), e[ch].end(), (*linear_output)[0][ch].begin());
+      std::copy(e[ch].begin(), e[ch].end(),
+                linear_output->begin(/*band=*/0, ch));
     }
   }
 
@@ -387,8 +403,8 @@ void EchoRemoverImpl::ProcessCapture(
   // Choose the linear output.
   const auto& Y_fft = aec_state_.UseLinearFilterOutput() ? E : Y;
 
-  data_dumper_->DumpWav("aec3_output_linear", kBlockSize, &(*y)[0][0][0], 16000,
-                        1);
+  data_dumper_->DumpWav("aec3_output_linear", kBlockSize,
+                        y->begin(/*band=*/0, /*channel=*/0), 16000, 1);
   data_dumper_->DumpWav("aec3_output_linear2", kBlockSize, &e[0][0], 16000, 1);
 
   // Estimate the residual echo power.
@@ -430,13 +446,12 @@ void EchoRemoverImpl::ProcessCapture(
   // Debug outputs for the purpose of development and analysis.
   data_dumper_->DumpWav("aec3_echo_estimate", kBlockSize,
                         &subtractor_output[0].s_refined[0], 16000, 1);
-  data_dumper_->DumpRaw("aec3_output", (*y)[0][0]);
+  data_dumper_->DumpRaw("aec3_output", y->View(/*band=*/0, /*channel=*/0));
   data_dumper_->DumpRaw("aec3_narrow_render",
                         render_signal_analyzer_.NarrowPeakBand() ? 1 : 0);
   data_dumper_->DumpRaw("aec3_N2", cng_.NoiseSpectrum()[0]);
   data_dumper_->DumpRaw("aec3_suppressor_gain", G);
-  data_dumper_->DumpWav("aec3_output",
-                        rtc::ArrayView<const float>(&(*y)[0][0][0], kBlockSize),
+  data_dumper_->DumpWav("aec3_output", y->View(/*band=*/0, /*channel=*/0),
                         16000, 1);
   data_dumper_->DumpRaw("aec3_using_subtractor_output[0]",
                         aec_state_.UseLinearFilterOutput() ? 1 : 0);
@@ -0,0 +1,303 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+#include "modules/audio_processing/aec3/fft_matched_filter.h"
+
+#include <algorithm>
+
+#include "modules/audio_processing/aec3/downsampled_render_buffer.h"
+#include "modules/audio_processing/logging/apm_data_dumper.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/logging.h"
+
+namespace webrtc {
+namespace {
+
+// Scaling of the inverse Ooura FFT.
+constexpr float kIfftScale = 1.f / kFftLengthBy2;
+
+size_t NumPartitions(size_t max_filter_lag) {
+  return (max_filter_lag + kFftLengthBy2 - 1) / kFftLengthBy2;
+}
+
+}  // namespace
+
+FftMatchedFilter::FftMatchedFilter(ApmDataDumper* data_dumper,
+                                   size_t sub_block_size,
+                                   size_t window_size_sub_blocks,
+                                   int num_matched_filters,
+                                   size_t alignment_shift_sub_blocks,
+                                   float excitation_limit,
+                                   float smoothing,
+                                   float detection_threshold)
+    : data_dumper_(data_dumper),
+      sub_block_size_(sub_block_size),
+      filter_length_(window_size_sub_blocks * sub_block_size_),
+      filter_intra_lag_shift_(alignment_shift_sub_blocks * sub_block_size_),
+      num_filters_(num_matched_filters),
+      max_filter_lag_(num_filters_ * filter_intra_lag_shift_ + filter_length_),
+      num_partitions_(NumPartitions(max_filter_lag_)),
+      excitation_limit_(excitation_limit),
+      smoothing_(smoothing),
+      detection_threshold_(detection_threshold),
+      render_spectra_(num_partitions_),
+      cross_spectra_(num_partitions_),
+      render_power_(max_filter_lag_, 0.f),
+      capture_power_(num_partitions_, 0.f),
+      render_((num_partitions_ + 1) * kFftLengthBy2, 0.f),
+      render_energy_(max_filter_lag_, 0.f),
+      correlation_(max_filter_lag_, 0.f),
+      partition_updated_(num_partitions_, false),
+      partition_buffers_(num_partitions_),
+      partition_buffer_ptrs_(num_partitions_),
+      render_spectra_ptrs_(num_partitions_),
+      cross_spectra_ptrs_(num_partitions_),
+      updated_partitions_(num_partitions_),
+      lag_estimates_(num_matched_filters) {
+  RTC_DCHECK(data_dumper);
+  RTC_DCHECK_LT(0, window_size_sub_blocks);
+  RTC_DCHECK_LT(0, num_matched_filters);
+  RTC_DCHECK_EQ(0, kFftLengthBy2 % sub_block_size_);
+  RTC_DCHECK_LE(20, filter_length_);
+  for (size_t p = 0; p < num_partitions_; ++p) {
+    partition_buffer_ptrs_[p] = &partition_buffers_[p];
+    render_spectra_ptrs_[p] = &render_spectra_[p];
+  }
+  Reset();
+}
+
+FftMatchedFilter::~FftMatchedFilter() = default;
+
+void FftMatchedFilter::Reset() {
+  capture_block_size_ = 0;
+  last_sub_block_read_ = -1;
+  last_block_read_ = -1;
+  render_spectra_valid_ = false;
+  render_spectra_start_ = 0;
+  for (auto& S : cross_spectra_) {
+    S.Clear();
+  }
+  std::fill(render_power_.begin(), render_power_.end(), 0.f);
+  std::fill(capture_power_.begin(), capture_power_.end(), 0.f);
+  std::fill(correlation_.begin(), correlation_.end(), 0.f);
+  for (auto& l : lag_estimates_) {
+    l = MatchedFilter::LagEstimate();
+  }
+}
+
+void FftMatchedFilter::Update(const DownsampledRenderBuffer& render_buffer,
+                              rtc::ArrayView<const float> capture) {
+  RTC_DCHECK_EQ(sub_block_size_, capture.size());
+
+  // The sub-blocks of a capture block must be aligned with consecutive render
+  // sub-blocks. If the render buffer has been realigned in between, the
+  // partially gathered capture block is discarded.
+  if (capture_block_size_ > 0 &&
+      render_buffer.read !=
+          render_buffer.OffsetIndex(last_sub_block_read_,
+                                    -static_cast<int>(sub_block_size_))) {
+    capture_block_size_ = 0;
+  }
+  last_sub_block_read_ = render_buffer.read;
+
+  std::copy(capture.begin(), capture.end(),
+            capture_block_.begin() + capture_block_size_);
+  capture_block_size_ += sub_block_size_;
+
+  if (capture_block_size_ == kFftLengthBy2) {
+    ProcessCaptureBlock(render_buffer);
+    capture_block_size_ = 0;
+  }
+}
+
+void FftMatchedFilter::ProcessCaptureBlock(
+    const DownsampledRenderBuffer& render_buffer) {
+  // Gather the render samples in order of increasing lag, where lag zero is
+  // aligned with the most recent capture sample. Lags beyond the render buffer
+  // are zeroed.
+  const size_t num_render_samples =
+      std::min(render_.size(), render_buffer.buffer.size());
+  int index = render_buffer.read;
+  for (size_t k = 0; k < num_render_samples; ++k) {
+    render_[k] = render_buffer.buffer[index];
+    index = render_buffer.IncIndex(index);
+  }
+  std::fill(render_.begin() + num_render_samples, render_.end(), 0.f);
+
+  // Render spectra for the lag partitions. As the render buffer advances one
+  // capture block between calls, the partitions from the previous call are
+  // shifted by one partition and only the first one needs to be computed.
+  std::array<float, kFftLength> x;
+  if (render_spectra_valid_ &&
+      render_buffer.read ==
+          render_buffer.OffsetIndex(last_block_read_,
+                                    -static_cast<int>(kFftLengthBy2))) {
+    render_spectra_start_ = render_spectra_start_ > 0
+                                ? render_spectra_start_ - 1
+                                : num_partitions_ - 1;
+    std::copy(render_.begin(), render_.begin() + kFftLength, x.begin());
+    fft_.Fft(&x, &render_spectra_[render_spectra_start_]);
+  } else {
+    ComputeAllRenderSpectra();
+  }
+  last_block_read_ = render_buffer.read;
+
+  // Capture spectrum, time-reversed to match the render ordering.
+  std::array<float, kFftLength> y;
+  float capture_energy = 0.f;
+  bool saturation = false;
+  for (size_t k = 0; k < kFftLengthBy2; ++k) {
+    const float v = capture_block_[kFftLengthBy2 - 1 - k];
+    y[k] = v;
+    capture_energy += v * v;
+    saturation = saturation || v >= 32000.f || v <= -32000.f;
+  }
+  std::fill(y.begin() + kFftLengthBy2, y.end(), 0.f);
+  FftData Y;
+  fft_.Fft(&y, &Y);
+
+  // Render energies over one capture block for each lag.
+  double energy = 0.0;
+  for (size_t k = 0; k < kFftLengthBy2; ++k) {
+    energy += render_[k] * render_[k];
+  }
+  for (size_t k = 0; k < max_filter_lag_; ++k) {
+    render_energy_[k] = static_cast<float>(energy);
+    energy += render_[k + kFftLengthBy2] * render_[k + kFftLengthBy2] -
+              render_[k] * render_[k];
+  }
+
+  // Update the smoothed cross-spectra for all sufficiently excited partitions.
+  size_t num_updated_partitions = 0;
+  const float x2_sum_threshold =
+      kFftLength * excitation_limit_ * excitation_limit_;
+  for (size_t p = 0; p < num_partitions_; ++p) {
+    partition_updated_[p] = false;
+    if (saturation) {
+      continue;
+    }
+
+    const size_t lag_begin = p * kFftLengthBy2;
+    const size_t lag_end = std::min(lag_begin + kFftLengthBy2, max_filter_lag_);
+    float x2_sum = 0.f;
+    for (size_t k = lag_begin; k < lag_begin + kFftLength; ++k) {
+      x2_sum += render_[k] * render_[k];
+    }
+    if (x2_sum <= x2_sum_threshold) {
+      continue;
+    }
+
+    // Smoothed cross-spectrum X * conj(Y).
+    const FftData& X =
+        render_spectra_[(render_spectra_start_ + p) % num_partitions_];
+    FftData& S = cross_spectra_[p];
+    for (size_t f = 0; f < kFftLengthBy2Plus1; ++f) {
+      const float re = X.re[f] * Y.re[f] + X.im[f] * Y.im[f];
+      const float im = X.im[f] * Y.re[f] - X.re[f] * Y.im[f];
+      S.re[f] += smoothing_ * (re - S.re[f]);
+      S.im[f] += smoothing_ * (im - S.im[f]);
+    }
+
+    capture_power_[p] += smoothing_ * (capture_energy - capture_power_[p]);
+    for (size_t k = lag_begin; k < lag_end; ++k) {
+      render_power_[k] += smoothing_ * (render_energy_[k] - render_power_[k]);
+    }
+
+    cross_spectra_ptrs_[num_updated_partitions] = &S;
+    updated_partitions_[num_updated_partitions] = p;
+    ++num_updated_partitions;
+    partition_updated_[p] = true;
+  }
+
+  // Transform the updated cross-spectra to cross-correlations, all at once.
+  fft_.IfftBatch(
+      rtc::ArrayView<const FftData* const>(cross_spectra_ptrs_.data(),
+                                           num_updated_partitions),
+      rtc::ArrayView<std::array<float, kFftLength>* const>(
+          partition_buffer_ptrs_.data(), num_updated_partitions));
+  for (size_t i = 0; i < num_updated_partitions; ++i) {
+    const size_t p = updated_partitions_[i];
+    const size_t lag_begin = p * kFftLengthBy2;
+    const size_t lag_end = std::min(lag_begin + kFftLengthBy2, max_filter_lag_);
+    const std::array<float, kFftLength>& x = partition_buffers_[i];
+    for (size_t k = lag_begin, j = 0; k < lag_end; ++k, ++j) {
+      correlation_[k] = x[j] * kIfftScale;
+    }
+  }
+
+  data_dumper_->DumpRaw("aec3_fft_matched_filter_correlation", correlation_);
+
+  // Form the lag estimates using the same lag banks as the time-domain
+  // matched filter. The strength of a lag is measured as the capture energy
+  // that is explained by a one-tap predictor at that lag.
+  const float render_power_floor =
+      kFftLengthBy2 * excitation_limit_ * excitation_limit_;
+  size_t alignment_shift = 0;
+  for (size_t n = 0; n < num_filters_; ++n) {
+    const size_t bank_end = alignment_shift + filter_length_;
+    float best_score = 0.f;
+    size_t best_lag = alignment_shift;
+    for (size_t k = alignment_shift; k < bank_end; ++k) {
+      const float score = correlation_[k] * correlation_[k] /
+                          std::max(render_power_[k], render_power_floor);
+      if (score > best_score) {
+        best_score = score;
+        best_lag = k;
+      }
+    }
+
+    bool updated = false;
+    for (size_t p = alignment_shift / kFftLengthBy2;
+         p <= (bank_end - 1) / kFftLengthBy2; ++p) {
+      updated = updated || partition_updated_[p];
+    }
+
+    const float capture_power = capture_power_[best_lag / kFftLengthBy2];
+    const float coherence =
+        capture_power > 0.f ? best_score / capture_power : 0.f;
+    const size_t lag_in_bank = best_lag - alignment_shift;
+    lag_estimates_[n] = MatchedFilter::LagEstimate(
+        best_score,
+        lag_in_bank > 2 && lag_in_bank < (filter_length_ - 10) &&
+            coherence > detection_threshold_,
+        best_lag, updated);
+
+    alignment_shift += filter_intra_lag_shift_;
+  }
+}
+
+void FftMatchedFilter::ComputeAllRenderSpectra() {
+  for (size_t p = 0; p < num_partitions_; ++p) {
+    auto start = render_.begin() + p * kFftLengthBy2;
+    std::copy(start, start + kFftLength, partition_buffers_[p].begin());
+  }
+  fft_.FftBatch(partition_buffer_ptrs_, render_spectra_ptrs_);
+  render_spectra_start_ = 0;
+  render_spectra_valid_ = true;
+}
+
+void FftMatchedFilter::LogFilterProperties(int sample_rate_hz,
+                                           size_t shift,
+                                           size_t downsampling_factor) const {
+  size_t alignment_shift = 0;
+  constexpr int kFsBy1000 = 16;
+  for (size_t k = 0; k < num_filters_; ++k) {
+    int start = static_cast<int>(alignment_shift * downsampling_factor);
+    int end = static_cast<int>((alignment_shift + filter_length_) *
+                               downsampling_factor);
+    RTC_LOG(LS_VERBOSE) << "Filter " << k << ": start: "
+                        << (start - static_cast<int>(shift)) / kFsBy1000
+                        << " ms, end: "
+                        << (end - static_cast<int>(shift)) / kFsBy1000
+                        << " ms.";
+    alignment_shift += filter_intra_lag_shift_;
+  }
+}
+
+}  // namespace webrtc
@@ -0,0 +1,125 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_AUDIO_PROCESSING_AEC3_FFT_MATCHED_FILTER_H_
+#define MODULES_AUDIO_PROCESSING_AEC3_FFT_MATCHED_FILTER_H_
+
+#include <stddef.h>
+
+#include <array>
+#include <vector>
+
+#include "api/array_view.h"
+#include "modules/audio_processing/aec3/aec3_common.h"
+#include "modules/audio_processing/aec3/aec3_fft.h"
+#include "modules/audio_processing/aec3/fft_data.h"
+#include "modules/audio_processing/aec3/matched_filter.h"
+
+namespace webrtc {
+
+class ApmDataDumper;
+struct DownsampledRenderBuffer;
+
+// Frequency-domain counterpart of MatchedFilter. Instead of adapting one NLMS
+// filter per lag bank in the time domain, the downsampled capture signal is
+// gathered into blocks of kFftLengthBy2 samples and correlated against the
+// render signal for all lags at once using partitioned 128 point FFTs. The
+// cross-spectra are recursively smoothed in the frequency domain and the
+// resulting correlation is split into the same lag banks as for MatchedFilter,
+// which allows the lag estimates to be aggregated by
+// MatchedFilterLagAggregator.
+//
+// As the render spectra of the lag partitions are shifted by one partition for
+// each capture block, only one new render FFT is needed per capture block
+// during steady state operation. This makes the cost grow much slower with the
+// delay search range than for the time-domain matched filter.
+class FftMatchedFilter {
+ public:
+  FftMatchedFilter(ApmDataDumper* data_dumper,
+                   size_t sub_block_size,
+                   size_t window_size_sub_blocks,
+                   int num_matched_filters,
+                   size_t alignment_shift_sub_blocks,
+                   float excitation_limit,
+                   float smoothing,
+                   float detection_threshold);
+
+  FftMatchedFilter() = delete;
+  FftMatchedFilter(const FftMatchedFilter&) = delete;
+  FftMatchedFilter& operator=(const FftMatchedFilter&) = delete;
+
+  ~FftMatchedFilter();
+
+  // Updates the correlation with the values in the capture buffer.
+  void Update(const DownsampledRenderBuffer& render_buffer,
+              rtc::ArrayView<const float> capture);
+
+  // Resets the correlation estimates.
+  void Reset();
+
+  // Returns the current lag estimates.
+  rtc::ArrayView<const MatchedFilter::LagEstimate> GetLagEstimates() const {
+    return lag_estimates_;
+  }
+
+  // Returns the maximum filter lag.
+  size_t GetMaxFilterLag() const { return max_filter_lag_; }
+
+  // Log matched filter properties.
+  void LogFilterProperties(int sample_rate_hz,
+                           size_t shift,
+                           size_t downsampling_factor) const;
+
+ private:
+  // Correlates the gathered capture block against the render signal and
+  // updates the lag estimates.
+  void ProcessCaptureBlock(const DownsampledRenderBuffer& render_buffer);
+
+  // Computes the render spectra for all lag partitions.
+  void ComputeAllRenderSpectra();
+
+  ApmDataDumper* const data_dumper_;
+  const Aec3Fft fft_;
+  const size_t sub_block_size_;
+  const size_t filter_length_;
+  const size_t filter_intra_lag_shift_;
+  const size_t num_filters_;
+  const size_t max_filter_lag_;
+  const size_t num_partitions_;
+  const float excitation_limit_;
+  const float smoothing_;
+  const float detection_threshold_;
+
+  std::array<float, kFftLengthBy2> capture_block_;
+  size_t capture_block_size_ = 0;
+  int last_sub_block_read_ = -1;
+  int last_block_read_ = -1;
+  bool render_spectra_valid_ = false;
+  size_t render_spectra_start_ = 0;
+  std::vector<FftData> render_spectra_;
+  std::vector<FftData> cross_spectra_;
+  std::vector<float> render_power_;
+  std::vector<float> capture_power_;
+  std::vector<float> render_;
+  std::vector<float> render_energy_;
+  std::vector<float> correlation_;
+  std::vector<bool> partition_updated_;
+  // Buffers for the batched transforms over the partitions.
+  std::vector<std::array<float, kFftLength>> partition_buffers_;
+  std::vector<std::array<float, kFftLength>*> partition_buffer_ptrs_;
+  std::vector<FftData*> render_spectra_ptrs_;
+  std::vector<const FftData*> cross_spectra_ptrs_;
+  std::vector<size_t> updated_partitions_;
+  std::vector<MatchedFilter::LagEstimate> lag_estimates_;
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_AUDIO_PROCESSING_AEC3_FFT_MATCHED_FILTER_H_
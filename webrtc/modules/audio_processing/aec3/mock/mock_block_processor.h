@@ -28,12 +28,12 @@ class MockBlockProcessor : public BlockProcessor {
               ProcessCapture,
               (bool level_change,
                bool saturated_microphone_signal,
-               std::vector<std::vector<std::vector<float>>>* linear_output,
-               std::vector<std::vector<std::vector<float>>>* capture_block),
+               Block* linear_output,
+               Block* capture_block),
               (override));
   MOCK_METHOD(void,
               BufferRender,
-              (const std::vector<std::vector<std::vector<float>>>& block),
+              (const Block& block),
               (override));
   MOCK_METHOD(void,
               UpdateEchoLeakageStatus,
@@ -13,6 +13,7 @@
 #include <string.h>
 
 #include <algorithm>
+#include <array>
 #include <cmath>
 #include <memory>
 #include <numeric>
@@ -55,7 +56,7 @@ class RenderDelayBufferImpl final : public RenderDelayBuffer {
 
   void Reset() override;
   BufferingEvent Insert(
-      const std::vector<std::vector<std::vector<float>>>& block) override;
+      const Block& block) override;
   BufferingEvent PrepareCaptureProcessing() override;
   void HandleSkippedCaptureProcessing() override;
   bool AlignFromDelay(size_t delay) override;
@@ -93,6 +94,9 @@ class RenderDelayBufferImpl final : public RenderDelayBuffer {
   AlignmentMixer render_mixer_;
   Decimator render_decimator_;
   const Aec3Fft fft_;
+  std::vector<std::array<float, kFftLength>> fft_inputs_;
+  std::vector<std::array<float, kFftLength>*> fft_input_ptrs_;
+  std::vector<FftData*> fft_output_ptrs_;
   std::vector<float> render_ds_;
   const int buffer_headroom_;
   bool last_call_was_render_ = false;
@@ -110,8 +114,7 @@ class RenderDelayBufferImpl final : public RenderDelayBuffer {
   int MapDelayToTotalDelay(size_t delay) const;
   int ComputeDelay() const;
   void ApplyTotalDelay(int delay);
-  void InsertBlock(const std::vector<std::vector<std::vector<float>>>& block,
-                   int previous_write);
+  void InsertBlock(const Block& block, int previous_write);
   bool DetectActiveRender(rtc::ArrayView<const float> x) const;
   bool DetectExcessRenderBlocks();
   void IncrementWriteIndices();
@@ -145,8 +148,7 @@ RenderDelayBufferImpl::RenderDelayBufferImpl(const EchoCanceller3Config& config,
                                        config.delay.num_filters,
                                        config.filter.refined.length_blocks),
               NumBandsForRate(sample_rate_hz),
-              num_render_channels,
-              kBlockSize),
+              num_render_channels),
       spectra_(blocks_.buffer.size(), num_render_channels),
       ffts_(blocks_.buffer.size(), num_render_channels),
       delay_(config_.delay.default_delay),
@@ -156,14 +158,20 @@ RenderDelayBufferImpl::RenderDelayBufferImpl(const EchoCanceller3Config& config,
       render_mixer_(num_render_channels, config.delay.render_alignment_mixing),
       render_decimator_(down_sampling_factor_),
       fft_(),
+      fft_inputs_(num_render_channels),
+      fft_input_ptrs_(num_render_channels),
+      fft_output_ptrs_(num_render_channels),
       render_ds_(sub_block_size_, 0.f),
       buffer_headroom_(config.filter.refined.length_blocks) {
   RTC_DCHECK_EQ(blocks_.buffer.size(), ffts_.buffer.size());
   RTC_DCHECK_EQ(spectra_.buffer.size(), ffts_.buffer.size());
   for (size_t i = 0; i < blocks_.buffer.size(); ++i) {
-    RTC_DCHECK_EQ(blocks_.buffer[i][0].size(), ffts_.buffer[i].size());
+    RTC_DCHECK_EQ(blocks_.buffer[i].NumChannels(), ffts_.buffer[i].size());
     RTC_DCHECK_EQ(spectra_.buffer[i].size(), ffts_.buffer[i].size());
   }
+  for (size_t ch = 0; ch < num_render_channels; ++ch) {
+    fft_input_ptrs_[ch] = &fft_inputs_[ch];
+  }
 
   Reset();
 }
@@ -211,7 +219,7 @@ void RenderDelayBufferImpl::Reset() {
 
 // Inserts a new block into the render buffers.
 RenderDelayBuffer::BufferingEvent RenderDelayBufferImpl::Insert(
-    const std::vector<std::vector<std::vector<float>>>& block) {
+    const Block& block) {
   ++render_call_counter_;
   if (delay_) {
     if (!last_call_was_render_) {
@@ -239,7 +247,8 @@ RenderDelayBuffer::BufferingEvent RenderDelayBufferImpl::Insert(
 
   // Detect and update render activity.
   if (!render_activity_) {
-    render_activity_counter_ += DetectActiveRender(block[0][0]) ? 1 : 0;
+    render_activity_counter_ +=
+        DetectActiveRender(block.View(/*band=*/0, /*channel=*/0)) ? 1 : 0;
     render_activity_ = render_activity_counter_ >= 20;
   }
 
@@ -392,47 +401,45 @@ void RenderDelayBufferImpl::AlignFromExternalDelay() {
 }
 
 // Inserts a block into the render buffers.
-void RenderDelayBufferImpl::InsertBlock(
-    const std::vector<std::vector<std::vector<float>>>& block,
-    int previous_write) {
+void RenderDelayBufferImpl::InsertBlock(const Block& block,
+                                        int previous_write) {
   auto& b = blocks_;
   auto& lr = low_rate_;
   auto& ds = render_ds_;
   auto& f = ffts_;
   auto& s = spectra_;
-  const size_t num_bands = b.buffer[b.write].size();
-  const size_t num_render_channels = b.buffer[b.write][0].size();
-  RTC_DCHECK_EQ(block.size(), b.buffer[b.write].size());
-  for (size_t band = 0; band < num_bands; ++band) {
-    RTC_DCHECK_EQ(block[band].size(), num_render_channels);
-    RTC_DCHECK_EQ(b.buffer[b.write][band].size(), num_render_channels);
-    for (size_t ch = 0; ch < num_render_channels; ++ch) {
-      RTC_DCHECK_EQ(block[band][ch].size(), b.buffer[b.write][band][ch].size());
-      std::copy(block[band][ch].begin(), block[band][ch].end(),
-                b.buffer[b.write][band][ch].begin());
-    }
-  }
+  const size_t num_bands = b.buffer[b.write].NumBands();
+  const size_t num_render_channels = b.buffer[b.write].NumChannels();
+  RTC_DCHECK_EQ(block.NumBands(), num_bands);
+  RTC_DCHECK_EQ(block.NumChannels(), num_render_channels);
+  b.buffer[b.write] = block;
 
   if (render_linear_amplitude_gain_ != 1.f) {
     for (size_t band = 0; band < num_bands; ++band) {
       for (size_t ch = 0; ch < num_render_channels; ++ch) {
-        for (size_t k = 0; k < 64; ++k) {
-          b.buffer[b.write][band][ch][k] *= render_linear_amplitude_gain_;
+        float* b_ch = b.buffer[b.write].begin(band, ch);
+        for (size_t k = 0; k < kBlockSize; ++k) {
+          b_ch[k] *= render_linear_amplitude_gain_;
         }
       }
     }
   }
 
   std::array<float, kBlockSize> downmixed_render;
-  render_mixer_.ProduceOutput(b.buffer[b.write][0], downmixed_render);
+  render_mixer_.ProduceOutput(b.buffer[b.write], downmixed_render);
   render_decimator_.Decimate(downmixed_render, ds);
   data_dumper_->DumpWav("aec3_render_decimator_output", ds.size(), ds.data(),
                         16000 / down_sampling_factor_, 1);
   std::copy(ds.rbegin(), ds.rend(), lr.buffer.begin() + lr.write);
-  for (size_t channel = 0; channel < b.buffer[b.write][0].size(); ++channel) {
-    fft_.PaddedFft(b.buffer[b.write][0][channel],
-                   b.buffer[previous_write][0][channel],
-                   &f.buffer[f.write][channel]);
+  RTC_DCHECK_EQ(fft_inputs_.size(), num_render_channels);
+  for (size_t channel = 0; channel < num_render_channels; ++channel) {
+    fft_.PadAndWindow(b.buffer[b.write].View(/*band=*/0, channel),
+                      b.buffer[previous_write].View(/*band=*/0, channel),
+                      Aec3Fft::Window::kRectangular, &fft_inputs_[channel]);
+    fft_output_ptrs_[channel] = &f.buffer[f.write][channel];
+  }
+  fft_.FftBatch(fft_input_ptrs_, fft_output_ptrs_);
+  for (size_t channel = 0; channel < num_render_channels; ++channel) {
     f.buffer[f.write][channel].Spectrum(optimization_,
                                         s.buffer[s.write][channel]);
   }
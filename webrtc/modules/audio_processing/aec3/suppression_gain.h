@@ -20,6 +20,7 @@
 #include "api/audio/echo_canceller3_config.h"
 #include "modules/audio_processing/aec3/aec3_common.h"
 #include "modules/audio_processing/aec3/aec_state.h"
+#include "modules/audio_processing/aec3/block.h"
 #include "modules/audio_processing/aec3/fft_data.h"
 #include "modules/audio_processing/aec3/moving_average.h"
 #include "modules/audio_processing/aec3/nearend_detector.h"
@@ -46,7 +47,7 @@ class SuppressionGain {
           comfort_noise_spectrum,
       const RenderSignalAnalyzer& render_signal_analyzer,
       const AecState& aec_state,
-      const std::vector<std::vector<std::vector<float>>>& render,
+      const Block& render,
       float* high_bands_gain,
       std::array<float, kFftLengthBy2Plus1>* low_band_gain);
 
@@ -61,7 +62,7 @@ class SuppressionGain {
           comfort_noise_spectrum,
       const absl::optional<int>& narrow_peak_band,
       bool saturated_echo,
-      const std::vector<std::vector<std::vector<float>>>& render,
+      const Block& render,
       const std::array<float, kFftLengthBy2Plus1>& low_band_gain) const;
 
   void GainToNoAudibleEcho(const std::array<float, kFftLengthBy2Plus1>& nearend,
@@ -89,7 +90,7 @@ class SuppressionGain {
 
   class LowNoiseRenderDetector {
    public:
-    bool Detect(const std::vector<std::vector<std::vector<float>>>& render);
+    bool Detect(const Block& render);
 
    private:
     float average_power_ = 32768.f * 32768.f;
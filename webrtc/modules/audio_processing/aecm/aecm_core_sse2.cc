@@ -0,0 +1,131 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_processing/aecm/aecm_core.h"
+
+#include <emmintrin.h>
+
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+
+namespace {
+
+// Multiplies the signed 16-bit values |a| by the unsigned 16-bit values |b|,
+// as WEBRTC_SPL_MUL_16_U16() does, and returns the 32-bit products of the four
+// lower values in |low| and of the four upper values in |high|.
+inline void MulS16U16(__m128i a, __m128i b, __m128i* low, __m128i* high) {
+  const __m128i low16 = _mm_mullo_epi16(a, b);
+  // The unsigned high half is corrected by |b| for negative values of |a|.
+  const __m128i high16 = _mm_sub_epi16(
+      _mm_mulhi_epu16(a, b), _mm_and_si128(_mm_srai_epi16(a, 15), b));
+  *low = _mm_unpacklo_epi16(low16, high16);
+  *high = _mm_unpackhi_epi16(low16, high16);
+}
+
+// Returns the sum of the four 32-bit values of |v|, modulo 2^32.
+inline uint32_t HorizontalSum(__m128i v) {
+  v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+  v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+  return static_cast<uint32_t>(_mm_cvtsi128_si32(v));
+}
+
+}  // namespace
+
+void WebRtcAecm_CalcLinearEnergiesSse2(AecmCore* aecm,
+                                       const uint16_t* far_spectrum,
+                                       int32_t* echo_est,
+                                       uint32_t* far_energy,
+                                       uint32_t* echo_energy_adapt,
+                                       uint32_t* echo_energy_stored) {
+  const __m128i zero = _mm_setzero_si128();
+  __m128i far_energy_4 = zero;
+  __m128i echo_energy_adapt_4 = zero;
+  __m128i echo_energy_stored_4 = zero;
+
+  // Get energy for the delayed far end signal and estimated
+  // echo using both stored and adapted channels. The sums wrap around as in
+  // the generic code, so their order does not matter.
+  for (int i = 0; i < PART_LEN; i += 8) {
+    const __m128i far = _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(&far_spectrum[i]));
+    const __m128i stored = _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(&aecm->channelStored[i]));
+    const __m128i adapt = _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(&aecm->channelAdapt16[i]));
+
+    __m128i echo_low, echo_high;
+    MulS16U16(stored, far, &echo_low, &echo_high);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&echo_est[i]), echo_low);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&echo_est[i + 4]), echo_high);
+    echo_energy_stored_4 = _mm_add_epi32(
+        echo_energy_stored_4, _mm_add_epi32(echo_low, echo_high));
+
+    __m128i adapt_low, adapt_high;
+    MulS16U16(adapt, far, &adapt_low, &adapt_high);
+    echo_energy_adapt_4 = _mm_add_epi32(echo_energy_adapt_4,
+                                        _mm_add_epi32(adapt_low, adapt_high));
+
+    far_energy_4 = _mm_add_epi32(
+        far_energy_4, _mm_add_epi32(_mm_unpacklo_epi16(far, zero),
+                                    _mm_unpackhi_epi16(far, zero)));
+  }
+
+  echo_est[PART_LEN] = WEBRTC_SPL_MUL_16_U16(aecm->channelStored[PART_LEN],
+                                             far_spectrum[PART_LEN]);
+  *far_energy += HorizontalSum(far_energy_4) + far_spectrum[PART_LEN];
+  *echo_energy_adapt += HorizontalSum(echo_energy_adapt_4) +
+                        aecm->channelAdapt16[PART_LEN] * far_spectrum[PART_LEN];
+  *echo_energy_stored +=
+      HorizontalSum(echo_energy_stored_4) + (uint32_t)echo_est[PART_LEN];
+}
+
+void WebRtcAecm_StoreAdaptiveChannelSse2(AecmCore* aecm,
+                                         const uint16_t* far_spectrum,
+                                         int32_t* echo_est) {
+  // During startup we store the channel every block, and recalculate the echo
+  // estimate.
+  for (int i = 0; i < PART_LEN; i += 8) {
+    const __m128i far = _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(&far_spectrum[i]));
+    const __m128i stored = _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(&aecm->channelAdapt16[i]));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&aecm->channelStored[i]),
+                     stored);
+    __m128i echo_low, echo_high;
+    MulS16U16(stored, far, &echo_low, &echo_high);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&echo_est[i]), echo_low);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&echo_est[i + 4]), echo_high);
+  }
+  aecm->channelStored[PART_LEN] = aecm->channelAdapt16[PART_LEN];
+  echo_est[PART_LEN] = WEBRTC_SPL_MUL_16_U16(aecm->channelStored[PART_LEN],
+                                             far_spectrum[PART_LEN]);
+}
+
+void WebRtcAecm_ResetAdaptiveChannelSse2(AecmCore* aecm) {
+  // The stored channel has a significantly lower MSE than the adaptive one for
+  // two consecutive calculations. Reset the adaptive channel, and restore the
+  // W32 channel.
+  const __m128i zero = _mm_setzero_si128();
+  for (int i = 0; i < PART_LEN; i += 8) {
+    const __m128i stored = _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(&aecm->channelStored[i]));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&aecm->channelAdapt16[i]),
+                     stored);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&aecm->channelAdapt32[i]),
+                     _mm_unpacklo_epi16(zero, stored));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&aecm->channelAdapt32[i + 4]),
+                     _mm_unpackhi_epi16(zero, stored));
+  }
+  aecm->channelAdapt16[PART_LEN] = aecm->channelStored[PART_LEN];
+  aecm->channelAdapt32[PART_LEN] = (int32_t)aecm->channelStored[PART_LEN] << 16;
+}
+
+}  // namespace webrtc
@@ -10,12 +10,15 @@
 
 #include "modules/audio_processing/agc/agc.h"
 
+#include <array>
 #include <cmath>
 #include <cstdlib>
 #include <vector>
 
+#include "common_audio/include/audio_util.h"
 #include "modules/audio_processing/agc/loudness_histogram.h"
 #include "modules/audio_processing/agc/utility.h"
+#include "modules/audio_processing/vad/vad_audio_proc_internal.h"
 #include "rtc_base/checks.h"
 
 namespace webrtc {
@@ -25,6 +28,38 @@ const int kDefaultLevelDbfs = -18;
 const int kNumAnalysisFrames = 100;
 const double kActivityThreshold = 0.3;
 
+// Longest 10 ms chunk, at 48 kHz.
+constexpr size_t kMaxChunkLength = 480;
+
+// Channel of a MultiChannelAgc.
+class ChannelAgc : public AgcAnalyzer {
+ public:
+  ChannelAgc(MultiChannelAgc* analysis, size_t channel)
+      : analysis_(analysis), channel_(channel) {}
+
+  void Process(const int16_t* audio,
+               size_t length,
+               int sample_rate_hz) override {}
+
+  bool GetRmsErrorDb(int* error) override {
+    if (!error) {
+      RTC_NOTREACHED();
+      return false;
+    }
+    return analysis_->GetRmsErrorDb(channel_, error);
+  }
+
+  void Reset() override { analysis_->Reset(channel_); }
+
+  float voice_probability() const override {
+    return analysis_->voice_probability();
+  }
+
+ private:
+  MultiChannelAgc* const analysis_;
+  const size_t channel_;
+};
+
 }  // namespace
 
 Agc::Agc()
@@ -91,4 +126,119 @@ float Agc::voice_probability() const {
   return vad_.last_voice_probability();
 }
 
+MultiChannelAgc::MultiChannelAgc(size_t num_channels)
+    : num_channels_(num_channels),
+      chunk_rms_(kMaxNumFrames * num_channels),
+      histogram_(num_channels, kNumAnalysisFrames) {
+  RTC_DCHECK_GT(num_channels, 0);
+  for (size_t ch = 0; ch < num_channels; ++ch) {
+    resamplers_.push_back(std::make_unique<Resampler>());
+    high_pass_filters_.emplace_back(PoleZeroFilter::Create(
+        kCoeffNumerator, kFilterOrder, kCoeffDenominator, kFilterOrder));
+  }
+}
+
+MultiChannelAgc::~MultiChannelAgc() = default;
+
+void MultiChannelAgc::Process(rtc::ArrayView<const float* const> audio,
+                              size_t length,
+                              int sample_rate_hz) {
+  RTC_DCHECK_EQ(audio.size(), num_channels_);
+  RTC_DCHECK_EQ(length, sample_rate_hz / 100);
+  RTC_DCHECK_LE(length, kMaxChunkLength);
+  RTC_DCHECK_LT(num_buffered_chunks_, kMaxNumFrames);
+
+  // Voice activity detection on the average of the channels.
+  std::array<int16_t, kMaxChunkLength> mix;
+  if (num_channels_ == 1) {
+    FloatS16ToS16(audio[0], length, mix.data());
+  } else {
+    const float scaling = 1.f / num_channels_;
+    for (size_t i = 0; i < length; ++i) {
+      float sum = 0.f;
+      for (size_t ch = 0; ch < num_channels_; ++ch) {
+        sum += audio[ch][i];
+      }
+      mix[i] = FloatS16ToS16(sum * scaling);
+    }
+  }
+  vad_.ProcessChunk(mix.data(), length, sample_rate_hz);
+
+  // RMS of each channel.
+  for (size_t ch = 0; ch < num_channels_; ++ch) {
+    std::array<int16_t, kMaxChunkLength> chunk;
+    const int16_t* chunk_ptr = mix.data();
+    if (num_channels_ > 1) {
+      FloatS16ToS16(audio[ch], length, chunk.data());
+      chunk_ptr = chunk.data();
+    }
+    int16_t resampled[kLength10Ms];
+    if (sample_rate_hz != kSampleRateHz) {
+      size_t resampled_length = length;
+      RTC_CHECK_EQ(
+          resamplers_[ch]->ResetIfNeeded(sample_rate_hz, kSampleRateHz, 1), 0);
+      resamplers_[ch]->Push(chunk_ptr, length, resampled, kLength10Ms,
+                            resampled_length);
+      RTC_DCHECK_EQ(resampled_length, kLength10Ms);
+      chunk_ptr = resampled;
+    }
+    float filtered[kLength10Ms];
+    high_pass_filters_[ch]->Filter(chunk_ptr, kLength10Ms, filtered);
+    double rms = 0;
+    for (size_t n = 0; n < kLength10Ms; ++n) {
+      rms += filtered[n] * filtered[n];
+    }
+    chunk_rms_[num_buffered_chunks_ * num_channels_ + ch] =
+        sqrt(rms / kLength10Ms);
+  }
+  ++num_buffered_chunks_;
+
+  // The voice probabilities come in batches, one for each buffered chunk.
+  const std::vector<double>& probabilities =
+      vad_.chunkwise_voice_probabilities();
+  if (probabilities.empty()) {
+    return;
+  }
+  RTC_DCHECK_EQ(probabilities.size(), num_buffered_chunks_);
+  for (size_t i = 0; i < probabilities.size(); ++i) {
+    histogram_.Update(rtc::ArrayView<const double>(
+                          &chunk_rms_[i * num_channels_], num_channels_),
+                      probabilities[i]);
+  }
+  num_buffered_chunks_ = 0;
+}
+
+std::unique_ptr<AgcAnalyzer> MultiChannelAgc::CreateChannelAgc(
+    size_t channel) {
+  RTC_DCHECK_LT(channel, num_channels_);
+  return std::make_unique<ChannelAgc>(this, channel);
+}
+
+bool MultiChannelAgc::GetRmsErrorDb(size_t channel, int* error) {
+  if (histogram_.num_updates(channel) < kNumAnalysisFrames) {
+    // We haven't yet received enough frames.
+    return false;
+  }
+
+  if (histogram_.AudioContent(channel) <
+      kNumAnalysisFrames * kActivityThreshold) {
+    // We are likely in an inactive segment.
+    return false;
+  }
+
+  double loudness = Linear2Loudness(histogram_.CurrentRms(channel));
+  *error = std::floor(
+      Loudness2Db(Dbfs2Loudness(kDefaultLevelDbfs) - loudness) + 0.5);
+  histogram_.Reset(channel);
+  return true;
+}
+
+void MultiChannelAgc::Reset(size_t channel) {
+  histogram_.Reset(channel);
+}
+
+float MultiChannelAgc::voice_probability() const {
+  return vad_.last_voice_probability();
+}
+
 }  // namespace webrtc
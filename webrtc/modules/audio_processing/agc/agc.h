@@ -11,32 +11,53 @@
 #ifndef MODULES_AUDIO_PROCESSING_AGC_AGC_H_
 #define MODULES_AUDIO_PROCESSING_AGC_AGC_H_
 
+#include <stddef.h>
+
 #include <memory>
+#include <vector>
 
+#include "api/array_view.h"
+#include "common_audio/resampler/include/resampler.h"
+#include "modules/audio_processing/agc/loudness_histogram.h"
+#include "modules/audio_processing/vad/pole_zero_filter.h"
 #include "modules/audio_processing/vad/voice_activity_detector.h"
 
 namespace webrtc {
 
-class LoudnessHistogram;
-
-class Agc {
+// Level analysis of a single channel, from which MonoAgc updates the gain.
+class AgcAnalyzer {
  public:
-  Agc();
-  virtual ~Agc();
+  virtual ~AgcAnalyzer() = default;
 
   // |audio| must be mono; in a multi-channel stream, provide the first (usually
   // left) channel.
-  virtual void Process(const int16_t* audio, size_t length, int sample_rate_hz);
+  virtual void Process(const int16_t* audio,
+                       size_t length,
+                       int sample_rate_hz) = 0;
 
   // Retrieves the difference between the target RMS level and the current
   // signal RMS level in dB. Returns true if an update is available and false
   // otherwise, in which case |error| should be ignored and no action taken.
-  virtual bool GetRmsErrorDb(int* error);
-  virtual void Reset();
+  virtual bool GetRmsErrorDb(int* error) = 0;
+  virtual void Reset() = 0;
+
+  virtual float voice_probability() const = 0;
+};
+
+class Agc : public AgcAnalyzer {
+ public:
+  Agc();
+  ~Agc() override;
+
+  void Process(const int16_t* audio,
+               size_t length,
+               int sample_rate_hz) override;
+  bool GetRmsErrorDb(int* error) override;
+  void Reset() override;
 
   virtual int set_target_level_dbfs(int level);
   virtual int target_level_dbfs() const;
-  virtual float voice_probability() const;
+  float voice_probability() const override;
 
  private:
   double target_level_loudness_;
@@ -46,6 +67,48 @@ class Agc {
   VoiceActivityDetector vad_;
 };
 
+// Analysis of Agc for several channels, where a single voice activity detector
+// runs on the average of the channels. Its voice probabilities are shared by
+// the loudness histograms of all the channels, which are updated with the RMS
+// level of each channel. With one channel, the analysis is the same as that of
+// Agc.
+class MultiChannelAgc {
+ public:
+  explicit MultiChannelAgc(size_t num_channels);
+  MultiChannelAgc(const MultiChannelAgc&) = delete;
+  MultiChannelAgc& operator=(const MultiChannelAgc&) = delete;
+  ~MultiChannelAgc();
+
+  // Analyzes 10 ms of each channel of |audio|, given in the FloatS16 domain.
+  void Process(rtc::ArrayView<const float* const> audio,
+               size_t length,
+               int sample_rate_hz);
+
+  // Returns an analyzer for |channel|, whose Process() does nothing since the
+  // audio is analyzed by Process(). It must not outlive this object.
+  std::unique_ptr<AgcAnalyzer> CreateChannelAgc(size_t channel);
+
+  // Same as the Agc methods, for |channel| and the default target level.
+  bool GetRmsErrorDb(size_t channel, int* error);
+  void Reset(size_t channel);
+  float voice_probability() const;
+
+  size_t num_channels() const { return num_channels_; }
+
+ private:
+  const size_t num_channels_;
+  VoiceActivityDetector vad_;
+  // Resampling to the rate of |vad_| and high-pass filtering of each channel,
+  // as |vad_| does before computing the RMS.
+  std::vector<std::unique_ptr<Resampler>> resamplers_;
+  std::vector<std::unique_ptr<PoleZeroFilter>> high_pass_filters_;
+  // RMS of the chunks not yet analyzed by |vad_|, with the values of the
+  // channels of a chunk stored together.
+  std::vector<double> chunk_rms_;
+  size_t num_buffered_chunks_ = 0;
+  MultiChannelLoudnessHistogram histogram_;
+};
+
 }  // namespace webrtc
 
 #endif  // MODULES_AUDIO_PROCESSING_AGC_AGC_H_
@@ -12,6 +12,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <utility>
 
 #include "common_audio/include/audio_util.h"
 #include "modules/audio_processing/agc/gain_control.h"
@@ -135,14 +136,14 @@ float ComputeClippedRatio(const float* const* audio,
 
 }  // namespace
 
-MonoAgc::MonoAgc(ApmDataDumper* data_dumper,
+MonoAgc::MonoAgc(std::unique_ptr<AgcAnalyzer> agc,
                  int startup_min_level,
                  int clipped_level_min,
-                 bool use_agc2_level_estimation,
                  bool disable_digital_adaptive,
                  int min_mic_level)
     : min_mic_level_(min_mic_level),
       disable_digital_adaptive_(disable_digital_adaptive),
+      agc_(std::move(agc)),
       max_level_(kMaxMicLevel),
       max_compression_gain_(kMaxCompressionGain),
       target_compression_(kDefaultCompressionGain),
@@ -150,11 +151,7 @@ MonoAgc::MonoAgc(ApmDataDumper* data_dumper,
       compression_accumulator_(compression_),
       startup_min_level_(ClampLevel(startup_min_level, min_mic_level_)),
       clipped_level_min_(clipped_level_min) {
-  if (use_agc2_level_estimation) {
-    agc_ = std::make_unique<AdaptiveModeLevelEstimatorAgc>(data_dumper);
-  } else {
-    agc_ = std::make_unique<Agc>();
-  }
+  RTC_DCHECK(agc_);
 }
 
 MonoAgc::~MonoAgc() = default;
@@ -440,12 +437,24 @@ AgcManagerDirect::AgcManagerDirect(int num_capture_channels,
       channel_agcs_(num_capture_channels),
       new_compressions_to_set_(num_capture_channels) {
   const int min_mic_level = GetMinMicLevel();
+  if (num_capture_channels > 1 && !use_agc2_level_estimation) {
+    multi_channel_agc_ =
+        std::make_unique<MultiChannelAgc>(num_capture_channels);
+  }
   for (size_t ch = 0; ch < channel_agcs_.size(); ++ch) {
     ApmDataDumper* data_dumper_ch = ch == 0 ? data_dumper_.get() : nullptr;
 
+    std::unique_ptr<AgcAnalyzer> agc;
+    if (multi_channel_agc_) {
+      agc = multi_channel_agc_->CreateChannelAgc(ch);
+    } else if (use_agc2_level_estimation) {
+      agc = std::make_unique<AdaptiveModeLevelEstimatorAgc>(data_dumper_ch);
+    } else {
+      agc = std::make_unique<Agc>();
+    }
     channel_agcs_[ch] = std::make_unique<MonoAgc>(
-        data_dumper_ch, startup_min_level, clipped_level_min,
-        use_agc2_level_estimation, disable_digital_adaptive_, min_mic_level);
+        std::move(agc), startup_min_level, clipped_level_min,
+        disable_digital_adaptive_, min_mic_level);
   }
   RTC_DCHECK_LT(0, channel_agcs_.size());
   channel_agcs_[0]->ActivateLogging();
@@ -518,12 +527,12 @@ void AgcManagerDirect::AnalyzePreProcess(const float* const* audio,
   if (clipped_ratio > kClippedRatioThreshold) {
     RTC_DLOG(LS_INFO) << "[agc] Clipping detected. clipped_ratio="
                       << clipped_ratio;
-    for (auto& state_ch : channel_agcs_) {
-      state_ch->HandleClipping();
+    for (size_t ch = 0; ch < channel_agcs_.size(); ++ch) {
+      channel_agcs_[ch]->HandleClipping();
+      AggregateChannelLevel(ch);
     }
     frames_since_clipped_ = 0;
   }
-  AggregateChannelLevels();
 }
 
 void AgcManagerDirect::Process(const AudioBuffer* audio) {
@@ -533,14 +542,24 @@ void AgcManagerDirect::Process(const AudioBuffer* audio) {
     return;
   }
 
+  if (multi_channel_agc_ && audio) {
+    multi_channel_agc_->Process(
+        rtc::ArrayView<const float* const>(
+            audio->split_channels_const_f(kBand0To8kHz), channel_agcs_.size()),
+        audio->num_frames_per_band(), sample_rate_hz_);
+  }
+
   for (size_t ch = 0; ch < channel_agcs_.size(); ++ch) {
     int16_t* audio_use = nullptr;
     std::array<int16_t, AudioBuffer::kMaxSampleRate / 100> audio_data;
     int num_frames_per_band;
     if (audio) {
-      FloatS16ToS16(audio->split_bands_const_f(ch)[0],
-                    audio->num_frames_per_band(), audio_data.data());
-      audio_use = audio_data.data();
+      // With a MultiChannelAgc, the audio has already been analyzed.
+      if (!multi_channel_agc_) {
+        FloatS16ToS16(audio->split_bands_const_f(ch)[0],
+                      audio->num_frames_per_band(), audio_data.data());
+        audio_use = audio_data.data();
+      }
       num_frames_per_band = audio->num_frames_per_band();
     } else {
       // Only used for testing.
@@ -549,9 +568,8 @@ void AgcManagerDirect::Process(const AudioBuffer* audio) {
     }
     channel_agcs_[ch]->Process(audio_use, num_frames_per_band, sample_rate_hz_);
     new_compressions_to_set_[ch] = channel_agcs_[ch]->new_compression();
+    AggregateChannelLevel(ch);
   }
-
-  AggregateChannelLevels();
 }
 
 absl::optional<int> AgcManagerDirect::GetDigitalComressionGain() {
@@ -583,24 +601,18 @@ void AgcManagerDirect::set_stream_analog_level(int level) {
 }
 
 void AgcManagerDirect::AggregateChannelLevels() {
-  stream_analog_level_ = channel_agcs_[0]->stream_analog_level();
-  channel_controlling_gain_ = 0;
-  if (use_min_channel_level_) {
-    for (size_t ch = 1; ch < channel_agcs_.size(); ++ch) {
-      int level = channel_agcs_[ch]->stream_analog_level();
-      if (level < stream_analog_level_) {
-        stream_analog_level_ = level;
-        channel_controlling_gain_ = static_cast<int>(ch);
-      }
-    }
-  } else {
-    for (size_t ch = 1; ch < channel_agcs_.size(); ++ch) {
-      int level = channel_agcs_[ch]->stream_analog_level();
-      if (level > stream_analog_level_) {
-        stream_analog_level_ = level;
-        channel_controlling_gain_ = static_cast<int>(ch);
-      }
-    }
+  for (size_t ch = 0; ch < channel_agcs_.size(); ++ch) {
+    AggregateChannelLevel(ch);
+  }
+}
+
+void AgcManagerDirect::AggregateChannelLevel(size_t channel) {
+  const int level = channel_agcs_[channel]->stream_analog_level();
+  if (channel == 0 ||
+      (use_min_channel_level_ ? level < stream_analog_level_
+                              : level > stream_analog_level_)) {
+    stream_analog_level_ = level;
+    channel_controlling_gain_ = static_cast<int>(channel);
   }
 }
 
@@ -84,6 +84,9 @@ class AgcManagerDirect final {
   void AnalyzePreProcess(const float* const* audio, size_t samples_per_channel);
 
   void AggregateChannelLevels();
+  // Folds the level of |channel| into the aggregated level, where channel 0
+  // starts a new aggregation.
+  void AggregateChannelLevel(size_t channel);
 
   std::unique_ptr<ApmDataDumper> data_dumper_;
   static int instance_counter_;
@@ -97,16 +100,18 @@ class AgcManagerDirect final {
   bool capture_muted_;
   int channel_controlling_gain_ = 0;
 
+  // Shared analysis of the channels, which is used with more than one channel
+  // unless the AGC2 level estimation is used.
+  std::unique_ptr<MultiChannelAgc> multi_channel_agc_;
   std::vector<std::unique_ptr<MonoAgc>> channel_agcs_;
   std::vector<absl::optional<int>> new_compressions_to_set_;
 };
 
 class MonoAgc {
  public:
-  MonoAgc(ApmDataDumper* data_dumper,
+  MonoAgc(std::unique_ptr<AgcAnalyzer> agc,
           int startup_min_level,
           int clipped_level_min,
-          bool use_agc2_level_estimation,
           bool disable_digital_adaptive,
           int min_mic_level);
   ~MonoAgc();
@@ -151,7 +156,7 @@ class MonoAgc {
 
   const int min_mic_level_;
   const bool disable_digital_adaptive_;
-  std::unique_ptr<Agc> agc_;
+  std::unique_ptr<AgcAnalyzer> agc_;
   int level_ = 0;
   int max_level_;
   int max_compression_gain_;
@@ -12,6 +12,10 @@
 
 #include <string.h>
 
+#include <algorithm>
+#include <cmath>
+
+#include "common_audio/include/audio_util.h"
 #include "modules/audio_processing/agc/legacy/gain_control.h"
 #include "rtc_base/checks.h"
 
@@ -61,6 +65,83 @@ static const int16_t kAvgDecayTime = 250;  // frames; < 3000
 #define AGC_SCALEDIFF32(A, B, C) \
   ((C) + ((B) >> 16) * (A) + (((0x0000FFFF & (B)) * (A)) >> 16))
 
+// Largest squared sample of a band, and largest squared output sample of the
+// limiter in the fixed-point version.
+constexpr float kMaxEnergy = 32768.f * 32768.f;
+constexpr float kMaxOutputEnergy = 32767.f * 32768.f;
+
+// Runs the near-end VAD and returns the decay factor of the slow envelope
+// follower (Q16).
+int16_t ComputeDecay(DigitalAgc* stt,
+                     const int16_t* in_near,
+                     size_t num_samples,
+                     int16_t lowlevelSignal) {
+  int32_t tmp32;
+  int16_t logratio;
+  int16_t lower_thr, upper_thr;
+  int16_t decay;
+
+  // VAD for near end
+  logratio = WebRtcAgc_ProcessVad(&stt->vadNearend, in_near, num_samples);
+
+  // Account for far end VAD
+  if (stt->vadFarend.counter > 10) {
+    tmp32 = 3 * logratio;
+    logratio = (int16_t)((tmp32 - stt->vadFarend.logRatio) >> 2);
+  }
+
+  // Determine decay factor depending on VAD
+  //  upper_thr = 1.0f;
+  //  lower_thr = 0.25f;
+  upper_thr = 1024;  // Q10
+  lower_thr = 0;     // Q10
+  if (logratio > upper_thr) {
+    // decay = -2^17 / DecayTime;  ->  -65
+    decay = -65;
+  } else if (logratio < lower_thr) {
+    decay = 0;
+  } else {
+    // decay = (int16_t)(((lower_thr - logratio)
+    //       * (2^27/(DecayTime*(upper_thr-lower_thr)))) >> 10);
+    // SUBSTITUTED: 2^27/(DecayTime*(upper_thr-lower_thr))  ->  65
+    tmp32 = (lower_thr - logratio) * 65;
+    decay = (int16_t)(tmp32 >> 10);
+  }
+
+  // adjust decay factor for long silence (detected as low standard deviation)
+  // This is only done in the adaptive modes
+  if (stt->agcMode != kAgcModeFixedDigital) {
+    if (stt->vadNearend.stdLongTerm < 4000) {
+      decay = 0;
+    } else if (stt->vadNearend.stdLongTerm < 8096) {
+      // decay = (int16_t)(((stt->vadNearend.stdLongTerm - 4000) * decay) >>
+      // 12);
+      tmp32 = (stt->vadNearend.stdLongTerm - 4000) * decay;
+      decay = (int16_t)(tmp32 >> 12);
+    }
+
+    if (lowlevelSignal != 0) {
+      decay = 0;
+    }
+  }
+  return decay;
+}
+
+// Splits |level| into the number of leading zeros of its 32-bit integer
+// representation and the fraction below its leading one, which the
+// fixed-point version computes with WebRtcSpl_NormU32().
+void NormalizeLevel(float level, int* zeros, float* frac) {
+  if (level < 1.f) {
+    *zeros = 31;
+    *frac = 0.f;
+    return;
+  }
+  int exponent;
+  const float mantissa = std::frexp(level, &exponent);
+  *zeros = 32 - exponent;
+  *frac = 2.f * mantissa - 1.f;
+}
+
 }  // namespace
 
 int32_t WebRtcAgc_CalculateGainTable(int32_t* gainTable,       // Q16
@@ -257,6 +338,10 @@ int32_t WebRtcAgc_InitDigital(DigitalAgc* stt, int16_t agcMode) {
   stt->gain = 65536;
   stt->gatePrevious = 0;
   stt->agcMode = agcMode;
+  stt->capacitorSlowFloat = stt->capacitorSlow;
+  stt->capacitorFastFloat = 0.f;
+  stt->gainFloat = 1.f;
+  stt->gatePreviousFloat = 0.f;
 
   // initialize VADs
   WebRtcAgc_InitVad(&stt->vadNearend);
@@ -287,8 +372,6 @@ int32_t WebRtcAgc_ComputeDigitalGains(DigitalAgc* stt,
   int32_t max_nrg;
   int32_t cur_level;
   int32_t gain32;
-  int16_t logratio;
-  int16_t lower_thr, upper_thr;
   int16_t zeros = 0, zeros_fast, frac = 0;
   int16_t decay;
   int16_t gate, gain_adj;
@@ -307,49 +390,8 @@ int32_t WebRtcAgc_ComputeDigitalGains(DigitalAgc* stt,
     return -1;
   }
 
-  // VAD for near end
-  logratio = WebRtcAgc_ProcessVad(&stt->vadNearend, in_near[0], L * 10);
-
-  // Account for far end VAD
-  if (stt->vadFarend.counter > 10) {
-    tmp32 = 3 * logratio;
-    logratio = (int16_t)((tmp32 - stt->vadFarend.logRatio) >> 2);
-  }
-
-  // Determine decay factor depending on VAD
-  //  upper_thr = 1.0f;
-  //  lower_thr = 0.25f;
-  upper_thr = 1024;  // Q10
-  lower_thr = 0;     // Q10
-  if (logratio > upper_thr) {
-    // decay = -2^17 / DecayTime;  ->  -65
-    decay = -65;
-  } else if (logratio < lower_thr) {
-    decay = 0;
-  } else {
-    // decay = (int16_t)(((lower_thr - logratio)
-    //       * (2^27/(DecayTime*(upper_thr-lower_thr)))) >> 10);
-    // SUBSTITUTED: 2^27/(DecayTime*(upper_thr-lower_thr))  ->  65
-    tmp32 = (lower_thr - logratio) * 65;
-    decay = (int16_t)(tmp32 >> 10);
-  }
-
-  // adjust decay factor for long silence (detected as low standard deviation)
-  // This is only done in the adaptive modes
-  if (stt->agcMode != kAgcModeFixedDigital) {
-    if (stt->vadNearend.stdLongTerm < 4000) {
-      decay = 0;
-    } else if (stt->vadNearend.stdLongTerm < 8096) {
-      // decay = (int16_t)(((stt->vadNearend.stdLongTerm - 4000) * decay) >>
-      // 12);
-      tmp32 = (stt->vadNearend.stdLongTerm - 4000) * decay;
-      decay = (int16_t)(tmp32 >> 12);
-    }
+  decay = ComputeDecay(stt, in_near[0], L * 10, lowlevelSignal);
 
-    if (lowlevelSignal != 0) {
-      decay = 0;
-    }
-  }
   // Find max amplitude per sub frame
   // iterate over sub frames
   for (k = 0; k < 10; k++) {
@@ -483,6 +525,106 @@ int32_t WebRtcAgc_ComputeDigitalGains(DigitalAgc* stt,
   return 0;
 }
 
+int32_t WebRtcAgc_ComputeDigitalGainsFloat(DigitalAgc* stt,
+                                           const float* in_near,
+                                           uint32_t FS,
+                                           int16_t lowlevelSignal,
+                                           float gains[11]) {
+  constexpr float kGainTableScaling = 1.f / 65536.f;
+  int16_t in_near_s16[160];
+  float env[10];
+  int zeros = 0;
+  float frac = 0.f;
+  size_t L;
+
+  // determine number of samples per ms
+  if (FS == 8000) {
+    L = 8;
+  } else if (FS == 16000 || FS == 32000 || FS == 48000) {
+    L = 16;
+  } else {
+    return -1;
+  }
+
+  FloatS16ToS16(in_near, L * 10, in_near_s16);
+  const float decay =
+      ComputeDecay(stt, in_near_s16, L * 10, lowlevelSignal) / 65536.f;
+
+  // Find max energy per sub frame
+  for (size_t k = 0; k < 10; ++k) {
+    float max_nrg = 0.f;
+    for (size_t n = 0; n < L; ++n) {
+      max_nrg = std::max(max_nrg, in_near[k * L + n] * in_near[k * L + n]);
+    }
+    env[k] = std::min(max_nrg, kMaxEnergy);
+  }
+
+  // Calculate gain per sub frame
+  const int32_t* gain_table = stt->gainTable;
+  gains[0] = stt->gainFloat;
+  for (size_t k = 0; k < 10; ++k) {
+    // Fast envelope follower, decay time 131 ms.
+    stt->capacitorFastFloat -= stt->capacitorFastFloat * (1000.f / 65536.f);
+    stt->capacitorFastFloat = std::max(stt->capacitorFastFloat, env[k]);
+    // Slow envelope follower
+    if (env[k] > stt->capacitorSlowFloat) {
+      stt->capacitorSlowFloat +=
+          (env[k] - stt->capacitorSlowFloat) * (500.f / 65536.f);
+    } else {
+      stt->capacitorSlowFloat += stt->capacitorSlowFloat * decay;
+    }
+
+    // Interpolate the gain table at the current level.
+    const float cur_level =
+        std::max(stt->capacitorFastFloat, stt->capacitorSlowFloat);
+    NormalizeLevel(cur_level, &zeros, &frac);
+    RTC_DCHECK_GT(zeros, 0);
+    gains[k + 1] = (gain_table[zeros] +
+                    (gain_table[zeros - 1] - gain_table[zeros]) * frac) *
+                   kGainTableScaling;
+  }
+
+  // Gate processing (lower gain during absence of speech), with the levels in
+  // the log2 domain in Q9 as in the fixed-point version.
+  int zeros_fast;
+  float frac_fast;
+  NormalizeLevel(stt->capacitorFastFloat, &zeros_fast, &frac_fast);
+  float gate = 1000.f + 512.f * ((zeros_fast - frac_fast) - (zeros - frac)) -
+               stt->vadNearend.stdShortTerm;
+  if (gate < 0.f) {
+    stt->gatePreviousFloat = 0.f;
+  } else {
+    gate = (gate + stt->gatePreviousFloat * 7.f) * 0.125f;
+    stt->gatePreviousFloat = gate;
+  }
+  // gate < 0     -> no gate
+  // gate > 2500  -> max gate
+  if (gate > 0.f) {
+    const float gain_adj = gate < 2500.f ? (2500.f - gate) / 32.f : 0.f;
+    const float min_gain = gain_table[0] * kGainTableScaling;
+    for (size_t k = 0; k < 10; ++k) {
+      gains[k + 1] =
+          min_gain + (gains[k + 1] - min_gain) * ((178.f + gain_adj) / 256.f);
+    }
+  }
+
+  // Limit gain to avoid overload distortion
+  for (size_t k = 0; k < 10; ++k) {
+    while (env[k] * gains[k + 1] * gains[k + 1] > kMaxOutputEnergy) {
+      // multiply by 253/256 ==> -0.1 dB
+      gains[k + 1] *= 253.f / 256.f;
+    }
+  }
+  // gain reductions should be done 1 ms earlier than gain increases
+  for (size_t k = 1; k < 10; ++k) {
+    gains[k] = std::min(gains[k], gains[k + 1]);
+  }
+  // save start gain for next frame
+  stt->gainFloat = gains[10];
+
+  return 0;
+}
+
 int32_t WebRtcAgc_ApplyDigitalGains(const int32_t gains[11],
                                     size_t num_bands,
                                     uint32_t FS,
@@ -37,6 +37,12 @@ typedef struct {
   int16_t agcMode;
   AgcVad vadNearend;
   AgcVad vadFarend;
+  // State of WebRtcAgc_ComputeDigitalGainsFloat(), in the same units as the
+  // fixed-point state but with a linear gain.
+  float capacitorSlowFloat;
+  float capacitorFastFloat;
+  float gainFloat;
+  float gatePreviousFloat;
 } DigitalAgc;
 
 int32_t WebRtcAgc_InitDigital(DigitalAgc* digitalAgcInst, int16_t agcMode);
@@ -48,6 +54,15 @@ int32_t WebRtcAgc_ComputeDigitalGains(DigitalAgc* digitalAgcInst,
                                       int16_t lowLevelSignal,
                                       int32_t gains[11]);
 
+// Floating point variant of WebRtcAgc_ComputeDigitalGains(), which reads the
+// lowest band |in_near| in the FloatS16 domain and produces linear |gains|.
+// Only the near-end VAD runs in fixed point, on a rounded copy of the band.
+int32_t WebRtcAgc_ComputeDigitalGainsFloat(DigitalAgc* digitalAgcInst,
+                                           const float* in_near,
+                                           uint32_t FS,
+                                           int16_t lowLevelSignal,
+                                           float gains[11]);
+
 int32_t WebRtcAgc_ApplyDigitalGains(const int32_t gains[11],
                                     size_t num_bands,
                                     uint32_t FS,
@@ -157,6 +157,26 @@ int WebRtcAgc_Analyze(void* agcInst,
                       uint8_t* saturationWarning,
                       int32_t gains[11]);
 
+/*
+ * Floating point variant of WebRtcAgc_Analyze(), which reads the near-end
+ * bands in the FloatS16 domain, e.g., as the split bands of an AudioBuffer, and
+ * produces linear gains. The gains match those of WebRtcAgc_Analyze() within
+ * the resolution of its fixed-point arithmetic, and are applied with a float
+ * gain applier rather than with WebRtcAgc_Process().
+ *
+ * Output:
+ *      - gains             : Vector of linear gains to apply for digital
+ *                            normalization
+ */
+int WebRtcAgc_AnalyzeFloat(void* agcInst,
+                           const float* const* inNear,
+                           size_t samples,
+                           int32_t inMicLevel,
+                           int32_t* outMicLevel,
+                           int16_t echo,
+                           uint8_t* saturationWarning,
+                           float gains[11]);
+
 /*
  * This function processes a 10 ms frame by applying precomputed digital gains.
  *
@@ -59,6 +59,51 @@ static const double kLowProbabilityThreshold = 0.2;
 static const int kLowProbThresholdQ10 =
     static_cast<int>(kLowProbabilityThreshold * kProbQDomain);
 
+static const int kNumHistBins =
+    sizeof(kHistBinCenters) / sizeof(kHistBinCenters[0]);
+
+// Finds the histogram bin associated with the given |rms|.
+static int ComputeBinIndex(double rms) {
+  // First exclude overload cases.
+  if (rms <= kHistBinCenters[0]) {
+    return 0;
+  } else if (rms >= kHistBinCenters[kNumHistBins - 1]) {
+    return kNumHistBins - 1;
+  } else {
+    // The quantizer is uniform in log domain. Alternatively we could do binary
+    // search in linear domain.
+    double rms_log = log(rms);
+
+    int index = static_cast<int>(
+        floor((rms_log - kLogDomainMinBinCenter) * kLogDomainStepSizeInverse));
+    // The final decision is in linear domain.
+    double b = 0.5 * (kHistBinCenters[index] + kHistBinCenters[index + 1]);
+    if (rms > b) {
+      return index + 1;
+    }
+    return index;
+  }
+}
+
+// Computes the mean of a histogram in loudness domain, where the count of bin
+// n is |bin_count_q10[n * stride]|.
+static double ComputeMeanRms(const int64_t* bin_count_q10,
+                             size_t stride,
+                             int64_t audio_content_q10) {
+  double p;
+  double mean_val = 0;
+  if (audio_content_q10 > 0) {
+    double p_total_inverse = 1. / static_cast<double>(audio_content_q10);
+    for (int n = 0; n < kNumHistBins; n++) {
+      p = static_cast<double>(bin_count_q10[n * stride]) * p_total_inverse;
+      mean_val += p * kHistBinCenters[n];
+    }
+  } else {
+    mean_val = kHistBinCenters[0];
+  }
+  return mean_val;
+}
+
 LoudnessHistogram::LoudnessHistogram()
     : num_updates_(0),
       audio_content_q10_(0),
@@ -190,40 +235,119 @@ void LoudnessHistogram::Reset() {
 }
 
 int LoudnessHistogram::GetBinIndex(double rms) {
-  // First exclude overload cases.
-  if (rms <= kHistBinCenters[0]) {
-    return 0;
-  } else if (rms >= kHistBinCenters[kHistSize - 1]) {
-    return kHistSize - 1;
-  } else {
-    // The quantizer is uniform in log domain. Alternatively we could do binary
-    // search in linear domain.
-    double rms_log = log(rms);
+  return ComputeBinIndex(rms);
+}
 
-    int index = static_cast<int>(
-        floor((rms_log - kLogDomainMinBinCenter) * kLogDomainStepSizeInverse));
-    // The final decision is in linear domain.
-    double b = 0.5 * (kHistBinCenters[index] + kHistBinCenters[index + 1]);
-    if (rms > b) {
-      return index + 1;
+double LoudnessHistogram::CurrentRms() const {
+  return ComputeMeanRms(bin_count_q10_, 1, audio_content_q10_);
+}
+
+MultiChannelLoudnessHistogram::MultiChannelLoudnessHistogram(
+    size_t num_channels,
+    int window_size)
+    : num_channels_(num_channels),
+      len_circular_buffer_(window_size),
+      num_updates_(num_channels, 0),
+      audio_content_q10_(num_channels, 0),
+      buffer_index_(num_channels, 0),
+      buffer_is_full_(num_channels, false),
+      len_high_activity_(num_channels, 0),
+      bin_count_q10_(kNumHistBins * num_channels, 0),
+      activity_probability_(window_size * num_channels, 0),
+      hist_bin_index_(window_size * num_channels, 0) {
+  RTC_DCHECK_GT(window_size, 0);
+}
+
+MultiChannelLoudnessHistogram::~MultiChannelLoudnessHistogram() = default;
+
+void MultiChannelLoudnessHistogram::Update(rtc::ArrayView<const double> rms,
+                                           double activity_probability) {
+  RTC_DCHECK_EQ(rms.size(), num_channels_);
+  // To Q10 domain.
+  const int prob_q10 =
+      static_cast<int16_t>(floor(activity_probability * kProbQDomain));
+  for (size_t ch = 0; ch < num_channels_; ++ch) {
+    // Remove the oldest entry if the circular buffer is full.
+    if (buffer_is_full_[ch]) {
+      const size_t oldest = buffer_index_[ch] * num_channels_ + ch;
+      UpdateHist(ch, -activity_probability_[oldest], hist_bin_index_[oldest]);
     }
-    return index;
+
+    int activity_prob_q10 = prob_q10;
+    // Removing transient.
+    if (activity_prob_q10 <= kLowProbThresholdQ10) {
+      // Lower than threshold probability, set it to zero.
+      activity_prob_q10 = 0;
+      // Check if this has been a transient.
+      if (len_high_activity_[ch] <= kTransientWidthThreshold)
+        RemoveTransient(ch);  // Remove this transient.
+      len_high_activity_[ch] = 0;
+    } else if (len_high_activity_[ch] <= kTransientWidthThreshold) {
+      len_high_activity_[ch]++;
+    }
+    // Updating the circular buffer.
+    const int hist_index = ComputeBinIndex(rms[ch]);
+    const size_t newest = buffer_index_[ch] * num_channels_ + ch;
+    activity_probability_[newest] = activity_prob_q10;
+    hist_bin_index_[newest] = hist_index;
+    // Increment the buffer index and check for wrap-around.
+    buffer_index_[ch]++;
+    if (buffer_index_[ch] >= len_circular_buffer_) {
+      buffer_index_[ch] = 0;
+      buffer_is_full_[ch] = true;
+    }
+
+    num_updates_[ch]++;
+    if (num_updates_[ch] < 0)
+      num_updates_[ch]--;
+
+    UpdateHist(ch, activity_prob_q10, hist_index);
   }
 }
 
-double LoudnessHistogram::CurrentRms() const {
-  double p;
-  double mean_val = 0;
-  if (audio_content_q10_ > 0) {
-    double p_total_inverse = 1. / static_cast<double>(audio_content_q10_);
-    for (int n = 0; n < kHistSize; n++) {
-      p = static_cast<double>(bin_count_q10_[n]) * p_total_inverse;
-      mean_val += p * kHistBinCenters[n];
-    }
-  } else {
-    mean_val = kHistBinCenters[0];
+void MultiChannelLoudnessHistogram::Reset(size_t channel) {
+  RTC_DCHECK_LT(channel, num_channels_);
+  for (int n = 0; n < kNumHistBins; ++n) {
+    bin_count_q10_[n * num_channels_ + channel] = 0;
+  }
+  audio_content_q10_[channel] = 0;
+  num_updates_[channel] = 0;
+  buffer_index_[channel] = 0;
+  buffer_is_full_[channel] = false;
+  len_high_activity_[channel] = 0;
+}
+
+double MultiChannelLoudnessHistogram::CurrentRms(size_t channel) const {
+  RTC_DCHECK_LT(channel, num_channels_);
+  return ComputeMeanRms(&bin_count_q10_[channel], num_channels_,
+                        audio_content_q10_[channel]);
+}
+
+double MultiChannelLoudnessHistogram::AudioContent(size_t channel) const {
+  RTC_DCHECK_LT(channel, num_channels_);
+  return audio_content_q10_[channel] / kProbQDomain;
+}
+
+void MultiChannelLoudnessHistogram::UpdateHist(size_t channel,
+                                               int activity_prob_q10,
+                                               int hist_index) {
+  bin_count_q10_[hist_index * num_channels_ + channel] += activity_prob_q10;
+  audio_content_q10_[channel] += activity_prob_q10;
+}
+
+void MultiChannelLoudnessHistogram::RemoveTransient(size_t channel) {
+  // Don't expect to be here if high-activity region is longer than
+  // |kTransientWidthThreshold| or there has not been any transient.
+  RTC_DCHECK_LE(len_high_activity_[channel], kTransientWidthThreshold);
+  int index = (buffer_index_[channel] > 0) ? (buffer_index_[channel] - 1)
+                                           : len_circular_buffer_ - 1;
+  while (len_high_activity_[channel] > 0) {
+    const size_t entry = index * num_channels_ + channel;
+    UpdateHist(channel, -activity_probability_[entry], hist_bin_index_[entry]);
+    activity_probability_[entry] = 0;
+    index = (index > 0) ? (index - 1) : (len_circular_buffer_ - 1);
+    len_high_activity_[channel]--;
   }
-  return mean_val;
 }
 
 }  // namespace webrtc
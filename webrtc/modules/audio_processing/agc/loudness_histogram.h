@@ -11,9 +11,13 @@
 #ifndef MODULES_AUDIO_PROCESSING_AGC_LOUDNESS_HISTOGRAM_H_
 #define MODULES_AUDIO_PROCESSING_AGC_LOUDNESS_HISTOGRAM_H_
 
+#include <stddef.h>
 #include <stdint.h>
 
 #include <memory>
+#include <vector>
+
+#include "api/array_view.h"
 
 namespace webrtc {
 
@@ -85,6 +89,53 @@ class LoudnessHistogram {
   int len_high_activity_;
 };
 
+// Sliding LoudnessHistograms of several channels, which are updated together
+// with one activity probability shared by the channels. The state is stored as
+// a structure of arrays indexed by channel, such that an update is one pass
+// over contiguous memory. Each channel behaves as a LoudnessHistogram with the
+// same window size, and may be reset on its own.
+class MultiChannelLoudnessHistogram {
+ public:
+  MultiChannelLoudnessHistogram(size_t num_channels, int window_size);
+  MultiChannelLoudnessHistogram(const MultiChannelLoudnessHistogram&) = delete;
+  MultiChannelLoudnessHistogram& operator=(
+      const MultiChannelLoudnessHistogram&) = delete;
+  ~MultiChannelLoudnessHistogram();
+
+  // Inserts the RMS of each channel with the activity probability.
+  void Update(rtc::ArrayView<const double> rms, double activity_probability);
+
+  // Resets the histogram of |channel|.
+  void Reset(size_t channel);
+
+  // Same as the LoudnessHistogram methods, for |channel|.
+  double CurrentRms(size_t channel) const;
+  double AudioContent(size_t channel) const;
+  int num_updates(size_t channel) const { return num_updates_[channel]; }
+
+  size_t num_channels() const { return num_channels_; }
+
+ private:
+  void UpdateHist(size_t channel, int activity_prob_q10, int hist_index);
+  void RemoveTransient(size_t channel);
+
+  const size_t num_channels_;
+  const int len_circular_buffer_;
+
+  // Per-channel state, see LoudnessHistogram.
+  std::vector<int> num_updates_;
+  std::vector<int64_t> audio_content_q10_;
+  std::vector<int> buffer_index_;
+  std::vector<int> buffer_is_full_;
+  std::vector<int> len_high_activity_;
+
+  // Bin counts and circular buffers, with the values of the channels of a bin
+  // or a buffer position stored together.
+  std::vector<int64_t> bin_count_q10_;
+  std::vector<int> activity_probability_;
+  std::vector<int> hist_bin_index_;
+};
+
 }  // namespace webrtc
 
 #endif  // MODULES_AUDIO_PROCESSING_AGC_LOUDNESS_HISTOGRAM_H_
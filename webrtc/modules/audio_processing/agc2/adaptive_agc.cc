@@ -11,6 +11,8 @@
 #include "modules/audio_processing/agc2/adaptive_agc.h"
 
 #include "common_audio/include/audio_util.h"
+#include "modules/audio_processing/agc2/agc2_common.h"
+#include "modules/audio_processing/agc2/state_snapshot.h"
 #include "modules/audio_processing/agc2/vad_with_level.h"
 #include "modules/audio_processing/logging/apm_data_dumper.h"
 #include "rtc_base/checks.h"
@@ -19,6 +21,11 @@
 namespace webrtc {
 namespace {
 
+// Sample rate and number of channels of the loudness meter until the first
+// frame is analyzed.
+constexpr int kInitialLoudnessMeterSampleRateHz = 48000;
+constexpr size_t kInitialLoudnessMeterNumChannels = 1;
+
 void DumpDebugData(const AdaptiveDigitalGainApplier::FrameInfo& info,
                    ApmDataDumper& dumper) {
   dumper.DumpRaw("agc2_vad_probability", info.vad_result.speech_probability);
@@ -47,13 +54,19 @@ AdaptiveAgc::AdaptiveAgc(ApmDataDumper* apm_data_dumper,
               .level_estimator_adjacent_speech_frames_threshold,
           config.adaptive_digital.initial_saturation_margin_db,
           config.adaptive_digital.extra_saturation_margin_db),
-      vad_(config.adaptive_digital.vad_probability_attack),
+      vad_(config.adaptive_digital.vad_probability_attack,
+           config.adaptive_digital.vad_backend),
       gain_applier_(apm_data_dumper,
                     config.adaptive_digital
                         .gain_applier_adjacent_speech_frames_threshold),
       apm_data_dumper_(apm_data_dumper),
       noise_level_estimator_(apm_data_dumper) {
   RTC_DCHECK(apm_data_dumper);
+  if (config.adaptive_digital.level_estimator ==
+      AudioProcessing::Config::GainController2::LevelEstimator::kLoudness) {
+    loudness_meter_.reset(new LoudnessMeter(kInitialLoudnessMeterSampleRateHz,
+                                            kInitialLoudnessMeterNumChannels));
+  }
   if (!config.adaptive_digital.use_saturation_protector) {
     RTC_LOG(LS_WARNING) << "The saturation protector cannot be disabled.";
   }
@@ -61,21 +74,68 @@ AdaptiveAgc::AdaptiveAgc(ApmDataDumper* apm_data_dumper,
 
 AdaptiveAgc::~AdaptiveAgc() = default;
 
-void AdaptiveAgc::Process(AudioFrameView<float> frame, float limiter_envelope) {
+rtc::ArrayView<const float> AdaptiveAgc::Analyze(
+    AudioFrameView<const float> frame,
+    const FrameStats& stats,
+    float limiter_envelope) {
   AdaptiveDigitalGainApplier::FrameInfo info;
-  info.vad_result = vad_.AnalyzeFrame(frame);
-  speech_level_estimator_.Update(info.vad_result);
+  info.vad_result = vad_.AnalyzeFrame(frame, stats);
+  if (loudness_meter_) {
+    const int sample_rate_hz = static_cast<int>(
+        frame.samples_per_channel() * 1000 / kFrameDurationMs);
+    if (sample_rate_hz != loudness_meter_->sample_rate_hz() ||
+        frame.num_channels() != loudness_meter_->num_channels()) {
+      loudness_meter_->Initialize(sample_rate_hz, frame.num_channels());
+    }
+    loudness_meter_->Analyze(frame);
+    apm_data_dumper_->DumpRaw("agc2_momentary_loudness_lufs",
+                              loudness_meter_->momentary_loudness());
+  }
+  if (loudness_meter_ && loudness_meter_->has_loudness()) {
+    VadLevelAnalyzer::Result level = info.vad_result;
+    level.rms_dbfs = loudness_meter_->momentary_loudness();
+    speech_level_estimator_.Update(level);
+  } else {
+    speech_level_estimator_.Update(info.vad_result);
+  }
   info.input_level_dbfs = speech_level_estimator_.level_dbfs();
-  info.input_noise_level_dbfs = noise_level_estimator_.Analyze(frame);
+  info.input_noise_level_dbfs = noise_level_estimator_.Analyze(frame, stats);
   info.limiter_envelope_dbfs =
       limiter_envelope > 0 ? FloatS16ToDbfs(limiter_envelope) : -90.f;
   info.estimate_is_confident = speech_level_estimator_.IsConfident();
   DumpDebugData(info, *apm_data_dumper_);
-  gain_applier_.Process(info, frame);
+  return gain_applier_.ComputeGains(info, frame.samples_per_channel());
+}
+
+void AdaptiveAgc::HandleInputGainChange() {
+  speech_level_estimator_.Reset();
+  if (loudness_meter_) {
+    loudness_meter_->Reset();
+  }
 }
 
 void AdaptiveAgc::Reset() {
   speech_level_estimator_.Reset();
+  if (loudness_meter_) {
+    loudness_meter_->Reset();
+  }
+  vad_.Reset();
+  gain_applier_.Reset();
+  noise_level_estimator_.Reset();
+}
+
+void AdaptiveAgc::SaveState(StateSnapshotWriter* writer) const {
+  speech_level_estimator_.SaveState(writer);
+  vad_.SaveState(writer);
+  gain_applier_.SaveState(writer);
+  noise_level_estimator_.SaveState(writer);
+}
+
+void AdaptiveAgc::RestoreState(StateSnapshotReader* reader) {
+  speech_level_estimator_.RestoreState(reader);
+  vad_.RestoreState(reader);
+  gain_applier_.RestoreState(reader);
+  noise_level_estimator_.RestoreState(reader);
 }
 
 }  // namespace webrtc
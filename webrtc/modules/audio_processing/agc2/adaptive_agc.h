@@ -11,8 +11,12 @@
 #ifndef MODULES_AUDIO_PROCESSING_AGC2_ADAPTIVE_AGC_H_
 #define MODULES_AUDIO_PROCESSING_AGC2_ADAPTIVE_AGC_H_
 
+#include <memory>
+
+#include "api/array_view.h"
 #include "modules/audio_processing/agc2/adaptive_digital_gain_applier.h"
 #include "modules/audio_processing/agc2/adaptive_mode_level_estimator.h"
+#include "modules/audio_processing/agc2/loudness_meter.h"
 #include "modules/audio_processing/agc2/noise_level_estimator.h"
 #include "modules/audio_processing/agc2/vad_with_level.h"
 #include "modules/audio_processing/include/audio_frame_view.h"
@@ -20,6 +24,9 @@
 
 namespace webrtc {
 class ApmDataDumper;
+struct FrameStats;
+class StateSnapshotReader;
+class StateSnapshotWriter;
 
 // Adaptive digital gain controller.
 // TODO(crbug.com/webrtc/7494): Unify with `AdaptiveDigitalGainApplier`.
@@ -30,14 +37,34 @@ class AdaptiveAgc {
               const AudioProcessing::Config::GainController2& config);
   ~AdaptiveAgc();
 
-  // Analyzes `frame` and applies a digital adaptive gain to it. Takes into
-  // account the envelope measured by the limiter.
+  // Analyzes `frame` and returns the digital adaptive gain to apply to each of
+  // its samples, or an empty view if the frame is to be left unchanged. The
+  // view is valid until the next call. Takes into account the envelope
+  // measured by the limiter. `stats` must have been computed for `frame`.
   // TODO(crbug.com/webrtc/7494): Make the class depend on the limiter.
-  void Process(AudioFrameView<float> frame, float limiter_envelope);
+  rtc::ArrayView<const float> Analyze(AudioFrameView<const float> frame,
+                                      const FrameStats& stats,
+                                      float limiter_envelope);
+  // Resets the speech level estimate after a change of the input gain.
+  void HandleInputGainChange();
+  // Resets the complete state to that of a newly created instance without
+  // allocating memory.
   void Reset();
 
+  // Linear adaptive gain applied at the end of the last frame.
+  float GetGainFactor() const { return gain_applier_.GetGainFactor(); }
+
+  // Writes the state of the level estimators, the VAD and the gain applier
+  // into `writer`.
+  void SaveState(StateSnapshotWriter* writer) const;
+  // Restores the state written by `SaveState()`.
+  void RestoreState(StateSnapshotReader* reader);
+
  private:
   AdaptiveModeLevelEstimator speech_level_estimator_;
+  // Measures the level passed to `speech_level_estimator_` when it estimates
+  // the speech loudness, null otherwise.
+  std::unique_ptr<LoudnessMeter> loudness_meter_;
   VadLevelAnalyzer vad_;
   AdaptiveDigitalGainApplier gain_applier_;
   ApmDataDumper* const apm_data_dumper_;
@@ -14,6 +14,7 @@
 
 #include "common_audio/include/audio_util.h"
 #include "modules/audio_processing/agc2/agc2_common.h"
+#include "modules/audio_processing/agc2/state_snapshot.h"
 #include "modules/audio_processing/logging/apm_data_dumper.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/numerics/safe_minmax.h"
@@ -106,11 +107,16 @@ AdaptiveDigitalGainApplier::AdaptiveDigitalGainApplier(
   RTC_DCHECK_GE(frames_to_gain_increase_allowed_, 1);
 }
 
-void AdaptiveDigitalGainApplier::Process(const FrameInfo& info,
-                                         AudioFrameView<float> frame) {
+rtc::ArrayView<const float> AdaptiveDigitalGainApplier::ComputeGains(
+    const FrameInfo& info,
+    size_t samples_per_channel) {
+  RTC_DCHECK_GE(samples_per_channel, 1);
+  UpdateGain(info);
+  return gain_applier_.ComputeGains(samples_per_channel);
+}
+
+void AdaptiveDigitalGainApplier::UpdateGain(const FrameInfo& info) {
   RTC_DCHECK_GE(info.input_level_dbfs, -150.f);
-  RTC_DCHECK_GE(frame.num_channels(), 1);
-  RTC_DCHECK_GE(frame.samples_per_channel(), 1);
 
   // Log every second.
   calls_since_last_gain_log_++;
@@ -150,10 +156,32 @@ void AdaptiveDigitalGainApplier::Process(const FrameInfo& info,
     gain_applier_.SetGainFactor(
         DbToRatio(last_gain_db_ + gain_change_this_frame_db));
   }
-  gain_applier_.ApplyGain(frame);
 
   // Remember that the gain has changed for the next iteration.
   last_gain_db_ = last_gain_db_ + gain_change_this_frame_db;
   apm_data_dumper_->DumpRaw("agc2_applied_gain_db", last_gain_db_);
 }
+
+void AdaptiveDigitalGainApplier::Reset() {
+  gain_applier_.Reset(DbToRatio(kInitialAdaptiveDigitalGainDb));
+  calls_since_last_gain_log_ = 0;
+  frames_to_gain_increase_allowed_ = adjacent_speech_frames_threshold_;
+  last_gain_db_ = kInitialAdaptiveDigitalGainDb;
+}
+
+void AdaptiveDigitalGainApplier::SaveState(StateSnapshotWriter* writer) const {
+  gain_applier_.SaveState(writer);
+  writer->Write(calls_since_last_gain_log_);
+  writer->Write(frames_to_gain_increase_allowed_);
+  writer->Write(last_gain_db_);
+}
+
+void AdaptiveDigitalGainApplier::RestoreState(StateSnapshotReader* reader) {
+  // The target gain is within [0, kMaxGainDb] and the gain moves towards it.
+  gain_applier_.RestoreState(reader, DbToRatio(0.f), DbToRatio(kMaxGainDb));
+  reader->ReadInRange(&calls_since_last_gain_log_, 0, 99);
+  reader->ReadInRange(&frames_to_gain_increase_allowed_, 0,
+                      adjacent_speech_frames_threshold_);
+  reader->ReadInRange(&last_gain_db_, 0.f, kMaxGainDb);
+}
 }  // namespace webrtc
@@ -11,13 +11,15 @@
 #ifndef MODULES_AUDIO_PROCESSING_AGC2_ADAPTIVE_DIGITAL_GAIN_APPLIER_H_
 #define MODULES_AUDIO_PROCESSING_AGC2_ADAPTIVE_DIGITAL_GAIN_APPLIER_H_
 
+#include "api/array_view.h"
 #include "modules/audio_processing/agc2/gain_applier.h"
 #include "modules/audio_processing/agc2/vad_with_level.h"
-#include "modules/audio_processing/include/audio_frame_view.h"
 
 namespace webrtc {
 
 class ApmDataDumper;
+class StateSnapshotReader;
+class StateSnapshotWriter;
 
 // Part of the adaptive digital controller that applies a digital adaptive gain.
 // The gain is updated towards a target. The logic decides when gain updates are
@@ -43,10 +45,27 @@ class AdaptiveDigitalGainApplier {
   AdaptiveDigitalGainApplier& operator=(const AdaptiveDigitalGainApplier&) =
       delete;
 
-  // Analyzes `info`, updates the digital gain and applies it to `frame`.
-  void Process(const FrameInfo& info, AudioFrameView<float> frame);
+  // Writes the adaptation state into `writer`.
+  void SaveState(StateSnapshotWriter* writer) const;
+  // Restores the adaptation state written by `SaveState()`.
+  void RestoreState(StateSnapshotReader* reader);
+
+  // Analyzes `info`, updates the digital gain and returns the gain to apply to
+  // each sample of a frame with `samples_per_channel` samples per channel.
+  // Returns an empty view if the frame is to be left unchanged.
+  rtc::ArrayView<const float> ComputeGains(const FrameInfo& info,
+                                           size_t samples_per_channel);
+
+  // Resets the gain to its initial value.
+  void Reset();
+
+  // Linear gain applied at the end of the last frame.
+  float GetGainFactor() const { return gain_applier_.GetGainFactor(); }
 
  private:
+  // Updates the gain of `gain_applier_` for the frame described by `info`.
+  void UpdateGain(const FrameInfo& info);
+
   ApmDataDumper* const apm_data_dumper_;
   GainApplier gain_applier_;
 
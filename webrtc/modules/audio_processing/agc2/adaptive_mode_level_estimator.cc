@@ -10,7 +10,10 @@
 
 #include "modules/audio_processing/agc2/adaptive_mode_level_estimator.h"
 
+#include <limits>
+
 #include "modules/audio_processing/agc2/agc2_common.h"
+#include "modules/audio_processing/agc2/state_snapshot.h"
 #include "modules/audio_processing/logging/apm_data_dumper.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/logging.h"
@@ -22,13 +25,19 @@ namespace {
 using LevelEstimatorType =
     AudioProcessing::Config::GainController2::LevelEstimator;
 
+// Range of the level estimate and of the levels of the analyzed frames.
+constexpr float kMinLevelEstimateDbfs = -90.f;
+constexpr float kMaxLevelEstimateDbfs = 30.f;
+constexpr float kMinFrameLevelDbfs = -150.f;
+constexpr float kMaxFrameLevelDbfs = 50.f;
+
 // Combines a level estimation with the saturation protector margins.
 float ComputeLevelEstimateDbfs(float level_estimate_dbfs,
                                float saturation_margin_db,
                                float extra_saturation_margin_db) {
   return rtc::SafeClamp<float>(
       level_estimate_dbfs + saturation_margin_db + extra_saturation_margin_db,
-      -90.f, 30.f);
+      kMinLevelEstimateDbfs, kMaxLevelEstimateDbfs);
 }
 
 // Returns the level of given type from `vad_level`.
@@ -41,6 +50,10 @@ float GetLevel(const VadLevelAnalyzer::Result& vad_level,
     case LevelEstimatorType::kPeak:
       return vad_level.peak_dbfs;
       break;
+    case LevelEstimatorType::kLoudness:
+      // The caller replaces the RMS level with the loudness.
+      return vad_level.rms_dbfs;
+      break;
   }
 }
 
@@ -89,10 +102,10 @@ AdaptiveModeLevelEstimator::AdaptiveModeLevelEstimator(
 
 void AdaptiveModeLevelEstimator::Update(
     const VadLevelAnalyzer::Result& vad_level) {
-  RTC_DCHECK_GT(vad_level.rms_dbfs, -150.f);
-  RTC_DCHECK_LT(vad_level.rms_dbfs, 50.f);
-  RTC_DCHECK_GT(vad_level.peak_dbfs, -150.f);
-  RTC_DCHECK_LT(vad_level.peak_dbfs, 50.f);
+  RTC_DCHECK_GT(vad_level.rms_dbfs, kMinFrameLevelDbfs);
+  RTC_DCHECK_LT(vad_level.rms_dbfs, kMaxFrameLevelDbfs);
+  RTC_DCHECK_GT(vad_level.peak_dbfs, kMinFrameLevelDbfs);
+  RTC_DCHECK_LT(vad_level.peak_dbfs, kMaxFrameLevelDbfs);
   RTC_DCHECK_GE(vad_level.speech_probability, 0.f);
   RTC_DCHECK_LE(vad_level.speech_probability, 1.f);
   DumpDebugData();
@@ -174,6 +187,42 @@ void AdaptiveModeLevelEstimator::Reset() {
   num_adjacent_speech_frames_ = 0;
 }
 
+void AdaptiveModeLevelEstimator::SaveState(StateSnapshotWriter* writer) const {
+  for (const LevelEstimatorState* state : {&preliminary_state_,
+                                           &reliable_state_}) {
+    writer->Write(state->time_to_full_buffer_ms);
+    writer->Write(state->level_dbfs.numerator);
+    writer->Write(state->level_dbfs.denominator);
+    SaveSaturationProtectorState(state->saturation_protector, writer);
+  }
+  writer->Write(level_dbfs_);
+  writer->Write(num_adjacent_speech_frames_);
+}
+
+void AdaptiveModeLevelEstimator::RestoreState(StateSnapshotReader* reader) {
+  for (LevelEstimatorState* state : {&preliminary_state_, &reliable_state_}) {
+    reader->ReadInRange(&state->time_to_full_buffer_ms, 0,
+                        static_cast<int>(kFullBufferSizeMs));
+    // The level is a weighted average of frame levels.
+    reader->ReadFinite(&state->level_dbfs.numerator);
+    reader->ReadInRange(&state->level_dbfs.denominator, 0.f,
+                        std::numeric_limits<float>::max());
+    if (reader->ok() && state->level_dbfs.denominator > 0.f) {
+      const float level_dbfs = state->level_dbfs.GetRatio();
+      if (!(level_dbfs >= kMinFrameLevelDbfs &&
+            level_dbfs <= kMaxFrameLevelDbfs)) {
+        reader->SetFailed();
+      }
+    }
+    RestoreSaturationProtectorState(reader, initial_saturation_margin_db_,
+                                    state->saturation_protector);
+  }
+  reader->ReadInRange(&level_dbfs_, kMinLevelEstimateDbfs,
+                      kMaxLevelEstimateDbfs);
+  reader->ReadInRange(&num_adjacent_speech_frames_, 0,
+                      std::numeric_limits<int>::max());
+}
+
 void AdaptiveModeLevelEstimator::ResetLevelEstimatorState(
     LevelEstimatorState& state) const {
   state.time_to_full_buffer_ms = kFullBufferSizeMs;
@@ -21,6 +21,8 @@
 
 namespace webrtc {
 class ApmDataDumper;
+class StateSnapshotReader;
+class StateSnapshotWriter;
 
 // Level estimator for the digital adaptive gain controller.
 class AdaptiveModeLevelEstimator {
@@ -45,6 +47,11 @@ class AdaptiveModeLevelEstimator {
 
   void Reset();
 
+  // Writes the adaptation state into `writer`.
+  void SaveState(StateSnapshotWriter* writer) const;
+  // Restores the adaptation state written by `SaveState()`.
+  void RestoreState(StateSnapshotReader* reader);
+
  private:
   // Part of the level estimator state used for check-pointing and restore ops.
   struct LevelEstimatorState {
@@ -19,6 +19,12 @@ constexpr float kMinFloatS16Value = -32768.f;
 constexpr float kMaxFloatS16Value = 32767.f;
 constexpr float kMaxAbsFloatS16Value = 32768.0f;
 
+// The adaptive digital controller analyzes the samples after the fixed digital
+// gain, which is below 50 dB.
+constexpr float kMaxFixedDigitalGainDb = 50.f;
+constexpr float kMaxAbsAnalyzedSampleValue =
+    kMaxAbsFloatS16Value * 316.2278f;  // 50 dB.
+
 constexpr size_t kFrameDurationMs = 10;
 constexpr size_t kSubFramesInFrame = 20;
 constexpr size_t kMaximalNumberOfSamplesPerChannel = 480;
@@ -12,6 +12,8 @@
 
 #include <stddef.h>
 
+#include "modules/audio_processing/agc2/state_snapshot.h"
+
 namespace webrtc {
 
 // Transposed direct form I implementation of a bi-quad filter applied to an
@@ -33,4 +35,17 @@ void BiQuadFilter::Process(rtc::ArrayView<const float> x,
   }
 }
 
+void BiQuadFilter::SaveState(StateSnapshotWriter* writer) const {
+  writer->WriteArray<float>(biquad_state_.b);
+  writer->WriteArray<float>(biquad_state_.a);
+}
+
+void BiQuadFilter::RestoreState(StateSnapshotReader* reader,
+                                float max_abs_value) {
+  reader->ReadArrayInRange<float>(biquad_state_.b, -max_abs_value,
+                                  max_abs_value);
+  reader->ReadArrayInRange<float>(biquad_state_.a, -max_abs_value,
+                                  max_abs_value);
+}
+
 }  // namespace webrtc
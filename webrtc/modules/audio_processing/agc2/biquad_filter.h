@@ -19,6 +19,9 @@
 
 namespace webrtc {
 
+class StateSnapshotReader;
+class StateSnapshotWriter;
+
 class BiQuadFilter {
  public:
   // Normalized filter coefficients.
@@ -42,6 +45,13 @@ class BiQuadFilter {
   // have the same length. In-place modification is allowed.
   void Process(rtc::ArrayView<const float> x, rtc::ArrayView<float> y);
 
+  // Writes the internal state into |writer|.
+  void SaveState(StateSnapshotWriter* writer) const;
+
+  // Restores the internal state written by SaveState(). The filter inputs and
+  // outputs stored in the state must be within [-max_abs_value, max_abs_value].
+  void RestoreState(StateSnapshotReader* reader, float max_abs_value);
+
  private:
   struct BiQuadState {
     BiQuadState() { Reset(); }
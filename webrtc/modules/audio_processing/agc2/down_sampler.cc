@@ -14,7 +14,9 @@
 
 #include <algorithm>
 
+#include "modules/audio_processing/agc2/agc2_common.h"
 #include "modules/audio_processing/agc2/biquad_filter.h"
+#include "modules/audio_processing/agc2/state_snapshot.h"
 #include "modules/audio_processing/logging/apm_data_dumper.h"
 #include "rtc_base/checks.h"
 
@@ -96,4 +98,13 @@ void DownSampler::DownSample(rtc::ArrayView<const float> in,
   data_dumper_->DumpWav("lc_down_sampler_output", out, kSampleRate8kHz, 1);
 }
 
+void DownSampler::SaveState(StateSnapshotWriter* writer) const {
+  low_pass_filter_.SaveState(writer);
+}
+
+void DownSampler::RestoreState(StateSnapshotReader* reader) {
+  // Twice the largest input to allow for the overshoot of the filter.
+  low_pass_filter_.RestoreState(reader, 2.f * kMaxAbsAnalyzedSampleValue);
+}
+
 }  // namespace webrtc
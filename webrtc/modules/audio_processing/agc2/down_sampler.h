@@ -17,6 +17,8 @@
 namespace webrtc {
 
 class ApmDataDumper;
+class StateSnapshotReader;
+class StateSnapshotWriter;
 
 class DownSampler {
  public:
@@ -30,6 +32,11 @@ class DownSampler {
 
   void DownSample(rtc::ArrayView<const float> in, rtc::ArrayView<float> out);
 
+  // Writes the filter state into |writer|.
+  void SaveState(StateSnapshotWriter* writer) const;
+  // Restores the filter state written by SaveState().
+  void RestoreState(StateSnapshotReader* reader);
+
  private:
   ApmDataDumper* data_dumper_;
   int sample_rate_hz_;
@@ -12,8 +12,10 @@
 
 #include <algorithm>
 #include <cmath>
+#include <limits>
 
 #include "api/array_view.h"
+#include "modules/audio_processing/agc2/state_snapshot.h"
 #include "modules/audio_processing/logging/apm_data_dumper.h"
 #include "rtc_base/checks.h"
 
@@ -43,25 +45,13 @@ void FixedDigitalLevelEstimator::CheckParameterCombination() {
 }
 
 std::array<float, kSubFramesInFrame> FixedDigitalLevelEstimator::ComputeLevel(
-    const AudioFrameView<const float>& float_frame) {
+    const AudioFrameView<const float>& float_frame,
+    const std::array<float, kSubFramesInFrame>& max_envelope) {
   RTC_DCHECK_GT(float_frame.num_channels(), 0);
   RTC_DCHECK_EQ(float_frame.samples_per_channel(), samples_in_frame_);
 
-  // Compute max envelope without smoothing.
-  std::array<float, kSubFramesInFrame> envelope{};
-  for (size_t channel_idx = 0; channel_idx < float_frame.num_channels();
-       ++channel_idx) {
-    const auto channel = float_frame.channel(channel_idx);
-    for (size_t sub_frame = 0; sub_frame < kSubFramesInFrame; ++sub_frame) {
-      for (size_t sample_in_sub_frame = 0;
-           sample_in_sub_frame < samples_in_sub_frame_; ++sample_in_sub_frame) {
-        envelope[sub_frame] =
-            std::max(envelope[sub_frame],
-                     std::abs(channel[sub_frame * samples_in_sub_frame_ +
-                                      sample_in_sub_frame]));
-      }
-    }
-  }
+  // Max envelope without smoothing.
+  std::array<float, kSubFramesInFrame> envelope = max_envelope;
 
   // Make sure envelope increases happen one step earlier so that the
   // corresponding *gain decrease* doesn't miss a sudden signal
@@ -109,4 +99,13 @@ void FixedDigitalLevelEstimator::Reset() {
   filter_state_level_ = kInitialFilterStateLevel;
 }
 
+void FixedDigitalLevelEstimator::SaveState(StateSnapshotWriter* writer) const {
+  writer->Write(filter_state_level_);
+}
+
+void FixedDigitalLevelEstimator::RestoreState(StateSnapshotReader* reader) {
+  reader->ReadInRange(&filter_state_level_, 0.f,
+                      std::numeric_limits<float>::max());
+}
+
 }  // namespace webrtc
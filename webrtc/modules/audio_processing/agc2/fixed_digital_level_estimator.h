@@ -21,6 +21,8 @@
 namespace webrtc {
 
 class ApmDataDumper;
+class StateSnapshotReader;
+class StateSnapshotWriter;
 // Produces a smooth signal level estimate from an input audio
 // stream. The estimate smoothing is done through exponential
 // filtering.
@@ -37,9 +39,12 @@ class FixedDigitalLevelEstimator {
   // The input is assumed to be in FloatS16 format. Scaled input will
   // produce similarly scaled output. A frame of with kFrameDurationMs
   // ms of audio produces a level estimates in the same scale. The
-  // level estimate contains kSubFramesInFrame values.
+  // level estimate contains kSubFramesInFrame values. |envelope| holds the
+  // largest absolute sample value across all the channels in each sub-frame
+  // of |float_frame| (see FrameStats).
   std::array<float, kSubFramesInFrame> ComputeLevel(
-      const AudioFrameView<const float>& float_frame);
+      const AudioFrameView<const float>& float_frame,
+      const std::array<float, kSubFramesInFrame>& envelope);
 
   // Rate may be changed at any time (but not concurrently) from the
   // value passed to the constructor. The class is not thread safe.
@@ -48,6 +53,12 @@ class FixedDigitalLevelEstimator {
   // Resets the level estimator internal state.
   void Reset();
 
+  // Writes the internal state into |writer|.
+  void SaveState(StateSnapshotWriter* writer) const;
+
+  // Restores the internal state written by SaveState().
+  void RestoreState(StateSnapshotReader* reader);
+
   float LastAudioLevel() const { return filter_state_level_; }
 
  private:
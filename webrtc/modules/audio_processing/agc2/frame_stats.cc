@@ -0,0 +1,249 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_processing/agc2/frame_stats.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "rtc_base/checks.h"
+#include "rtc_base/system/arch.h"
+#include "system_wrappers/include/cpu_features_wrapper.h"
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#include <emmintrin.h>
+#endif
+
+namespace webrtc {
+namespace {
+
+bool IsSse2Available() {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  return GetCPUInfo(kSSE2) != 0;
+#else
+  return false;
+#endif
+}
+
+// Computes the energy and the peak of one channel and updates the sub-frame
+// envelope. If `kApplyGain` is true, the samples are first multiplied by
+// `gains` and written back.
+template <bool kApplyGain>
+void AnalyzeChannel(rtc::ArrayView<float> x,
+                    const float* gains,
+                    size_t samples_in_sub_frame,
+                    float* energy,
+                    float* peak,
+                    rtc::ArrayView<float, kSubFramesInFrame> envelope) {
+  float channel_energy = 0.f;
+  float channel_peak = 0.f;
+  for (size_t sub_frame = 0; sub_frame < kSubFramesInFrame; ++sub_frame) {
+    const size_t offset = sub_frame * samples_in_sub_frame;
+    float* sub_frame_data = &x[offset];
+    float sub_frame_peak = 0.f;
+    for (size_t k = 0; k < samples_in_sub_frame; ++k) {
+      if (kApplyGain) {
+        sub_frame_data[k] *= gains[offset + k];
+      }
+      channel_energy += sub_frame_data[k] * sub_frame_data[k];
+      sub_frame_peak = std::max(sub_frame_peak, std::fabs(sub_frame_data[k]));
+    }
+    envelope[sub_frame] = std::max(envelope[sub_frame], sub_frame_peak);
+    channel_peak = std::max(channel_peak, sub_frame_peak);
+  }
+  *energy = channel_energy;
+  *peak = channel_peak;
+}
+
+// Updates the sub-frame envelope with that of one channel multiplied by
+// `gains`.
+void UpdateEnvelope(rtc::ArrayView<const float> x,
+                    rtc::ArrayView<const float> gains,
+                    size_t samples_in_sub_frame,
+                    rtc::ArrayView<float, kSubFramesInFrame> envelope) {
+  for (size_t sub_frame = 0; sub_frame < kSubFramesInFrame; ++sub_frame) {
+    const size_t offset = sub_frame * samples_in_sub_frame;
+    for (size_t k = offset; k < offset + samples_in_sub_frame; ++k) {
+      envelope[sub_frame] =
+          std::max(envelope[sub_frame], std::fabs(x[k] * gains[k]));
+    }
+  }
+}
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+// Returns the sum of the four lanes of |v|.
+inline float HorizontalSum(__m128 v) {
+  v = _mm_add_ps(v, _mm_movehl_ps(v, v));
+  v = _mm_add_ss(v, _mm_shuffle_ps(v, v, 1));
+  return _mm_cvtss_f32(v);
+}
+
+// Returns the largest of the four lanes of |v|.
+inline float HorizontalMax(__m128 v) {
+  v = _mm_max_ps(v, _mm_movehl_ps(v, v));
+  v = _mm_max_ss(v, _mm_shuffle_ps(v, v, 1));
+  return _mm_cvtss_f32(v);
+}
+
+// Same as AnalyzeChannel() for sub-frames whose length is a multiple of four.
+// The energy is accumulated in four lanes, hence it may differ from that
+// computed by AnalyzeChannel() in the last bits.
+template <bool kApplyGain>
+void AnalyzeChannelSse2(rtc::ArrayView<float> x,
+                        const float* gains,
+                        size_t samples_in_sub_frame,
+                        float* energy,
+                        float* peak,
+                        rtc::ArrayView<float, kSubFramesInFrame> envelope) {
+  RTC_DCHECK_EQ(0, samples_in_sub_frame % 4);
+  const __m128 abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+  __m128 channel_energy = _mm_setzero_ps();
+  float channel_peak = 0.f;
+  for (size_t sub_frame = 0; sub_frame < kSubFramesInFrame; ++sub_frame) {
+    const size_t offset = sub_frame * samples_in_sub_frame;
+    float* sub_frame_data = &x[offset];
+    __m128 sub_frame_peak = _mm_setzero_ps();
+    for (size_t k = 0; k < samples_in_sub_frame; k += 4) {
+      __m128 v = _mm_loadu_ps(&sub_frame_data[k]);
+      if (kApplyGain) {
+        v = _mm_mul_ps(v, _mm_loadu_ps(&gains[offset + k]));
+        _mm_storeu_ps(&sub_frame_data[k], v);
+      }
+      channel_energy = _mm_add_ps(channel_energy, _mm_mul_ps(v, v));
+      sub_frame_peak = _mm_max_ps(sub_frame_peak, _mm_and_ps(v, abs_mask));
+    }
+    const float sub_frame_peak_value = HorizontalMax(sub_frame_peak);
+    envelope[sub_frame] = std::max(envelope[sub_frame], sub_frame_peak_value);
+    channel_peak = std::max(channel_peak, sub_frame_peak_value);
+  }
+  *energy = HorizontalSum(channel_energy);
+  *peak = channel_peak;
+}
+
+// Same as UpdateEnvelope() for sub-frames whose length is a multiple of four.
+void UpdateEnvelopeSse2(rtc::ArrayView<const float> x,
+                        rtc::ArrayView<const float> gains,
+                        size_t samples_in_sub_frame,
+                        rtc::ArrayView<float, kSubFramesInFrame> envelope) {
+  RTC_DCHECK_EQ(0, samples_in_sub_frame % 4);
+  const __m128 abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+  for (size_t sub_frame = 0; sub_frame < kSubFramesInFrame; ++sub_frame) {
+    const size_t offset = sub_frame * samples_in_sub_frame;
+    __m128 sub_frame_peak = _mm_setzero_ps();
+    for (size_t k = offset; k < offset + samples_in_sub_frame; k += 4) {
+      const __m128 v =
+          _mm_mul_ps(_mm_loadu_ps(&x[k]), _mm_loadu_ps(&gains[k]));
+      sub_frame_peak = _mm_max_ps(sub_frame_peak, _mm_and_ps(v, abs_mask));
+    }
+    envelope[sub_frame] =
+        std::max(envelope[sub_frame], HorizontalMax(sub_frame_peak));
+  }
+}
+#endif
+
+}  // namespace
+
+float FrameStats::MaxEnergy() const {
+  return energy.empty() ? 0.f : *std::max_element(energy.begin(), energy.end());
+}
+
+FrameStatsAnalyzer::FrameStatsAnalyzer() : use_sse2_(IsSse2Available()) {}
+
+void FrameStatsAnalyzer::Analyze(AudioFrameView<const float> frame,
+                                 FrameStats* stats) const {
+  // Without gains, the samples are only read.
+  AudioFrameView<float> writable_frame(const_cast<float* const*>(frame.data()),
+                                       frame.num_channels(),
+                                       frame.samples_per_channel());
+  ApplyGainAndAnalyze(rtc::ArrayView<const float>(), writable_frame, stats);
+}
+
+void FrameStatsAnalyzer::ApplyGainAndAnalyze(rtc::ArrayView<const float> gains,
+                                             AudioFrameView<float> frame,
+                                             FrameStats* stats) const {
+  RTC_DCHECK(stats);
+  const size_t samples_per_channel = frame.samples_per_channel();
+  RTC_DCHECK_EQ(0, samples_per_channel % kSubFramesInFrame);
+  RTC_DCHECK(gains.empty() || gains.size() == samples_per_channel);
+  const size_t samples_in_sub_frame = samples_per_channel / kSubFramesInFrame;
+  const bool apply_gain = !gains.empty();
+
+  stats->samples_per_channel = samples_per_channel;
+  stats->energy.resize(frame.num_channels());
+  stats->peak.resize(frame.num_channels());
+  stats->envelope.fill(0.f);
+  for (size_t ch = 0; ch < frame.num_channels(); ++ch) {
+    float* const energy = &stats->energy[ch];
+    float* const peak = &stats->peak[ch];
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+    if (use_sse2_ && samples_in_sub_frame % 4 == 0) {
+      if (apply_gain) {
+        AnalyzeChannelSse2<true>(frame.channel(ch), gains.data(),
+                                 samples_in_sub_frame, energy, peak,
+                                 stats->envelope);
+      } else {
+        AnalyzeChannelSse2<false>(frame.channel(ch), nullptr,
+                                  samples_in_sub_frame, energy, peak,
+                                  stats->envelope);
+      }
+      continue;
+    }
+#endif
+    if (apply_gain) {
+      AnalyzeChannel<true>(frame.channel(ch), gains.data(),
+                           samples_in_sub_frame, energy, peak,
+                           stats->envelope);
+    } else {
+      AnalyzeChannel<false>(frame.channel(ch), nullptr, samples_in_sub_frame,
+                            energy, peak, stats->envelope);
+    }
+  }
+}
+
+void FrameStatsAnalyzer::ComputeEnvelope(
+    AudioFrameView<const float> frame,
+    const FrameStats& stats,
+    rtc::ArrayView<const float> gains,
+    std::array<float, kSubFramesInFrame>* envelope) const {
+  RTC_DCHECK(envelope);
+  RTC_DCHECK_EQ(stats.samples_per_channel, frame.samples_per_channel());
+  if (gains.empty()) {
+    *envelope = stats.envelope;
+    return;
+  }
+  RTC_DCHECK_EQ(gains.size(), frame.samples_per_channel());
+
+  // The gain is constant if the first and the last gains are equal, since
+  // the gain ramps monotonically. Scaling by a positive constant and rounding
+  // preserve the order of the absolute values, hence the scaled maximum is
+  // exactly the maximum of the scaled samples.
+  if (gains[0] == gains[gains.size() - 1]) {
+    for (size_t sub_frame = 0; sub_frame < kSubFramesInFrame; ++sub_frame) {
+      (*envelope)[sub_frame] = stats.envelope[sub_frame] * gains[0];
+    }
+    return;
+  }
+
+  const size_t samples_in_sub_frame =
+      frame.samples_per_channel() / kSubFramesInFrame;
+  envelope->fill(0.f);
+  for (size_t ch = 0; ch < frame.num_channels(); ++ch) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+    if (use_sse2_ && samples_in_sub_frame % 4 == 0) {
+      UpdateEnvelopeSse2(frame.channel(ch), gains, samples_in_sub_frame,
+                         *envelope);
+      continue;
+    }
+#endif
+    UpdateEnvelope(frame.channel(ch), gains, samples_in_sub_frame, *envelope);
+  }
+}
+
+}  // namespace webrtc
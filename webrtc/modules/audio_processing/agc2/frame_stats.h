@@ -0,0 +1,74 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_AUDIO_PROCESSING_AGC2_FRAME_STATS_H_
+#define MODULES_AUDIO_PROCESSING_AGC2_FRAME_STATS_H_
+
+#include <stddef.h>
+
+#include <array>
+#include <vector>
+
+#include "api/array_view.h"
+#include "modules/audio_processing/agc2/agc2_common.h"
+#include "modules/audio_processing/include/audio_frame_view.h"
+
+namespace webrtc {
+
+// Level statistics of a 10 ms frame shared by the AGC2 level estimators, so
+// that the samples are only read once per frame.
+struct FrameStats {
+  // Returns the largest channel energy.
+  float MaxEnergy() const;
+
+  size_t samples_per_channel = 0;
+  // Sum of the squared samples of each channel.
+  std::vector<float> energy;
+  // Largest absolute sample value of each channel.
+  std::vector<float> peak;
+  // Largest absolute sample value across all the channels in each sub-frame.
+  std::array<float, kSubFramesInFrame> envelope = {};
+};
+
+// Computes the FrameStats of a frame in a single pass over its samples.
+class FrameStatsAnalyzer {
+ public:
+  FrameStatsAnalyzer();
+  FrameStatsAnalyzer(const FrameStatsAnalyzer&) = delete;
+  FrameStatsAnalyzer& operator=(const FrameStatsAnalyzer&) = delete;
+
+  // The number of samples per channel must be a multiple of
+  // kSubFramesInFrame. Memory is only allocated when the number of channels
+  // differs from that of the previous call.
+  void Analyze(AudioFrameView<const float> frame, FrameStats* stats) const;
+
+  // Multiplies each channel of `frame` by the per-sample `gains` and computes
+  // the stats of the result in the same pass. Same as Analyze() if `gains` is
+  // empty.
+  void ApplyGainAndAnalyze(rtc::ArrayView<const float> gains,
+                           AudioFrameView<float> frame,
+                           FrameStats* stats) const;
+
+  // Computes the sub-frame envelope that `frame` would have after being
+  // multiplied by the per-sample `gains`, given the `stats` of `frame`. The
+  // samples are only read if the gain changes within the frame, since
+  // otherwise the envelope is that of `stats` scaled by the gain.
+  void ComputeEnvelope(AudioFrameView<const float> frame,
+                       const FrameStats& stats,
+                       rtc::ArrayView<const float> gains,
+                       std::array<float, kSubFramesInFrame>* envelope) const;
+
+ private:
+  const bool use_sse2_;
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_AUDIO_PROCESSING_AGC2_FRAME_STATS_H_
@@ -10,8 +10,11 @@
 
 #include "modules/audio_processing/agc2/gain_applier.h"
 
+#include <algorithm>
+
 #include "api/array_view.h"
 #include "modules/audio_processing/agc2/agc2_common.h"
+#include "modules/audio_processing/agc2/state_snapshot.h"
 #include "rtc_base/numerics/safe_minmax.h"
 
 namespace webrtc {
@@ -33,39 +36,6 @@ void ClipSignal(AudioFrameView<float> signal) {
   }
 }
 
-void ApplyGainWithRamping(float last_gain_linear,
-                          float gain_at_end_of_frame_linear,
-                          float inverse_samples_per_channel,
-                          AudioFrameView<float> float_frame) {
-  // Do not modify the signal.
-  if (last_gain_linear == gain_at_end_of_frame_linear &&
-      GainCloseToOne(gain_at_end_of_frame_linear)) {
-    return;
-  }
-
-  // Gain is constant and different from 1.
-  if (last_gain_linear == gain_at_end_of_frame_linear) {
-    for (size_t k = 0; k < float_frame.num_channels(); ++k) {
-      rtc::ArrayView<float> channel_view = float_frame.channel(k);
-      for (auto& sample : channel_view) {
-        sample *= gain_at_end_of_frame_linear;
-      }
-    }
-    return;
-  }
-
-  // The gain changes. We have to change slowly to avoid discontinuities.
-  const float increment = (gain_at_end_of_frame_linear - last_gain_linear) *
-                          inverse_samples_per_channel;
-  float gain = last_gain_linear;
-  for (size_t i = 0; i < float_frame.samples_per_channel(); ++i) {
-    for (size_t ch = 0; ch < float_frame.num_channels(); ++ch) {
-      float_frame.channel(ch)[i] *= gain;
-    }
-    gain += increment;
-  }
-}
-
 }  // namespace
 
 GainApplier::GainApplier(bool hard_clip_samples, float initial_gain_factor)
@@ -74,18 +44,57 @@ GainApplier::GainApplier(bool hard_clip_samples, float initial_gain_factor)
       current_gain_factor_(initial_gain_factor) {}
 
 void GainApplier::ApplyGain(AudioFrameView<float> signal) {
-  if (static_cast<int>(signal.samples_per_channel()) != samples_per_channel_) {
-    Initialize(signal.samples_per_channel());
+  const rtc::ArrayView<const float> gains =
+      UpdateGains(signal.samples_per_channel());
+  if (!gains.empty()) {
+    for (size_t k = 0; k < signal.num_channels(); ++k) {
+      rtc::ArrayView<float> channel_view = signal.channel(k);
+      for (size_t i = 0; i < channel_view.size(); ++i) {
+        channel_view[i] *= gains[i];
+      }
+    }
+  }
+
+  if (hard_clip_samples_) {
+    ClipSignal(signal);
   }
+}
 
-  ApplyGainWithRamping(last_gain_factor_, current_gain_factor_,
-                       inverse_samples_per_channel_, signal);
+rtc::ArrayView<const float> GainApplier::ComputeGains(
+    size_t samples_per_channel) {
+  RTC_DCHECK(!hard_clip_samples_);
+  return UpdateGains(samples_per_channel);
+}
 
+rtc::ArrayView<const float> GainApplier::UpdateGains(
+    size_t samples_per_channel) {
+  if (static_cast<int>(samples_per_channel) != samples_per_channel_) {
+    Initialize(samples_per_channel);
+  }
+  const float last_gain_factor = last_gain_factor_;
   last_gain_factor_ = current_gain_factor_;
 
-  if (hard_clip_samples_) {
-    ClipSignal(signal);
+  // Do not modify the signal.
+  if (last_gain_factor == current_gain_factor_ &&
+      GainCloseToOne(current_gain_factor_)) {
+    return rtc::ArrayView<const float>();
   }
+
+  rtc::ArrayView<float> gains(gains_.data(), samples_per_channel);
+  if (last_gain_factor == current_gain_factor_) {
+    // Gain is constant and different from 1.
+    std::fill(gains.begin(), gains.end(), current_gain_factor_);
+  } else {
+    // The gain changes. We have to change slowly to avoid discontinuities.
+    const float increment = (current_gain_factor_ - last_gain_factor) *
+                            inverse_samples_per_channel_;
+    float gain = last_gain_factor;
+    for (size_t i = 0; i < samples_per_channel; ++i) {
+      gains[i] = gain;
+      gain += increment;
+    }
+  }
+  return gains;
 }
 
 void GainApplier::SetGainFactor(float gain_factor) {
@@ -93,8 +102,27 @@ void GainApplier::SetGainFactor(float gain_factor) {
   current_gain_factor_ = gain_factor;
 }
 
+void GainApplier::Reset(float gain_factor) {
+  last_gain_factor_ = gain_factor;
+  current_gain_factor_ = gain_factor;
+}
+
+void GainApplier::SaveState(StateSnapshotWriter* writer) const {
+  writer->Write(last_gain_factor_);
+  writer->Write(current_gain_factor_);
+}
+
+void GainApplier::RestoreState(StateSnapshotReader* reader,
+                               float min_gain_factor,
+                               float max_gain_factor) {
+  RTC_DCHECK_GE(min_gain_factor, 0.f);
+  reader->ReadInRange(&last_gain_factor_, min_gain_factor, max_gain_factor);
+  reader->ReadInRange(&current_gain_factor_, min_gain_factor, max_gain_factor);
+}
+
 void GainApplier::Initialize(size_t samples_per_channel) {
   RTC_DCHECK_GT(samples_per_channel, 0);
+  RTC_DCHECK_LE(samples_per_channel, gains_.size());
   samples_per_channel_ = static_cast<int>(samples_per_channel);
   inverse_samples_per_channel_ = 1.f / samples_per_channel_;
 }
@@ -13,19 +13,48 @@
 
 #include <stddef.h>
 
+#include <array>
+
+#include "api/array_view.h"
+#include "modules/audio_processing/agc2/agc2_common.h"
 #include "modules/audio_processing/include/audio_frame_view.h"
 
 namespace webrtc {
+class StateSnapshotReader;
+class StateSnapshotWriter;
+
 class GainApplier {
  public:
   GainApplier(bool hard_clip_samples, float initial_gain_factor);
 
   void ApplyGain(AudioFrameView<float> signal);
+
+  // Returns the gain that ApplyGain() would apply to each sample of the next
+  // frame and updates the state as ApplyGain() does, which lets the caller
+  // apply the gain together with other processing. Returns an empty view if
+  // ApplyGain() would leave the signal unchanged. The view is valid until the
+  // next call. Only supported without hard-clipping.
+  rtc::ArrayView<const float> ComputeGains(size_t samples_per_channel);
+
   void SetGainFactor(float gain_factor);
   float GetGainFactor() const { return current_gain_factor_; }
 
+  // Sets both the last applied and the target gain factors to |gain_factor|,
+  // as done by the ctor.
+  void Reset(float gain_factor);
+
+  // Writes the last applied and the target gain factors into |writer|.
+  void SaveState(StateSnapshotWriter* writer) const;
+
+  // Restores the state written by SaveState(). Fails unless both gain factors
+  // are within [min_gain_factor, max_gain_factor].
+  void RestoreState(StateSnapshotReader* reader,
+                    float min_gain_factor,
+                    float max_gain_factor);
+
  private:
   void Initialize(size_t samples_per_channel);
+  rtc::ArrayView<const float> UpdateGains(size_t samples_per_channel);
 
   // Whether to clip samples after gain is applied. If 'true', result
   // will fit in FloatS16 range.
@@ -38,6 +67,7 @@ class GainApplier {
   float current_gain_factor_;
   int samples_per_channel_ = -1;
   float inverse_samples_per_channel_ = -1.f;
+  std::array<float, kMaximalNumberOfSamplesPerChannel> gains_;
 };
 }  // namespace webrtc
 
@@ -158,7 +158,10 @@ void InterpolatedGainCurve::UpdateStats(float input_level) const {
 // linear interpolation (one product and one sum).
 float InterpolatedGainCurve::LookUpGainToApply(float input_level) const {
   UpdateStats(input_level);
+  return ComputeGainToApply(input_level);
+}
 
+float InterpolatedGainCurve::ComputeGainToApply(float input_level) const {
   if (input_level <= approximation_params_x_[0]) {
     // Identity region.
     return 1.0f;
@@ -72,6 +72,10 @@ class InterpolatedGainCurve {
   // after applying this gain
   float LookUpGainToApply(float input_level) const;
 
+  // Same as LookUpGainToApply() without updating the stats, for callers that
+  // look up the gain of each sample after looking up that of the sub-frame.
+  float ComputeGainToApply(float input_level) const;
+
  private:
   // For comparing 'approximation_params_*_' with ones computed by
   // ComputeInterpolatedGainCurve.
@@ -16,9 +16,17 @@
 
 #include "api/array_view.h"
 #include "modules/audio_processing/agc2/agc2_common.h"
+#include "modules/audio_processing/agc2/frame_stats.h"
+#include "modules/audio_processing/agc2/state_snapshot.h"
 #include "modules/audio_processing/logging/apm_data_dumper.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/numerics/safe_minmax.h"
+#include "rtc_base/system/arch.h"
+#include "system_wrappers/include/cpu_features_wrapper.h"
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#include <emmintrin.h>
+#endif
 
 namespace webrtc {
 namespace {
@@ -71,16 +79,67 @@ void ComputePerSampleSubframeFactors(
   }
 }
 
-void ScaleSamples(rtc::ArrayView<const float> per_sample_scaling_factors,
+bool IsSse2Available() {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  return GetCPUInfo(kSSE2) != 0;
+#else
+  return false;
+#endif
+}
+
+// Scales the samples from |begin| on by |pre_gains|, if not empty, and then by
+// the scaling factors, and clamps the result.
+void ScaleChannel(rtc::ArrayView<const float> pre_gains,
+                  rtc::ArrayView<const float> per_sample_scaling_factors,
+                  size_t begin,
+                  rtc::ArrayView<float> channel) {
+  for (size_t j = begin; j < channel.size(); ++j) {
+    const float sample =
+        pre_gains.empty() ? channel[j] : channel[j] * pre_gains[j];
+    channel[j] = rtc::SafeClamp(sample * per_sample_scaling_factors[j],
+                                kMinFloatS16Value, kMaxFloatS16Value);
+  }
+}
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+// Same as ScaleChannel() for the samples that fill groups of four. Returns the
+// number of samples scaled.
+size_t ScaleChannelSse2(rtc::ArrayView<const float> pre_gains,
+                        rtc::ArrayView<const float> per_sample_scaling_factors,
+                        rtc::ArrayView<float> channel) {
+  const __m128 min_value = _mm_set1_ps(kMinFloatS16Value);
+  const __m128 max_value = _mm_set1_ps(kMaxFloatS16Value);
+  const size_t num_samples = channel.size() & ~static_cast<size_t>(3);
+  for (size_t j = 0; j < num_samples; j += 4) {
+    __m128 sample = _mm_loadu_ps(&channel[j]);
+    if (!pre_gains.empty()) {
+      sample = _mm_mul_ps(sample, _mm_loadu_ps(&pre_gains[j]));
+    }
+    sample = _mm_mul_ps(sample, _mm_loadu_ps(&per_sample_scaling_factors[j]));
+    sample = _mm_min_ps(_mm_max_ps(sample, min_value), max_value);
+    _mm_storeu_ps(&channel[j], sample);
+  }
+  return num_samples;
+}
+#endif
+
+void ScaleSamples(rtc::ArrayView<const float> pre_gains,
+                  rtc::ArrayView<const float> per_sample_scaling_factors,
+                  bool use_sse2,
                   AudioFrameView<float> signal) {
   const size_t samples_per_channel = signal.samples_per_channel();
   RTC_DCHECK_EQ(samples_per_channel, per_sample_scaling_factors.size());
+  RTC_DCHECK(pre_gains.empty() || pre_gains.size() == samples_per_channel);
   for (size_t i = 0; i < signal.num_channels(); ++i) {
     auto channel = signal.channel(i);
-    for (size_t j = 0; j < samples_per_channel; ++j) {
-      channel[j] = rtc::SafeClamp(channel[j] * per_sample_scaling_factors[j],
-                                  kMinFloatS16Value, kMaxFloatS16Value);
+    size_t num_scaled = 0;
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+    if (use_sse2) {
+      num_scaled =
+          ScaleChannelSse2(pre_gains, per_sample_scaling_factors, channel);
     }
+#endif
+    ScaleChannel(pre_gains, per_sample_scaling_factors, num_scaled, channel);
   }
 }
 
@@ -97,14 +156,22 @@ Limiter::Limiter(size_t sample_rate_hz,
                  std::string histogram_name)
     : interp_gain_curve_(apm_data_dumper, histogram_name),
       level_estimator_(sample_rate_hz, apm_data_dumper),
-      apm_data_dumper_(apm_data_dumper) {
+      apm_data_dumper_(apm_data_dumper),
+      use_sse2_(IsSse2Available()) {
   CheckLimiterSampleRate(sample_rate_hz);
 }
 
 Limiter::~Limiter() = default;
 
-void Limiter::Process(AudioFrameView<float> signal) {
-  const auto level_estimate = level_estimator_.ComputeLevel(signal);
+void Limiter::Process(AudioFrameView<float> signal, const FrameStats& stats) {
+  RTC_DCHECK_EQ(stats.samples_per_channel, signal.samples_per_channel());
+  Process(signal, rtc::ArrayView<const float>(), stats.envelope);
+}
+
+void Limiter::Process(AudioFrameView<float> signal,
+                      rtc::ArrayView<const float> pre_gains,
+                      const std::array<float, kSubFramesInFrame>& envelope) {
+  const auto level_estimate = level_estimator_.ComputeLevel(signal, envelope);
 
   RTC_DCHECK_EQ(level_estimate.size() + 1, scaling_factors_.size());
   scaling_factors_[0] = last_scaling_factor_;
@@ -120,7 +187,7 @@ void Limiter::Process(AudioFrameView<float> signal) {
       &per_sample_scaling_factors_[0], samples_per_channel);
   ComputePerSampleSubframeFactors(scaling_factors_, samples_per_channel,
                                   per_sample_scaling_factors);
-  ScaleSamples(per_sample_scaling_factors, signal);
+  ScaleSamples(pre_gains, per_sample_scaling_factors, use_sse2_, signal);
 
   last_scaling_factor_ = scaling_factors_.back();
 
@@ -141,6 +208,18 @@ void Limiter::SetSampleRate(size_t sample_rate_hz) {
 
 void Limiter::Reset() {
   level_estimator_.Reset();
+  last_scaling_factor_ = 1.f;
+}
+
+void Limiter::SaveState(StateSnapshotWriter* writer) const {
+  level_estimator_.SaveState(writer);
+  writer->Write(last_scaling_factor_);
+}
+
+void Limiter::RestoreState(StateSnapshotReader* reader) {
+  level_estimator_.RestoreState(reader);
+  // The gain curve never amplifies.
+  reader->ReadInRange(&last_scaling_factor_, 0.f, 1.f);
 }
 
 float Limiter::LastAudioLevel() const {
@@ -11,9 +11,11 @@
 #ifndef MODULES_AUDIO_PROCESSING_AGC2_LIMITER_H_
 #define MODULES_AUDIO_PROCESSING_AGC2_LIMITER_H_
 
+#include <array>
 #include <string>
 #include <vector>
 
+#include "api/array_view.h"
 #include "modules/audio_processing/agc2/fixed_digital_level_estimator.h"
 #include "modules/audio_processing/agc2/interpolated_gain_curve.h"
 #include "modules/audio_processing/include/audio_frame_view.h"
@@ -21,6 +23,9 @@
 
 namespace webrtc {
 class ApmDataDumper;
+struct FrameStats;
+class StateSnapshotReader;
+class StateSnapshotWriter;
 
 class Limiter {
  public:
@@ -31,8 +36,19 @@ class Limiter {
   Limiter& operator=(const Limiter& limiter) = delete;
   ~Limiter();
 
-  // Applies limiter and hard-clipping to |signal|.
-  void Process(AudioFrameView<float> signal);
+  // Applies limiter and hard-clipping to |signal|. |stats| must have been
+  // computed for |signal|.
+  void Process(AudioFrameView<float> signal, const FrameStats& stats);
+
+  // Multiplies |signal| by the per-sample |pre_gains| and applies limiter and
+  // hard-clipping to the result, all in a single pass over the samples. The
+  // limiter level is estimated from |envelope|, which must be the sub-frame
+  // envelope of |signal| after applying |pre_gains| (see
+  // FrameStatsAnalyzer::ComputeEnvelope()). An empty |pre_gains| leaves the
+  // signal unchanged before limiting.
+  void Process(AudioFrameView<float> signal,
+               rtc::ArrayView<const float> pre_gains,
+               const std::array<float, kSubFramesInFrame>& envelope);
   InterpolatedGainCurve::Stats GetGainCurveStats() const;
 
   // Supported rates must be
@@ -45,12 +61,19 @@ class Limiter {
   // Resets the internal state.
   void Reset();
 
+  // Writes the internal state into |writer|.
+  void SaveState(StateSnapshotWriter* writer) const;
+
+  // Restores the internal state written by SaveState().
+  void RestoreState(StateSnapshotReader* reader);
+
   float LastAudioLevel() const;
 
  private:
   const InterpolatedGainCurve interp_gain_curve_;
   FixedDigitalLevelEstimator level_estimator_;
   ApmDataDumper* const apm_data_dumper_ = nullptr;
+  const bool use_sse2_;
 
   // Work array containing the sub-frame scaling factors to be interpolated.
   std::array<float, kSubFramesInFrame + 1> scaling_factors_ = {};
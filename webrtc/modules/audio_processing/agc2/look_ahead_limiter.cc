@@ -0,0 +1,486 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_processing/agc2/look_ahead_limiter.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "modules/audio_processing/logging/apm_data_dumper.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/numerics/safe_minmax.h"
+#include "rtc_base/system/arch.h"
+#include "system_wrappers/include/cpu_features_wrapper.h"
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#include <emmintrin.h>
+#endif
+
+namespace webrtc {
+namespace {
+
+bool IsSse2Available() {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  return GetCPUInfo(kSSE2) != 0;
+#else
+  return false;
+#endif
+}
+
+// Returns a Hann-windowed sinc interpolator with a support of |kNumTaps|
+// samples, half on each side of the value at |fraction| of the way from a
+// sample to the next one, normalized to unit DC gain.
+template <size_t kNumTaps>
+std::array<float, kNumTaps> ComputeInterpolator(float fraction) {
+  constexpr float kPi = 3.14159265f;
+  constexpr float kHalfLength = kNumTaps / 2;
+  std::array<float, kNumTaps> filter;
+  float sum = 0.f;
+  for (size_t k = 0; k < kNumTaps; ++k) {
+    const float t = k - (kHalfLength - 1.f) - fraction;
+    const float window = 0.5f * (1.f + std::cos(kPi * t / kHalfLength));
+    filter[k] = window * std::sin(kPi * t) / (kPi * t);
+    sum += filter[k];
+  }
+  for (float& c : filter) {
+    c /= sum;
+  }
+  return filter;
+}
+
+// Fills each sub-frame of |gains| with the values from the gain at its
+// beginning to that at its end in |boundary_gains|, the former excluded.
+void InterpolateGains(
+    const std::array<float, kSubFramesInFrame + 1>& boundary_gains,
+    size_t sub_frame_size,
+    float* gains) {
+  for (size_t i = 0; i < kSubFramesInFrame; ++i) {
+    const float from = boundary_gains[i];
+    const float step = (boundary_gains[i + 1] - from) / sub_frame_size;
+    float* sub_frame_gains = &gains[i * sub_frame_size];
+    for (size_t k = 0; k < sub_frame_size - 1; ++k) {
+      sub_frame_gains[k] = from + step * (k + 1);
+    }
+    sub_frame_gains[sub_frame_size - 1] = boundary_gains[i + 1];
+  }
+}
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+// Returns the largest of the four elements of |v|.
+float HorizontalMaxSse2(__m128 v) {
+  v = _mm_max_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 0, 3, 2)));
+  v = _mm_max_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+  return _mm_cvtss_f32(v);
+}
+
+// Same as InterpolateGains() for sub-frames of a multiple of four samples.
+void InterpolateGainsSse2(
+    const std::array<float, kSubFramesInFrame + 1>& boundary_gains,
+    size_t sub_frame_size,
+    float* gains) {
+  RTC_DCHECK_EQ(sub_frame_size % 4, 0);
+  const __m128 four = _mm_set1_ps(4.f);
+  for (size_t i = 0; i < kSubFramesInFrame; ++i) {
+    const __m128 from = _mm_set1_ps(boundary_gains[i]);
+    const __m128 step = _mm_set1_ps(
+        (boundary_gains[i + 1] - boundary_gains[i]) / sub_frame_size);
+    float* sub_frame_gains = &gains[i * sub_frame_size];
+    __m128 index = _mm_setr_ps(1.f, 2.f, 3.f, 4.f);
+    for (size_t k = 0; k < sub_frame_size; k += 4) {
+      _mm_storeu_ps(&sub_frame_gains[k],
+                    _mm_add_ps(from, _mm_mul_ps(step, index)));
+      index = _mm_add_ps(index, four);
+    }
+    sub_frame_gains[sub_frame_size - 1] = boundary_gains[i + 1];
+  }
+}
+#endif
+
+}  // namespace
+
+constexpr size_t LookAheadLimiter::kTruePeakTaps;
+constexpr size_t LookAheadLimiter::kTruePeakHalfTaps;
+constexpr size_t LookAheadLimiter::kMaxLookAheadSubFrames;
+constexpr size_t LookAheadLimiter::kMaxDelaySamples;
+constexpr size_t LookAheadLimiter::kMaxSubFrameSamples;
+constexpr size_t LookAheadLimiter::kMaxTruePeakWindow;
+constexpr size_t LookAheadLimiter::kMaxBoundaryGains;
+constexpr size_t LookAheadLimiter::kTruePeakSubFramesPerFrame;
+constexpr size_t LookAheadLimiter::kMaxTruePeakSubFrames;
+
+LookAheadLimiter::LookAheadLimiter(size_t sample_rate_hz,
+                                   float delay_ms,
+                                   ApmDataDumper* apm_data_dumper,
+                                   std::string histogram_name_prefix)
+    : interp_gain_curve_(apm_data_dumper, histogram_name_prefix),
+      apm_data_dumper_(apm_data_dumper),
+      delay_ms_(delay_ms),
+      use_sse2_(IsSse2Available()) {
+  RTC_DCHECK_GE(delay_ms, kMinLookAheadLimiterDelayMs);
+  RTC_DCHECK_LE(delay_ms, kMaxLookAheadLimiterDelayMs);
+  const auto quarter = ComputeInterpolator<kTruePeakTaps>(0.25f);
+  const auto half = ComputeInterpolator<kTruePeakTaps>(0.5f);
+  float quarter_abs_sum = 0.f;
+  float half_abs_sum = 0.f;
+  for (size_t k = 0; k < kTruePeakHalfTaps; ++k) {
+    const size_t mirror = kTruePeakTaps - 1 - k;
+    quarter_even_[k] = 0.5f * (quarter[k] + quarter[mirror]);
+    quarter_odd_[k] = 0.5f * (quarter[k] - quarter[mirror]);
+    half_[k] = 0.5f * (half[k] + half[mirror]);
+    quarter_abs_sum += std::fabs(quarter[k]) + std::fabs(quarter[mirror]);
+    half_abs_sum += 2.f * std::fabs(half_[k]);
+  }
+  true_peak_bound_ = std::max({1.f, quarter_abs_sum, half_abs_sum});
+  SetSampleRate(sample_rate_hz);
+}
+
+LookAheadLimiter::~LookAheadLimiter() = default;
+
+void LookAheadLimiter::Process(
+    AudioFrameView<float> signal,
+    rtc::ArrayView<const float> pre_gains,
+    const std::array<float, kSubFramesInFrame>& envelope) {
+  const size_t samples_per_channel = signal.samples_per_channel();
+  RTC_DCHECK_EQ(samples_per_channel, samples_in_sub_frame_ * kSubFramesInFrame);
+  RTC_DCHECK(pre_gains.empty() || pre_gains.size() == samples_per_channel);
+  if (signal.num_channels() != num_channels_) {
+    SetNumChannels(signal.num_channels());
+  }
+
+  // The true peaks of this frame are computed from the samples of this frame
+  // and of the tail of the previous one, and are at most |true_peak_bound_|
+  // times larger than the largest of those samples. When they cannot reach
+  // the knee, and no gain in the look-ahead is below one, all the gains are
+  // one.
+  const float frame_peak = *std::max_element(envelope.begin(), envelope.end());
+  const float peak_bound =
+      true_peak_bound_ *
+      std::max({frame_peak, last_envelope_[0], last_envelope_[1]});
+  true_peak_credit_ = std::min(true_peak_credit_ + kTruePeakSubFramesPerFrame,
+                               kMaxTruePeakSubFrames);
+  const bool attenuating =
+      last_gain_ < 1.f ||
+      std::any_of(boundary_gains_.begin(),
+                  boundary_gains_.begin() + 2 * look_ahead_sub_frames_ - 2,
+                  [](float gain) { return gain < 1.f; });
+  if (!attenuating && interp_gain_curve_.ComputeGainToApply(
+                          std::max(peak_bound, envelope_)) == 1.f) {
+    SkipGains(samples_per_channel, envelope);
+  } else {
+    ComputeGains(signal, pre_gains, envelope);
+  }
+  last_envelope_ = {envelope[kSubFramesInFrame - 2],
+                    envelope[kSubFramesInFrame - 1]};
+
+  // Output the delay line followed by the beginning of the frame, scaled by
+  // the gains. The end of the frame is saved as the next delay line, and the
+  // frame is shifted from its end on, such that each sample is read before
+  // being overwritten.
+  RTC_DCHECK_LT(delay_samples_, samples_per_channel);
+  const size_t num_shifted = samples_per_channel - delay_samples_;
+  const size_t next_set = 1 - delay_line_set_;
+  const float* lines =
+      &delay_lines_[delay_line_set_ * num_channels_ * kMaxDelaySamples];
+  float* next_lines =
+      &delay_lines_[next_set * num_channels_ * kMaxDelaySamples];
+  for (size_t ch = 0; ch < num_channels_; ++ch) {
+    const float* line = &lines[ch * kMaxDelaySamples];
+    float* next_line = &next_lines[ch * kMaxDelaySamples];
+    auto channel = signal.channel(ch);
+    if (pre_gains.empty()) {
+      std::copy(channel.begin() + num_shifted, channel.end(), next_line);
+    } else {
+      for (size_t k = 0; k < delay_samples_; ++k) {
+        next_line[k] = channel[num_shifted + k] * pre_gains[num_shifted + k];
+      }
+    }
+    size_t k = samples_per_channel;
+    size_t j = 0;
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+    if (use_sse2_) {
+      const __m128 min_value = _mm_set1_ps(kMinFloatS16Value);
+      const __m128 max_value = _mm_set1_ps(kMaxFloatS16Value);
+      for (; k >= delay_samples_ + 4; k -= 4) {
+        const size_t input = k - 4 - delay_samples_;
+        __m128 sample = _mm_loadu_ps(&channel[input]);
+        if (!pre_gains.empty()) {
+          sample = _mm_mul_ps(sample, _mm_loadu_ps(&pre_gains[input]));
+        }
+        sample = _mm_mul_ps(sample, _mm_loadu_ps(&gains_[k - 4]));
+        sample = _mm_min_ps(_mm_max_ps(sample, min_value), max_value);
+        _mm_storeu_ps(&channel[k - 4], sample);
+      }
+      for (; j + 4 <= delay_samples_; j += 4) {
+        __m128 sample =
+            _mm_mul_ps(_mm_loadu_ps(&line[j]), _mm_loadu_ps(&gains_[j]));
+        sample = _mm_min_ps(_mm_max_ps(sample, min_value), max_value);
+        _mm_storeu_ps(&channel[j], sample);
+      }
+    }
+#endif
+    for (; k > delay_samples_; --k) {
+      const size_t input = k - 1 - delay_samples_;
+      const float sample =
+          channel[input] * (pre_gains.empty() ? 1.f : pre_gains[input]);
+      channel[k - 1] = rtc::SafeClamp(sample * gains_[k - 1],
+                                      kMinFloatS16Value, kMaxFloatS16Value);
+    }
+    for (; j < delay_samples_; ++j) {
+      channel[j] = rtc::SafeClamp(line[j] * gains_[j], kMinFloatS16Value,
+                                  kMaxFloatS16Value);
+    }
+  }
+  delay_line_set_ = next_set;
+
+  apm_data_dumper_->DumpRaw("agc2_look_ahead_limiter_gains",
+                            samples_per_channel, gains_.data());
+}
+
+float LookAheadLimiter::ComputeTruePeak(AudioFrameView<const float> signal,
+                                        rtc::ArrayView<const float> pre_gains,
+                                        size_t begin) const {
+  // The values between x[k] and x[k + 1] are interpolated from x[k - 3] to
+  // x[k + 4].
+  constexpr size_t kTapsBefore = kTruePeakHalfTaps - 1;
+  const size_t size = samples_in_sub_frame_;
+  RTC_DCHECK_GE(begin, kTapsBefore);
+  RTC_DCHECK_LE(begin + size + kTruePeakHalfTaps,
+                delay_samples_ + signal.samples_per_channel());
+  // The samples are read from |signal| when they all lie in it and no
+  // pre-gains apply, and are otherwise gathered in |window|.
+  const size_t first = begin - kTapsBefore;
+  const size_t window_size = size + kTruePeakTaps - 1;
+  const bool in_signal = first >= delay_samples_ && pre_gains.empty();
+  std::array<float, kMaxTruePeakWindow> window;
+  float peak = 0.f;
+  for (size_t ch = 0; ch < num_channels_; ++ch) {
+    const auto channel = signal.channel(ch);
+    const float* x = &window[0];
+    if (in_signal) {
+      x = &channel[first - delay_samples_];
+    } else {
+      const float* line =
+          &delay_lines_[(delay_line_set_ * num_channels_ + ch) *
+                        kMaxDelaySamples];
+      size_t k = 0;
+      for (; k < window_size && first + k < delay_samples_; ++k) {
+        window[k] = line[first + k];
+      }
+      for (; k < window_size; ++k) {
+        const size_t input = first + k - delay_samples_;
+        window[k] =
+            channel[input] * (pre_gains.empty() ? 1.f : pre_gains[input]);
+      }
+    }
+    size_t k = 0;
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+    if (use_sse2_) {
+      // Four consecutive values of each phase at a time. |taps[j]| holds the
+      // j-th taps of the four values, hence the first half of the taps of the
+      // next four values are the second half of those of the current ones.
+      const __m128 abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+      __m128 taps[kTruePeakTaps];
+      for (size_t j = 0; j < kTruePeakHalfTaps; ++j) {
+        taps[j] = _mm_loadu_ps(&x[j]);
+      }
+      __m128 peaks = _mm_setzero_ps();
+      for (; k < size; k += 4) {
+        for (size_t j = kTruePeakHalfTaps; j < kTruePeakTaps; ++j) {
+          taps[j] = _mm_loadu_ps(&x[k + j]);
+        }
+        __m128 even = _mm_setzero_ps();
+        __m128 odd = _mm_setzero_ps();
+        __m128 middle = _mm_setzero_ps();
+        for (size_t j = 0; j < kTruePeakHalfTaps; ++j) {
+          const __m128 sum = _mm_add_ps(taps[j], taps[kTruePeakTaps - 1 - j]);
+          const __m128 difference =
+              _mm_sub_ps(taps[j], taps[kTruePeakTaps - 1 - j]);
+          even = _mm_add_ps(
+              even, _mm_mul_ps(_mm_set1_ps(quarter_even_[j]), sum));
+          odd = _mm_add_ps(
+              odd, _mm_mul_ps(_mm_set1_ps(quarter_odd_[j]), difference));
+          middle = _mm_add_ps(middle, _mm_mul_ps(_mm_set1_ps(half_[j]), sum));
+        }
+        peaks = _mm_max_ps(peaks, _mm_add_ps(_mm_and_ps(even, abs_mask),
+                                             _mm_and_ps(odd, abs_mask)));
+        peaks = _mm_max_ps(peaks, _mm_and_ps(middle, abs_mask));
+        for (size_t j = 0; j < kTruePeakHalfTaps; ++j) {
+          taps[j] = taps[j + kTruePeakHalfTaps];
+        }
+      }
+      peak = std::max(peak, HorizontalMaxSse2(peaks));
+    }
+#endif
+    for (; k < size; ++k) {
+      float even = 0.f;
+      float odd = 0.f;
+      float middle = 0.f;
+      for (size_t j = 0; j < kTruePeakHalfTaps; ++j) {
+        const float sum = x[k + j] + x[k + kTruePeakTaps - 1 - j];
+        const float difference = x[k + j] - x[k + kTruePeakTaps - 1 - j];
+        even += quarter_even_[j] * sum;
+        odd += quarter_odd_[j] * difference;
+        middle += half_[j] * sum;
+      }
+      peak = std::max({peak, std::fabs(even) + std::fabs(odd),
+                       std::fabs(middle)});
+    }
+  }
+  return peak;
+}
+
+void LookAheadLimiter::ComputeGains(
+    AudioFrameView<const float> signal,
+    rtc::ArrayView<const float> pre_gains,
+    const std::array<float, kSubFramesInFrame>& envelope) {
+  const size_t look_ahead = look_ahead_sub_frames_;
+  const size_t num_previous_gains = 2 * look_ahead - 2;
+  // The sub-frames that follow the output by the look-ahead lag those of
+  // |envelope| by kTruePeakHalfTaps samples, hence their samples are bounded
+  // by the envelope of the same sub-frame and of the previous one. The taps
+  // before them reach the sub-frame before the previous one as well when the
+  // sub-frames are shorter than kTruePeakTaps - 1 samples.
+  std::array<float, kSubFramesInFrame + 2> peaks;
+  std::copy(last_envelope_.begin(), last_envelope_.end(), peaks.begin());
+  std::copy(envelope.begin(), envelope.end(), peaks.begin() + 2);
+  const bool taps_span_three_sub_frames =
+      samples_in_sub_frame_ < kTruePeakTaps - 1;
+
+  // Compute the levels of those sub-frames and the gains at their
+  // beginnings.
+  float level = envelope_;
+  float level_gain = last_level_gain_;
+  float* new_gains = &boundary_gains_[num_previous_gains];
+  for (size_t i = 0; i < kSubFramesInFrame; ++i) {
+    const float sample_peak = std::max(peaks[i + 1], peaks[i + 2]);
+    const float taps_peak = taps_span_three_sub_frames
+                                ? std::max(sample_peak, peaks[i])
+                                : sample_peak;
+    // The level decays to at least kDecayFilterConstant * |level|, hence it
+    // stays above the true peaks when they cannot exceed that. Otherwise,
+    // the true peaks are computed while |true_peak_credit_| lasts, and
+    // bounded once it runs out.
+    float peak = sample_peak;
+    const float true_peak_bound = true_peak_bound_ * taps_peak;
+    if (true_peak_bound > kDecayFilterConstant * level) {
+      if (true_peak_credit_ > 0) {
+        --true_peak_credit_;
+        peak = std::max(
+            peak, ComputeTruePeak(signal, pre_gains,
+                                  (look_ahead + i) * samples_in_sub_frame_));
+      } else {
+        peak = true_peak_bound;
+      }
+    }
+    // Instant attack, exponential decay.
+    level = peak >= level ? peak
+                          : peak * (1.f - kDecayFilterConstant) +
+                                level * kDecayFilterConstant;
+    const float gain = interp_gain_curve_.LookUpGainToApply(level);
+    new_gains[i] = std::min(level_gain, gain);
+    level_gain = gain;
+  }
+
+  // Hold each boundary gain over the look-ahead. The gain at the end of the
+  // i-th output sub-frame is the average of the held gains i to i +
+  // |look_ahead| - 1, all of which hold the gain at the end of the sub-frame.
+  // The look-ahead is short, hence the sliding minimum is taken over one
+  // shift at a time, which vectorizes, rather than with a monotonic queue.
+  const size_t num_held_gains = kSubFramesInFrame + look_ahead - 1;
+  std::array<float, kSubFramesInFrame + kMaxLookAheadSubFrames - 1> held_gains;
+  std::copy(boundary_gains_.begin(), boundary_gains_.begin() + num_held_gains,
+            held_gains.begin());
+  for (size_t k = 1; k < look_ahead; ++k) {
+    for (size_t j = 0; j < num_held_gains; ++j) {
+      held_gains[j] = std::min(held_gains[j], boundary_gains_[j + k]);
+    }
+  }
+  std::array<float, kSubFramesInFrame + 1> output_gains;
+  output_gains[0] = last_gain_;
+  std::copy(held_gains.begin(), held_gains.begin() + kSubFramesInFrame,
+            output_gains.begin() + 1);
+  for (size_t k = 1; k < look_ahead; ++k) {
+    for (size_t i = 0; i < kSubFramesInFrame; ++i) {
+      output_gains[i + 1] += held_gains[i + k];
+    }
+  }
+  for (size_t i = 1; i <= kSubFramesInFrame; ++i) {
+    output_gains[i] /= look_ahead;
+  }
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (use_sse2_) {
+    InterpolateGainsSse2(output_gains, samples_in_sub_frame_, gains_.data());
+  } else {
+    InterpolateGains(output_gains, samples_in_sub_frame_, gains_.data());
+  }
+#else
+  InterpolateGains(output_gains, samples_in_sub_frame_, gains_.data());
+#endif
+
+  std::copy(boundary_gains_.begin() + kSubFramesInFrame,
+            boundary_gains_.begin() + kSubFramesInFrame + num_previous_gains,
+            boundary_gains_.begin());
+  envelope_ = level;
+  last_level_gain_ = level_gain;
+  last_gain_ = output_gains[kSubFramesInFrame];
+}
+
+void LookAheadLimiter::SkipGains(
+    size_t samples_per_channel,
+    const std::array<float, kSubFramesInFrame>& envelope) {
+  // All the boundary gains are one and stay so until the level reaches the
+  // knee. The level is updated from the samples instead of the true peaks.
+  for (float level : envelope) {
+    envelope_ = level >= envelope_ ? level
+                                   : level * (1.f - kDecayFilterConstant) +
+                                         envelope_ * kDecayFilterConstant;
+    interp_gain_curve_.LookUpGainToApply(envelope_);
+  }
+  std::fill(gains_.begin(), gains_.begin() + samples_per_channel, 1.f);
+}
+
+InterpolatedGainCurve::Stats LookAheadLimiter::GetGainCurveStats() const {
+  return interp_gain_curve_.get_stats();
+}
+
+void LookAheadLimiter::SetSampleRate(size_t sample_rate_hz) {
+  RTC_DCHECK_LE(sample_rate_hz,
+                kMaximalNumberOfSamplesPerChannel * 1000 / kFrameDurationMs);
+  samples_in_sub_frame_ = rtc::CheckedDivExact(
+      sample_rate_hz * kFrameDurationMs / 1000, kSubFramesInFrame);
+  RTC_DCHECK_EQ(samples_in_sub_frame_ % 4, 0);
+  // The delay is rounded to whole sub-frames, plus the samples after the last
+  // interpolated values that the true peaks depend on.
+  look_ahead_sub_frames_ = std::max<size_t>(
+      static_cast<size_t>(delay_ms_ * kSubFramesInFrame / kFrameDurationMs +
+                          0.5f),
+      1);
+  RTC_DCHECK_LE(look_ahead_sub_frames_, kMaxLookAheadSubFrames);
+  delay_samples_ =
+      look_ahead_sub_frames_ * samples_in_sub_frame_ + kTruePeakHalfTaps;
+  Reset();
+}
+
+void LookAheadLimiter::Reset() {
+  std::fill(delay_lines_.begin(), delay_lines_.end(), 0.f);
+  envelope_ = 0.f;
+  last_envelope_.fill(0.f);
+  last_level_gain_ = 1.f;
+  boundary_gains_.fill(1.f);
+  last_gain_ = 1.f;
+  true_peak_credit_ = kMaxTruePeakSubFrames;
+}
+
+void LookAheadLimiter::SetNumChannels(size_t num_channels) {
+  num_channels_ = num_channels;
+  delay_lines_.assign(2 * num_channels * kMaxDelaySamples, 0.f);
+}
+
+}  // namespace webrtc
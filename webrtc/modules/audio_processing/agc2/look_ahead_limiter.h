@@ -0,0 +1,170 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_AUDIO_PROCESSING_AGC2_LOOK_AHEAD_LIMITER_H_
+#define MODULES_AUDIO_PROCESSING_AGC2_LOOK_AHEAD_LIMITER_H_
+
+#include <stddef.h>
+
+#include <array>
+#include <string>
+#include <vector>
+
+#include "api/array_view.h"
+#include "modules/audio_processing/agc2/agc2_common.h"
+#include "modules/audio_processing/agc2/interpolated_gain_curve.h"
+#include "modules/audio_processing/include/audio_frame_view.h"
+
+namespace webrtc {
+class ApmDataDumper;
+
+// Range of the delay of the look-ahead limiter.
+constexpr float kMinLookAheadLimiterDelayMs = 1.f;
+constexpr float kMaxLookAheadLimiterDelayMs = 5.f;
+
+// Limiter that delays the signal by a few milliseconds, such that the gain is
+// reduced before the peaks reach the output instead of when they arrive. The
+// level is the true peak of the signal, i.e. the largest of the samples and of
+// the values between them estimated by 4x oversampling, so that the peaks
+// created between the samples when the signal is reconstructed, e.g. by a
+// codec, are limited as well. The gain curve is that of Limiter.
+//
+// As in Limiter, the level is computed per sub-frame, with instant attack and
+// the same decay, and the gain of each sample is interpolated between the
+// gains at the boundaries of its sub-frame. The gain at a boundary is that of
+// the louder of the two sub-frames around it. It is held for the look-ahead,
+// i.e., the boundary takes the lowest gain of the next boundaries within the
+// look-ahead, and then averaged over the look-ahead, such that the gain ramps
+// down over the look-ahead and reaches the gain for a peak when the peak
+// leaves the delay line.
+class LookAheadLimiter {
+ public:
+  LookAheadLimiter(size_t sample_rate_hz,
+                   float delay_ms,
+                   ApmDataDumper* apm_data_dumper,
+                   std::string histogram_name_prefix);
+  LookAheadLimiter(const LookAheadLimiter&) = delete;
+  LookAheadLimiter& operator=(const LookAheadLimiter&) = delete;
+  ~LookAheadLimiter();
+
+  // Multiplies |signal| by the per-sample |pre_gains|, or leaves it unchanged
+  // if |pre_gains| is empty, and replaces it with the limited signal delayed by
+  // delay_samples(). |envelope| must be the sub-frame envelope of |signal|
+  // after applying |pre_gains| (see FrameStatsAnalyzer::ComputeEnvelope()).
+  // The true peaks are only computed when the envelope may reach the knee of
+  // the gain curve. Memory is only allocated when the number of channels
+  // differs from that of the previous call.
+  void Process(AudioFrameView<float> signal,
+               rtc::ArrayView<const float> pre_gains,
+               const std::array<float, kSubFramesInFrame>& envelope);
+  InterpolatedGainCurve::Stats GetGainCurveStats() const;
+
+  // Same sample rates as Limiter.
+  void SetSampleRate(size_t sample_rate_hz);
+
+  // Resets the internal state and clears the delay line.
+  void Reset();
+
+  float LastAudioLevel() const { return envelope_; }
+  size_t delay_samples() const { return delay_samples_; }
+
+ private:
+  // The interpolation filter has kTruePeakTaps taps, half of which precede
+  // the interpolated values, and is symmetric: the phase at 3/4 is the phase
+  // at 1/4 reversed, and the phase at 1/2 is its own reverse.
+  static constexpr size_t kTruePeakTaps = 8;
+  static constexpr size_t kTruePeakHalfTaps = kTruePeakTaps / 2;
+  static constexpr size_t kMaxLookAheadSubFrames = static_cast<size_t>(
+      kMaxLookAheadLimiterDelayMs * kSubFramesInFrame / kFrameDurationMs);
+  static constexpr size_t kMaxSubFrameSamples =
+      kMaximalNumberOfSamplesPerChannel / kSubFramesInFrame;
+  static constexpr size_t kMaxDelaySamples =
+      kMaxLookAheadSubFrames * kMaxSubFrameSamples + kTruePeakHalfTaps;
+  // Samples read to interpolate the values within a sub-frame.
+  static constexpr size_t kMaxTruePeakWindow =
+      kMaxSubFrameSamples + kTruePeakTaps - 1;
+  // Gains at the sub-frame boundaries needed in a frame: the boundaries of
+  // the frame followed by those of the look-ahead, and the boundaries of the
+  // previous look-ahead, over which the first boundaries are averaged.
+  static constexpr size_t kMaxBoundaryGains =
+      2 * kMaxLookAheadSubFrames - 2 + kSubFramesInFrame;
+  // The true peaks of kTruePeakSubFramesPerFrame sub-frames per frame are
+  // computed on average, and of at most the whole frame when enough of the
+  // previous ones were not needed. The level of the other sub-frames is
+  // bounded from their envelope, which may reduce the gain more than needed
+  // but keeps the cost of stationary loud signals below that of Limiter
+  // followed by clipping.
+  static constexpr size_t kTruePeakSubFramesPerFrame = 1;
+  static constexpr size_t kMaxTruePeakSubFrames = kSubFramesInFrame;
+
+  void SetNumChannels(size_t num_channels);
+  // Returns the largest value interpolated between the samples of the
+  // sub-frame starting at |begin| across the channels, where the samples are
+  // those of the delay line followed by those of |signal| after |pre_gains|.
+  float ComputeTruePeak(AudioFrameView<const float> signal,
+                        rtc::ArrayView<const float> pre_gains,
+                        size_t begin) const;
+  // Computes the gain of each sample from the sub-frame peaks of the end of
+  // |signal| after |pre_gains|, bounded by |envelope| where they cannot reach
+  // the level or exceed the true peak budget.
+  void ComputeGains(AudioFrameView<const float> signal,
+                    rtc::ArrayView<const float> pre_gains,
+                    const std::array<float, kSubFramesInFrame>& envelope);
+  // Updates the level of the frames that do not reach the knee, where all
+  // the gains are one, from the sub-frame |envelope|.
+  void SkipGains(size_t samples_per_channel,
+                 const std::array<float, kSubFramesInFrame>& envelope);
+
+  const InterpolatedGainCurve interp_gain_curve_;
+  ApmDataDumper* const apm_data_dumper_;
+  const float delay_ms_;
+  const bool use_sse2_;
+  // The interpolation filter folded around its center: the phase at 1/4 is
+  // |quarter_even_| + |quarter_odd_| and the phase at 1/2 is |half_|, applied
+  // to the sums (odd: the differences) of the taps at the same distance from
+  // the center. The phase at 3/4 is |quarter_even_| - |quarter_odd_|, hence
+  // the larger of the values at 1/4 and 3/4 is the sum of the magnitudes of
+  // the even and odd parts.
+  std::array<float, kTruePeakHalfTaps> quarter_even_;
+  std::array<float, kTruePeakHalfTaps> quarter_odd_;
+  std::array<float, kTruePeakHalfTaps> half_;
+  // Largest sum of the absolute coefficients of a phase, which bounds the
+  // interpolated values.
+  float true_peak_bound_ = 1.f;
+
+  size_t samples_in_sub_frame_ = 0;
+  size_t look_ahead_sub_frames_ = 0;
+  size_t delay_samples_ = 0;
+
+  size_t num_channels_ = 0;
+  // Two sets of delay lines of each channel. The set |delay_line_set_|
+  // holds the last |delay_samples_| samples of the previous frames after the
+  // pre-gains, and the other one receives those of the current frame.
+  std::vector<float> delay_lines_;
+  size_t delay_line_set_ = 0;
+  std::array<float, kMaximalNumberOfSamplesPerChannel> gains_;
+
+  float envelope_ = 0.f;
+  // Envelope of the last two sub-frames of the previous frame.
+  std::array<float, 2> last_envelope_ = {};
+  // Gain for the level of the last sub-frame.
+  float last_level_gain_ = 1.f;
+  // Gains at the sub-frame boundaries, the first 2 * |look_ahead_sub_frames_|
+  // - 2 of which are those of the end of the previous frame.
+  std::array<float, kMaxBoundaryGains> boundary_gains_;
+  // Gain at the end of the last output sub-frame.
+  float last_gain_ = 1.f;
+  // Number of sub-frames whose true peaks may still be computed.
+  size_t true_peak_credit_ = kMaxTruePeakSubFrames;
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_AUDIO_PROCESSING_AGC2_LOOK_AHEAD_LIMITER_H_
@@ -0,0 +1,334 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_processing/agc2/loudness_meter.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "modules/audio_processing/utility/cascaded_biquad_filter.h"
+#include "modules/audio_processing/utility/multi_channel_biquad_filter.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/system/arch.h"
+#include "system_wrappers/include/cpu_features_wrapper.h"
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#include <emmintrin.h>
+#endif
+
+namespace webrtc {
+namespace {
+
+constexpr size_t kStepsPerSecond = 10;
+constexpr size_t kMomentarySteps = 4;
+// Longest run of samples filtered at once, 10 ms at 48 kHz.
+constexpr size_t kMaxChunkLength = 480;
+
+constexpr float kAbsoluteGateLufs = -70.f;
+constexpr float kIntegratedRelativeGateLu = 10.f;
+constexpr float kRangeRelativeGateLu = 20.f;
+constexpr float kRangeLowPercentile = 0.1f;
+constexpr float kRangeHighPercentile = 0.95f;
+constexpr float kBinWidthLu = 0.1f;
+
+// Scales the squared S16 samples to full scale.
+constexpr double kEnergyScale = 1.0 / (32768.0 * 32768.0);
+
+// Offset of the loudness with respect to the mean square of the K-weighted
+// signal, such that a 997 Hz sine has the loudness of its RMS level.
+constexpr double kLoudnessOffsetDb = -0.691;
+
+bool IsSse2Available() {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  return GetCPUInfo(kSSE2) != 0;
+#else
+  return false;
+#endif
+}
+
+float EnergyToLoudness(double energy) {
+  if (energy <= 0.0) {
+    return kMinLoudnessLufs;
+  }
+  return std::max(
+      static_cast<float>(kLoudnessOffsetDb + 10.0 * std::log10(energy)),
+      kMinLoudnessLufs);
+}
+
+// Returns the coefficients of the pre-filter and of the RLB high-pass filter
+// of BS.1770 for `sample_rate_hz`. They are derived from the analog
+// prototypes of the 48 kHz filters of the recommendation with the bilinear
+// transform, which gives back these filters at 48 kHz.
+std::vector<CascadedBiQuadFilter::BiQuadCoefficients>
+ComputeKWeightingCoefficients(int sample_rate_hz) {
+  const double pi = 3.14159265358979323846;
+  std::vector<CascadedBiQuadFilter::BiQuadCoefficients> coefficients(2);
+
+  // High-shelf pre-filter modelling the acoustic effect of the head.
+  {
+    const double f0 = 1681.974450955533;
+    const double gain_db = 3.999843853973347;
+    const double q = 0.7071752369554196;
+    const double k = std::tan(pi * f0 / sample_rate_hz);
+    const double vh = std::pow(10.0, gain_db / 20.0);
+    const double vb = std::pow(vh, 0.4996667741545416);
+    const double a0 = 1.0 + k / q + k * k;
+    auto& c = coefficients[0];
+    c.b[0] = static_cast<float>((vh + vb * k / q + k * k) / a0);
+    c.b[1] = static_cast<float>(2.0 * (k * k - vh) / a0);
+    c.b[2] = static_cast<float>((vh - vb * k / q + k * k) / a0);
+    c.a[0] = static_cast<float>(2.0 * (k * k - 1.0) / a0);
+    c.a[1] = static_cast<float>((1.0 - k / q + k * k) / a0);
+  }
+
+  // Revised low-frequency B-weighting high-pass filter.
+  {
+    const double f0 = 38.13547087602444;
+    const double q = 0.5003270373238773;
+    const double k = std::tan(pi * f0 / sample_rate_hz);
+    const double a0 = 1.0 + k / q + k * k;
+    auto& c = coefficients[1];
+    c.b[0] = 1.f;
+    c.b[1] = -2.f;
+    c.b[2] = 1.f;
+    c.a[0] = static_cast<float>(2.0 * (k * k - 1.0) / a0);
+    c.a[1] = static_cast<float>((1.0 - k / q + k * k) / a0);
+  }
+  return coefficients;
+}
+
+float SumOfSquares(const float* x, size_t length) {
+  float sum = 0.f;
+  for (size_t k = 0; k < length; ++k) {
+    sum += x[k] * x[k];
+  }
+  return sum;
+}
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+// Same as SumOfSquares(), with the sum accumulated in four lanes.
+float SumOfSquaresSse2(const float* x, size_t length) {
+  __m128 sum = _mm_setzero_ps();
+  size_t k = 0;
+  for (; k + 4 <= length; k += 4) {
+    const __m128 v = _mm_loadu_ps(&x[k]);
+    sum = _mm_add_ps(sum, _mm_mul_ps(v, v));
+  }
+  sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+  sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+  return _mm_cvtss_f32(sum) + SumOfSquares(&x[k], length - k);
+}
+#endif
+
+size_t BinIndex(float loudness, size_t num_bins) {
+  const float index = std::floor((loudness - kAbsoluteGateLufs) / kBinWidthLu);
+  return std::min(static_cast<size_t>(std::max(index, 0.f)), num_bins - 1);
+}
+
+}  // namespace
+
+constexpr size_t LoudnessMeter::GatingHistogram::kNumBins;
+
+void LoudnessMeter::GatingHistogram::Add(double energy) {
+  const float loudness = EnergyToLoudness(energy);
+  if (loudness <= kAbsoluteGateLufs) {
+    return;
+  }
+  const size_t bin = BinIndex(loudness, kNumBins);
+  ++counts_[bin];
+  energies_[bin] += energy;
+  ++total_count_;
+  total_energy_ += energy;
+}
+
+void LoudnessMeter::GatingHistogram::Reset() {
+  counts_.fill(0);
+  energies_.fill(0.0);
+  total_count_ = 0;
+  total_energy_ = 0.0;
+}
+
+size_t LoudnessMeter::GatingHistogram::RelativeGateBin(
+    float relative_gate_lu) const {
+  if (total_count_ == 0) {
+    return kNumBins;
+  }
+  const float gate =
+      EnergyToLoudness(total_energy_ / total_count_) - relative_gate_lu;
+  return BinIndex(gate, kNumBins);
+}
+
+float LoudnessMeter::GatingHistogram::GatedLoudness(
+    float relative_gate_lu) const {
+  int count = 0;
+  double energy = 0.0;
+  for (size_t bin = RelativeGateBin(relative_gate_lu); bin < kNumBins; ++bin) {
+    count += counts_[bin];
+    energy += energies_[bin];
+  }
+  return count > 0 ? EnergyToLoudness(energy / count) : kMinLoudnessLufs;
+}
+
+float LoudnessMeter::GatingHistogram::Range(float relative_gate_lu) const {
+  const size_t first_bin = RelativeGateBin(relative_gate_lu);
+  int count = 0;
+  for (size_t bin = first_bin; bin < kNumBins; ++bin) {
+    count += counts_[bin];
+  }
+  if (count == 0) {
+    return 0.f;
+  }
+  // Nearest-rank percentiles of the gated blocks.
+  const int low_rank =
+      static_cast<int>((count - 1) * kRangeLowPercentile + 0.5f);
+  const int high_rank =
+      static_cast<int>((count - 1) * kRangeHighPercentile + 0.5f);
+  size_t low_bin = first_bin;
+  size_t high_bin = first_bin;
+  int rank = 0;
+  for (size_t bin = first_bin; bin < kNumBins; ++bin) {
+    if (rank <= low_rank) {
+      low_bin = bin;
+    }
+    if (rank <= high_rank) {
+      high_bin = bin;
+    }
+    rank += counts_[bin];
+  }
+  return (high_bin - low_bin) * kBinWidthLu;
+}
+
+LoudnessMeter::LoudnessMeter(int sample_rate_hz, size_t num_channels)
+    : use_sse2_(IsSse2Available()) {
+  Initialize(sample_rate_hz, num_channels);
+}
+
+LoudnessMeter::~LoudnessMeter() = default;
+
+void LoudnessMeter::Initialize(int sample_rate_hz, size_t num_channels) {
+  RTC_DCHECK_GT(sample_rate_hz, 0);
+  RTC_DCHECK_EQ(static_cast<size_t>(sample_rate_hz) % kStepsPerSecond, 0u);
+  RTC_DCHECK_GT(num_channels, 0);
+  if (sample_rate_hz != sample_rate_hz_) {
+    sample_rate_hz_ = sample_rate_hz;
+    step_length_ = sample_rate_hz / kStepsPerSecond;
+    // The block form of the recursion is used for mono, since its rounding
+    // differences are negligible in the measured energy.
+    k_weighting_.reset(new MultiChannelBiQuadFilter(
+        ComputeKWeightingCoefficients(sample_rate_hz), num_channels,
+        /*use_block_form_for_mono=*/true));
+  } else if (num_channels != num_channels_) {
+    k_weighting_->SetNumChannels(num_channels);
+  }
+  if (num_channels != num_channels_) {
+    num_channels_ = num_channels;
+    filtered_.resize(num_channels * kMaxChunkLength);
+    filtered_channels_.resize(num_channels);
+    for (size_t ch = 0; ch < num_channels; ++ch) {
+      filtered_channels_[ch] = &filtered_[ch * kMaxChunkLength];
+    }
+  }
+  Reset();
+}
+
+void LoudnessMeter::Analyze(rtc::ArrayView<const float* const> channels,
+                            size_t num_frames) {
+  RTC_DCHECK_EQ(channels.size(), num_channels_);
+  size_t offset = 0;
+  while (offset < num_frames) {
+    // Each chunk ends at or before the end of the current step.
+    const size_t length =
+        std::min(std::min(num_frames - offset, kMaxChunkLength),
+                 step_length_ - step_position_);
+    for (size_t ch = 0; ch < num_channels_; ++ch) {
+      std::copy(channels[ch] + offset, channels[ch] + offset + length,
+                filtered_channels_[ch]);
+    }
+    k_weighting_->Process(filtered_channels_, length);
+    for (size_t ch = 0; ch < num_channels_; ++ch) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+      if (use_sse2_) {
+        step_energy_ += SumOfSquaresSse2(filtered_channels_[ch], length);
+        continue;
+      }
+#endif
+      step_energy_ += SumOfSquares(filtered_channels_[ch], length);
+    }
+    offset += length;
+    step_position_ += length;
+    if (step_position_ == step_length_) {
+      EndStep();
+    }
+  }
+}
+
+void LoudnessMeter::Analyze(AudioFrameView<const float> frame) {
+  Analyze(rtc::ArrayView<const float* const>(frame.data(),
+                                             frame.num_channels()),
+          frame.samples_per_channel());
+}
+
+void LoudnessMeter::Reset() {
+  k_weighting_->Reset();
+  step_energy_ = 0.0;
+  step_position_ = 0;
+  step_energies_.fill(0.0);
+  next_step_ = 0;
+  num_steps_ = 0;
+  momentary_loudness_ = kMinLoudnessLufs;
+  short_term_loudness_ = kMinLoudnessLufs;
+  momentary_histogram_.Reset();
+  short_term_histogram_.Reset();
+}
+
+float LoudnessMeter::IntegratedLoudness() const {
+  return momentary_histogram_.GatedLoudness(kIntegratedRelativeGateLu);
+}
+
+float LoudnessMeter::LoudnessRange() const {
+  return short_term_histogram_.Range(kRangeRelativeGateLu);
+}
+
+void LoudnessMeter::EndStep() {
+  const size_t num_history_steps = step_energies_.size();
+  step_energies_[next_step_] = step_energy_ * kEnergyScale / step_length_;
+  next_step_ = (next_step_ + 1) % num_history_steps;
+  num_steps_ = std::min(num_steps_ + 1, num_history_steps);
+  step_energy_ = 0.0;
+  step_position_ = 0;
+
+  // The windows are summed from the newest step backwards, which is cheap
+  // enough at 10 steps per second not to require running sums.
+  double momentary_energy = 0.0;
+  double short_term_energy = 0.0;
+  for (size_t i = 0; i < num_steps_; ++i) {
+    const double energy =
+        step_energies_[(next_step_ + num_history_steps - 1 - i) %
+                       num_history_steps];
+    if (i < kMomentarySteps) {
+      momentary_energy += energy;
+    }
+    short_term_energy += energy;
+  }
+  momentary_energy /= std::min(num_steps_, kMomentarySteps);
+  short_term_energy /= num_steps_;
+  momentary_loudness_ = EnergyToLoudness(momentary_energy);
+  short_term_loudness_ = EnergyToLoudness(short_term_energy);
+
+  // Only complete windows are gated.
+  if (num_steps_ >= kMomentarySteps) {
+    momentary_histogram_.Add(momentary_energy);
+  }
+  if (num_steps_ == num_history_steps) {
+    short_term_histogram_.Add(short_term_energy);
+  }
+}
+
+}  // namespace webrtc
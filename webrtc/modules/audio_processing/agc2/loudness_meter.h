@@ -0,0 +1,132 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_AUDIO_PROCESSING_AGC2_LOUDNESS_METER_H_
+#define MODULES_AUDIO_PROCESSING_AGC2_LOUDNESS_METER_H_
+
+#include <stddef.h>
+
+#include <array>
+#include <memory>
+#include <vector>
+
+#include "api/array_view.h"
+#include "modules/audio_processing/include/audio_frame_view.h"
+
+namespace webrtc {
+
+class MultiChannelBiQuadFilter;
+
+// Loudness reported when no audio, or only digital silence, has been
+// measured (LUFS).
+constexpr float kMinLoudnessLufs = -90.f;
+
+// Streaming loudness meter as specified in ITU-R BS.1770-4 and EBU R128.
+// The channels are K-weighted, one channel per SIMD lane, and the energy of
+// the filtered signal is accumulated in steps of 100 ms. The momentary (400
+// ms) and short-term (3 s) loudness are updated at the end of each step from
+// a ring buffer of step energies. The gating of the integrated loudness and
+// of the loudness range uses histograms of the block loudness with 0.1 LU
+// bins, hence the cost of the analysis does not depend on the length of the
+// measurement. All the channels have weight 1, as the front channels in
+// BS.1770. The samples are expected in the S16 range of the float APM
+// frames, where a full-scale 1 kHz sine measures about -3 LUFS.
+class LoudnessMeter {
+ public:
+  LoudnessMeter(int sample_rate_hz, size_t num_channels);
+  LoudnessMeter(const LoudnessMeter&) = delete;
+  LoudnessMeter& operator=(const LoudnessMeter&) = delete;
+  ~LoudnessMeter();
+
+  // Changes the sample rate and the number of channels and resets the meter.
+  // Memory is only allocated if either of them changes.
+  void Initialize(int sample_rate_hz, size_t num_channels);
+
+  // Analyzes the first `num_frames` samples of each of the `channels`, whose
+  // number must be num_channels(). Any number of samples may be passed.
+  void Analyze(rtc::ArrayView<const float* const> channels, size_t num_frames);
+  void Analyze(AudioFrameView<const float> frame);
+
+  // Forgets the measured audio, without changing the filter coefficients.
+  void Reset();
+
+  // Returns true once the first 100 ms have been analyzed.
+  bool has_loudness() const { return num_steps_ > 0; }
+
+  // Loudness of the last 400 ms (LUFS). Until 400 ms have been analyzed, the
+  // loudness of all the audio analyzed so far.
+  float momentary_loudness() const { return momentary_loudness_; }
+  // Loudness of the last 3 s (LUFS), with the same ramp-up as the momentary
+  // loudness.
+  float short_term_loudness() const { return short_term_loudness_; }
+
+  // Gated loudness of the audio analyzed since the last reset (LUFS).
+  float IntegratedLoudness() const;
+  // Loudness range of the audio analyzed since the last reset, as specified
+  // in EBU Tech 3342 (LU). Zero until 3 s have been analyzed.
+  float LoudnessRange() const;
+
+  int sample_rate_hz() const { return sample_rate_hz_; }
+  size_t num_channels() const { return num_channels_; }
+
+ private:
+  // Histogram of block loudness values above the absolute gate of -70 LUFS.
+  // Each bin holds the number of blocks and the sum of their energies, such
+  // that the gated loudness only depends on the bins through the relative
+  // gate.
+  class GatingHistogram {
+   public:
+    void Add(double energy);
+    void Reset();
+    // Returns the index of the first bin above the relative gate, which is
+    // `relative_gate_lu` below the loudness of the blocks above the absolute
+    // gate.
+    size_t RelativeGateBin(float relative_gate_lu) const;
+    // Loudness of the blocks above the relative gate (LUFS).
+    float GatedLoudness(float relative_gate_lu) const;
+    // Difference between the 95th and the 10th percentiles of the loudness
+    // of the blocks above the relative gate (LU).
+    float Range(float relative_gate_lu) const;
+
+   private:
+    static constexpr size_t kNumBins = 800;
+    std::array<int, kNumBins> counts_;
+    std::array<double, kNumBins> energies_;
+    int total_count_;
+    double total_energy_;
+  };
+
+  void EndStep();
+
+  const bool use_sse2_;
+  int sample_rate_hz_ = 0;
+  size_t num_channels_ = 0;
+  size_t step_length_ = 0;
+  std::unique_ptr<MultiChannelBiQuadFilter> k_weighting_;
+  // K-weighted samples of each channel, and pointers to them.
+  std::vector<float> filtered_;
+  std::vector<float*> filtered_channels_;
+
+  // Sum of the squared K-weighted samples of the current step.
+  double step_energy_;
+  size_t step_position_;
+  // Mean square of each of the last 30 steps, summed over the channels.
+  std::array<double, 30> step_energies_;
+  size_t next_step_;
+  size_t num_steps_;
+  float momentary_loudness_;
+  float short_term_loudness_;
+  GatingHistogram momentary_histogram_;
+  GatingHistogram short_term_histogram_;
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_AUDIO_PROCESSING_AGC2_LOUDNESS_METER_H_
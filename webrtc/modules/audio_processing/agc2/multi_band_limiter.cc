@@ -0,0 +1,58 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_processing/agc2/multi_band_limiter.h"
+
+#include "api/array_view.h"
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+namespace {
+
+constexpr size_t kBandSampleRateHz = 16000;
+
+}  // namespace
+
+constexpr size_t MultiBandLimiter::kMaxNumBands;
+
+MultiBandLimiter::MultiBandLimiter(ApmDataDumper* apm_data_dumper,
+                                   std::string histogram_name_prefix) {
+  for (auto& limiter : limiters_) {
+    limiter.reset(new Limiter(kBandSampleRateHz, apm_data_dumper,
+                              histogram_name_prefix));
+  }
+}
+
+MultiBandLimiter::~MultiBandLimiter() = default;
+
+void MultiBandLimiter::Process(size_t band_index,
+                               AudioFrameView<float> band,
+                               float downstream_gain) {
+  RTC_DCHECK_LT(band_index, kMaxNumBands);
+  RTC_DCHECK_EQ(band.samples_per_channel(),
+                kBandSampleRateHz * kFrameDurationMs / 1000);
+  RTC_DCHECK_GT(downstream_gain, 0.f);
+  // The levels of the band after the downstream gain select the gains, which
+  // are applied to the band as it is.
+  frame_stats_analyzer_.Analyze(band, &frame_stats_);
+  for (size_t sub_frame = 0; sub_frame < kSubFramesInFrame; ++sub_frame) {
+    envelope_[sub_frame] = frame_stats_.envelope[sub_frame] * downstream_gain;
+  }
+  limiters_[band_index]->Process(band, rtc::ArrayView<const float>(),
+                                 envelope_);
+}
+
+void MultiBandLimiter::Reset() {
+  for (auto& limiter : limiters_) {
+    limiter->Reset();
+  }
+}
+
+}  // namespace webrtc
@@ -0,0 +1,65 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_AUDIO_PROCESSING_AGC2_MULTI_BAND_LIMITER_H_
+#define MODULES_AUDIO_PROCESSING_AGC2_MULTI_BAND_LIMITER_H_
+
+#include <stddef.h>
+
+#include <array>
+#include <memory>
+#include <string>
+
+#include "modules/audio_processing/agc2/agc2_common.h"
+#include "modules/audio_processing/agc2/frame_stats.h"
+#include "modules/audio_processing/agc2/limiter.h"
+#include "modules/audio_processing/include/audio_frame_view.h"
+
+namespace webrtc {
+class ApmDataDumper;
+
+// Limits the frequency bands of a split signal separately, so that a loud
+// band does not reduce the gain of the other ones. Each band has its own
+// Limiter, whose level is that of the band after the gain that is applied to
+// the merged signal afterwards. Hence a band is only attenuated when it would
+// reach the knee of the gain curve by itself, and the merged signal still
+// needs a broadband limiter for the sum of the bands.
+class MultiBandLimiter {
+ public:
+  // Largest number of bands, that of a 48 kHz signal.
+  static constexpr size_t kMaxNumBands = 3;
+
+  MultiBandLimiter(ApmDataDumper* apm_data_dumper,
+                   std::string histogram_name_prefix);
+  MultiBandLimiter(const MultiBandLimiter&) = delete;
+  MultiBandLimiter& operator=(const MultiBandLimiter&) = delete;
+  ~MultiBandLimiter();
+
+  // Limits |band|, the band with index |band_index| of a frame split into
+  // 16 kHz bands, given the linear |downstream_gain| that is applied to the
+  // frame after merging the bands. Memory is only allocated when the number
+  // of channels differs from that of the previous call.
+  void Process(size_t band_index,
+               AudioFrameView<float> band,
+               float downstream_gain);
+
+  // Resets the limiters of all the bands.
+  void Reset();
+
+ private:
+  const FrameStatsAnalyzer frame_stats_analyzer_;
+  FrameStats frame_stats_;
+  std::array<float, kSubFramesInFrame> envelope_;
+  std::array<std::unique_ptr<Limiter>, kMaxNumBands> limiters_;
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_AUDIO_PROCESSING_AGC2_MULTI_BAND_LIMITER_H_
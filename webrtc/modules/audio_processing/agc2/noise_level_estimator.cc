@@ -14,10 +14,12 @@
 
 #include <algorithm>
 #include <cmath>
-#include <numeric>
+#include <limits>
 
 #include "api/array_view.h"
 #include "common_audio/include/audio_util.h"
+#include "modules/audio_processing/agc2/frame_stats.h"
+#include "modules/audio_processing/agc2/state_snapshot.h"
 #include "modules/audio_processing/logging/apm_data_dumper.h"
 #include "rtc_base/checks.h"
 
@@ -25,17 +27,9 @@ namespace webrtc {
 
 namespace {
 constexpr int kFramesPerSecond = 100;
-
-float FrameEnergy(const AudioFrameView<const float>& audio) {
-  float energy = 0.f;
-  for (size_t k = 0; k < audio.num_channels(); ++k) {
-    float channel_energy =
-        std::accumulate(audio.channel(k).begin(), audio.channel(k).end(), 0.f,
-                        [](float a, float b) -> float { return a + b * b; });
-    energy = std::max(channel_energy, energy);
-  }
-  return energy;
-}
+// Number of frames during which the noise estimate is not leaked upwards after
+// a downward update.
+constexpr int kNoiseEnergyHoldFrames = 1000;
 
 float EnergyToDbfs(float signal_energy, size_t num_samples) {
   const float rms = std::sqrt(signal_energy / num_samples);
@@ -50,6 +44,35 @@ NoiseLevelEstimator::NoiseLevelEstimator(ApmDataDumper* data_dumper)
 
 NoiseLevelEstimator::~NoiseLevelEstimator() {}
 
+void NoiseLevelEstimator::SaveState(StateSnapshotWriter* writer) const {
+  writer->Write(sample_rate_hz_);
+  writer->Write(first_update_);
+  writer->Write(noise_energy_);
+  writer->Write(noise_energy_hold_counter_);
+  signal_classifier_.SaveState(writer);
+}
+
+void NoiseLevelEstimator::RestoreState(StateSnapshotReader* reader) {
+  int sample_rate_hz = 0;
+  reader->Read(&sample_rate_hz);
+  if (sample_rate_hz != 8000 && sample_rate_hz != 16000 &&
+      sample_rate_hz != 32000 && sample_rate_hz != 48000) {
+    reader->SetFailed();
+    return;
+  }
+  if (sample_rate_hz != sample_rate_hz_) {
+    Initialize(sample_rate_hz);
+  }
+  reader->Read(&first_update_);
+  reader->ReadInRange(&noise_energy_, 0.f, std::numeric_limits<float>::max());
+  reader->ReadInRange(&noise_energy_hold_counter_, 0, kNoiseEnergyHoldFrames);
+  signal_classifier_.RestoreState(reader);
+}
+
+void NoiseLevelEstimator::Reset() {
+  Initialize(sample_rate_hz_);
+}
+
 void NoiseLevelEstimator::Initialize(int sample_rate_hz) {
   sample_rate_hz_ = sample_rate_hz;
   noise_energy_ = 1.f;
@@ -59,13 +82,15 @@ void NoiseLevelEstimator::Initialize(int sample_rate_hz) {
   signal_classifier_.Initialize(sample_rate_hz);
 }
 
-float NoiseLevelEstimator::Analyze(const AudioFrameView<const float>& frame) {
+float NoiseLevelEstimator::Analyze(const AudioFrameView<const float>& frame,
+                                   const FrameStats& stats) {
+  RTC_DCHECK_EQ(stats.samples_per_channel, frame.samples_per_channel());
   const int rate =
       static_cast<int>(frame.samples_per_channel() * kFramesPerSecond);
   if (rate != sample_rate_hz_) {
     Initialize(rate);
   }
-  const float frame_energy = FrameEnergy(frame);
+  const float frame_energy = stats.MaxEnergy();
   if (frame_energy <= 0.f) {
     RTC_DCHECK_GE(frame_energy, 0.f);
     return EnergyToDbfs(noise_energy_, frame.samples_per_channel());
@@ -97,7 +122,7 @@ float NoiseLevelEstimator::Analyze(const AudioFrameView<const float>& frame) {
       noise_energy_ =
           std::max(noise_energy_ * 0.9f,
                    noise_energy_ + 0.05f * (frame_energy - noise_energy_));
-      noise_energy_hold_counter_ = 1000;
+      noise_energy_hold_counter_ = kNoiseEnergyHoldFrames;
     }
   } else {
     // For a non-stationary signal, leak the estimate downwards in order to
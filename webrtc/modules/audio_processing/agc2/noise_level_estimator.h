@@ -17,13 +17,25 @@
 
 namespace webrtc {
 class ApmDataDumper;
+struct FrameStats;
+class StateSnapshotReader;
+class StateSnapshotWriter;
 
 class NoiseLevelEstimator {
  public:
   NoiseLevelEstimator(ApmDataDumper* data_dumper);
   ~NoiseLevelEstimator();
-  // Returns the estimated noise level in dBFS.
-  float Analyze(const AudioFrameView<const float>& frame);
+  // Returns the estimated noise level in dBFS. |stats| must have been computed
+  // for |frame|.
+  float Analyze(const AudioFrameView<const float>& frame,
+                const FrameStats& stats);
+  // Resets the noise estimate and the classifier state.
+  void Reset();
+
+  // Writes the noise estimate and the classifier state into |writer|.
+  void SaveState(StateSnapshotWriter* writer) const;
+  // Restores the state written by SaveState().
+  void RestoreState(StateSnapshotReader* reader);
 
  private:
   void Initialize(int sample_rate_hz);
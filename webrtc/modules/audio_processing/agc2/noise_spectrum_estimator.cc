@@ -13,8 +13,10 @@
 #include <string.h>
 
 #include <algorithm>
+#include <limits>
 
 #include "api/array_view.h"
+#include "modules/audio_processing/agc2/state_snapshot.h"
 #include "modules/audio_processing/logging/apm_data_dumper.h"
 #include "rtc_base/arraysize.h"
 #include "rtc_base/checks.h"
@@ -67,4 +69,13 @@ void NoiseSpectrumEstimator::Update(rtc::ArrayView<const float> spectrum,
   data_dumper_->DumpRaw("lc_signal_spectrum", spectrum);
 }
 
+void NoiseSpectrumEstimator::SaveState(StateSnapshotWriter* writer) const {
+  writer->Write(noise_spectrum_);
+}
+
+void NoiseSpectrumEstimator::RestoreState(StateSnapshotReader* reader) {
+  reader->ReadArrayInRange<float>(noise_spectrum_, kMinNoisePower,
+                                  std::numeric_limits<float>::max());
+}
+
 }  // namespace webrtc
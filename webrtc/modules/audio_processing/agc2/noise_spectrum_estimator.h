@@ -16,6 +16,8 @@
 namespace webrtc {
 
 class ApmDataDumper;
+class StateSnapshotReader;
+class StateSnapshotWriter;
 
 class NoiseSpectrumEstimator {
  public:
@@ -28,6 +30,11 @@ class NoiseSpectrumEstimator {
   void Initialize();
   void Update(rtc::ArrayView<const float> spectrum, bool first_update);
 
+  // Writes the noise spectrum into |writer|.
+  void SaveState(StateSnapshotWriter* writer) const;
+  // Restores the noise spectrum written by SaveState().
+  void RestoreState(StateSnapshotReader* reader);
+
   rtc::ArrayView<const float> GetNoiseSpectrum() const {
     return rtc::ArrayView<const float>(noise_spectrum_);
   }
@@ -12,7 +12,9 @@
 
 #include <array>
 
+#include "modules/audio_processing/agc2/agc2_common.h"
 #include "modules/audio_processing/agc2/rnn_vad/lp_residual.h"
+#include "modules/audio_processing/agc2/state_snapshot.h"
 #include "rtc_base/checks.h"
 
 namespace webrtc {
@@ -27,13 +29,13 @@ const BiQuadFilter::BiQuadCoefficients kHpfConfig24k = {
 }  // namespace
 
 FeaturesExtractor::FeaturesExtractor()
-    : use_high_pass_filter_(false),
+    : optimization_(DetectOptimization()),
+      use_high_pass_filter_(false),
       pitch_buf_24kHz_(),
-      pitch_buf_24kHz_view_(pitch_buf_24kHz_.GetBufferView()),
       lp_residual_(kBufSize24kHz),
       lp_residual_view_(lp_residual_.data(), kBufSize24kHz),
-      pitch_estimator_(),
-      reference_frame_view_(pitch_buf_24kHz_.GetMostRecentValuesView()) {
+      pitch_estimator_(optimization_),
+      spectral_features_extractor_(optimization_) {
   RTC_DCHECK_EQ(kBufSize24kHz, lp_residual_.size());
   hpf_.Initialize(kHpfConfig24k);
   Reset();
@@ -43,11 +45,30 @@ FeaturesExtractor::~FeaturesExtractor() = default;
 
 void FeaturesExtractor::Reset() {
   pitch_buf_24kHz_.Reset();
+  pitch_estimator_.Reset();
   spectral_features_extractor_.Reset();
   if (use_high_pass_filter_)
     hpf_.Reset();
 }
 
+void FeaturesExtractor::SaveState(StateSnapshotWriter* writer) const {
+  hpf_.SaveState(writer);
+  pitch_buf_24kHz_.SaveState(writer);
+  pitch_estimator_.SaveState(writer);
+  spectral_features_extractor_.SaveState(writer);
+}
+
+void FeaturesExtractor::RestoreState(StateSnapshotReader* reader) {
+  // Twice the largest input to allow for the overshoot of the resampler and of
+  // the high-pass filter.
+  constexpr float kMaxAbsSampleValue = 2.f * kMaxAbsAnalyzedSampleValue;
+  hpf_.RestoreState(reader, kMaxAbsSampleValue);
+  pitch_buf_24kHz_.RestoreState(reader, -kMaxAbsSampleValue,
+                                kMaxAbsSampleValue);
+  pitch_estimator_.RestoreState(reader);
+  spectral_features_extractor_.RestoreState(reader);
+}
+
 bool FeaturesExtractor::CheckSilenceComputeFeatures(
     rtc::ArrayView<const float, kFrameSize10ms24kHz> samples,
     rtc::ArrayView<float, kFeatureVectorSize> feature_vector) {
@@ -61,10 +82,14 @@ bool FeaturesExtractor::CheckSilenceComputeFeatures(
     // Feed buffer with |samples|.
     pitch_buf_24kHz_.Push(samples);
   }
+  // The views on the pitch buffer are only valid until the next push.
+  const auto pitch_buf_24kHz_view = pitch_buf_24kHz_.GetBufferView();
   // Extract the LP residual.
   float lpc_coeffs[kNumLpcCoefficients];
-  ComputeAndPostProcessLpcCoefficients(pitch_buf_24kHz_view_, lpc_coeffs);
-  ComputeLpResidual(lpc_coeffs, pitch_buf_24kHz_view_, lp_residual_view_);
+  ComputeAndPostProcessLpcCoefficients(pitch_buf_24kHz_view, lpc_coeffs,
+                                       optimization_);
+  ComputeLpResidual(lpc_coeffs, pitch_buf_24kHz_view, lp_residual_view_,
+                    optimization_);
   // Estimate pitch on the LP-residual and write the normalized pitch period
   // into the output vector (normalization based on training data stats).
   pitch_info_48kHz_ = pitch_estimator_.Estimate(lp_residual_view_);
@@ -72,12 +97,13 @@ bool FeaturesExtractor::CheckSilenceComputeFeatures(
       0.01f * (static_cast<int>(pitch_info_48kHz_.period) - 300);
   // Extract lagged frames (according to the estimated pitch period).
   RTC_DCHECK_LE(pitch_info_48kHz_.period / 2, kMaxPitch24kHz);
-  auto lagged_frame = pitch_buf_24kHz_view_.subview(
+  auto lagged_frame = pitch_buf_24kHz_view.subview(
       kMaxPitch24kHz - pitch_info_48kHz_.period / 2, kFrameSize20ms24kHz);
   // Analyze reference and lagged frames checking if silence has been detected
   // and write the feature vector.
   return spectral_features_extractor_.CheckSilenceComputeFeatures(
-      reference_frame_view_, {lagged_frame.data(), kFrameSize20ms24kHz},
+      pitch_buf_24kHz_.GetMostRecentValuesView(),
+      {lagged_frame.data(), kFrameSize20ms24kHz},
       {feature_vector.data() + kNumLowerBands, kNumBands - kNumLowerBands},
       {feature_vector.data(), kNumLowerBands},
       {feature_vector.data() + kNumBands, kNumLowerBands},
@@ -32,6 +32,10 @@ class FeaturesExtractor {
   FeaturesExtractor& operator=(const FeaturesExtractor&) = delete;
   ~FeaturesExtractor();
   void Reset();
+  // Writes the internal state into |writer|.
+  void SaveState(StateSnapshotWriter* writer) const;
+  // Restores the internal state written by SaveState().
+  void RestoreState(StateSnapshotReader* reader);
   // Analyzes the samples, computes the feature vector and returns true if
   // silence is detected (false if not). When silence is detected,
   // |feature_vector| is partially written and therefore must not be used to
@@ -41,17 +45,16 @@ class FeaturesExtractor {
       rtc::ArrayView<float, kFeatureVectorSize> feature_vector);
 
  private:
+  const Optimization optimization_;
   const bool use_high_pass_filter_;
   // TODO(bugs.webrtc.org/7494): Remove HPF depending on how AGC2 is used in APM
   // and on whether an HPF is already used as pre-processing step in APM.
   BiQuadFilter hpf_;
   SequenceBuffer<float, kBufSize24kHz, kFrameSize10ms24kHz, kFrameSize20ms24kHz>
       pitch_buf_24kHz_;
-  rtc::ArrayView<const float, kBufSize24kHz> pitch_buf_24kHz_view_;
   std::vector<float> lp_residual_;
   rtc::ArrayView<float, kBufSize24kHz> lp_residual_view_;
   PitchEstimator pitch_estimator_;
-  rtc::ArrayView<const float, kFrameSize20ms24kHz> reference_frame_view_;
   SpectralFeaturesExtractor spectral_features_extractor_;
   PitchInfo pitch_info_48kHz_;
 };
@@ -10,6 +10,12 @@
 
 #include "modules/audio_processing/agc2/rnn_vad/lp_residual.h"
 
+// Defines WEBRTC_ARCH_X86_FAMILY, used below.
+#include "rtc_base/system/arch.h"
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#include <emmintrin.h>
+#endif
 #include <algorithm>
 #include <array>
 #include <cmath>
@@ -40,6 +46,110 @@ void ComputeCrossCorrelation(
   }
 }
 
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+// Returns the sum of the four elements of |v|.
+float HorizontalSumSse2(__m128 v) {
+  v = _mm_add_ps(v, _mm_movehl_ps(v, v));
+  v = _mm_add_ss(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1)));
+  return _mm_cvtss_f32(v);
+}
+
+// ComputeCrossCorrelation() SSE2 implementation. Two partial sums of 4 values
+// are accumulated for each lag, hence the result differs from the un-optimized
+// one by rounding errors.
+void ComputeCrossCorrelationSse2(
+    rtc::ArrayView<const float> x,
+    rtc::ArrayView<const float> y,
+    rtc::ArrayView<float, kNumLpcCoefficients> x_corr) {
+  constexpr size_t max_lag = x_corr.size();
+  RTC_DCHECK_EQ(x.size(), y.size());
+  RTC_DCHECK_LT(max_lag, x.size());
+  for (size_t lag = 0; lag < max_lag; ++lag) {
+    const size_t size = x.size() - lag;
+    const float* x_p = x.data();
+    const float* y_p = y.data() + lag;
+    __m128 sum0 = _mm_setzero_ps();
+    __m128 sum1 = _mm_setzero_ps();
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+      sum0 = _mm_add_ps(
+          sum0, _mm_mul_ps(_mm_loadu_ps(x_p + i), _mm_loadu_ps(y_p + i)));
+      sum1 = _mm_add_ps(sum1, _mm_mul_ps(_mm_loadu_ps(x_p + i + 4),
+                                         _mm_loadu_ps(y_p + i + 4)));
+    }
+    float sum = HorizontalSumSse2(_mm_add_ps(sum0, sum1));
+    for (; i < size; ++i) {
+      sum += x_p[i] * y_p[i];
+    }
+    x_corr[lag] = sum;
+  }
+}
+
+// Given |a| = x[n - 4:n] and |b| = x[n:n + 4], the functions below return
+// x[n - k:n - k + 4] for k = 1, 2, 3.
+__m128 ShiftBy1Sse2(__m128 a, __m128 b) {
+  const __m128 t = _mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 0, 3, 3));
+  return _mm_shuffle_ps(t, b, _MM_SHUFFLE(2, 1, 2, 0));
+}
+
+__m128 ShiftBy2Sse2(__m128 a, __m128 b) {
+  return _mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 0, 3, 2));
+}
+
+__m128 ShiftBy3Sse2(__m128 a, __m128 b) {
+  const __m128 t = _mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 3, 3));
+  return _mm_shuffle_ps(a, t, _MM_SHUFFLE(2, 0, 2, 1));
+}
+
+// ComputeLpResidual() SSE2 implementation. Computes 4 output samples at a
+// time. The filter taps are added in the same order as in the un-optimized
+// implementation, which gives the same result. The past input samples are
+// kept in registers, so that |x| and |y| can point to the same array.
+void ComputeLpResidualSse2(
+    rtc::ArrayView<const float, kNumLpcCoefficients> lpc_coeffs,
+    rtc::ArrayView<const float> x,
+    rtc::ArrayView<float> y) {
+  static_assert(kNumLpcCoefficients == 5, "");
+  const __m128 c0 = _mm_set1_ps(lpc_coeffs[0]);
+  const __m128 c1 = _mm_set1_ps(lpc_coeffs[1]);
+  const __m128 c2 = _mm_set1_ps(lpc_coeffs[2]);
+  const __m128 c3 = _mm_set1_ps(lpc_coeffs[3]);
+  const __m128 c4 = _mm_set1_ps(lpc_coeffs[4]);
+  // x[i - 8:i - 4] and x[i - 4:i].
+  __m128 x_old = _mm_setzero_ps();
+  __m128 x_prev = _mm_setzero_ps();
+  size_t i = 0;
+  for (; i + 4 <= y.size(); i += 4) {
+    const __m128 x_curr = _mm_loadu_ps(x.data() + i);
+    __m128 sum =
+        _mm_add_ps(x_curr, _mm_mul_ps(ShiftBy1Sse2(x_prev, x_curr), c0));
+    sum = _mm_add_ps(sum, _mm_mul_ps(ShiftBy2Sse2(x_prev, x_curr), c1));
+    sum = _mm_add_ps(sum, _mm_mul_ps(ShiftBy3Sse2(x_prev, x_curr), c2));
+    sum = _mm_add_ps(sum, _mm_mul_ps(x_prev, c3));
+    sum = _mm_add_ps(sum, _mm_mul_ps(ShiftBy1Sse2(x_old, x_prev), c4));
+    _mm_storeu_ps(y.data() + i, sum);
+    x_old = x_prev;
+    x_prev = x_curr;
+  }
+  // Remaining samples.
+  std::array<float, 8> x_past;
+  _mm_storeu_ps(x_past.data(), x_old);
+  _mm_storeu_ps(x_past.data() + 4, x_prev);
+  std::array<float, kNumLpcCoefficients> input_chunk;
+  for (size_t j = 0; j < kNumLpcCoefficients; ++j) {
+    input_chunk[j] = x_past[x_past.size() - 1 - j];
+  }
+  for (; i < y.size(); ++i) {
+    const float sum = std::inner_product(input_chunk.begin(), input_chunk.end(),
+                                         lpc_coeffs.begin(), x[i]);
+    for (size_t j = kNumLpcCoefficients - 1; j > 0; --j)
+      input_chunk[j] = input_chunk[j - 1];
+    input_chunk[0] = x[i];
+    y[i] = sum;
+  }
+}
+#endif
+
 // Applies denoising to the auto-correlation coefficients.
 void DenoiseAutoCorrelation(
     rtc::ArrayView<float, kNumLpcCoefficients> auto_corr) {
@@ -89,9 +199,18 @@ void ComputeInitialInverseFilterCoefficients(
 
 void ComputeAndPostProcessLpcCoefficients(
     rtc::ArrayView<const float> x,
-    rtc::ArrayView<float, kNumLpcCoefficients> lpc_coeffs) {
+    rtc::ArrayView<float, kNumLpcCoefficients> lpc_coeffs,
+    Optimization optimization) {
   std::array<float, kNumLpcCoefficients> auto_corr;
-  ComputeCrossCorrelation(x, x, {auto_corr.data(), auto_corr.size()});
+  switch (optimization) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+    case Optimization::kSse2:
+      ComputeCrossCorrelationSse2(x, x, {auto_corr.data(), auto_corr.size()});
+      break;
+#endif
+    default:
+      ComputeCrossCorrelation(x, x, {auto_corr.data(), auto_corr.size()});
+  }
   if (auto_corr[0] == 0.f) {  // Empty frame.
     std::fill(lpc_coeffs.begin(), lpc_coeffs.end(), 0);
     return;
@@ -117,9 +236,16 @@ void ComputeAndPostProcessLpcCoefficients(
 void ComputeLpResidual(
     rtc::ArrayView<const float, kNumLpcCoefficients> lpc_coeffs,
     rtc::ArrayView<const float> x,
-    rtc::ArrayView<float> y) {
+    rtc::ArrayView<float> y,
+    Optimization optimization) {
   RTC_DCHECK_LT(kNumLpcCoefficients, x.size());
   RTC_DCHECK_EQ(x.size(), y.size());
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (optimization == Optimization::kSse2) {
+    ComputeLpResidualSse2(lpc_coeffs, x, y);
+    return;
+  }
+#endif
   std::array<float, kNumLpcCoefficients> input_chunk;
   input_chunk.fill(0.f);
   for (size_t i = 0; i < y.size(); ++i) {
@@ -14,6 +14,7 @@
 #include <stddef.h>
 
 #include "api/array_view.h"
+#include "modules/audio_processing/agc2/rnn_vad/common.h"
 
 namespace webrtc {
 namespace rnn_vad {
@@ -25,7 +26,8 @@ constexpr size_t kNumLpcCoefficients = 5;
 // tailored for pitch estimation.
 void ComputeAndPostProcessLpcCoefficients(
     rtc::ArrayView<const float> x,
-    rtc::ArrayView<float, kNumLpcCoefficients> lpc_coeffs);
+    rtc::ArrayView<float, kNumLpcCoefficients> lpc_coeffs,
+    Optimization optimization = Optimization::kNone);
 
 // Computes the LP residual for the input frame |x| and the LPC coefficients
 // |lpc_coeffs|. |y| and |x| can point to the same array for in-place
@@ -33,7 +35,8 @@ void ComputeAndPostProcessLpcCoefficients(
 void ComputeLpResidual(
     rtc::ArrayView<const float, kNumLpcCoefficients> lpc_coeffs,
     rtc::ArrayView<const float> x,
-    rtc::ArrayView<float> y);
+    rtc::ArrayView<float> y,
+    Optimization optimization = Optimization::kNone);
 
 }  // namespace rnn_vad
 }  // namespace webrtc
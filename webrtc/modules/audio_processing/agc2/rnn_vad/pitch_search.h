@@ -21,20 +21,31 @@
 #include "modules/audio_processing/agc2/rnn_vad/pitch_search_internal.h"
 
 namespace webrtc {
+
+class StateSnapshotReader;
+class StateSnapshotWriter;
+
 namespace rnn_vad {
 
 // Pitch estimator.
 class PitchEstimator {
  public:
-  PitchEstimator();
+  explicit PitchEstimator(Optimization optimization = Optimization::kNone);
   PitchEstimator(const PitchEstimator&) = delete;
   PitchEstimator& operator=(const PitchEstimator&) = delete;
   ~PitchEstimator();
   // Estimates the pitch period and gain. Returns the pitch estimation data for
   // 48 kHz.
   PitchInfo Estimate(rtc::ArrayView<const float, kBufSize24kHz> pitch_buf);
+  // Forgets the last pitch estimate.
+  void Reset();
+  // Writes the last pitch estimate into |writer|.
+  void SaveState(StateSnapshotWriter* writer) const;
+  // Restores the last pitch estimate written by SaveState().
+  void RestoreState(StateSnapshotReader* reader);
 
  private:
+  const Optimization optimization_;
   PitchInfo last_pitch_48kHz_;
   AutoCorrelationCalculator auto_corr_calculator_;
   std::vector<float> pitch_buf_decimated_;
@@ -10,6 +10,12 @@
 
 #include "modules/audio_processing/agc2/rnn_vad/pitch_search_internal.h"
 
+// Defines WEBRTC_ARCH_X86_FAMILY, used below.
+#include "rtc_base/system/arch.h"
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#include <emmintrin.h>
+#endif
 #include <stdlib.h>
 
 #include <algorithm>
@@ -36,11 +42,212 @@ float ComputeAutoCorrelationCoeff(rtc::ArrayView<const float> pitch_buf,
   RTC_DCHECK_LT(inv_lag, pitch_buf.size());
   RTC_DCHECK_LT(max_pitch_period, pitch_buf.size());
   RTC_DCHECK_LE(inv_lag, max_pitch_period);
-  // TODO(bugs.webrtc.org/9076): Maybe optimize using vectorization.
   return std::inner_product(pitch_buf.begin() + max_pitch_period,
                             pitch_buf.end(), pitch_buf.begin() + inv_lag, 0.f);
 }
 
+// Maximum number of inverted lags for which the SSE2 implementation computes
+// the auto-correlation coefficients at once.
+constexpr size_t kAutoCorrelationTileSize = 4;
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+// Returns the sum of the four elements of |v|.
+float HorizontalSumSse2(__m128 v) {
+  v = _mm_add_ps(v, _mm_movehl_ps(v, v));
+  v = _mm_add_ss(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1)));
+  return _mm_cvtss_f32(v);
+}
+
+// Returns the dot product of the first |size| elements of |x| and |y|.
+float DotProductSse2(const float* x, const float* y, size_t size) {
+  __m128 sum0 = _mm_setzero_ps();
+  __m128 sum1 = _mm_setzero_ps();
+  const size_t vectorized_size = size & ~size_t{7};
+  size_t i = 0;
+  for (; i < vectorized_size; i += 8) {
+    sum0 = _mm_add_ps(sum0,
+                      _mm_mul_ps(_mm_loadu_ps(x + i), _mm_loadu_ps(y + i)));
+    sum1 = _mm_add_ps(
+        sum1, _mm_mul_ps(_mm_loadu_ps(x + i + 4), _mm_loadu_ps(y + i + 4)));
+  }
+  float sum = HorizontalSumSse2(_mm_add_ps(sum0, sum1));
+  for (; i < size; ++i) {
+    sum += x[i] * y[i];
+  }
+  return sum;
+}
+
+// Computes the auto-correlation coefficients between the reference frame |x|
+// and |kNumLags| sliding frames |y| at once. Each block of samples of |x| is
+// loaded once and used for all the sliding frames, which keeps one
+// accumulator per lag in a register.
+template <size_t kNumLags>
+void ComputeAutoCorrelationTileSse2(const float* x,
+                                    const float* const* y,
+                                    size_t frame_size,
+                                    float* auto_corr) {
+  static_assert(kNumLags <= kAutoCorrelationTileSize, "");
+  __m128 sum[kNumLags];
+  for (size_t j = 0; j < kNumLags; ++j) {
+    sum[j] = _mm_setzero_ps();
+  }
+  const size_t vectorized_size = frame_size & ~size_t{3};
+  size_t i = 0;
+  for (; i < vectorized_size; i += 4) {
+    const __m128 x_i = _mm_loadu_ps(x + i);
+    for (size_t j = 0; j < kNumLags; ++j) {
+      sum[j] = _mm_add_ps(sum[j], _mm_mul_ps(x_i, _mm_loadu_ps(y[j] + i)));
+    }
+  }
+  for (size_t j = 0; j < kNumLags; ++j) {
+    auto_corr[j] = HorizontalSumSse2(sum[j]);
+    for (size_t k = i; k < frame_size; ++k) {
+      auto_corr[j] += x[k] * y[j][k];
+    }
+  }
+}
+
+// Moves the elements of |v| up by |kNumElements| positions and shifts in zeros.
+template <int kNumElements>
+__m128 ShiftUpSse2(__m128 v) {
+  return _mm_castsi128_ps(
+      _mm_slli_si128(_mm_castps_si128(v), 4 * kNumElements));
+}
+
+// Computes |sums[i]| = max(0, |sums[i - 1]| + |deltas[i]|), where |sums[-1]|
+// is the non-negative |initial_sum|, four values at a time. Within a block,
+// the clamped sum at i equals P(i) - min(-s, P(0), ..., P(i)), where P are the
+// prefix sums of the deltas of the block and s is the last sum of the previous
+// block, i.e., the sum restarts from zero after its lowest prefix. Both scans
+// are computed in registers and every sum is non-negative, as with the scalar
+// clamping at each step.
+void ComputeRunningSumsSse2(float initial_sum,
+                            rtc::ArrayView<const float> deltas,
+                            rtc::ArrayView<float> sums) {
+  RTC_DCHECK_EQ(deltas.size(), sums.size());
+  RTC_DCHECK_GE(initial_sum, 0.f);
+  __m128 offset = _mm_set1_ps(initial_sum);
+  const size_t vectorized_size = deltas.size() & ~size_t{3};
+  size_t i = 0;
+  for (; i < vectorized_size; i += 4) {
+    __m128 prefix_sums = _mm_loadu_ps(&deltas[i]);
+    prefix_sums = _mm_add_ps(prefix_sums, ShiftUpSse2<1>(prefix_sums));
+    prefix_sums = _mm_add_ps(prefix_sums, ShiftUpSse2<2>(prefix_sums));
+    // The zeros shifted in do not change the minimum, which is at most
+    // -|offset| <= 0.
+    __m128 min_prefix_sums = _mm_sub_ps(_mm_setzero_ps(), offset);
+    min_prefix_sums = _mm_min_ps(min_prefix_sums, prefix_sums);
+    min_prefix_sums =
+        _mm_min_ps(min_prefix_sums, ShiftUpSse2<1>(min_prefix_sums));
+    min_prefix_sums =
+        _mm_min_ps(min_prefix_sums, ShiftUpSse2<2>(min_prefix_sums));
+    const __m128 v = _mm_sub_ps(prefix_sums, min_prefix_sums);
+    _mm_storeu_ps(&sums[i], v);
+    offset = _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3));
+  }
+  float sum = _mm_cvtss_f32(offset);
+  for (; i < deltas.size(); ++i) {
+    sum = std::max(0.f, sum + deltas[i]);
+    sums[i] = sum;
+  }
+}
+
+// Returns the four elements of |v| in reversed order.
+__m128 ReverseSse2(__m128 v) {
+  return _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 1, 2, 3));
+}
+#endif
+
+// Computes the auto-correlation coefficients for the inverted lags |inv_lags|
+// (see ComputeAutoCorrelationCoeff()).
+void ComputeAutoCorrelationCoeffs(rtc::ArrayView<const float> pitch_buf,
+                                  rtc::ArrayView<const size_t> inv_lags,
+                                  size_t max_pitch_period,
+                                  rtc::ArrayView<float> auto_corr,
+                                  Optimization optimization) {
+  RTC_DCHECK_EQ(inv_lags.size(), auto_corr.size());
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (optimization == Optimization::kSse2) {
+    RTC_DCHECK_LT(max_pitch_period, pitch_buf.size());
+    const float* x = pitch_buf.data() + max_pitch_period;
+    const size_t frame_size = pitch_buf.size() - max_pitch_period;
+    const float* y[kAutoCorrelationTileSize];
+    for (size_t i = 0; i < inv_lags.size(); i += kAutoCorrelationTileSize) {
+      const size_t num_lags =
+          std::min(kAutoCorrelationTileSize, inv_lags.size() - i);
+      for (size_t j = 0; j < num_lags; ++j) {
+        RTC_DCHECK_LE(inv_lags[i + j], max_pitch_period);
+        y[j] = pitch_buf.data() + inv_lags[i + j];
+      }
+      switch (num_lags) {
+        case 1:
+          auto_corr[i] = DotProductSse2(x, y[0], frame_size);
+          break;
+        case 2:
+          ComputeAutoCorrelationTileSse2<2>(x, y, frame_size, &auto_corr[i]);
+          break;
+        case 3:
+          ComputeAutoCorrelationTileSse2<3>(x, y, frame_size, &auto_corr[i]);
+          break;
+        default:
+          ComputeAutoCorrelationTileSse2<4>(x, y, frame_size, &auto_corr[i]);
+      }
+    }
+    return;
+  }
+#endif
+  for (size_t i = 0; i < inv_lags.size(); ++i) {
+    auto_corr[i] =
+        ComputeAutoCorrelationCoeff(pitch_buf, inv_lags[i], max_pitch_period);
+  }
+}
+
+// Computes the energy of the sliding frames of size |frame_size| + 1 in
+// |pitch_buf| for the inverted lags used in FindBestPitchPeriods(). The
+// energies are biased by 1 to avoid divisions by zero.
+void ComputeSlidingFrameEnergiesForInvertedLags(
+    rtc::ArrayView<const float> pitch_buf,
+    size_t frame_size,
+    rtc::ArrayView<float> yy_values,
+    Optimization optimization) {
+  RTC_DCHECK_LE(yy_values.size() + frame_size, pitch_buf.size());
+  const size_t num_inv_lags = yy_values.size();
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (optimization == Optimization::kSse2) {
+    std::array<float, kNumInvertedLags24kHz> deltas;
+    RTC_DCHECK_LE(num_inv_lags, deltas.size());
+    size_t i = 0;
+    for (; i + 4 < num_inv_lags; i += 4) {
+      const __m128 old_coeffs = _mm_loadu_ps(&pitch_buf[i]);
+      const __m128 new_coeffs = _mm_loadu_ps(&pitch_buf[i + frame_size]);
+      _mm_storeu_ps(&deltas[i], _mm_sub_ps(_mm_mul_ps(new_coeffs, new_coeffs),
+                                           _mm_mul_ps(old_coeffs, old_coeffs)));
+    }
+    for (; i + 1 < num_inv_lags; ++i) {
+      deltas[i] = pitch_buf[i + frame_size] * pitch_buf[i + frame_size] -
+                  pitch_buf[i] * pitch_buf[i];
+    }
+    yy_values[0] = 1.f + DotProductSse2(pitch_buf.data(), pitch_buf.data(),
+                                        frame_size + 1);
+    ComputeRunningSumsSse2(yy_values[0], {deltas.data(), num_inv_lags - 1},
+                           {yy_values.data() + 1, num_inv_lags - 1});
+    return;
+  }
+#endif
+  float yy =
+      std::inner_product(pitch_buf.begin(), pitch_buf.begin() + frame_size + 1,
+                         pitch_buf.begin(), 1.f);
+  for (size_t inv_lag = 0; inv_lag < num_inv_lags; ++inv_lag) {
+    yy_values[inv_lag] = yy;
+    // Update |yy| for the next inverted lag.
+    const float old_coeff = pitch_buf[inv_lag];
+    const float new_coeff = pitch_buf[inv_lag + frame_size];
+    yy -= old_coeff * old_coeff;
+    yy += new_coeff * new_coeff;
+    yy = std::max(0.f, yy);
+  }
+}
+
 // Computes a pseudo-interpolation offset for an estimated pitch period |lag| by
 // looking at the auto-correlation coefficients in the neighborhood of |lag|.
 // (namely, |prev_auto_corr|, |lag_auto_corr| and |next_auto_corr|). The output
@@ -70,18 +277,19 @@ int GetPitchPseudoInterpolationOffset(size_t lag,
 // output sample rate is twice as that of |lag|.
 size_t PitchPseudoInterpolationLagPitchBuf(
     size_t lag,
-    rtc::ArrayView<const float, kBufSize24kHz> pitch_buf) {
+    rtc::ArrayView<const float, kBufSize24kHz> pitch_buf,
+    Optimization optimization) {
   int offset = 0;
   // Cannot apply pseudo-interpolation at the boundaries.
   if (lag > 0 && lag < kMaxPitch24kHz) {
-    offset = GetPitchPseudoInterpolationOffset(
-        lag,
-        ComputeAutoCorrelationCoeff(pitch_buf, GetInvertedLag(lag - 1),
-                                    kMaxPitch24kHz),
-        ComputeAutoCorrelationCoeff(pitch_buf, GetInvertedLag(lag),
-                                    kMaxPitch24kHz),
-        ComputeAutoCorrelationCoeff(pitch_buf, GetInvertedLag(lag + 1),
-                                    kMaxPitch24kHz));
+    const std::array<size_t, 3> inv_lags = {{GetInvertedLag(lag - 1),
+                                             GetInvertedLag(lag),
+                                             GetInvertedLag(lag + 1)}};
+    std::array<float, 3> auto_corr;
+    ComputeAutoCorrelationCoeffs(pitch_buf, inv_lags, kMaxPitch24kHz,
+                                 auto_corr, optimization);
+    offset = GetPitchPseudoInterpolationOffset(lag, auto_corr[0], auto_corr[1],
+                                               auto_corr[2]);
   }
   return 2 * lag + offset;
 }
@@ -131,6 +339,11 @@ size_t PitchPseudoInterpolationInvLagAutoCorr(
 constexpr std::array<int, 14> kSubHarmonicMultipliers = {
     {3, 2, 3, 2, 5, 2, 3, 2, 3, 2, 5, 2, 3, 2}};
 
+// Maximum number of pitch periods checked in
+// CheckLowerPitchPeriodsAndComputePitchGain() - i.e., the initial one and two
+// for each sub-harmonic.
+constexpr size_t kMaxCandidatePeriods = 2 * kSubHarmonicMultipliers.size() + 1;
+
 // Initial pitch period candidate thresholds for ComputePitchGainThreshold() for
 // a sample rate of 24 kHz. Computed as [5*k*k for k in range(16)].
 constexpr std::array<int, 14> kInitialPitchPeriodThresholds = {
@@ -197,7 +410,32 @@ float ComputePitchGainThreshold(int candidate_pitch_period,
 
 void ComputeSlidingFrameSquareEnergies(
     rtc::ArrayView<const float, kBufSize24kHz> pitch_buf,
-    rtc::ArrayView<float, kMaxPitch24kHz + 1> yy_values) {
+    rtc::ArrayView<float, kMaxPitch24kHz + 1> yy_values,
+    Optimization optimization) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (optimization == Optimization::kSse2) {
+    // Compute the energy variations between consecutive sliding frames and
+    // then their prefix sums. The frames slide towards the oldest samples,
+    // hence the samples are loaded in reversed order.
+    static_assert(kMaxPitch24kHz % 4 == 0, "");
+    std::array<float, kMaxPitch24kHz> deltas;
+    for (size_t i = 0; i < kMaxPitch24kHz; i += 4) {
+      const __m128 new_coeffs =
+          ReverseSse2(_mm_loadu_ps(&pitch_buf[kMaxPitch24kHz - 4 - i]));
+      const __m128 old_coeffs =
+          ReverseSse2(_mm_loadu_ps(&pitch_buf[kBufSize24kHz - 4 - i]));
+      _mm_storeu_ps(&deltas[i],
+                    _mm_sub_ps(_mm_mul_ps(new_coeffs, new_coeffs),
+                               _mm_mul_ps(old_coeffs, old_coeffs)));
+    }
+    yy_values[0] = DotProductSse2(pitch_buf.data() + kMaxPitch24kHz,
+                                  pitch_buf.data() + kMaxPitch24kHz,
+                                  kFrameSize20ms24kHz);
+    ComputeRunningSumsSse2(yy_values[0], deltas,
+                           {yy_values.data() + 1, kMaxPitch24kHz});
+    return;
+  }
+#endif
   float yy =
       ComputeAutoCorrelationCoeff(pitch_buf, kMaxPitch24kHz, kMaxPitch24kHz);
   yy_values[0] = yy;
@@ -216,7 +454,8 @@ void ComputeSlidingFrameSquareEnergies(
 std::array<size_t, 2> FindBestPitchPeriods(
     rtc::ArrayView<const float> auto_corr,
     rtc::ArrayView<const float> pitch_buf,
-    size_t max_pitch_period) {
+    size_t max_pitch_period,
+    Optimization optimization) {
   // Stores a pitch candidate period and strength information.
   struct PitchCandidate {
     // Pitch period encoded as inverted lag.
@@ -234,23 +473,25 @@ std::array<size_t, 2> FindBestPitchPeriods(
 
   RTC_DCHECK_GT(max_pitch_period, auto_corr.size());
   RTC_DCHECK_LT(max_pitch_period, pitch_buf.size());
+  RTC_DCHECK_LE(auto_corr.size(), kNumInvertedLags24kHz);
   const size_t frame_size = pitch_buf.size() - max_pitch_period;
-  // TODO(bugs.webrtc.org/9076): Maybe optimize using vectorization.
-  float yy =
-      std::inner_product(pitch_buf.begin(), pitch_buf.begin() + frame_size + 1,
-                         pitch_buf.begin(), 1.f);
+  // Compute the energy of the sliding frame for each inverted lag.
+  std::array<float, kNumInvertedLags24kHz> yy_values;
+  const size_t num_inv_lags = auto_corr.size();
+  ComputeSlidingFrameEnergiesForInvertedLags(
+      pitch_buf, frame_size, {yy_values.data(), num_inv_lags}, optimization);
   // Search best and second best pitches by looking at the scaled
   // auto-correlation.
   PitchCandidate candidate;
   PitchCandidate best;
   PitchCandidate second_best;
   second_best.period_inverted_lag = 1;
-  for (size_t inv_lag = 0; inv_lag < auto_corr.size(); ++inv_lag) {
+  for (size_t inv_lag = 0; inv_lag < num_inv_lags; ++inv_lag) {
     // A pitch candidate must have positive correlation.
     if (auto_corr[inv_lag] > 0) {
       candidate.period_inverted_lag = inv_lag;
       candidate.strength_numerator = auto_corr[inv_lag] * auto_corr[inv_lag];
-      candidate.strength_denominator = yy;
+      candidate.strength_denominator = yy_values[inv_lag];
       if (candidate.HasStrongerPitchThan(second_best)) {
         if (candidate.HasStrongerPitchThan(best)) {
           second_best = best;
@@ -260,19 +501,14 @@ std::array<size_t, 2> FindBestPitchPeriods(
         }
       }
     }
-    // Update |squared_energy_y| for the next inverted lag.
-    const float old_coeff = pitch_buf[inv_lag];
-    const float new_coeff = pitch_buf[inv_lag + frame_size];
-    yy -= old_coeff * old_coeff;
-    yy += new_coeff * new_coeff;
-    yy = std::max(0.f, yy);
   }
   return {{best.period_inverted_lag, second_best.period_inverted_lag}};
 }
 
 size_t RefinePitchPeriod48kHz(
     rtc::ArrayView<const float, kBufSize24kHz> pitch_buf,
-    rtc::ArrayView<const size_t, 2> inv_lags) {
+    rtc::ArrayView<const size_t, 2> inv_lags,
+    Optimization optimization) {
   // Compute the auto-correlation terms only for neighbors of the given pitch
   // candidates (similar to what is done in ComputePitchAutoCorrelation(), but
   // for a few lag values).
@@ -281,15 +517,30 @@ size_t RefinePitchPeriod48kHz(
   auto is_neighbor = [](size_t i, size_t j) {
     return ((i > j) ? (i - j) : (j - i)) <= 2;
   };
+  // Up to 5 neighbors for each of the two candidates.
+  std::array<size_t, 10> neighbor_inv_lags;
+  size_t num_neighbors = 0;
   for (size_t inv_lag = 0; inv_lag < auto_corr.size(); ++inv_lag) {
-    if (is_neighbor(inv_lag, inv_lags[0]) || is_neighbor(inv_lag, inv_lags[1]))
-      auto_corr[inv_lag] =
-          ComputeAutoCorrelationCoeff(pitch_buf, inv_lag, kMaxPitch24kHz);
+    if (is_neighbor(inv_lag, inv_lags[0]) ||
+        is_neighbor(inv_lag, inv_lags[1])) {
+      RTC_DCHECK_LT(num_neighbors, neighbor_inv_lags.size());
+      neighbor_inv_lags[num_neighbors++] = inv_lag;
+    }
+  }
+  // Compute the coefficients for neighboring lags at once.
+  std::array<float, 10> neighbor_auto_corr;
+  ComputeAutoCorrelationCoeffs(pitch_buf,
+                               {neighbor_inv_lags.data(), num_neighbors},
+                               kMaxPitch24kHz,
+                               {neighbor_auto_corr.data(), num_neighbors},
+                               optimization);
+  for (size_t i = 0; i < num_neighbors; ++i) {
+    auto_corr[neighbor_inv_lags[i]] = neighbor_auto_corr[i];
   }
   // Find best pitch at 24 kHz.
   const auto pitch_candidates_inv_lags = FindBestPitchPeriods(
       {auto_corr.data(), auto_corr.size()},
-      {pitch_buf.data(), pitch_buf.size()}, kMaxPitch24kHz);
+      {pitch_buf.data(), pitch_buf.size()}, kMaxPitch24kHz, optimization);
   const auto inv_lag = pitch_candidates_inv_lags[0];  // Refine the best.
   // Pseudo-interpolation.
   return PitchPseudoInterpolationInvLagAutoCorr(inv_lag, auto_corr);
@@ -298,7 +549,8 @@ size_t RefinePitchPeriod48kHz(
 PitchInfo CheckLowerPitchPeriodsAndComputePitchGain(
     rtc::ArrayView<const float, kBufSize24kHz> pitch_buf,
     int initial_pitch_period_48kHz,
-    PitchInfo prev_pitch_48kHz) {
+    PitchInfo prev_pitch_48kHz,
+    Optimization optimization) {
   RTC_DCHECK_LE(kMinPitch48kHz, initial_pitch_period_48kHz);
   RTC_DCHECK_LE(initial_pitch_period_48kHz, kMaxPitch48kHz);
   // Stores information for a refined pitch candidate.
@@ -317,32 +569,30 @@ PitchInfo CheckLowerPitchPeriodsAndComputePitchGain(
 
   // Initialize.
   std::array<float, kMaxPitch24kHz + 1> yy_values;
-  ComputeSlidingFrameSquareEnergies(pitch_buf,
-                                    {yy_values.data(), yy_values.size()});
+  ComputeSlidingFrameSquareEnergies(
+      pitch_buf, {yy_values.data(), yy_values.size()}, optimization);
   const float xx = yy_values[0];
   // Helper lambdas.
   const auto pitch_gain = [](float xy, float yy, float xx) {
     RTC_DCHECK_LE(0.f, xx * yy);
     return xy / std::sqrt(1.f + xx * yy);
   };
-  // Initial pitch candidate gain.
+  // Initial pitch candidate.
   RefinedPitchCandidate best_pitch;
   best_pitch.period_24kHz = std::min(initial_pitch_period_48kHz / 2,
                                      static_cast<int>(kMaxPitch24kHz - 1));
-  best_pitch.xy = ComputeAutoCorrelationCoeff(
-      pitch_buf, GetInvertedLag(best_pitch.period_24kHz), kMaxPitch24kHz);
-  best_pitch.yy = yy_values[best_pitch.period_24kHz];
-  best_pitch.gain = pitch_gain(best_pitch.xy, best_pitch.yy, xx);
-
-  // Store the initial pitch period information.
   const size_t initial_pitch_period = best_pitch.period_24kHz;
-  const float initial_pitch_gain = best_pitch.gain;
 
-  // Given the initial pitch estimation, check lower periods (i.e., harmonics).
+  // Given the initial pitch estimation, find the lower periods to check (i.e.,
+  // harmonics). The initial period is followed by pairs of primary and
+  // secondary candidate periods.
   const auto alternative_period = [](int period, int k, int n) -> int {
     RTC_DCHECK_GT(k, 0);
     return (2 * n * period + k) / (2 * k);  // Same as round(n*period/k).
   };
+  std::array<int, kMaxCandidatePeriods> candidate_periods;
+  size_t num_candidate_periods = 0;
+  candidate_periods[num_candidate_periods++] = initial_pitch_period;
   for (int k = 2; k < static_cast<int>(kSubHarmonicMultipliers.size() + 2);
        ++k) {
     int candidate_pitch_period = alternative_period(initial_pitch_period, k, 1);
@@ -363,15 +613,36 @@ PitchInfo CheckLowerPitchPeriodsAndComputePitchGain(
     RTC_DCHECK_NE(candidate_pitch_period, candidate_pitch_secondary_period)
         << "The lower pitch period and the additional sub-harmonic must not "
            "coincide.";
+    candidate_periods[num_candidate_periods++] = candidate_pitch_period;
+    candidate_periods[num_candidate_periods++] =
+        candidate_pitch_secondary_period;
+  }
+
+  // Compute the auto-correlation coefficients for all the candidate periods at
+  // once.
+  std::array<size_t, kMaxCandidatePeriods> candidate_inv_lags;
+  for (size_t i = 0; i < num_candidate_periods; ++i) {
+    candidate_inv_lags[i] = GetInvertedLag(candidate_periods[i]);
+  }
+  std::array<float, kMaxCandidatePeriods> xy_values;
+  ComputeAutoCorrelationCoeffs(
+      pitch_buf, {candidate_inv_lags.data(), num_candidate_periods},
+      kMaxPitch24kHz, {xy_values.data(), num_candidate_periods}, optimization);
+
+  // Initial pitch candidate gain.
+  best_pitch.xy = xy_values[0];
+  best_pitch.yy = yy_values[best_pitch.period_24kHz];
+  best_pitch.gain = pitch_gain(best_pitch.xy, best_pitch.yy, xx);
+  const float initial_pitch_gain = best_pitch.gain;
+
+  for (size_t i = 1; i < num_candidate_periods; i += 2) {
+    const int k = static_cast<int>(i / 2) + 2;
+    const int candidate_pitch_period = candidate_periods[i];
+    const int candidate_pitch_secondary_period = candidate_periods[i + 1];
     // Compute an auto-correlation score for the primary pitch candidate
     // |candidate_pitch_period| by also looking at its possible sub-harmonic
     // |candidate_pitch_secondary_period|.
-    float xy_primary_period = ComputeAutoCorrelationCoeff(
-        pitch_buf, GetInvertedLag(candidate_pitch_period), kMaxPitch24kHz);
-    float xy_secondary_period = ComputeAutoCorrelationCoeff(
-        pitch_buf, GetInvertedLag(candidate_pitch_secondary_period),
-        kMaxPitch24kHz);
-    float xy = 0.5f * (xy_primary_period + xy_secondary_period);
+    float xy = 0.5f * (xy_values[i] + xy_values[i + 1]);
     float yy = 0.5f * (yy_values[candidate_pitch_period] +
                        yy_values[candidate_pitch_secondary_period]);
     float candidate_pitch_gain = pitch_gain(xy, yy, xx);
@@ -394,7 +665,8 @@ PitchInfo CheckLowerPitchPeriodsAndComputePitchGain(
   final_pitch_gain = std::min(best_pitch.gain, final_pitch_gain);
   int final_pitch_period_48kHz = std::max(
       kMinPitch48kHz,
-      PitchPseudoInterpolationLagPitchBuf(best_pitch.period_24kHz, pitch_buf));
+      PitchPseudoInterpolationLagPitchBuf(best_pitch.period_24kHz, pitch_buf,
+                                          optimization));
 
   return {final_pitch_period_48kHz, final_pitch_gain};
 }
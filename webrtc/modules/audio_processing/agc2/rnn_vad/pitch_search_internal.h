@@ -47,7 +47,8 @@ float ComputePitchGainThreshold(int candidate_pitch_period,
 // that of "b" to the frame size (e.g., 16 ms and 20 ms respectively).
 void ComputeSlidingFrameSquareEnergies(
     rtc::ArrayView<const float, kBufSize24kHz> pitch_buf,
-    rtc::ArrayView<float, kMaxPitch24kHz + 1> yy_values);
+    rtc::ArrayView<float, kMaxPitch24kHz + 1> yy_values,
+    Optimization optimization = Optimization::kNone);
 
 // Given the auto-correlation coefficients stored according to
 // ComputePitchAutoCorrelation() (i.e., using inverted lags), returns the best
@@ -55,21 +56,24 @@ void ComputeSlidingFrameSquareEnergies(
 std::array<size_t, 2> FindBestPitchPeriods(
     rtc::ArrayView<const float> auto_corr,
     rtc::ArrayView<const float> pitch_buf,
-    size_t max_pitch_period);
+    size_t max_pitch_period,
+    Optimization optimization = Optimization::kNone);
 
 // Refines the pitch period estimation given the pitch buffer |pitch_buf| and
 // the initial pitch period estimation |inv_lags|. Returns an inverted lag at
 // 48 kHz.
 size_t RefinePitchPeriod48kHz(
     rtc::ArrayView<const float, kBufSize24kHz> pitch_buf,
-    rtc::ArrayView<const size_t, 2> inv_lags);
+    rtc::ArrayView<const size_t, 2> inv_lags,
+    Optimization optimization = Optimization::kNone);
 
 // Refines the pitch period estimation and compute the pitch gain. Returns the
 // refined pitch estimation data at 48 kHz.
 PitchInfo CheckLowerPitchPeriodsAndComputePitchGain(
     rtc::ArrayView<const float, kBufSize24kHz> pitch_buf,
     int initial_pitch_period_48kHz,
-    PitchInfo prev_pitch_48kHz);
+    PitchInfo prev_pitch_48kHz,
+    Optimization optimization = Optimization::kNone);
 
 }  // namespace rnn_vad
 }  // namespace webrtc
@@ -16,6 +16,7 @@
 #include <type_traits>
 
 #include "api/array_view.h"
+#include "modules/audio_processing/agc2/state_snapshot.h"
 
 namespace webrtc {
 namespace rnn_vad {
@@ -34,7 +35,10 @@ class RingBuffer {
   RingBuffer& operator=(const RingBuffer&) = delete;
   ~RingBuffer() = default;
   // Set the ring buffer values to zero.
-  void Reset() { buffer_.fill(0); }
+  void Reset() {
+    buffer_.fill(0);
+    tail_ = 0;
+  }
   // Replace the least recently pushed array in the buffer with |new_values|.
   void Push(rtc::ArrayView<const T, S> new_values) {
     std::memcpy(buffer_.data() + S * tail_, new_values.data(), S * sizeof(T));
@@ -54,6 +58,21 @@ class RingBuffer {
       offset += N;
     return {buffer_.data() + S * offset, S};
   }
+  // Writes the buffer into |writer|.
+  void SaveState(StateSnapshotWriter* writer) const {
+    writer->Write(tail_);
+    writer->Write(buffer_);
+  }
+  // Restores the buffer written by SaveState(). All the values must be within
+  // [min_value, max_value].
+  void RestoreState(StateSnapshotReader* reader, T min_value, T max_value) {
+    reader->Read(&tail_);
+    reader->ReadArrayInRange<T>(buffer_, min_value, max_value);
+    if (tail_ < 0 || tail_ >= static_cast<int>(N)) {
+      reader->SetFailed();
+      tail_ = 0;
+    }
+  }
 
  private:
   int tail_;  // Index of the least recently pushed sub-array.
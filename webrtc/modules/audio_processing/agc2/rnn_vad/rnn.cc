@@ -22,8 +22,10 @@
 #include <algorithm>
 #include <array>
 #include <cmath>
+#include <limits>
 #include <numeric>
 
+#include "modules/audio_processing/agc2/state_snapshot.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/logging.h"
 #include "third_party/rnnoise/src/rnn_activations.h"
@@ -353,6 +355,16 @@ void GatedRecurrentLayer::Reset() {
   state_.fill(0.f);
 }
 
+void GatedRecurrentLayer::SaveState(StateSnapshotWriter* writer) const {
+  writer->WriteArray<float>(GetOutput());
+}
+
+void GatedRecurrentLayer::RestoreState(StateSnapshotReader* reader) {
+  // The state is a mix of the previous state and of a ReLU output.
+  reader->ReadArrayInRange<float>({state_.data(), output_size_}, 0.f,
+                                  std::numeric_limits<float>::max());
+}
+
 void GatedRecurrentLayer::ComputeOutput(rtc::ArrayView<const float> input) {
   switch (optimization_) {
 #if defined(WEBRTC_ARCH_X86_FAMILY)
@@ -407,6 +419,14 @@ void RnnBasedVad::Reset() {
   hidden_layer_.Reset();
 }
 
+void RnnBasedVad::SaveState(StateSnapshotWriter* writer) const {
+  hidden_layer_.SaveState(writer);
+}
+
+void RnnBasedVad::RestoreState(StateSnapshotReader* reader) {
+  hidden_layer_.RestoreState(reader);
+}
+
 float RnnBasedVad::ComputeVadProbability(
     rtc::ArrayView<const float, kFeatureVectorSize> feature_vector,
     bool is_silence) {
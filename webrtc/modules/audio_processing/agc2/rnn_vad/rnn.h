@@ -23,6 +23,10 @@
 #include "rtc_base/system/arch.h"
 
 namespace webrtc {
+
+class StateSnapshotReader;
+class StateSnapshotWriter;
+
 namespace rnn_vad {
 
 // Maximum number of units for a fully-connected layer. This value is used to
@@ -86,6 +90,10 @@ class GatedRecurrentLayer {
   Optimization optimization() const { return optimization_; }
   rtc::ArrayView<const float> GetOutput() const;
   void Reset();
+  // Writes the recurrent state into |writer|.
+  void SaveState(StateSnapshotWriter* writer) const;
+  // Restores the recurrent state written by SaveState().
+  void RestoreState(StateSnapshotReader* reader);
   // Computes the recurrent layer output and updates the status.
   void ComputeOutput(rtc::ArrayView<const float> input);
 
@@ -109,6 +117,10 @@ class RnnBasedVad {
   RnnBasedVad& operator=(const RnnBasedVad&) = delete;
   ~RnnBasedVad();
   void Reset();
+  // Writes the recurrent state into |writer|.
+  void SaveState(StateSnapshotWriter* writer) const;
+  // Restores the recurrent state written by SaveState().
+  void RestoreState(StateSnapshotReader* reader);
   // Compute and returns the probability of voice (range: [0.0, 1.0]).
   float ComputeVadProbability(
       rtc::ArrayView<const float, kFeatureVectorSize> feature_vector,
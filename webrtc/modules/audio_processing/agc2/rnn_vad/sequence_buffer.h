@@ -17,6 +17,7 @@
 #include <vector>
 
 #include "api/array_view.h"
+#include "modules/audio_processing/agc2/state_snapshot.h"
 #include "rtc_base/checks.h"
 
 namespace webrtc {
@@ -29,6 +30,14 @@ namespace rnn_vad {
 // values are written at the end of the buffer.
 // The class also provides a view on the most recent M values, where 0 < M <= S
 // and by default M = N.
+//
+// The values are stored in a linear buffer of size 2S in which the sequence
+// slides forward as new chunks are pushed. The S - N most recent values are
+// only moved back to the beginning of the storage when the end is reached -
+// i.e., once every S / N pushes - hence the amortized cost of Push() is O(N)
+// instead of O(S). The views returned by GetBufferView() and
+// GetMostRecentValuesView() are only valid until the next call to Push(),
+// Reset() or RestoreState().
 template <typename T, size_t S, size_t N, size_t M = N>
 class SequenceBuffer {
   static_assert(N <= S,
@@ -38,8 +47,8 @@ class SequenceBuffer {
                 "Integral or floating point required.");
 
  public:
-  SequenceBuffer() : buffer_(S) {
-    RTC_DCHECK_EQ(S, buffer_.size());
+  SequenceBuffer() : buffer_(2 * S) {
+    RTC_DCHECK_EQ(2 * S, buffer_.size());
     Reset();
   }
   SequenceBuffer(const SequenceBuffer&) = delete;
@@ -48,29 +57,52 @@ class SequenceBuffer {
   size_t size() const { return S; }
   size_t chunks_size() const { return N; }
   // Sets the sequence buffer values to zero.
-  void Reset() { std::fill(buffer_.begin(), buffer_.end(), 0); }
+  void Reset() {
+    std::fill(buffer_.begin(), buffer_.end(), 0);
+    begin_ = 0;
+  }
   // Returns a view on the whole buffer.
   rtc::ArrayView<const T, S> GetBufferView() const {
-    return {buffer_.data(), S};
+    return {buffer_.data() + begin_, S};
   }
   // Returns a view on the M most recent values of the buffer.
   rtc::ArrayView<const T, M> GetMostRecentValuesView() const {
     static_assert(M <= S,
                   "The number of most recent values cannot be larger than the "
                   "sequence buffer size.");
-    return {buffer_.data() + S - M, M};
+    return {buffer_.data() + begin_ + S - M, M};
   }
-  // Shifts left the buffer by N items and add new N items at the end.
+  // Drops the N oldest items and adds N new items at the end.
   void Push(rtc::ArrayView<const T, N> new_values) {
-    // Make space for the new values.
-    if (S > N)
-      std::memmove(buffer_.data(), buffer_.data() + N, (S - N) * sizeof(T));
-    // Copy the new values at the end of the buffer.
-    std::memcpy(buffer_.data() + S - N, new_values.data(), N * sizeof(T));
+    if (begin_ + S + N > buffer_.size()) {
+      // Move the values to keep at the beginning of the storage.
+      if (S > N) {
+        std::memmove(buffer_.data(), buffer_.data() + begin_ + N,
+                     (S - N) * sizeof(T));
+      }
+      begin_ = 0;
+    } else {
+      begin_ += N;
+    }
+    // Copy the new values at the end of the sequence.
+    std::memcpy(buffer_.data() + begin_ + S - N, new_values.data(),
+                N * sizeof(T));
+  }
+  // Writes the buffer values into |writer|.
+  void SaveState(StateSnapshotWriter* writer) const {
+    writer->WriteArray<T>(GetBufferView());
+  }
+  // Restores the buffer values written by SaveState(). All the values must be
+  // within [min_value, max_value].
+  void RestoreState(StateSnapshotReader* reader, T min_value, T max_value) {
+    begin_ = 0;
+    reader->ReadArrayInRange<T>({buffer_.data(), S}, min_value, max_value);
   }
 
  private:
   std::vector<T> buffer_;
+  // Index of the oldest value of the sequence.
+  size_t begin_ = 0;
 };
 
 }  // namespace rnn_vad
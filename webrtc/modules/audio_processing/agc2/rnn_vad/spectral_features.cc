@@ -22,6 +22,12 @@ namespace rnn_vad {
 namespace {
 
 constexpr float kSilenceThreshold = 0.04f;
+// Bounds of the restored cepstral coefficients and distances. The band energies
+// of the analyzed frames are below 1e18, hence the magnitude of the cepstral
+// coefficients is below 200; the bounds have a wide margin.
+constexpr float kMaxAbsCepstralCoeff = 1000.f;
+constexpr float kMaxCepstralDistance =
+    kNumBands * 4.f * kMaxAbsCepstralCoeff * kMaxAbsCepstralCoeff;
 
 // Computes the new cepstral difference stats and pushes them into the passed
 // symmetric matrix buffer.
@@ -84,13 +90,15 @@ void ComputeWindowedForwardFft(
 
 }  // namespace
 
-SpectralFeaturesExtractor::SpectralFeaturesExtractor()
+SpectralFeaturesExtractor::SpectralFeaturesExtractor(
+    Optimization optimization)
     : half_window_(ComputeScaledHalfVorbisWindow(
           1.f / static_cast<float>(kFrameSize20ms24kHz))),
       fft_(kFrameSize20ms24kHz, Pffft::FftType::kReal),
       fft_buffer_(fft_.CreateBuffer()),
       reference_frame_fft_(fft_.CreateBuffer()),
       lagged_frame_fft_(fft_.CreateBuffer()),
+      spectral_correlator_(optimization),
       dct_table_(ComputeDctTable()) {}
 
 SpectralFeaturesExtractor::~SpectralFeaturesExtractor() = default;
@@ -100,6 +108,17 @@ void SpectralFeaturesExtractor::Reset() {
   cepstral_diffs_buf_.Reset();
 }
 
+void SpectralFeaturesExtractor::SaveState(StateSnapshotWriter* writer) const {
+  cepstral_coeffs_ring_buf_.SaveState(writer);
+  cepstral_diffs_buf_.SaveState(writer);
+}
+
+void SpectralFeaturesExtractor::RestoreState(StateSnapshotReader* reader) {
+  cepstral_coeffs_ring_buf_.RestoreState(reader, -kMaxAbsCepstralCoeff,
+                                         kMaxAbsCepstralCoeff);
+  cepstral_diffs_buf_.RestoreState(reader, 0.f, kMaxCepstralDistance);
+}
+
 bool SpectralFeaturesExtractor::CheckSilenceComputeFeatures(
     rtc::ArrayView<const float, kFrameSize20ms24kHz> reference_frame,
     rtc::ArrayView<const float, kFrameSize20ms24kHz> lagged_frame,
@@ -132,7 +151,8 @@ bool SpectralFeaturesExtractor::CheckSilenceComputeFeatures(
                                       log_bands_energy);
   // Reference frame cepstrum.
   std::array<float, kNumBands> cepstrum;
-  ComputeDct(log_bands_energy, dct_table_, cepstrum);
+  ComputeDct(log_bands_energy, dct_table_, cepstrum,
+             spectral_correlator_.optimization());
   // Ad-hoc correction terms for the first two cepstral coefficients.
   cepstrum[0] -= 12.f;
   cepstrum[1] -= 4.f;
@@ -185,7 +205,8 @@ void SpectralFeaturesExtractor::ComputeNormalizedCepstralCorrelation(
                                lagged_frame_bands_energy_[i]);
   }
   // Cepstrum.
-  ComputeDct(bands_cross_corr_, dct_table_, bands_cross_corr);
+  ComputeDct(bands_cross_corr_, dct_table_, bands_cross_corr,
+             spectral_correlator_.optimization());
   // Ad-hoc correction terms for the first two cepstral coefficients.
   bands_cross_corr[0] -= 1.3f;
   bands_cross_corr[1] -= 0.9f;
@@ -29,13 +29,18 @@ namespace rnn_vad {
 // Class to compute spectral features.
 class SpectralFeaturesExtractor {
  public:
-  SpectralFeaturesExtractor();
+  explicit SpectralFeaturesExtractor(
+      Optimization optimization = Optimization::kNone);
   SpectralFeaturesExtractor(const SpectralFeaturesExtractor&) = delete;
   SpectralFeaturesExtractor& operator=(const SpectralFeaturesExtractor&) =
       delete;
   ~SpectralFeaturesExtractor();
   // Resets the internal state of the feature extractor.
   void Reset();
+  // Writes the cepstral history into |writer|.
+  void SaveState(StateSnapshotWriter* writer) const;
+  // Restores the cepstral history written by SaveState().
+  void RestoreState(StateSnapshotReader* reader);
   // Analyzes a pair of reference and lagged frames from the pitch buffer,
   // detects silence and computes features. If silence is detected, the output
   // is neither computed nor written.
@@ -10,6 +10,12 @@
 
 #include "modules/audio_processing/agc2/rnn_vad/spectral_features_internal.h"
 
+// Defines WEBRTC_ARCH_X86_FAMILY, used below.
+#include "rtc_base/system/arch.h"
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#include <emmintrin.h>
+#endif
 #include <algorithm>
 #include <cmath>
 #include <cstddef>
@@ -82,11 +88,105 @@ constexpr std::array<float, kFrameSize20ms24kHz / 2> kOpusBandWeights24kHz20ms =
         0.9375f,   0.958333f,  0.979167f  // Band 18
     }};
 
+// DCT scaling factor - i.e., sqrt(2 / kNumBands).
+constexpr float kDctScalingFactor = 0.301511345f;
+constexpr float kDctScalingFactorError =
+    kDctScalingFactor * kDctScalingFactor - 2.f / static_cast<float>(kNumBands);
+static_assert(
+    (kDctScalingFactorError >= 0.f && kDctScalingFactorError < 1e-1f) ||
+        (kDctScalingFactorError < 0.f && kDctScalingFactorError > -1e-1f),
+    "kNumBands changed and kDctScalingFactor has not been updated.");
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+// Returns true if the size of each band is a multiple of 4 FFT coefficients.
+constexpr bool OpusBandSizesAreMultiplesOf4() {
+  constexpr auto kOpusScaleNumBins24kHz20ms = GetOpusScaleNumBins24kHz20ms();
+  for (size_t i = 0; i < kOpusScaleNumBins24kHz20ms.size(); ++i) {
+    if (kOpusScaleNumBins24kHz20ms[i] % 4 != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Returns the sum of the four elements of |v|.
+float HorizontalSumSse2(__m128 v) {
+  v = _mm_add_ps(v, _mm_movehl_ps(v, v));
+  v = _mm_add_ss(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1)));
+  return _mm_cvtss_f32(v);
+}
+
+// SpectralCorrelator::ComputeCrossCorrelation() SSE2 implementation. Processes
+// 4 Fourier coefficients at a time and accumulates the two triangular filter
+// contributions of each band separately, hence the result differs from the
+// un-optimized one by rounding errors.
+void ComputeCrossCorrelationSse2(
+    rtc::ArrayView<const float> x,
+    rtc::ArrayView<const float> y,
+    rtc::ArrayView<const float> weights,
+    rtc::ArrayView<float, kOpusBands24kHz> cross_corr) {
+  static_assert(OpusBandSizesAreMultiplesOf4(), "");
+  constexpr auto kOpusScaleNumBins24kHz20ms = GetOpusScaleNumBins24kHz20ms();
+  size_t k = 0;  // Next Fourier coefficient index.
+  cross_corr[0] = 0.f;
+  for (size_t i = 0; i < kOpusBands24kHz - 1; ++i) {
+    __m128 lower_band_sum = _mm_setzero_ps();
+    __m128 upper_band_sum = _mm_setzero_ps();
+    for (int j = 0; j < kOpusScaleNumBins24kHz20ms[i]; j += 4, k += 4) {
+      // Interleaved real and imaginary parts of 4 Fourier coefficients.
+      const __m128 p0 = _mm_mul_ps(_mm_loadu_ps(x.data() + 2 * k),
+                                   _mm_loadu_ps(y.data() + 2 * k));
+      const __m128 p1 = _mm_mul_ps(_mm_loadu_ps(x.data() + 2 * k + 4),
+                                   _mm_loadu_ps(y.data() + 2 * k + 4));
+      const __m128 v =
+          _mm_add_ps(_mm_shuffle_ps(p0, p1, _MM_SHUFFLE(2, 0, 2, 0)),
+                     _mm_shuffle_ps(p0, p1, _MM_SHUFFLE(3, 1, 3, 1)));
+      const __m128 tmp = _mm_mul_ps(_mm_loadu_ps(weights.data() + k), v);
+      lower_band_sum = _mm_add_ps(lower_band_sum, _mm_sub_ps(v, tmp));
+      upper_band_sum = _mm_add_ps(upper_band_sum, tmp);
+    }
+    cross_corr[i] += HorizontalSumSse2(lower_band_sum);
+    cross_corr[i + 1] = HorizontalSumSse2(upper_band_sum);
+  }
+  cross_corr[0] *= 2.f;  // The first band only gets half contribution.
+  RTC_DCHECK_EQ(k, kFrameSize20ms24kHz / 2);  // Nyquist coefficient never used.
+}
+
+// ComputeDct() SSE2 implementation. Computes 4 output coefficients at a time
+// as a matrix-vector product with the DCT table. The products are added in the
+// same order as in the un-optimized implementation, which gives the same
+// result.
+void ComputeDctSse2(
+    rtc::ArrayView<const float> in,
+    rtc::ArrayView<const float, kNumBands * kNumBands> dct_table,
+    rtc::ArrayView<float> out) {
+  const __m128 scaling_factor = _mm_set1_ps(kDctScalingFactor);
+  size_t i = 0;
+  for (; i + 4 <= out.size(); i += 4) {
+    __m128 sum = _mm_setzero_ps();
+    for (size_t j = 0; j < in.size(); ++j) {
+      sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(in[j]),
+                                       _mm_loadu_ps(&dct_table[j * kNumBands +
+                                                               i])));
+    }
+    _mm_storeu_ps(&out[i], _mm_mul_ps(sum, scaling_factor));
+  }
+  for (; i < out.size(); ++i) {
+    out[i] = 0.f;
+    for (size_t j = 0; j < in.size(); ++j) {
+      out[i] += in[j] * dct_table[j * kNumBands + i];
+    }
+    out[i] *= kDctScalingFactor;
+  }
+}
+#endif
+
 }  // namespace
 
-SpectralCorrelator::SpectralCorrelator()
+SpectralCorrelator::SpectralCorrelator(Optimization optimization)
     : weights_(kOpusBandWeights24kHz20ms.begin(),
-               kOpusBandWeights24kHz20ms.end()) {}
+               kOpusBandWeights24kHz20ms.end()),
+      optimization_(optimization) {}
 
 SpectralCorrelator::~SpectralCorrelator() = default;
 
@@ -104,6 +204,12 @@ void SpectralCorrelator::ComputeCrossCorrelation(
   RTC_DCHECK_EQ(x.size(), y.size());
   RTC_DCHECK_EQ(x[1], 0.f) << "The Nyquist coefficient must be zeroed.";
   RTC_DCHECK_EQ(y[1], 0.f) << "The Nyquist coefficient must be zeroed.";
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (optimization_ == Optimization::kSse2) {
+    ComputeCrossCorrelationSse2(x, y, weights_, cross_corr);
+    return;
+  }
+#endif
   constexpr auto kOpusScaleNumBins24kHz20ms = GetOpusScaleNumBins24kHz20ms();
   size_t k = 0;  // Next Fourier coefficient index.
   cross_corr[0] = 0.f;
@@ -159,20 +265,18 @@ std::array<float, kNumBands * kNumBands> ComputeDctTable() {
 
 void ComputeDct(rtc::ArrayView<const float> in,
                 rtc::ArrayView<const float, kNumBands * kNumBands> dct_table,
-                rtc::ArrayView<float> out) {
-  // DCT scaling factor - i.e., sqrt(2 / kNumBands).
-  constexpr float kDctScalingFactor = 0.301511345f;
-  constexpr float kDctScalingFactorError =
-      kDctScalingFactor * kDctScalingFactor -
-      2.f / static_cast<float>(kNumBands);
-  static_assert(
-      (kDctScalingFactorError >= 0.f && kDctScalingFactorError < 1e-1f) ||
-          (kDctScalingFactorError < 0.f && kDctScalingFactorError > -1e-1f),
-      "kNumBands changed and kDctScalingFactor has not been updated.");
+                rtc::ArrayView<float> out,
+                Optimization optimization) {
   RTC_DCHECK_NE(in.data(), out.data()) << "In-place DCT is not supported.";
   RTC_DCHECK_LE(in.size(), kNumBands);
   RTC_DCHECK_LE(1, out.size());
   RTC_DCHECK_LE(out.size(), in.size());
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (optimization == Optimization::kSse2) {
+    ComputeDctSse2(in, dct_table, out);
+    return;
+  }
+#endif
   for (size_t i = 0; i < out.size(); ++i) {
     out[i] = 0.f;
     for (size_t j = 0; j < in.size(); ++j) {
@@ -44,7 +44,7 @@ constexpr std::array<int, kOpusBands24kHz - 1> GetOpusScaleNumBins24kHz20ms() {
 class SpectralCorrelator {
  public:
   // Ctor.
-  SpectralCorrelator();
+  explicit SpectralCorrelator(Optimization optimization = Optimization::kNone);
   SpectralCorrelator(const SpectralCorrelator&) = delete;
   SpectralCorrelator& operator=(const SpectralCorrelator&) = delete;
   ~SpectralCorrelator();
@@ -68,8 +68,11 @@ class SpectralCorrelator {
       rtc::ArrayView<const float> y,
       rtc::ArrayView<float, kOpusBands24kHz> cross_corr) const;
 
+  Optimization optimization() const { return optimization_; }
+
  private:
   const std::vector<float> weights_;  // Weights for each Fourier coefficient.
+  const Optimization optimization_;
 };
 
 // TODO(bugs.webrtc.org/10480): Move to anonymous namespace in
@@ -92,7 +95,8 @@ std::array<float, kNumBands * kNumBands> ComputeDctTable();
 // testing.
 void ComputeDct(rtc::ArrayView<const float> in,
                 rtc::ArrayView<const float, kNumBands * kNumBands> dct_table,
-                rtc::ArrayView<float> out);
+                rtc::ArrayView<float> out,
+                Optimization optimization = Optimization::kNone);
 
 }  // namespace rnn_vad
 }  // namespace webrtc
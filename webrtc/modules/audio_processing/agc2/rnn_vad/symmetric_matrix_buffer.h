@@ -17,6 +17,7 @@
 #include <utility>
 
 #include "api/array_view.h"
+#include "modules/audio_processing/agc2/state_snapshot.h"
 #include "rtc_base/checks.h"
 
 namespace webrtc {
@@ -44,6 +45,13 @@ class SymmetricMatrixBuffer {
                   "Integral or floating point required.");
     buf_.fill(0);
   }
+  // Writes the buffer values into |writer|.
+  void SaveState(StateSnapshotWriter* writer) const { writer->Write(buf_); }
+  // Restores the buffer values written by SaveState(). All the values must be
+  // within [min_value, max_value].
+  void RestoreState(StateSnapshotReader* reader, T min_value, T max_value) {
+    reader->ReadArrayInRange<T>(buf_, min_value, max_value);
+  }
   // Pushes the results from the comparison between the most recent item and
   // those that are still in the ring buffer. The first element in |values| must
   // correspond to the comparison between the most recent item and the second
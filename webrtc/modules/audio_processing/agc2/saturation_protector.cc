@@ -10,6 +10,9 @@
 
 #include "modules/audio_processing/agc2/saturation_protector.h"
 
+#include <algorithm>
+
+#include "modules/audio_processing/agc2/state_snapshot.h"
 #include "modules/audio_processing/logging/apm_data_dumper.h"
 #include "rtc_base/numerics/safe_minmax.h"
 
@@ -17,6 +20,8 @@ namespace webrtc {
 namespace {
 
 constexpr float kMinLevelDbfs = -90.f;
+// Largest speech peak level accepted by the level estimator.
+constexpr float kMaxLevelDbfs = 50.f;
 
 // Min/max margins are based on speech crest-factor.
 constexpr float kMinMarginDb = 12.f;
@@ -68,6 +73,32 @@ absl::optional<float> RingBuffer::Front() const {
   return buffer_[FrontIndex()];
 }
 
+void RingBuffer::SaveState(StateSnapshotWriter* writer) const {
+  writer->Write(buffer_);
+  writer->Write(next_);
+  writer->Write(size_);
+}
+
+void RingBuffer::RestoreState(StateSnapshotReader* reader) {
+  reader->Read(&buffer_);
+  reader->Read(&next_);
+  reader->Read(&size_);
+  if (next_ < 0 || next_ >= Capacity() || size_ < 0 || size_ > Capacity()) {
+    reader->SetFailed();
+    Reset();
+    return;
+  }
+  // Only the `size_` values in the buffer must be levels.
+  for (int i = 0, index = FrontIndex(); i < size_; ++i, ++index) {
+    const float value = buffer_[index % buffer_.size()];
+    if (!(value >= kMinLevelDbfs && value <= kMaxLevelDbfs)) {
+      reader->SetFailed();
+      Reset();
+      return;
+    }
+  }
+}
+
 bool SaturationProtectorState::operator==(
     const SaturationProtectorState& b) const {
   return margin_db == b.margin_db && peak_delay_buffer == b.peak_delay_buffer &&
@@ -118,4 +149,24 @@ void UpdateSaturationProtectorState(float speech_peak_dbfs,
       rtc::SafeClamp<float>(state.margin_db, kMinMarginDb, kMaxMarginDb);
 }
 
+void SaveSaturationProtectorState(const SaturationProtectorState& state,
+                                  StateSnapshotWriter* writer) {
+  writer->Write(state.margin_db);
+  state.peak_delay_buffer.SaveState(writer);
+  writer->Write(state.max_peaks_dbfs);
+  writer->Write(state.time_since_push_ms);
+}
+
+void RestoreSaturationProtectorState(StateSnapshotReader* reader,
+                                     float initial_margin_db,
+                                     SaturationProtectorState& state) {
+  reader->ReadInRange(&state.margin_db,
+                      std::min(kMinMarginDb, initial_margin_db),
+                      std::max(kMaxMarginDb, initial_margin_db));
+  state.peak_delay_buffer.RestoreState(reader);
+  reader->ReadInRange(&state.max_peaks_dbfs, kMinLevelDbfs, kMaxLevelDbfs);
+  reader->ReadInRange(&state.time_since_push_ms, 0,
+                      static_cast<int>(kPeakEnveloperSuperFrameLengthMs));
+}
+
 }  // namespace webrtc
@@ -18,6 +18,10 @@
 #include "rtc_base/numerics/safe_compare.h"
 
 namespace webrtc {
+
+class StateSnapshotReader;
+class StateSnapshotWriter;
+
 namespace saturation_protector_impl {
 
 // Ring buffer which only supports (i) push back and (ii) read oldest item.
@@ -38,6 +42,11 @@ class RingBuffer {
   // buffer is empty.
   absl::optional<float> Front() const;
 
+  // Writes the buffer into `writer`.
+  void SaveState(StateSnapshotWriter* writer) const;
+  // Restores the buffer written by `SaveState()`.
+  void RestoreState(StateSnapshotReader* reader);
+
  private:
   inline int FrontIndex() const {
     return rtc::SafeEq(size_, buffer_.size()) ? next_ : 0;
@@ -77,6 +86,17 @@ void UpdateSaturationProtectorState(float speech_peak_dbfs,
                                     float speech_level_dbfs,
                                     SaturationProtectorState& state);
 
+// Writes `state` into `writer`.
+void SaveSaturationProtectorState(const SaturationProtectorState& state,
+                                  StateSnapshotWriter* writer);
+
+// Restores `state` from a snapshot written by `SaveSaturationProtectorState()`.
+// Fails if the margin is outside the range of the updates extended to
+// `initial_margin_db` or if a peak is not a valid level.
+void RestoreSaturationProtectorState(StateSnapshotReader* reader,
+                                     float initial_margin_db,
+                                     SaturationProtectorState& state);
+
 }  // namespace webrtc
 
 #endif  // MODULES_AUDIO_PROCESSING_AGC2_SATURATION_PROTECTOR_H_
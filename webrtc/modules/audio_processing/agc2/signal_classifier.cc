@@ -15,8 +15,10 @@
 #include <vector>
 
 #include "api/array_view.h"
+#include "modules/audio_processing/agc2/agc2_common.h"
 #include "modules/audio_processing/agc2/down_sampler.h"
 #include "modules/audio_processing/agc2/noise_spectrum_estimator.h"
+#include "modules/audio_processing/agc2/state_snapshot.h"
 #include "modules/audio_processing/logging/apm_data_dumper.h"
 #include "rtc_base/checks.h"
 #include "system_wrappers/include/cpu_features_wrapper.h"
@@ -24,6 +26,11 @@
 namespace webrtc {
 namespace {
 
+// Number of frames until the noise spectrum is reliable, and number of
+// consistent classifications required to report a stationary signal.
+constexpr int kInitializationFrames = 2;
+constexpr int kConsistentClassificationFrames = 3;
+
 bool IsSse2Available() {
 #if defined(WEBRTC_ARCH_X86_FAMILY)
   return GetCPUInfo(kSSE2) != 0;
@@ -32,6 +39,14 @@ bool IsSse2Available() {
 #endif
 }
 
+bool IsAvx2Available() {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  return GetCPUInfo(kAVX2) != 0;
+#else
+  return false;
+#endif
+}
+
 void RemoveDcLevel(rtc::ArrayView<float> x) {
   RTC_DCHECK_LT(0, x.size());
   float mean = std::accumulate(x.data(), x.data() + x.size(), 0.f);
@@ -105,6 +120,10 @@ SignalClassifier::FrameExtender::FrameExtender(size_t frame_size,
 
 SignalClassifier::FrameExtender::~FrameExtender() = default;
 
+void SignalClassifier::FrameExtender::Reset() {
+  std::fill(x_old_.begin(), x_old_.end(), 0.f);
+}
+
 void SignalClassifier::FrameExtender::ExtendFrame(
     rtc::ArrayView<const float> x,
     rtc::ArrayView<float> x_extended) {
@@ -115,11 +134,24 @@ void SignalClassifier::FrameExtender::ExtendFrame(
             x_extended.data() + x_extended.size(), x_old_.data());
 }
 
+void SignalClassifier::FrameExtender::SaveState(
+    StateSnapshotWriter* writer) const {
+  writer->WriteArray<float>(x_old_);
+}
+
+void SignalClassifier::FrameExtender::RestoreState(
+    StateSnapshotReader* reader) {
+  // The extended samples are down-sampler outputs.
+  reader->ReadArrayInRange<float>(x_old_, -2.f * kMaxAbsAnalyzedSampleValue,
+                                  2.f * kMaxAbsAnalyzedSampleValue);
+}
+
 SignalClassifier::SignalClassifier(ApmDataDumper* data_dumper)
     : data_dumper_(data_dumper),
       down_sampler_(data_dumper_),
+      frame_extender_(new FrameExtender(80, 128)),
       noise_spectrum_estimator_(data_dumper_),
-      ooura_fft_(IsSse2Available()) {
+      ooura_fft_(IsSse2Available(), IsAvx2Available()) {
   Initialize(48000);
 }
 SignalClassifier::~SignalClassifier() {}
@@ -127,10 +159,10 @@ SignalClassifier::~SignalClassifier() {}
 void SignalClassifier::Initialize(int sample_rate_hz) {
   down_sampler_.Initialize(sample_rate_hz);
   noise_spectrum_estimator_.Initialize();
-  frame_extender_.reset(new FrameExtender(80, 128));
+  frame_extender_->Reset();
   sample_rate_hz_ = sample_rate_hz;
-  initialization_frames_left_ = 2;
-  consistent_classification_counter_ = 3;
+  initialization_frames_left_ = kInitializationFrames;
+  consistent_classification_counter_ = kConsistentClassificationFrames;
   last_signal_type_ = SignalClassifier::SignalType::kNonStationary;
 }
 
@@ -165,7 +197,7 @@ SignalClassifier::SignalType SignalClassifier::Analyze(
         std::max(0, consistent_classification_counter_ - 1);
   } else {
     last_signal_type_ = signal_type;
-    consistent_classification_counter_ = 3;
+    consistent_classification_counter_ = kConsistentClassificationFrames;
   }
 
   if (consistent_classification_counter_ > 0) {
@@ -174,4 +206,26 @@ SignalClassifier::SignalType SignalClassifier::Analyze(
   return signal_type;
 }
 
+void SignalClassifier::SaveState(StateSnapshotWriter* writer) const {
+  down_sampler_.SaveState(writer);
+  frame_extender_->SaveState(writer);
+  noise_spectrum_estimator_.SaveState(writer);
+  writer->Write(initialization_frames_left_);
+  writer->Write(consistent_classification_counter_);
+  writer->Write(last_signal_type_ == SignalType::kStationary);
+}
+
+void SignalClassifier::RestoreState(StateSnapshotReader* reader) {
+  down_sampler_.RestoreState(reader);
+  frame_extender_->RestoreState(reader);
+  noise_spectrum_estimator_.RestoreState(reader);
+  reader->ReadInRange(&initialization_frames_left_, 0, kInitializationFrames);
+  reader->ReadInRange(&consistent_classification_counter_, 0,
+                      kConsistentClassificationFrames);
+  bool stationary = false;
+  reader->Read(&stationary);
+  last_signal_type_ =
+      stationary ? SignalType::kStationary : SignalType::kNonStationary;
+}
+
 }  // namespace webrtc
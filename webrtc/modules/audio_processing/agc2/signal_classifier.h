@@ -23,6 +23,8 @@ namespace webrtc {
 
 class ApmDataDumper;
 class AudioBuffer;
+class StateSnapshotReader;
+class StateSnapshotWriter;
 
 class SignalClassifier {
  public:
@@ -39,6 +41,12 @@ class SignalClassifier {
   void Initialize(int sample_rate_hz);
   SignalType Analyze(rtc::ArrayView<const float> signal);
 
+  // Writes the classifier state into |writer|. The sample rate is not part of
+  // the state.
+  void SaveState(StateSnapshotWriter* writer) const;
+  // Restores the state written by SaveState().
+  void RestoreState(StateSnapshotReader* reader);
+
  private:
   class FrameExtender {
    public:
@@ -52,6 +60,10 @@ class SignalClassifier {
 
     void ExtendFrame(rtc::ArrayView<const float> x,
                      rtc::ArrayView<float> x_extended);
+    void Reset();
+
+    void SaveState(StateSnapshotWriter* writer) const;
+    void RestoreState(StateSnapshotReader* reader);
 
    private:
     std::vector<float> x_old_;
@@ -0,0 +1,154 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_AUDIO_PROCESSING_AGC2_STATE_SNAPSHOT_H_
+#define MODULES_AUDIO_PROCESSING_AGC2_STATE_SNAPSHOT_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <algorithm>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include "api/array_view.h"
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+
+// Appends the state of the AGC2 sub-modules to a binary snapshot. The values
+// are stored in native byte order and without padding, hence a snapshot can
+// only be restored by the same build on the same architecture.
+class StateSnapshotWriter {
+ public:
+  explicit StateSnapshotWriter(std::vector<uint8_t>* snapshot)
+      : snapshot_(snapshot) {
+    RTC_DCHECK(snapshot_);
+  }
+  StateSnapshotWriter(const StateSnapshotWriter&) = delete;
+  StateSnapshotWriter& operator=(const StateSnapshotWriter&) = delete;
+
+  template <typename T>
+  void Write(const T& value) {
+    static_assert(std::is_trivially_copyable<T>::value, "");
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+    snapshot_->insert(snapshot_->end(), bytes, bytes + sizeof(T));
+  }
+
+  void Write(bool value) { Write<uint8_t>(value ? 1 : 0); }
+
+  template <typename T>
+  void WriteArray(rtc::ArrayView<const T> values) {
+    static_assert(std::is_trivially_copyable<T>::value, "");
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(values.data());
+    snapshot_->insert(snapshot_->end(), bytes,
+                      bytes + values.size() * sizeof(T));
+  }
+
+ private:
+  std::vector<uint8_t>* const snapshot_;
+};
+
+// Reads back the values appended by StateSnapshotWriter in the same order.
+// Reading past the end of the snapshot or reading an invalid value marks the
+// reader as failed, after which all reads are ignored.
+class StateSnapshotReader {
+ public:
+  explicit StateSnapshotReader(rtc::ArrayView<const uint8_t> snapshot)
+      : snapshot_(snapshot) {}
+  StateSnapshotReader(const StateSnapshotReader&) = delete;
+  StateSnapshotReader& operator=(const StateSnapshotReader&) = delete;
+
+  template <typename T>
+  void Read(T* value) {
+    static_assert(std::is_trivially_copyable<T>::value, "");
+    RTC_DCHECK(value);
+    ReadBytes(value, sizeof(T));
+  }
+
+  void Read(bool* value) {
+    RTC_DCHECK(value);
+    uint8_t byte = 0;
+    Read(&byte);
+    if (byte > 1) {
+      SetFailed();
+      return;
+    }
+    if (ok_) {
+      *value = byte == 1;
+    }
+  }
+
+  template <typename T>
+  void ReadArray(rtc::ArrayView<T> values) {
+    static_assert(std::is_trivially_copyable<T>::value, "");
+    ReadBytes(values.data(), values.size() * sizeof(T));
+  }
+
+  // Same as Read(), but marks the reader as failed unless the value is within
+  // [min_value, max_value]. NaN is never within the range.
+  template <typename T>
+  void ReadInRange(T* value, T min_value, T max_value) {
+    Read(value);
+    if (ok_ && !(*value >= min_value && *value <= max_value)) {
+      SetFailed();
+    }
+  }
+
+  // Same as ReadArray(), but marks the reader as failed unless all the values
+  // are within [min_value, max_value].
+  template <typename T>
+  void ReadArrayInRange(rtc::ArrayView<T> values, T min_value, T max_value) {
+    ReadArray(values);
+    if (ok_ && !std::all_of(values.begin(), values.end(), [&](T value) {
+          return value >= min_value && value <= max_value;
+        })) {
+      SetFailed();
+    }
+  }
+
+  // Reads a floating point value and marks the reader as failed if it is NaN
+  // or infinite.
+  template <typename T>
+  void ReadFinite(T* value) {
+    static_assert(std::is_floating_point<T>::value, "");
+    ReadInRange(value, std::numeric_limits<T>::lowest(),
+                std::numeric_limits<T>::max());
+  }
+
+  // Marks the snapshot as invalid, e.g., when a value is out of range.
+  void SetFailed() { ok_ = false; }
+
+  // Returns true if all the reads so far have succeeded.
+  bool ok() const { return ok_; }
+
+  // Returns the number of bytes that have not been read yet.
+  size_t remaining() const { return snapshot_.size() - position_; }
+
+ private:
+  void ReadBytes(void* destination, size_t num_bytes) {
+    if (!ok_ || remaining() < num_bytes) {
+      ok_ = false;
+      return;
+    }
+    memcpy(destination, snapshot_.data() + position_, num_bytes);
+    position_ += num_bytes;
+  }
+
+  const rtc::ArrayView<const uint8_t> snapshot_;
+  size_t position_ = 0;
+  bool ok_ = true;
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_AUDIO_PROCESSING_AGC2_STATE_SNAPSHOT_H_
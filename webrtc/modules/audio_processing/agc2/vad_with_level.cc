@@ -17,10 +17,14 @@
 #include "api/array_view.h"
 #include "common_audio/include/audio_util.h"
 #include "common_audio/resampler/include/push_resampler.h"
+#include "common_audio/vad/include/webrtc_vad.h"
+#include "common_audio/vad/vad_core.h"
 #include "modules/audio_processing/agc2/agc2_common.h"
+#include "modules/audio_processing/agc2/frame_stats.h"
 #include "modules/audio_processing/agc2/rnn_vad/common.h"
 #include "modules/audio_processing/agc2/rnn_vad/features_extraction.h"
 #include "modules/audio_processing/agc2/rnn_vad/rnn.h"
+#include "modules/audio_processing/agc2/state_snapshot.h"
 #include "rtc_base/checks.h"
 
 namespace webrtc {
@@ -56,12 +60,223 @@ class Vad : public VoiceActivityDetector {
     return rnn_vad_.ComputeVadProbability(feature_vector, is_silence);
   }
 
+  void Reset() override {
+    resampler_.Reset();
+    features_extractor_.Reset();
+    rnn_vad_.Reset();
+  }
+
+  // The resampler history is not part of the state. It only spans a few
+  // milliseconds of audio, hence a restored VAD produces almost, but not
+  // exactly, the same output as the saved one.
+  void SaveState(StateSnapshotWriter* writer) const override {
+    features_extractor_.SaveState(writer);
+    rnn_vad_.SaveState(writer);
+  }
+
+  void RestoreState(StateSnapshotReader* reader) override {
+    features_extractor_.RestoreState(reader);
+    rnn_vad_.RestoreState(reader);
+  }
+
  private:
   PushResampler<float> resampler_;
   rnn_vad::FeaturesExtractor features_extractor_;
   rnn_vad::RnnBasedVad rnn_vad_;
 };
 
+// Aggressiveness mode of the GMM VAD. The most aggressive mode has the fewest
+// false detections, which matters both when the GMM VAD is used alone, since
+// noise taken for speech biases the speech level estimate, and when it gates
+// the RNN VAD, since it then decides how often the RNN VAD runs.
+constexpr int kGmmVadMode = 3;
+// Number of frames for which the hybrid VAD keeps running the RNN VAD after
+// the GMM VAD stops detecting speech. Covers the short pauses within speech,
+// which the aggressive GMM VAD misses.
+constexpr int kHybridVadHangoverFrames = 30;
+
+// VAD based on the fixed-point GMM VAD of common_audio. Computes the speech
+// probability on the first channel. The GMM VAD only makes binary decisions,
+// hence the probability is either 0 or 1.
+class GmmVad : public VoiceActivityDetector {
+ public:
+  explicit GmmVad(int mode) : mode_(mode), vad_(WebRtcVad_Create()) {
+    RTC_CHECK(vad_);
+    Reset();
+  }
+  GmmVad(const GmmVad&) = delete;
+  GmmVad& operator=(const GmmVad&) = delete;
+  ~GmmVad() override { WebRtcVad_Free(vad_); }
+
+  float ComputeProbability(AudioFrameView<const float> frame) override {
+    const size_t samples_per_channel = frame.samples_per_channel();
+    RTC_DCHECK_LE(samples_per_channel, kMaximalNumberOfSamplesPerChannel);
+    std::array<int16_t, kMaximalNumberOfSamplesPerChannel> samples;
+    FloatS16ToS16(frame.channel(0).data(), samples_per_channel,
+                  samples.data());
+    const int is_speech = WebRtcVad_Process(
+        vad_, static_cast<int>(samples_per_channel * 100), samples.data(),
+        samples_per_channel);
+    RTC_DCHECK_GE(is_speech, 0);
+    return is_speech == 1 ? 1.f : 0.f;
+  }
+
+  void Reset() override {
+    WebRtcVad_Init(vad_);
+    const int error = WebRtcVad_set_mode(vad_, mode_);
+    RTC_DCHECK_EQ(0, error);
+  }
+
+  // Writes the adaptive part of the VAD instance: the filter states, the
+  // noise and speech models, the minimum tracker and the hangover counters.
+  // The thresholds are not written since they only depend on `mode_`.
+  void SaveState(StateSnapshotWriter* writer) const override {
+    const VadInstT& state = core();
+    writer->Write(state.vad);
+    writer->WriteArray(
+        rtc::ArrayView<const int32_t>(state.downsampling_filter_states));
+    writer->Write(state.state_48_to_8);
+    writer->WriteArray(rtc::ArrayView<const int16_t>(state.noise_means));
+    writer->WriteArray(rtc::ArrayView<const int16_t>(state.speech_means));
+    writer->WriteArray(rtc::ArrayView<const int16_t>(state.noise_stds));
+    writer->WriteArray(rtc::ArrayView<const int16_t>(state.speech_stds));
+    writer->Write(state.frame_counter);
+    writer->Write(state.over_hang);
+    writer->Write(state.num_of_speech);
+    writer->WriteArray(rtc::ArrayView<const int16_t>(state.index_vector));
+    writer->WriteArray(rtc::ArrayView<const int16_t>(state.low_value_vector));
+    writer->WriteArray(rtc::ArrayView<const int16_t>(state.mean_value));
+    writer->WriteArray(rtc::ArrayView<const int16_t>(state.upper_state));
+    writer->WriteArray(rtc::ArrayView<const int16_t>(state.lower_state));
+    writer->WriteArray(rtc::ArrayView<const int16_t>(state.hp_filter_state));
+  }
+
+  // Reads the state into a copy of the instance and only replaces the
+  // instance if the values are valid. The standard deviations divide the
+  // model inputs, hence they must be positive.
+  void RestoreState(StateSnapshotReader* reader) override {
+    VadInstT state = core();
+    reader->Read(&state.vad);
+    reader->ReadArray(
+        rtc::ArrayView<int32_t>(state.downsampling_filter_states));
+    reader->Read(&state.state_48_to_8);
+    reader->ReadArray(rtc::ArrayView<int16_t>(state.noise_means));
+    reader->ReadArray(rtc::ArrayView<int16_t>(state.speech_means));
+    reader->ReadArray(rtc::ArrayView<int16_t>(state.noise_stds));
+    reader->ReadArray(rtc::ArrayView<int16_t>(state.speech_stds));
+    reader->Read(&state.frame_counter);
+    reader->Read(&state.over_hang);
+    reader->Read(&state.num_of_speech);
+    reader->ReadArray(rtc::ArrayView<int16_t>(state.index_vector));
+    reader->ReadArray(rtc::ArrayView<int16_t>(state.low_value_vector));
+    reader->ReadArray(rtc::ArrayView<int16_t>(state.mean_value));
+    reader->ReadArray(rtc::ArrayView<int16_t>(state.upper_state));
+    reader->ReadArray(rtc::ArrayView<int16_t>(state.lower_state));
+    reader->ReadArray(rtc::ArrayView<int16_t>(state.hp_filter_state));
+    if (!reader->ok()) {
+      return;
+    }
+    auto is_positive = [](int16_t value) { return value > 0; };
+    auto is_valid_age = [](int16_t age) { return age >= 0 && age <= 101; };
+    if (state.vad < 0 || state.frame_counter < 0 || state.over_hang < 0 ||
+        state.num_of_speech < 0 ||
+        !std::all_of(std::begin(state.noise_stds), std::end(state.noise_stds),
+                     is_positive) ||
+        !std::all_of(std::begin(state.speech_stds),
+                     std::end(state.speech_stds), is_positive) ||
+        !std::all_of(std::begin(state.index_vector),
+                     std::end(state.index_vector), is_valid_age)) {
+      reader->SetFailed();
+      return;
+    }
+    core() = state;
+  }
+
+ private:
+  // The fields of the instance are those of the VAD core.
+  VadInstT& core() { return *reinterpret_cast<VadInstT*>(vad_); }
+  const VadInstT& core() const {
+    return *reinterpret_cast<const VadInstT*>(vad_);
+  }
+
+  const int mode_;
+  VadInst* const vad_;
+};
+
+// Runs the GMM VAD on every frame and the RNN VAD only while the GMM VAD
+// detects speech and for kHybridVadHangoverFrames frames after that. The
+// other frames are non-speech. Since the RNN VAD is reset when it is started
+// again, its probability is low during the first frames after a pause.
+class HybridVad : public VoiceActivityDetector {
+ public:
+  HybridVad() : gmm_vad_(kGmmVadMode) {}
+  HybridVad(const HybridVad&) = delete;
+  HybridVad& operator=(const HybridVad&) = delete;
+  ~HybridVad() override = default;
+
+  float ComputeProbability(AudioFrameView<const float> frame) override {
+    if (gmm_vad_.ComputeProbability(frame) > 0.f) {
+      hangover_frames_left_ = kHybridVadHangoverFrames;
+    } else if (hangover_frames_left_ > 0) {
+      --hangover_frames_left_;
+    }
+    if (hangover_frames_left_ == 0) {
+      rnn_vad_active_ = false;
+      return 0.f;
+    }
+    if (!rnn_vad_active_) {
+      rnn_vad_.Reset();
+      rnn_vad_active_ = true;
+    }
+    return rnn_vad_.ComputeProbability(frame);
+  }
+
+  void Reset() override {
+    gmm_vad_.Reset();
+    rnn_vad_.Reset();
+    hangover_frames_left_ = 0;
+    rnn_vad_active_ = false;
+  }
+
+  void SaveState(StateSnapshotWriter* writer) const override {
+    gmm_vad_.SaveState(writer);
+    writer->Write(hangover_frames_left_);
+    writer->Write(rnn_vad_active_);
+    rnn_vad_.SaveState(writer);
+  }
+
+  void RestoreState(StateSnapshotReader* reader) override {
+    gmm_vad_.RestoreState(reader);
+    reader->Read(&hangover_frames_left_);
+    reader->Read(&rnn_vad_active_);
+    if (hangover_frames_left_ < 0 ||
+        hangover_frames_left_ > kHybridVadHangoverFrames) {
+      reader->SetFailed();
+    }
+    rnn_vad_.RestoreState(reader);
+  }
+
+ private:
+  GmmVad gmm_vad_;
+  Vad rnn_vad_;
+  int hangover_frames_left_ = 0;
+  bool rnn_vad_active_ = false;
+};
+
+std::unique_ptr<VoiceActivityDetector> CreateVad(
+    AudioProcessing::Config::GainController2::VadBackend backend) {
+  switch (backend) {
+    case AudioProcessing::Config::GainController2::kRnn:
+      return std::make_unique<Vad>();
+    case AudioProcessing::Config::GainController2::kGmm:
+      return std::make_unique<GmmVad>(kGmmVadMode);
+    case AudioProcessing::Config::GainController2::kHybrid:
+      return std::make_unique<HybridVad>();
+  }
+  RTC_NOTREACHED();
+  return nullptr;
+}
+
 // Returns an updated version of `p_old` by using instant decay and the given
 // `attack` on a new VAD probability value `p_new`.
 float SmoothedVadProbability(float p_old, float p_new, float attack) {
@@ -85,6 +300,11 @@ VadLevelAnalyzer::VadLevelAnalyzer()
 VadLevelAnalyzer::VadLevelAnalyzer(float vad_probability_attack)
     : VadLevelAnalyzer(vad_probability_attack, std::make_unique<Vad>()) {}
 
+VadLevelAnalyzer::VadLevelAnalyzer(
+    float vad_probability_attack,
+    AudioProcessing::Config::GainController2::VadBackend backend)
+    : VadLevelAnalyzer(vad_probability_attack, CreateVad(backend)) {}
+
 VadLevelAnalyzer::VadLevelAnalyzer(float vad_probability_attack,
                                    std::unique_ptr<VoiceActivityDetector> vad)
     : vad_(std::move(vad)), vad_probability_attack_(vad_probability_attack) {
@@ -97,18 +317,48 @@ VadLevelAnalyzer::Result VadLevelAnalyzer::AnalyzeFrame(
     AudioFrameView<const float> frame) {
   // Compute levels.
   float peak = 0.f;
-  float rms = 0.f;
+  float energy = 0.f;
   for (const auto& x : frame.channel(0)) {
     peak = std::max(std::fabs(x), peak);
-    rms += x * x;
+    energy += x * x;
   }
+  return ComputeResult(frame, peak, energy);
+}
+
+VadLevelAnalyzer::Result VadLevelAnalyzer::AnalyzeFrame(
+    AudioFrameView<const float> frame,
+    const FrameStats& stats) {
+  RTC_DCHECK_EQ(stats.samples_per_channel, frame.samples_per_channel());
+  RTC_DCHECK_EQ(stats.energy.size(), frame.num_channels());
+  return ComputeResult(frame, stats.peak[0], stats.energy[0]);
+}
+
+VadLevelAnalyzer::Result VadLevelAnalyzer::ComputeResult(
+    AudioFrameView<const float> frame,
+    float peak,
+    float energy) {
   // Compute smoothed speech probability.
   vad_probability_ = SmoothedVadProbability(
       /*p_old=*/vad_probability_, /*p_new=*/vad_->ComputeProbability(frame),
       vad_probability_attack_);
   return {vad_probability_,
-          FloatS16ToDbfs(std::sqrt(rms / frame.samples_per_channel())),
+          FloatS16ToDbfs(std::sqrt(energy / frame.samples_per_channel())),
           FloatS16ToDbfs(peak)};
 }
 
+void VadLevelAnalyzer::Reset() {
+  vad_probability_ = 0.f;
+  vad_->Reset();
+}
+
+void VadLevelAnalyzer::SaveState(StateSnapshotWriter* writer) const {
+  writer->Write(vad_probability_);
+  vad_->SaveState(writer);
+}
+
+void VadLevelAnalyzer::RestoreState(StateSnapshotReader* reader) {
+  reader->ReadInRange(&vad_probability_, 0.f, 1.f);
+  vad_->RestoreState(reader);
+}
+
 }  // namespace webrtc
@@ -14,9 +14,14 @@
 #include <memory>
 
 #include "modules/audio_processing/include/audio_frame_view.h"
+#include "modules/audio_processing/include/audio_processing.h"
 
 namespace webrtc {
 
+struct FrameStats;
+class StateSnapshotReader;
+class StateSnapshotWriter;
+
 // Class to analyze voice activity and audio levels.
 class VadLevelAnalyzer {
  public:
@@ -32,11 +37,23 @@ class VadLevelAnalyzer {
     virtual ~VoiceActivityDetector() = default;
     // Analyzes an audio frame and returns the speech probability.
     virtual float ComputeProbability(AudioFrameView<const float> frame) = 0;
+    // Resets the internal state. Stateless detectors do not need to override
+    // it.
+    virtual void Reset() {}
+    // Writes the internal state into `writer`. Stateless detectors do not
+    // need to override it.
+    virtual void SaveState(StateSnapshotWriter* writer) const {}
+    // Restores the internal state written by `SaveState()`.
+    virtual void RestoreState(StateSnapshotReader* reader) {}
   };
 
   // Ctor. Uses the default VAD.
   VadLevelAnalyzer();
   explicit VadLevelAnalyzer(float vad_probability_attack);
+  // Ctor. Uses the VAD of the given `backend`.
+  VadLevelAnalyzer(
+      float vad_probability_attack,
+      AudioProcessing::Config::GainController2::VadBackend backend);
   // Ctor. Uses a custom `vad`.
   VadLevelAnalyzer(float vad_probability_attack,
                    std::unique_ptr<VoiceActivityDetector> vad);
@@ -46,8 +63,26 @@ class VadLevelAnalyzer {
 
   // Computes the speech probability and the level for `frame`.
   Result AnalyzeFrame(AudioFrameView<const float> frame);
+  // Same as above, but takes the levels from `stats`, which must have been
+  // computed for `frame`.
+  Result AnalyzeFrame(AudioFrameView<const float> frame,
+                      const FrameStats& stats);
+
+  // Resets the smoothed speech probability and the VAD state.
+  void Reset();
+
+  // Writes the smoothed speech probability and the VAD state into `writer`.
+  void SaveState(StateSnapshotWriter* writer) const;
+  // Restores the state written by `SaveState()`.
+  void RestoreState(StateSnapshotReader* reader);
 
  private:
+  // Updates the smoothed speech probability and returns the result for the
+  // given peak and energy of the first channel.
+  Result ComputeResult(AudioFrameView<const float> frame,
+                       float peak,
+                       float energy);
+
   std::unique_ptr<VoiceActivityDetector> vad_;
   const float vad_probability_attack_;
   float vad_probability_ = 0.f;
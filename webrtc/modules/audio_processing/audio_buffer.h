@@ -106,6 +106,13 @@ class AudioBuffer {
       return band == kBand0To8kHz ? data_->channels() : nullptr;
     }
   }
+  float* const* split_channels(Band band) {
+    if (split_data_.get()) {
+      return split_data_->channels(band);
+    } else {
+      return band == kBand0To8kHz ? data_->channels() : nullptr;
+    }
+  }
 
   // Copies data into the buffer.
   void CopyFrom(const int16_t* const interleaved_data,
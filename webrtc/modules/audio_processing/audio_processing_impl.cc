@@ -33,6 +33,7 @@
 #include "rtc_base/checks.h"
 #include "rtc_base/constructor_magic.h"
 #include "rtc_base/logging.h"
+#include "rtc_base/memory/allocation_guard.h"
 #include "rtc_base/ref_counted_object.h"
 #include "rtc_base/time_utils.h"
 #include "rtc_base/trace_event.h"
@@ -51,6 +52,10 @@ namespace webrtc {
 
 constexpr int kRuntimeSettingQueueSize = 100;
 
+// Number of render frames that can be queued by the lock-free render ingress
+// in between two capture calls.
+constexpr size_t kRenderIngressQueueSize = 32;
+
 namespace {
 
 static bool LayoutHasKeyboard(AudioProcessing::ChannelLayout layout) {
@@ -268,7 +273,8 @@ AudioProcessingImpl::AudioProcessingImpl(
                  !field_trial::IsEnabled(
                      "WebRTC-ApmExperimentalMultiChannelCaptureKillSwitch"),
                  EnforceSplitBandHpf()),
-      capture_nonlocked_() {
+      capture_nonlocked_(),
+      render_ingress_queue_(kRenderIngressQueueSize, RenderIngressFrame()) {
   RTC_LOG(LS_INFO) << "Injected APM submodules:"
                       "\nEcho control factory: "
                    << !!echo_control_factory_
@@ -572,7 +578,9 @@ void AudioProcessingImpl::ApplyConfig(const AudioProcessing::Config& config) {
               .enable_digital_adaptive;
 
   const bool agc2_config_changed =
-      config_.gain_controller2.enabled != config.gain_controller2.enabled;
+      config_.gain_controller2.enabled != config.gain_controller2.enabled ||
+      config_.gain_controller2.multi_band_limiter.enabled !=
+          config.gain_controller2.multi_band_limiter.enabled;
 
   const bool voice_detection_config_changed =
       config_.voice_detection.enabled != config.voice_detection.enabled;
@@ -639,6 +647,18 @@ void AudioProcessingImpl::ApplyConfig(const AudioProcessing::Config& config) {
   if (pipeline_config_changed) {
     InitializeLocked(formats_.api_format);
   }
+
+  if (config_.pipeline.lock_free_render_ingress !=
+      render_ingress_enabled_.load(std::memory_order_relaxed)) {
+    if (config_.pipeline.lock_free_render_ingress) {
+      render_ingress_queue_.Clear();
+    } else {
+      // Analyze the render frames that were queued before the switch.
+      ProcessRenderIngressFrames();
+    }
+    render_ingress_enabled_.store(config_.pipeline.lock_free_render_ingress,
+                                  std::memory_order_release);
+  }
 }
 
 void AudioProcessingImpl::OverrideSubmoduleCreationForTesting(
@@ -753,6 +773,11 @@ int AudioProcessingImpl::MaybeInitializeCapture(
     // released immediately, as we may need to acquire the render lock as part
     // of the conditional reinitialization.
     MutexLock lock_capture(&mutex_capture_);
+    if (render_ingress_enabled_.load(std::memory_order_relaxed)) {
+      // Render format changes in the queued render frames must be applied
+      // before the capture format is checked.
+      ProcessRenderIngressFrames();
+    }
     processing_config = formats_.api_format;
     reinitialization_required = UpdateActiveSubmoduleStates();
   }
@@ -768,6 +793,12 @@ int AudioProcessingImpl::MaybeInitializeCapture(
   }
 
   if (reinitialization_required) {
+    {
+      MutexLock lock_capture(&mutex_capture_);
+      if (render_ingress_enabled_.load(std::memory_order_relaxed)) {
+        return InitializeLockedForRenderIngress(processing_config);
+      }
+    }
     MutexLock lock_render(&mutex_render_);
     MutexLock lock_capture(&mutex_capture_);
     RETURN_ON_ERR(InitializeLocked(processing_config));
@@ -785,6 +816,9 @@ int AudioProcessingImpl::ProcessStream(const float* const* src,
   }
 
   RETURN_ON_ERR(MaybeInitializeCapture(input_config, output_config));
+  // A change of the stream format reinitializes the submodules, the steady
+  // state must not allocate.
+  ScopedRealTimeSection real_time_section;
 
   MutexLock lock_capture(&mutex_capture_);
 
@@ -1028,6 +1062,7 @@ int AudioProcessingImpl::ProcessStream(const int16_t* const src,
                                        int16_t* const dest) {
   TRACE_EVENT0("webrtc", "AudioProcessing::ProcessStream_AudioFrame");
   RETURN_ON_ERR(MaybeInitializeCapture(input_config, output_config));
+  ScopedRealTimeSection real_time_section;
 
   MutexLock lock_capture(&mutex_capture_);
 
@@ -1219,6 +1254,17 @@ int AudioProcessingImpl::ProcessCaptureStreamLocked() {
         capture_buffer, /*stream_has_echo*/ false));
   }
 
+  // The multi-band limiter only runs when the bands are split and merged for
+  // other submodules anyway, since the split and merge alone cost more than
+  // the limiter.
+  if (submodules_.gain_controller2 &&
+      config_.gain_controller2.multi_band_limiter.enabled &&
+      submodule_states_.CaptureMultiBandProcessingPresent() &&
+      SampleRateSupportsMultiBand(
+          capture_nonlocked_.capture_processing_format.sample_rate_hz())) {
+    submodules_.gain_controller2->ProcessSplitBands(capture_buffer);
+  }
+
   if (submodule_states_.CaptureMultiBandProcessingPresent() &&
       SampleRateSupportsMultiBand(
           capture_nonlocked_.capture_processing_format.sample_rate_hz())) {
@@ -1326,7 +1372,16 @@ int AudioProcessingImpl::AnalyzeReverseStream(
     const float* const* data,
     const StreamConfig& reverse_config) {
   TRACE_EVENT0("webrtc", "AudioProcessing::AnalyzeReverseStream_StreamConfig");
+  if (render_ingress_enabled_.load(std::memory_order_acquire)) {
+    return QueueRenderIngressFrame(data, reverse_config, reverse_config,
+                                   /*dest=*/nullptr);
+  }
   MutexLock lock(&mutex_render_);
+  // The ingress may have been enabled while waiting for the render lock.
+  if (render_ingress_enabled_.load(std::memory_order_relaxed)) {
+    return QueueRenderIngressFrame(data, reverse_config, reverse_config,
+                                   /*dest=*/nullptr);
+  }
   return AnalyzeReverseStreamLocked(data, reverse_config, reverse_config);
 }
 
@@ -1335,7 +1390,14 @@ int AudioProcessingImpl::ProcessReverseStream(const float* const* src,
                                               const StreamConfig& output_config,
                                               float* const* dest) {
   TRACE_EVENT0("webrtc", "AudioProcessing::ProcessReverseStream_StreamConfig");
+  if (render_ingress_enabled_.load(std::memory_order_acquire)) {
+    return QueueRenderIngressFrame(src, input_config, output_config, dest);
+  }
+
   MutexLock lock(&mutex_render_);
+  if (render_ingress_enabled_.load(std::memory_order_relaxed)) {
+    return QueueRenderIngressFrame(src, input_config, output_config, dest);
+  }
   RETURN_ON_ERR(AnalyzeReverseStreamLocked(src, input_config, output_config));
   if (submodule_states_.RenderMultiBandProcessingActive() ||
       submodule_states_.RenderFullBandProcessingActive()) {
@@ -1396,7 +1458,16 @@ int AudioProcessingImpl::ProcessReverseStream(const int16_t* const src,
     return AudioProcessing::Error::kBadNumberChannelsError;
   }
 
+  // The render output is left untouched as no render processing is applied to
+  // it with the lock-free render ingress.
+  if (render_ingress_enabled_.load(std::memory_order_acquire)) {
+    return QueueRenderIngressFrame(src, input_config);
+  }
+
   MutexLock lock(&mutex_render_);
+  if (render_ingress_enabled_.load(std::memory_order_relaxed)) {
+    return QueueRenderIngressFrame(src, input_config);
+  }
   ProcessingConfig processing_config = formats_.api_format;
   processing_config.reverse_input_stream().set_sample_rate_hz(
       input_config.sample_rate_hz());
@@ -1462,6 +1533,119 @@ int AudioProcessingImpl::ProcessRenderStreamLocked() {
   return kNoError;
 }
 
+int AudioProcessingImpl::QueueRenderIngressFrame(
+    const float* const* src,
+    const StreamConfig& input_config,
+    const StreamConfig& output_config,
+    float* const* dest) {
+  if (src == nullptr) {
+    return kNullPointerError;
+  }
+
+  if (input_config.num_channels() == 0) {
+    return kBadNumberChannelsError;
+  }
+
+  // No render processing is applied to the render output, which is therefore
+  // required to have the same format as the render input.
+  if (input_config != output_config) {
+    return kUnsupportedFunctionError;
+  }
+
+  const size_t num_channels = input_config.num_channels();
+  const size_t num_frames = input_config.num_frames();
+  const bool inserted =
+      render_ingress_queue_.Insert([&](RenderIngressFrame* frame) {
+        frame->config = input_config;
+        frame->is_s16 = false;
+        // No memory is allocated unless the frame is larger than any
+        // previous frame stored in the same slot.
+        frame->data.resize(num_channels * num_frames);
+        frame->channels.resize(num_channels);
+        for (size_t ch = 0; ch < num_channels; ++ch) {
+          float* channel = &frame->data[ch * num_frames];
+          std::copy(src[ch], src[ch] + num_frames, channel);
+          frame->channels[ch] = channel;
+        }
+      });
+  if (!inserted) {
+    RTC_LOG(LS_WARNING) << "The render ingress queue is full. Render frame "
+                           "discarded.";
+  }
+
+  if (dest) {
+    CopyAudioIfNeeded(src, num_frames, num_channels, dest);
+  }
+  return kNoError;
+}
+
+int AudioProcessingImpl::QueueRenderIngressFrame(
+    const int16_t* const src,
+    const StreamConfig& input_config) {
+  const size_t num_samples = input_config.num_samples();
+  const bool inserted =
+      render_ingress_queue_.Insert([&](RenderIngressFrame* frame) {
+        frame->config = input_config;
+        frame->is_s16 = true;
+        frame->data_s16.assign(src, src + num_samples);
+      });
+  if (!inserted) {
+    RTC_LOG(LS_WARNING) << "The render ingress queue is full. Render frame "
+                           "discarded.";
+  }
+  return kNoError;
+}
+
+void AudioProcessingImpl::ProcessRenderIngressFrames() {
+  // The render signal queues are emptied for each render frame as they would
+  // otherwise be emptied using EmptyQueuedRenderAudio(), which acquires the
+  // capture lock, when becoming full.
+  EmptyQueuedRenderAudioLocked();
+  while (render_ingress_queue_.Remove(&render_ingress_frame_)) {
+    const RenderIngressFrame& frame = render_ingress_frame_;
+    ProcessingConfig processing_config = formats_.api_format;
+    if (frame.is_s16) {
+      processing_config.reverse_input_stream().set_sample_rate_hz(
+          frame.config.sample_rate_hz());
+      processing_config.reverse_input_stream().set_num_channels(
+          frame.config.num_channels());
+    } else {
+      processing_config.reverse_input_stream() = frame.config;
+    }
+    processing_config.reverse_output_stream() =
+        processing_config.reverse_input_stream();
+
+    if (processing_config != formats_.api_format &&
+        InitializeLocked(processing_config) != kNoError) {
+      continue;
+    }
+
+    if (frame.is_s16) {
+      if (aec_dump_) {
+        aec_dump_->WriteRenderStreamMessage(frame.data_s16.data(),
+                                            frame.config.num_frames(),
+                                            frame.config.num_channels());
+      }
+      render_.render_audio->CopyFrom(frame.data_s16.data(), frame.config);
+    } else {
+      if (aec_dump_) {
+        aec_dump_->WriteRenderStreamMessage(AudioFrameView<const float>(
+            frame.channels.data(), frame.config.num_channels(),
+            frame.config.num_frames()));
+      }
+      render_.render_audio->CopyFrom(
+          frame.channels.data(), formats_.api_format.reverse_input_stream());
+    }
+    ProcessRenderStreamLocked();
+    EmptyQueuedRenderAudioLocked();
+  }
+}
+
+int AudioProcessingImpl::InitializeLockedForRenderIngress(
+    const ProcessingConfig& config) {
+  return InitializeLocked(config);
+}
+
 int AudioProcessingImpl::set_stream_delay_ms(int delay) {
   MutexLock lock(&mutex_capture_);
   Error retval = kNoError;
@@ -2054,6 +2238,27 @@ AudioProcessingImpl::ApmRenderState::ApmRenderState() = default;
 
 AudioProcessingImpl::ApmRenderState::~ApmRenderState() = default;
 
+AudioProcessingImpl::RenderIngressFrame::RenderIngressFrame()
+    : data(kMaxAllowedValuesOfSamplesPerFrame * 2),
+      channels(2),
+      data_s16(kMaxAllowedValuesOfSamplesPerFrame * 2) {}
+
+AudioProcessingImpl::RenderIngressFrame::RenderIngressFrame(
+    const RenderIngressFrame&) = default;
+
+AudioProcessingImpl::RenderIngressFrame&
+AudioProcessingImpl::RenderIngressFrame::operator=(const RenderIngressFrame&) =
+    default;
+
+AudioProcessingImpl::RenderIngressFrame::RenderIngressFrame(
+    RenderIngressFrame&&) = default;
+
+AudioProcessingImpl::RenderIngressFrame&
+AudioProcessingImpl::RenderIngressFrame::operator=(RenderIngressFrame&&) =
+    default;
+
+AudioProcessingImpl::RenderIngressFrame::~RenderIngressFrame() = default;
+
 AudioProcessingImpl::ApmStatsReporter::ApmStatsReporter()
     : stats_message_queue_(1) {}
 
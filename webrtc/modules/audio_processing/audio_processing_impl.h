@@ -13,6 +13,7 @@
 
 #include <stdio.h>
 
+#include <atomic>
 #include <list>
 #include <memory>
 #include <string>
@@ -41,6 +42,7 @@
 #include "modules/audio_processing/voice_detection.h"
 #include "rtc_base/gtest_prod_util.h"
 #include "rtc_base/ignore_wundef.h"
+#include "rtc_base/mpsc_queue.h"
 #include "rtc_base/swap_queue.h"
 #include "rtc_base/synchronization/mutex.h"
 #include "rtc_base/thread_annotations.h"
@@ -239,7 +241,8 @@ class AudioProcessingImpl : public AudioProcessing {
   int MaybeInitializeRender(const ProcessingConfig& processing_config)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(mutex_render_);
   // Called by capture: Holds the capture lock when reading the format struct
-  // and acquires both locks if reinitialization is needed.
+  // and acquires both locks if reinitialization is needed. When the lock-free
+  // render ingress is active, only the capture lock is acquired.
   int MaybeInitializeCapture(const StreamConfig& input_config,
                              const StreamConfig& output_config);
 
@@ -308,6 +311,24 @@ class AudioProcessingImpl : public AudioProcessing {
       RTC_EXCLUSIVE_LOCKS_REQUIRED(mutex_render_);
   int ProcessRenderStreamLocked() RTC_EXCLUSIVE_LOCKS_REQUIRED(mutex_render_);
 
+  // Methods for the lock-free render ingress. The render calls copy the render
+  // audio into |render_ingress_queue_| without acquiring any lock.
+  int QueueRenderIngressFrame(const float* const* src,
+                              const StreamConfig& input_config,
+                              const StreamConfig& output_config,
+                              float* const* dest);
+  int QueueRenderIngressFrame(const int16_t* const src,
+                              const StreamConfig& input_config);
+  // Called by capture while the lock-free render ingress is active: As the
+  // render thread then never accesses the render state, the render state is
+  // owned by the capture thread and the render lock is not needed.
+  void ProcessRenderIngressFrames()
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(mutex_capture_)
+          RTC_NO_THREAD_SAFETY_ANALYSIS;
+  int InitializeLockedForRenderIngress(const ProcessingConfig& config)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(mutex_capture_)
+          RTC_NO_THREAD_SAFETY_ANALYSIS;
+
   // Collects configuration settings from public and private
   // submodules to be saved as an audioproc::Config message on the
   // AecDump if it is attached.  If not |forced|, only writes the current
@@ -514,6 +535,32 @@ class AudioProcessingImpl : public AudioProcessing {
       agc_render_signal_queue_;
   std::unique_ptr<SwapQueue<std::vector<float>, RenderQueueItemVerifier<float>>>
       red_render_signal_queue_;
+
+  // Render frame handed over from the render thread(s) to the capture thread
+  // by the lock-free render ingress.
+  struct RenderIngressFrame {
+    RenderIngressFrame();
+    RenderIngressFrame(const RenderIngressFrame&);
+    RenderIngressFrame& operator=(const RenderIngressFrame&);
+    RenderIngressFrame(RenderIngressFrame&&);
+    RenderIngressFrame& operator=(RenderIngressFrame&&);
+    ~RenderIngressFrame();
+
+    StreamConfig config;
+    bool is_s16 = false;
+    // Deinterleaved float samples, stored one channel after another.
+    std::vector<float> data;
+    std::vector<const float*> channels;
+    // Interleaved int16 samples.
+    std::vector<int16_t> data_s16;
+  };
+
+  // Mirrors config_.pipeline.lock_free_render_ingress for the render calls.
+  // Only modified while holding both locks.
+  std::atomic<bool> render_ingress_enabled_{false};
+  // Lock protection not needed.
+  MpscQueue<RenderIngressFrame> render_ingress_queue_;
+  RenderIngressFrame render_ingress_frame_ RTC_GUARDED_BY(mutex_capture_);
 };
 
 }  // namespace webrtc
@@ -0,0 +1,155 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_processing/echo_detector/normalized_covariance_bank.h"
+
+#include <math.h>
+
+#include <algorithm>
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#include <emmintrin.h>
+#endif
+
+#include "rtc_base/checks.h"
+#include "system_wrappers/include/cpu_features_wrapper.h"
+
+namespace webrtc {
+namespace {
+
+// Parameter controlling the adaptation speed.
+constexpr float kAlpha = 0.001f;
+
+bool IsAvx2Available() {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  return GetCPUInfo(kAVX2) != 0;
+#else
+  return false;
+#endif
+}
+
+bool IsSse2Available() {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  return GetCPUInfo(kSSE2) != 0;
+#else
+  return false;
+#endif
+}
+
+// Updates the estimates from |begin| on and returns the largest normalized
+// cross correlation, or zero if none is positive.
+float UpdateNormalizedCovariances(float x_term,
+                                  float x_sigma,
+                                  rtc::ArrayView<const float> y_centered,
+                                  rtc::ArrayView<const float> y_sigma,
+                                  size_t begin,
+                                  rtc::ArrayView<float> covariance,
+                                  rtc::ArrayView<float> ncc) {
+  float max_ncc = 0.f;
+  for (size_t k = begin; k < covariance.size(); ++k) {
+    covariance[k] = (1.f - kAlpha) * covariance[k] + x_term * y_centered[k];
+    ncc[k] = covariance[k] / (x_sigma * y_sigma[k] + .0001f);
+    max_ncc = std::max(max_ncc, ncc[k]);
+  }
+  return max_ncc;
+}
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+float UpdateNormalizedCovariancesSse2(float x_term,
+                                      float x_sigma,
+                                      rtc::ArrayView<const float> y_centered,
+                                      rtc::ArrayView<const float> y_sigma,
+                                      rtc::ArrayView<float> covariance,
+                                      rtc::ArrayView<float> ncc) {
+  const size_t num_delays = covariance.size();
+  const size_t vector_limit = num_delays & ~size_t{3};
+  const __m128 decay = _mm_set1_ps(1.f - kAlpha);
+  const __m128 x_term_4 = _mm_set1_ps(x_term);
+  const __m128 x_sigma_4 = _mm_set1_ps(x_sigma);
+  const __m128 offset = _mm_set1_ps(.0001f);
+  __m128 max_ncc_4 = _mm_setzero_ps();
+  for (size_t k = 0; k < vector_limit; k += 4) {
+    __m128 c = _mm_mul_ps(decay, _mm_loadu_ps(&covariance[k]));
+    c = _mm_add_ps(c, _mm_mul_ps(x_term_4, _mm_loadu_ps(&y_centered[k])));
+    _mm_storeu_ps(&covariance[k], c);
+    const __m128 norm =
+        _mm_add_ps(_mm_mul_ps(x_sigma_4, _mm_loadu_ps(&y_sigma[k])), offset);
+    const __m128 n = _mm_div_ps(c, norm);
+    _mm_storeu_ps(&ncc[k], n);
+    max_ncc_4 = _mm_max_ps(max_ncc_4, n);
+  }
+  max_ncc_4 = _mm_max_ps(max_ncc_4, _mm_movehl_ps(max_ncc_4, max_ncc_4));
+  max_ncc_4 = _mm_max_ss(max_ncc_4, _mm_shuffle_ps(max_ncc_4, max_ncc_4, 1));
+  const float max_ncc = _mm_cvtss_f32(max_ncc_4);
+  return std::max(max_ncc,
+                  UpdateNormalizedCovariances(x_term, x_sigma, y_centered,
+                                              y_sigma, vector_limit,
+                                              covariance, ncc));
+}
+#endif
+
+}  // namespace
+
+NormalizedCovarianceBank::NormalizedCovarianceBank(size_t num_delays)
+    : use_avx2_(IsAvx2Available()),
+      use_sse2_(IsSse2Available()),
+      covariance_(num_delays, 0.f),
+      normalized_cross_correlation_(num_delays, 0.f) {}
+
+NormalizedCovarianceBank::~NormalizedCovarianceBank() = default;
+
+float NormalizedCovarianceBank::Update(float x,
+                                       float x_mean,
+                                       float x_sigma,
+                                       rtc::ArrayView<const float> y_centered,
+                                       rtc::ArrayView<const float> y_sigma) {
+  RTC_DCHECK_EQ(y_centered.size(), covariance_.size());
+  RTC_DCHECK_EQ(y_sigma.size(), covariance_.size());
+  const float x_term = kAlpha * (x - x_mean);
+  float max_ncc;
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (use_avx2_) {
+    max_ncc = UpdateNormalizedCovariancesAvx2(
+        1.f - kAlpha, x_term, x_sigma, y_centered, y_sigma, covariance_,
+        normalized_cross_correlation_);
+  } else if (use_sse2_) {
+    max_ncc = UpdateNormalizedCovariancesSse2(x_term, x_sigma, y_centered,
+                                              y_sigma, covariance_,
+                                              normalized_cross_correlation_);
+  } else {
+    max_ncc = UpdateNormalizedCovariances(x_term, x_sigma, y_centered, y_sigma,
+                                          0, covariance_,
+                                          normalized_cross_correlation_);
+  }
+#else
+  max_ncc = UpdateNormalizedCovariances(x_term, x_sigma, y_centered, y_sigma, 0,
+                                        covariance_,
+                                        normalized_cross_correlation_);
+#endif
+  for (size_t k = 0; k < covariance_.size(); ++k) {
+    RTC_DCHECK(isfinite(covariance_[k]));
+    RTC_DCHECK(isfinite(normalized_cross_correlation_[k]));
+  }
+  return max_ncc;
+}
+
+size_t NormalizedCovarianceBank::BestDelay() const {
+  return std::max_element(normalized_cross_correlation_.begin(),
+                          normalized_cross_correlation_.end()) -
+         normalized_cross_correlation_.begin();
+}
+
+void NormalizedCovarianceBank::Clear() {
+  std::fill(covariance_.begin(), covariance_.end(), 0.f);
+  std::fill(normalized_cross_correlation_.begin(),
+            normalized_cross_correlation_.end(), 0.f);
+}
+
+}  // namespace webrtc
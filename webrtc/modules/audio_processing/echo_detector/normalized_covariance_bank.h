@@ -0,0 +1,79 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_AUDIO_PROCESSING_ECHO_DETECTOR_NORMALIZED_COVARIANCE_BANK_H_
+#define MODULES_AUDIO_PROCESSING_ECHO_DETECTOR_NORMALIZED_COVARIANCE_BANK_H_
+
+#include <stddef.h>
+
+#include <vector>
+
+#include "api/array_view.h"
+#include "rtc_base/system/arch.h"
+
+namespace webrtc {
+
+// This class iteratively estimates the normalized covariance between a signal
+// x and a number of delayed versions of a signal y. The estimates for all the
+// delays are kept in contiguous arrays and updated together.
+class NormalizedCovarianceBank {
+ public:
+  explicit NormalizedCovarianceBank(size_t num_delays);
+  NormalizedCovarianceBank(const NormalizedCovarianceBank&) = delete;
+  NormalizedCovarianceBank& operator=(const NormalizedCovarianceBank&) =
+      delete;
+  ~NormalizedCovarianceBank();
+
+  size_t num_delays() const { return covariance_.size(); }
+
+  // Updates the estimates with the current value, mean and standard deviation
+  // of x. For each delay, |y_centered| holds the value of y with its mean
+  // removed and |y_sigma| its standard deviation. Returns the largest
+  // normalized cross correlation, or zero if none is positive.
+  float Update(float x,
+               float x_mean,
+               float x_sigma,
+               rtc::ArrayView<const float> y_centered,
+               rtc::ArrayView<const float> y_sigma);
+  // Returns the smallest delay with the largest normalized cross correlation.
+  size_t BestDelay() const;
+  // This function returns an estimate of the Pearson product-moment correlation
+  // coefficient of the two signals at |delay|.
+  float normalized_cross_correlation(size_t delay) const {
+    return normalized_cross_correlation_[delay];
+  }
+  float covariance(size_t delay) const { return covariance_[delay]; }
+  // This function resets the estimated values to zero.
+  void Clear();
+
+ private:
+  const bool use_avx2_;
+  const bool use_sse2_;
+  std::vector<float> covariance_;
+  std::vector<float> normalized_cross_correlation_;
+};
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+// AVX2 version of the update in NormalizedCovarianceBank, where |decay| is one
+// minus the adaptation speed and |x_term| the adaptation speed times the value
+// of x with its mean removed.
+float UpdateNormalizedCovariancesAvx2(
+    float decay,
+    float x_term,
+    float x_sigma,
+    rtc::ArrayView<const float> y_centered,
+    rtc::ArrayView<const float> y_sigma,
+    rtc::ArrayView<float> covariance,
+    rtc::ArrayView<float> normalized_cross_correlation);
+#endif
+
+}  // namespace webrtc
+
+#endif  // MODULES_AUDIO_PROCESSING_ECHO_DETECTOR_NORMALIZED_COVARIANCE_BANK_H_
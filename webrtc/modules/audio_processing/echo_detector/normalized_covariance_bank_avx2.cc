@@ -0,0 +1,65 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <immintrin.h>
+
+#include <algorithm>
+
+#include "modules/audio_processing/echo_detector/normalized_covariance_bank.h"
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+
+float UpdateNormalizedCovariancesAvx2(
+    float decay,
+    float x_term,
+    float x_sigma,
+    rtc::ArrayView<const float> y_centered,
+    rtc::ArrayView<const float> y_sigma,
+    rtc::ArrayView<float> covariance,
+    rtc::ArrayView<float> normalized_cross_correlation) {
+  RTC_DCHECK_EQ(y_centered.size(), covariance.size());
+  RTC_DCHECK_EQ(y_sigma.size(), covariance.size());
+  RTC_DCHECK_EQ(normalized_cross_correlation.size(), covariance.size());
+  const size_t num_delays = covariance.size();
+  const size_t vector_limit = num_delays & ~size_t{7};
+  const __m256 decay_8 = _mm256_set1_ps(decay);
+  const __m256 x_term_8 = _mm256_set1_ps(x_term);
+  const __m256 x_sigma_8 = _mm256_set1_ps(x_sigma);
+  const __m256 offset = _mm256_set1_ps(.0001f);
+  __m256 max_ncc_8 = _mm256_setzero_ps();
+  size_t k = 0;
+  for (; k < vector_limit; k += 8) {
+    // Same operation order as in the scalar code, so that the estimates match.
+    __m256 c = _mm256_mul_ps(decay_8, _mm256_loadu_ps(&covariance[k]));
+    c = _mm256_add_ps(c,
+                      _mm256_mul_ps(x_term_8, _mm256_loadu_ps(&y_centered[k])));
+    _mm256_storeu_ps(&covariance[k], c);
+    const __m256 norm = _mm256_add_ps(
+        _mm256_mul_ps(x_sigma_8, _mm256_loadu_ps(&y_sigma[k])), offset);
+    const __m256 ncc = _mm256_div_ps(c, norm);
+    _mm256_storeu_ps(&normalized_cross_correlation[k], ncc);
+    max_ncc_8 = _mm256_max_ps(max_ncc_8, ncc);
+  }
+  __m128 max_ncc_4 = _mm_max_ps(_mm256_castps256_ps128(max_ncc_8),
+                                _mm256_extractf128_ps(max_ncc_8, 1));
+  max_ncc_4 = _mm_max_ps(max_ncc_4, _mm_movehl_ps(max_ncc_4, max_ncc_4));
+  max_ncc_4 = _mm_max_ss(max_ncc_4, _mm_shuffle_ps(max_ncc_4, max_ncc_4, 1));
+  float max_ncc = _mm_cvtss_f32(max_ncc_4);
+  for (; k < num_delays; ++k) {
+    covariance[k] = decay * covariance[k] + x_term * y_centered[k];
+    normalized_cross_correlation[k] =
+        covariance[k] / (x_sigma * y_sigma[k] + .0001f);
+    max_ncc = std::max(max_ncc, normalized_cross_correlation[k]);
+  }
+  return max_ncc;
+}
+
+}  // namespace webrtc
@@ -10,6 +10,7 @@
 
 #include "modules/audio_processing/gain_control_impl.h"
 
+#include <algorithm>
 #include <cstdint>
 
 #include "absl/types/optional.h"
@@ -19,8 +20,14 @@
 #include "modules/audio_processing/logging/apm_data_dumper.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/logging.h"
+#include "rtc_base/system/arch.h"
+#include "system_wrappers/include/cpu_features_wrapper.h"
 #include "system_wrappers/include/field_trial.h"
 
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#include <emmintrin.h>
+#endif
+
 namespace webrtc {
 
 typedef void Handle;
@@ -39,36 +46,60 @@ int16_t MapSetting(GainControl::Mode mode) {
   return -1;
 }
 
-// Checks whether the legacy digital gain application should be used.
+// Checks whether the legacy fixed-point digital gain computation and
+// application should be used.
 bool UseLegacyDigitalGainApplier() {
   return field_trial::IsEnabled("WebRTC-UseLegacyDigitalGainApplier");
 }
 
-// Floating point variant of WebRtcAgc_Process.
-void ApplyDigitalGain(const int32_t gains[11],
-                      size_t num_bands,
-                      float* const* out) {
-  constexpr float kScaling = 1.f / 65536.f;
+bool IsSse2Available() {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  return GetCPUInfo(kSSE2) != 0;
+#else
+  return false;
+#endif
+}
+
+// Floating point variant of WebRtcAgc_Process, which applies the linear gains
+// to all the bands of all the channels. The gains are interpolated once into a
+// per-sample gain curve shared by the bands and channels.
+void ApplyDigitalGain(const float gains[11],
+                      bool use_sse2,
+                      AudioBuffer* audio) {
   constexpr int kNumSubSections = 16;
   constexpr float kOneByNumSubSections = 1.f / kNumSubSections;
-
-  float gains_scaled[11];
-  for (int k = 0; k < 11; ++k) {
-    gains_scaled[k] = gains[k] * kScaling;
+  constexpr size_t kFrameLength = 10 * kNumSubSections;
+  RTC_DCHECK_EQ(kFrameLength, audio->num_frames_per_band());
+
+  float gain_curve[kFrameLength];
+  for (int k = 0, sample = 0; k < 10; ++k) {
+    const float delta = (gains[k + 1] - gains[k]) * kOneByNumSubSections;
+    float gain = gains[k];
+    for (int n = 0; n < kNumSubSections; ++n, ++sample) {
+      gain_curve[sample] = gain;
+      gain += delta;
+    }
   }
 
-  for (size_t b = 0; b < num_bands; ++b) {
-    float* out_band = out[b];
-    for (int k = 0, sample = 0; k < 10; ++k) {
-      const float delta =
-          (gains_scaled[k + 1] - gains_scaled[k]) * kOneByNumSubSections;
-      float gain = gains_scaled[k];
-      for (int n = 0; n < kNumSubSections; ++n, ++sample) {
-        RTC_DCHECK_EQ(k * kNumSubSections + n, sample);
-        out_band[sample] *= gain;
-        out_band[sample] =
-            std::min(32767.f, std::max(-32768.f, out_band[sample]));
-        gain += delta;
+  for (size_t ch = 0; ch < audio->num_channels(); ++ch) {
+    for (size_t b = 0; b < audio->num_bands(); ++b) {
+      float* out_band = audio->split_bands(ch)[b];
+      size_t i = 0;
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+      if (use_sse2) {
+        const __m128 kMinValue = _mm_set1_ps(-32768.f);
+        const __m128 kMaxValue = _mm_set1_ps(32767.f);
+        for (; i < kFrameLength; i += 4) {
+          const __m128 out = _mm_mul_ps(_mm_loadu_ps(&out_band[i]),
+                                        _mm_loadu_ps(&gain_curve[i]));
+          _mm_storeu_ps(&out_band[i],
+                        _mm_min_ps(kMaxValue, _mm_max_ps(kMinValue, out)));
+        }
+      }
+#endif
+      for (; i < kFrameLength; ++i) {
+        out_band[i] =
+            std::min(32767.f, std::max(-32768.f, out_band[i] * gain_curve[i]));
       }
     }
   }
@@ -90,6 +121,7 @@ struct GainControlImpl::MonoAgcState {
   MonoAgcState(const MonoAgcState&) = delete;
   MonoAgcState& operator=(const MonoAgcState&) = delete;
   int32_t gains[11];
+  float linear_gains[11];
   Handle* state;
 };
 
@@ -98,6 +130,7 @@ int GainControlImpl::instance_counter_ = 0;
 GainControlImpl::GainControlImpl()
     : data_dumper_(new ApmDataDumper(instance_counter_)),
       use_legacy_gain_applier_(UseLegacyDigitalGainApplier()),
+      use_sse2_(IsSse2Available()),
       mode_(kAdaptiveAnalog),
       minimum_capture_level_(0),
       maximum_capture_level_(255),
@@ -207,20 +240,30 @@ int GainControlImpl::ProcessCaptureAudio(AudioBuffer* audio,
   stream_is_saturated_ = false;
   bool error_reported = false;
   for (size_t ch = 0; ch < mono_agcs_.size(); ++ch) {
-    int16_t split_band_data[AudioBuffer::kMaxNumBands]
-                           [AudioBuffer::kMaxSplitFrameLength];
-    int16_t* split_bands[AudioBuffer::kMaxNumBands] = {
-        split_band_data[0], split_band_data[1], split_band_data[2]};
-    audio->ExportSplitChannelData(ch, split_bands);
-
     // The call to stream_has_echo() is ok from a deadlock perspective
     // as the capture lock is allready held.
     int32_t new_capture_level = 0;
     uint8_t saturation_warning = 0;
-    int err_analyze = WebRtcAgc_Analyze(
-        mono_agcs_[ch]->state, split_bands, audio->num_bands(),
-        audio->num_frames_per_band(), capture_levels_[ch], &new_capture_level,
-        stream_has_echo, &saturation_warning, mono_agcs_[ch]->gains);
+    int err_analyze;
+    if (use_legacy_gain_applier_) {
+      int16_t split_band_data[AudioBuffer::kMaxNumBands]
+                             [AudioBuffer::kMaxSplitFrameLength];
+      int16_t* split_bands[AudioBuffer::kMaxNumBands] = {
+          split_band_data[0], split_band_data[1], split_band_data[2]};
+      audio->ExportSplitChannelData(ch, split_bands);
+
+      err_analyze = WebRtcAgc_Analyze(
+          mono_agcs_[ch]->state, split_bands, audio->num_bands(),
+          audio->num_frames_per_band(), capture_levels_[ch],
+          &new_capture_level, stream_has_echo, &saturation_warning,
+          mono_agcs_[ch]->gains);
+    } else {
+      err_analyze = WebRtcAgc_AnalyzeFloat(
+          mono_agcs_[ch]->state, audio->split_bands_const(ch),
+          audio->num_frames_per_band(), capture_levels_[ch],
+          &new_capture_level, stream_has_echo, &saturation_warning,
+          mono_agcs_[ch]->linear_gains);
+    }
     capture_levels_[ch] = new_capture_level;
 
     error_reported = error_reported || err_analyze != AudioProcessing::kNoError;
@@ -231,7 +274,11 @@ int GainControlImpl::ProcessCaptureAudio(AudioBuffer* audio,
   // Choose the minimun gain for application
   size_t index_to_apply = 0;
   for (size_t ch = 1; ch < mono_agcs_.size(); ++ch) {
-    if (mono_agcs_[index_to_apply]->gains[10] < mono_agcs_[ch]->gains[10]) {
+    const MonoAgcState& applied = *mono_agcs_[index_to_apply];
+    const MonoAgcState& candidate = *mono_agcs_[ch];
+    if (use_legacy_gain_applier_
+            ? applied.gains[10] < candidate.gains[10]
+            : applied.linear_gains[10] < candidate.linear_gains[10]) {
       index_to_apply = ch;
     }
   }
@@ -252,10 +299,8 @@ int GainControlImpl::ProcessCaptureAudio(AudioBuffer* audio,
       audio->ImportSplitChannelData(ch, split_bands);
     }
   } else {
-    for (size_t ch = 0; ch < mono_agcs_.size(); ++ch) {
-      ApplyDigitalGain(mono_agcs_[index_to_apply]->gains, audio->num_bands(),
-                       audio->split_bands(ch));
-    }
+    ApplyDigitalGain(mono_agcs_[index_to_apply]->linear_gains, use_sse2_,
+                     audio);
   }
 
   RTC_DCHECK_LT(0ul, *num_proc_channels_);
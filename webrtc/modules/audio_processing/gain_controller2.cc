@@ -11,14 +11,24 @@
 #include "modules/audio_processing/gain_controller2.h"
 
 #include "common_audio/include/audio_util.h"
+#include "modules/audio_processing/agc2/agc2_common.h"
+#include "modules/audio_processing/agc2/state_snapshot.h"
 #include "modules/audio_processing/audio_buffer.h"
 #include "modules/audio_processing/include/audio_frame_view.h"
 #include "modules/audio_processing/logging/apm_data_dumper.h"
 #include "rtc_base/atomic_ops.h"
 #include "rtc_base/checks.h"
+#include "rtc_base/memory/allocation_guard.h"
 #include "rtc_base/strings/string_builder.h"
 
 namespace webrtc {
+namespace {
+
+// Identifies the snapshot format written by GainController2::SaveState(). To be
+// changed whenever the layout of the state changes.
+constexpr uint32_t kSnapshotFormatVersion = 3;
+
+}  // namespace
 
 int GainController2::instance_count_ = 0;
 
@@ -40,34 +50,186 @@ void GainController2::Initialize(int sample_rate_hz) {
              sample_rate_hz == AudioProcessing::kSampleRate16kHz ||
              sample_rate_hz == AudioProcessing::kSampleRate32kHz ||
              sample_rate_hz == AudioProcessing::kSampleRate48kHz);
+  sample_rate_hz_ = sample_rate_hz;
   limiter_.SetSampleRate(sample_rate_hz);
+  if (look_ahead_limiter_) {
+    look_ahead_limiter_->SetSampleRate(sample_rate_hz);
+  }
   data_dumper_->InitiateNewSetOfRecordings();
   data_dumper_->DumpRaw("sample_rate_hz", sample_rate_hz);
 }
 
 void GainController2::Process(AudioBuffer* audio) {
+  ScopedRealTimeSection real_time_section;
   AudioFrameView<float> float_frame(audio->channels(), audio->num_channels(),
                                     audio->num_frames());
-  // Apply fixed gain first, then the adaptive one.
-  gain_applier_.ApplyGain(float_frame);
+  // Apply fixed gain first, then the adaptive one. The fixed gain is applied
+  // in the same pass that computes the levels shared by the VAD and the noise
+  // estimator, which analyze the signal after the fixed gain.
+  frame_stats_analyzer_.ApplyGainAndAnalyze(
+      gain_applier_.ComputeGains(audio->num_frames()), float_frame,
+      &frame_stats_);
+  rtc::ArrayView<const float> adaptive_gains;
+  if (adaptive_agc_) {
+    adaptive_gains = adaptive_agc_->Analyze(
+        float_frame, frame_stats_,
+        look_ahead_limiter_ ? look_ahead_limiter_->LastAudioLevel()
+                            : limiter_.LastAudioLevel());
+  }
+  // The adaptive gain is applied by the limiter in the same pass as the
+  // limiter gain. The limiter level is computed from the envelope after the
+  // adaptive gain, which only requires reading the samples again when the
+  // adaptive gain changes within the frame.
+  frame_stats_analyzer_.ComputeEnvelope(float_frame, frame_stats_,
+                                        adaptive_gains, &limiter_envelope_);
+  if (look_ahead_limiter_) {
+    look_ahead_limiter_->Process(float_frame, adaptive_gains,
+                                 limiter_envelope_);
+  } else {
+    limiter_.Process(float_frame, adaptive_gains, limiter_envelope_);
+  }
+}
+
+void GainController2::ProcessSplitBands(AudioBuffer* audio) {
+  if (!multi_band_limiter_ || audio->num_bands() == 1) {
+    return;
+  }
+  ScopedRealTimeSection real_time_section;
+  RTC_DCHECK_LE(audio->num_bands(), MultiBandLimiter::kMaxNumBands);
+  // The gains that Process() applies to the merged signal, as of the end of
+  // the last frame.
+  float downstream_gain = gain_applier_.GetGainFactor();
   if (adaptive_agc_) {
-    adaptive_agc_->Process(float_frame, limiter_.LastAudioLevel());
+    downstream_gain *= adaptive_agc_->GetGainFactor();
+  }
+  for (size_t band = 0; band < audio->num_bands(); ++band) {
+    multi_band_limiter_->Process(
+        band,
+        AudioFrameView<float>(audio->split_channels(static_cast<Band>(band)),
+                              audio->num_channels(),
+                              audio->num_frames_per_band()),
+        downstream_gain);
   }
-  limiter_.Process(float_frame);
 }
 
 void GainController2::NotifyAnalogLevel(int level) {
   if (analog_level_ != level && adaptive_agc_) {
-    adaptive_agc_->Reset();
+    adaptive_agc_->HandleInputGainChange();
   }
   analog_level_ = level;
 }
 
+void GainController2::Reset() {
+  // The fixed gain is ramped up from zero in the first frame, as done after
+  // construction.
+  gain_applier_.Reset(/*gain_factor=*/0.f);
+  gain_applier_.SetGainFactor(DbToRatio(config_.fixed_digital.gain_db));
+  limiter_.Reset();
+  if (look_ahead_limiter_) {
+    look_ahead_limiter_->Reset();
+  }
+  if (multi_band_limiter_) {
+    multi_band_limiter_->Reset();
+  }
+  if (adaptive_agc_) {
+    adaptive_agc_->Reset();
+  }
+  analog_level_ = -1;
+}
+
+void GainController2::SaveState(std::vector<uint8_t>* snapshot) const {
+  RTC_DCHECK(snapshot);
+  snapshot->clear();
+  StateSnapshotWriter writer(snapshot);
+  writer.Write(kSnapshotFormatVersion);
+  writer.Write(sample_rate_hz_);
+  writer.Write(static_cast<bool>(adaptive_agc_));
+  // The VAD state depends on the backend.
+  writer.Write(static_cast<int>(config_.adaptive_digital.vad_backend));
+  writer.Write(analog_level_);
+  gain_applier_.SaveState(&writer);
+  limiter_.SaveState(&writer);
+  if (adaptive_agc_) {
+    adaptive_agc_->SaveState(&writer);
+  }
+}
+
+bool GainController2::RestoreState(rtc::ArrayView<const uint8_t> snapshot) {
+  // Validate the header and the size before modifying any state. The size of
+  // the state only depends on the header fields.
+  std::vector<uint8_t> current_state;
+  SaveState(&current_state);
+  StateSnapshotReader reader(snapshot);
+  uint32_t version = 0;
+  int sample_rate_hz = 0;
+  bool adaptive_digital_enabled = false;
+  int vad_backend = 0;
+  reader.Read(&version);
+  reader.Read(&sample_rate_hz);
+  reader.Read(&adaptive_digital_enabled);
+  reader.Read(&vad_backend);
+  if (!reader.ok() || version != kSnapshotFormatVersion ||
+      sample_rate_hz != sample_rate_hz_ ||
+      adaptive_digital_enabled != static_cast<bool>(adaptive_agc_) ||
+      vad_backend != static_cast<int>(config_.adaptive_digital.vad_backend) ||
+      snapshot.size() != current_state.size()) {
+    return false;
+  }
+
+  RestoreStateFields(&reader);
+  if (!reader.ok()) {
+    // The snapshot holds invalid values. Roll back to the state before the
+    // call, which is always valid.
+    StateSnapshotReader rollback_reader(current_state);
+    rollback_reader.Read(&version);
+    rollback_reader.Read(&sample_rate_hz);
+    rollback_reader.Read(&adaptive_digital_enabled);
+    rollback_reader.Read(&vad_backend);
+    RestoreStateFields(&rollback_reader);
+    RTC_DCHECK(rollback_reader.ok());
+    return false;
+  }
+  RTC_DCHECK_EQ(0, reader.remaining());
+  return true;
+}
+
+void GainController2::RestoreStateFields(StateSnapshotReader* reader) {
+  reader->Read(&analog_level_);
+  // The gain factors are zero until the gain is first set.
+  gain_applier_.RestoreState(reader, 0.f, DbToRatio(kMaxFixedDigitalGainDb));
+  // The fixed gain follows the current configuration.
+  gain_applier_.SetGainFactor(DbToRatio(config_.fixed_digital.gain_db));
+  limiter_.RestoreState(reader);
+  // The look-ahead and the multi-band limiters are not part of the state,
+  // since the former holds audio of the stream that was saved and the latter
+  // depends on whether that stream was split into bands.
+  if (look_ahead_limiter_) {
+    look_ahead_limiter_->Reset();
+  }
+  if (multi_band_limiter_) {
+    multi_band_limiter_->Reset();
+  }
+  if (adaptive_agc_) {
+    adaptive_agc_->RestoreState(reader);
+  }
+}
+
 void GainController2::ApplyConfig(
     const AudioProcessing::Config::GainController2& config) {
   RTC_DCHECK(Validate(config))
       << " the invalid config was " << ToString(config);
 
+  // The look-ahead and the multi-band limiters are only recreated when their
+  // own configuration changes, since APM applies the config whenever the
+  // fixed gain changes and recreating the look-ahead limiter drops the delayed
+  // audio.
+  const bool recreate_look_ahead_limiter =
+      config.look_ahead_limiter.enabled !=
+          static_cast<bool>(look_ahead_limiter_) ||
+      config.look_ahead_limiter.delay_ms != config_.look_ahead_limiter.delay_ms;
+  const bool recreate_multi_band_limiter =
+      config.multi_band_limiter.enabled !=
+      static_cast<bool>(multi_band_limiter_);
   config_ = config;
   if (config.fixed_digital.gain_db != config_.fixed_digital.gain_db) {
     // Reset the limiter to quickly react on abrupt level changes caused by
@@ -80,14 +242,31 @@ void GainController2::ApplyConfig(
   } else {
     adaptive_agc_.reset();
   }
+  if (recreate_look_ahead_limiter) {
+    look_ahead_limiter_.reset(
+        config_.look_ahead_limiter.enabled
+            ? new LookAheadLimiter(sample_rate_hz_,
+                                   config_.look_ahead_limiter.delay_ms,
+                                   data_dumper_.get(), "Agc2")
+            : nullptr);
+  }
+  if (recreate_multi_band_limiter) {
+    multi_band_limiter_.reset(
+        config_.multi_band_limiter.enabled
+            ? new MultiBandLimiter(data_dumper_.get(), "Agc2MultiBand")
+            : nullptr);
+  }
 }
 
 bool GainController2::Validate(
     const AudioProcessing::Config::GainController2& config) {
   return config.fixed_digital.gain_db >= 0.f &&
-         config.fixed_digital.gain_db < 50.f &&
+         config.fixed_digital.gain_db < kMaxFixedDigitalGainDb &&
          config.adaptive_digital.extra_saturation_margin_db >= 0.f &&
-         config.adaptive_digital.extra_saturation_margin_db <= 100.f;
+         config.adaptive_digital.extra_saturation_margin_db <= 100.f &&
+         (!config.look_ahead_limiter.enabled ||
+          (config.look_ahead_limiter.delay_ms >= kMinLookAheadLimiterDelayMs &&
+           config.look_ahead_limiter.delay_ms <= kMaxLookAheadLimiterDelayMs));
 }
 
 std::string GainController2::ToString(
@@ -103,6 +282,22 @@ std::string GainController2::ToString(
     case LevelEstimatorType::kPeak:
       adaptive_digital_level_estimator = "peak";
       break;
+    case LevelEstimatorType::kLoudness:
+      adaptive_digital_level_estimator = "loudness";
+      break;
+  }
+  std::string adaptive_digital_vad_backend;
+  using VadBackendType = AudioProcessing::Config::GainController2::VadBackend;
+  switch (config.adaptive_digital.vad_backend) {
+    case VadBackendType::kRnn:
+      adaptive_digital_vad_backend = "RNN";
+      break;
+    case VadBackendType::kGmm:
+      adaptive_digital_vad_backend = "GMM";
+      break;
+    case VadBackendType::kHybrid:
+      adaptive_digital_vad_backend = "hybrid";
+      break;
   }
   // clang-format off
   // clang formatting doesn't respect custom nested style.
@@ -112,9 +307,17 @@ std::string GainController2::ToString(
         "adaptive_digital: {"
           "enabled: "
             << (config.adaptive_digital.enabled ? "true" : "false") << ", "
+          "vad_backend: " << adaptive_digital_vad_backend << ", "
           "level_estimator: " << adaptive_digital_level_estimator << ", "
           "extra_saturation_margin_db:"
-            << config.adaptive_digital.extra_saturation_margin_db << "}"
+            << config.adaptive_digital.extra_saturation_margin_db << "}, "
+        "look_ahead_limiter: {"
+          "enabled: "
+            << (config.look_ahead_limiter.enabled ? "true" : "false") << ", "
+          "delay_ms: " << config.look_ahead_limiter.delay_ms << "}, "
+        "multi_band_limiter: {"
+          "enabled: "
+            << (config.multi_band_limiter.enabled ? "true" : "false") << "}"
           "}";
   // clang-format on
   return ss.Release();
@@ -11,12 +11,20 @@
 #ifndef MODULES_AUDIO_PROCESSING_GAIN_CONTROLLER2_H_
 #define MODULES_AUDIO_PROCESSING_GAIN_CONTROLLER2_H_
 
+#include <stdint.h>
+
+#include <array>
 #include <memory>
 #include <string>
+#include <vector>
 
+#include "api/array_view.h"
 #include "modules/audio_processing/agc2/adaptive_agc.h"
+#include "modules/audio_processing/agc2/frame_stats.h"
 #include "modules/audio_processing/agc2/gain_applier.h"
 #include "modules/audio_processing/agc2/limiter.h"
+#include "modules/audio_processing/agc2/look_ahead_limiter.h"
+#include "modules/audio_processing/agc2/multi_band_limiter.h"
 #include "modules/audio_processing/include/audio_processing.h"
 #include "rtc_base/constructor_magic.h"
 
@@ -24,6 +32,7 @@ namespace webrtc {
 
 class ApmDataDumper;
 class AudioBuffer;
+class StateSnapshotReader;
 
 // Gain Controller 2 aims to automatically adjust levels by acting on the
 // microphone gain and/or applying digital gain.
@@ -34,21 +43,55 @@ class GainController2 {
 
   void Initialize(int sample_rate_hz);
   void Process(AudioBuffer* audio);
+  // Limits the frequency bands of |audio| before they are merged, if the
+  // multi-band limiter is enabled and |audio| is split into several bands.
+  // Must be called before Process() for the same frame.
+  void ProcessSplitBands(AudioBuffer* audio);
   void NotifyAnalogLevel(int level);
 
+  // Resets the processing state to that of a newly created instance with the
+  // same sample rate and configuration. Unlike ApplyConfig(), no memory is
+  // allocated, which makes it suitable to recycle instances.
+  void Reset();
+
+  // Writes the complete adaptation state (speech and noise levels, saturation
+  // margin, applied gains, limiter envelope and VAD state) into |snapshot|.
+  // Restoring it into another instance lets that instance continue from where
+  // this one is instead of re-adapting from the initial speech level estimate.
+  void SaveState(std::vector<uint8_t>* snapshot) const;
+
+  // Restores a state written by SaveState(). The configuration is not part of
+  // the state; the instance must be initialized with the same sample rate and
+  // must have the adaptive digital controller enabled if and only if it was
+  // enabled when saving, with the same VAD backend. Since ApplyConfig()
+  // resets the adaptive state, the state must be restored after applying the
+  // configuration. Returns false and leaves the state unchanged if the
+  // snapshot is incompatible or invalid.
+  bool RestoreState(rtc::ArrayView<const uint8_t> snapshot);
+
   void ApplyConfig(const AudioProcessing::Config::GainController2& config);
   static bool Validate(const AudioProcessing::Config::GainController2& config);
   static std::string ToString(
       const AudioProcessing::Config::GainController2& config);
 
  private:
+  // Reads the state that follows the snapshot header.
+  void RestoreStateFields(StateSnapshotReader* reader);
+
   static int instance_count_;
   std::unique_ptr<ApmDataDumper> data_dumper_;
   AudioProcessing::Config::GainController2 config_;
   GainApplier gain_applier_;
+  const FrameStatsAnalyzer frame_stats_analyzer_;
+  FrameStats frame_stats_;
+  std::array<float, kSubFramesInFrame> limiter_envelope_;
   std::unique_ptr<AdaptiveAgc> adaptive_agc_;
   Limiter limiter_;
+  // Replaces |limiter_| if enabled.
+  std::unique_ptr<LookAheadLimiter> look_ahead_limiter_;
+  std::unique_ptr<MultiBandLimiter> multi_band_limiter_;
   int analog_level_ = -1;
+  int sample_rate_hz_ = AudioProcessing::kSampleRate48kHz;
 
   RTC_DISALLOW_COPY_AND_ASSIGN(GainController2);
 };
@@ -11,11 +11,10 @@
 #ifndef MODULES_AUDIO_PROCESSING_HIGH_PASS_FILTER_H_
 #define MODULES_AUDIO_PROCESSING_HIGH_PASS_FILTER_H_
 
-#include <memory>
 #include <vector>
 
 #include "api/array_view.h"
-#include "modules/audio_processing/utility/cascaded_biquad_filter.h"
+#include "modules/audio_processing/utility/multi_channel_biquad_filter.h"
 
 namespace webrtc {
 
@@ -34,11 +33,12 @@ class HighPassFilter {
   void Reset(size_t num_channels);
 
   int sample_rate_hz() const { return sample_rate_hz_; }
-  size_t num_channels() const { return filters_.size(); }
+  size_t num_channels() const { return filter_.num_channels(); }
 
  private:
   const int sample_rate_hz_;
-  std::vector<std::unique_ptr<CascadedBiQuadFilter>> filters_;
+  MultiChannelBiQuadFilter filter_;
+  std::vector<float*> channel_ptrs_;
 };
 }  // namespace webrtc
 
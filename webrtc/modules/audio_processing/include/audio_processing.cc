@@ -10,6 +10,7 @@
 
 #include "modules/audio_processing/include/audio_processing.h"
 
+#include "rtc_base/checks.h"
 #include "rtc_base/strings/string_builder.h"
 #include "rtc_base/system/arch.h"
 
@@ -49,9 +50,25 @@ std::string GainController2LevelEstimatorToString(
       return "Rms";
     case AudioProcessing::Config::GainController2::LevelEstimator::kPeak:
       return "Peak";
+    case AudioProcessing::Config::GainController2::LevelEstimator::kLoudness:
+      return "Loudness";
   }
 }
 
+std::string GainController2VadBackendToString(
+    const AudioProcessing::Config::GainController2::VadBackend& backend) {
+  switch (backend) {
+    case AudioProcessing::Config::GainController2::VadBackend::kRnn:
+      return "Rnn";
+    case AudioProcessing::Config::GainController2::VadBackend::kGmm:
+      return "Gmm";
+    case AudioProcessing::Config::GainController2::VadBackend::kHybrid:
+      return "Hybrid";
+  }
+  RTC_NOTREACHED();
+  return "";
+}
+
 int GetDefaultMaxInternalRate() {
 #ifdef WEBRTC_ARCH_ARM_FAMILY
   return 32000;
@@ -81,6 +98,7 @@ std::string AudioProcessing::Config::ToString() const {
           << ", "
              ", multi_channel_capture: "
           << pipeline.multi_channel_capture
+          << ", lock_free_render_ingress: " << pipeline.lock_free_render_ingress
           << "}, "
              "pre_amplifier: { enabled: "
           << pre_amplifier.enabled
@@ -107,13 +125,21 @@ std::string AudioProcessing::Config::ToString() const {
           << ", fixed_digital: { gain_db: "
           << gain_controller2.fixed_digital.gain_db
           << " }, adaptive_digital: { enabled: "
-          << gain_controller2.adaptive_digital.enabled << ", level_estimator: "
+          << gain_controller2.adaptive_digital.enabled << ", vad_backend: "
+          << GainController2VadBackendToString(
+                 gain_controller2.adaptive_digital.vad_backend)
+          << ", level_estimator: "
           << GainController2LevelEstimatorToString(
                  gain_controller2.adaptive_digital.level_estimator)
           << ", use_saturation_protector: "
           << gain_controller2.adaptive_digital.use_saturation_protector
           << ", extra_saturation_margin_db: "
           << gain_controller2.adaptive_digital.extra_saturation_margin_db
+          << " }, look_ahead_limiter: { enabled: "
+          << gain_controller2.look_ahead_limiter.enabled
+          << ", delay_ms: " << gain_controller2.look_ahead_limiter.delay_ms
+          << " }, multi_band_limiter: { enabled: "
+          << gain_controller2.multi_band_limiter.enabled
           << " } }, residual_echo_detector: { enabled: "
           << residual_echo_detector.enabled
           << " }, level_estimation: { enabled: " << level_estimation.enabled
@@ -226,6 +226,15 @@ class RTC_EXPORT AudioProcessing : public rtc::RefCountInterface {
       // Allow multi-channel processing of capture audio when AEC3 is active
       // or a custom AEC is injected..
       bool multi_channel_capture = false;
+      // Let ProcessReverseStream() and AnalyzeReverseStream() hand the render
+      // audio over to the capture thread through a lock-free queue instead of
+      // processing it under the render lock. The render calls then never
+      // block on capture processing, and the queued render frames are analyzed
+      // at the start of the next ProcessStream() call. Any render
+      // pre-processing is then applied to the analyzed signal only and the
+      // render output is a copy of the render input, which requires the
+      // reverse input and output stream formats to be identical.
+      bool lock_free_render_ingress = false;
     } pipeline;
 
     // Enabled the pre-amplifier. It amplifies the capture signal
@@ -338,7 +347,15 @@ class RTC_EXPORT AudioProcessing : public rtc::RefCountInterface {
     // first applies a fixed gain. The adaptive digital AGC can be turned off by
     // setting |adaptive_digital_mode=false|.
     struct GainController2 {
-      enum LevelEstimator { kRms, kPeak };
+      // Level used by the adaptive digital controller to estimate the speech
+      // level. kLoudness is the BS.1770 momentary loudness of the last 400 ms.
+      enum LevelEstimator { kRms, kPeak, kLoudness };
+      // Voice activity detector used by the adaptive digital controller.
+      // kRnn is the most accurate. kGmm is the GMM VAD of common_audio, which
+      // is much cheaper but less robust to noise. kHybrid runs the GMM VAD on
+      // every frame and only runs the RNN VAD while the GMM VAD detects
+      // speech, plus a hangover.
+      enum VadBackend { kRnn, kGmm, kHybrid };
       bool enabled = false;
       struct {
         float gain_db = 0.f;
@@ -346,6 +363,7 @@ class RTC_EXPORT AudioProcessing : public rtc::RefCountInterface {
       struct {
         bool enabled = false;
         float vad_probability_attack = 1.f;
+        VadBackend vad_backend = kRnn;
         LevelEstimator level_estimator = kRms;
         int level_estimator_adjacent_speech_frames_threshold = 1;
         // TODO(crbug.com/webrtc/7494): Remove `use_saturation_protector`.
@@ -354,6 +372,22 @@ class RTC_EXPORT AudioProcessing : public rtc::RefCountInterface {
         float extra_saturation_margin_db = 2.f;
         int gain_applier_adjacent_speech_frames_threshold = 1;
       } adaptive_digital;
+      // Replaces the limiter with one that delays the output by |delay_ms|,
+      // in [1, 5] ms, rounded to 0.5 ms, plus four samples, and reduces the
+      // gain before the true peaks of the signal, including those between
+      // samples, reach the output.
+      struct {
+        bool enabled = false;
+        float delay_ms = 2.f;
+      } look_ahead_limiter;
+      // Limits each frequency band of the capture signal before the bands are
+      // merged, at 32 and 48 kHz, so that a band that would be limited after
+      // the gain applied by the controller does not lower the gain of the
+      // other bands. Only active when another submodule (e.g., the noise
+      // suppressor or the split-band high-pass filter) splits the bands.
+      struct {
+        bool enabled = false;
+      } multi_band_limiter;
     } gain_controller2;
 
     struct ResidualEchoDetector {
@@ -17,7 +17,7 @@
 #include "modules/audio_processing/echo_detector/circular_buffer.h"
 #include "modules/audio_processing/echo_detector/mean_variance_estimator.h"
 #include "modules/audio_processing/echo_detector/moving_max.h"
-#include "modules/audio_processing/echo_detector/normalized_covariance_estimator.h"
+#include "modules/audio_processing/echo_detector/normalized_covariance_bank.h"
 #include "modules/audio_processing/include/audio_processing.h"
 
 namespace webrtc {
@@ -63,16 +63,18 @@ class ResidualEchoDetector : public EchoDetector {
   // situation.
   size_t frames_since_zero_buffer_size_ = 0;
 
-  // Circular buffers containing delayed versions of the power, mean and
-  // standard deviation, for calculating the delayed covariance values.
+  // Buffers containing delayed versions of the power, mean, standard deviation
+  // and power with the mean removed, for calculating the delayed covariance
+  // values. Each buffer holds the values twice in a row, most recent first, so
+  // that the values of all delays are contiguous from |history_index_| on.
   std::vector<float> render_power_;
   std::vector<float> render_power_mean_;
   std::vector<float> render_power_std_dev_;
+  std::vector<float> render_power_centered_;
   // Covariance estimates for different delay values.
-  std::vector<NormalizedCovarianceEstimator> covariances_;
-  // Index where next element should be inserted in all of the above circular
-  // buffers.
-  size_t next_insertion_index_ = 0;
+  NormalizedCovarianceBank covariances_;
+  // Index of the most recent element in all of the above buffers.
+  size_t history_index_ = 0;
 
   MeanVarianceEstimator render_statistics_;
   MeanVarianceEstimator capture_statistics_;
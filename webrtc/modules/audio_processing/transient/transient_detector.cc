@@ -18,8 +18,6 @@
 
 #include "modules/audio_processing/transient/common.h"
 #include "modules/audio_processing/transient/daubechies_8_wavelet_coeffs.h"
-#include "modules/audio_processing/transient/moving_moments.h"
-#include "modules/audio_processing/transient/wpd_node.h"
 #include "modules/audio_processing/transient/wpd_tree.h"
 #include "rtc_base/checks.h"
 
@@ -32,6 +30,9 @@ static const float kDetectThreshold = 16.f;
 
 TransientDetector::TransientDetector(int sample_rate_hz)
     : samples_per_chunk_(sample_rate_hz * ts::kChunkSizeMs / 1000),
+      moments_history_index_(0),
+      sum_(),
+      sum_of_squares_(),
       last_first_moment_(),
       last_second_moment_(),
       chunks_at_startup_left_to_delete_(kChunksAtStartupLeftToDelete),
@@ -53,13 +54,10 @@ TransientDetector::TransientDetector(int sample_rate_hz)
                               kDaubechies8HighPassCoefficients,
                               kDaubechies8LowPassCoefficients,
                               kDaubechies8CoefficientsLength, kLevels));
-  for (size_t i = 0; i < kLeaves; ++i) {
-    moving_moments_[i].reset(
-        new MovingMoments(samples_per_transient / kLeaves));
-  }
-
-  first_moments_.reset(new float[tree_leaves_data_length_]);
-  second_moments_.reset(new float[tree_leaves_data_length_]);
+  detection_terms_.resize(kLeaves * tree_leaves_data_length_);
+  moments_length_ = samples_per_transient / kLeaves;
+  RTC_DCHECK_GT(moments_length_, 0);
+  moments_history_.resize(kLeaves * moments_length_, 0.f);
 
   for (int i = 0; i < kChunksAtStartupLeftToDelete; ++i) {
     previous_results_.push_back(0.f);
@@ -81,29 +79,40 @@ float TransientDetector::Detect(const float* data,
     return -1.f;
   }
 
-  float result = 0.f;
-
+  const float* leaves[kLeaves];
   for (size_t i = 0; i < kLeaves; ++i) {
-    WPDNode* leaf = wpd_tree_->NodeAt(kLevels, i);
-
-    moving_moments_[i]->CalculateMoments(leaf->data(), tree_leaves_data_length_,
-                                         first_moments_.get(),
-                                         second_moments_.get());
-
-    // Add value delayed (Use the last moments from the last call to Detect).
-    float unbiased_data = leaf->data()[0] - last_first_moment_[i];
-    result +=
-        unbiased_data * unbiased_data / (last_second_moment_[i] + FLT_MIN);
-
-    // Add new values.
-    for (size_t j = 1; j < tree_leaves_data_length_; ++j) {
-      unbiased_data = leaf->data()[j] - first_moments_[j - 1];
-      result +=
-          unbiased_data * unbiased_data / (second_moments_[j - 1] + FLT_MIN);
+    leaves[i] = wpd_tree_->NodeData(kLevels, i);
+  }
+
+  // The leaves are independent, so they are updated together value by value.
+  const float moments_length = static_cast<float>(moments_length_);
+  for (size_t j = 0; j < tree_leaves_data_length_; ++j) {
+    float* history = &moments_history_[moments_history_index_ * kLeaves];
+    for (size_t i = 0; i < kLeaves; ++i) {
+      const float value = leaves[i][j];
+      // Add value delayed (Use the moments up to the previous value, which for
+      // the first value are the last moments from the last call to Detect).
+      const float unbiased_data = value - last_first_moment_[i];
+      detection_terms_[i * tree_leaves_data_length_ + j] =
+          unbiased_data * unbiased_data / (last_second_moment_[i] + FLT_MIN);
+
+      // Update the moments with the new value.
+      const float old_value = history[i];
+      history[i] = value;
+      sum_[i] += value - old_value;
+      sum_of_squares_[i] += value * value - old_value * old_value;
+      last_first_moment_[i] = sum_[i] / moments_length;
+      last_second_moment_[i] =
+          std::max(0.f, sum_of_squares_[i] / moments_length);
     }
+    moments_history_index_ = moments_history_index_ + 1 < moments_length_
+                                 ? moments_history_index_ + 1
+                                 : 0;
+  }
 
-    last_first_moment_[i] = first_moments_[tree_leaves_data_length_ - 1];
-    last_second_moment_[i] = second_moments_[tree_leaves_data_length_ - 1];
+  float result = 0.f;
+  for (float term : detection_terms_) {
+    result += term;
   }
 
   result /= tree_leaves_data_length_;
@@ -15,8 +15,8 @@
 
 #include <deque>
 #include <memory>
+#include <vector>
 
-#include "modules/audio_processing/transient/moving_moments.h"
 #include "modules/audio_processing/transient/wpd_tree.h"
 
 namespace webrtc {
@@ -60,13 +60,19 @@ class TransientDetector {
   std::unique_ptr<WPDTree> wpd_tree_;
   size_t tree_leaves_data_length_;
 
-  // A MovingMoments object is needed for each leaf in the WPD tree.
-  std::unique_ptr<MovingMoments> moving_moments_[kLeaves];
-
-  std::unique_ptr<float[]> first_moments_;
-  std::unique_ptr<float[]> second_moments_;
-
-  // Stores the last calculated moments from the previous detection.
+  // The moving moments of each leaf are calculated over its last
+  // |moments_length_| values, which are stored interleaved in the circular
+  // buffer |moments_history_|.
+  size_t moments_length_;
+  std::vector<float> moments_history_;
+  size_t moments_history_index_;
+  // Sums of the values and of the squared values in the history of each leaf.
+  float sum_[kLeaves];
+  float sum_of_squares_[kLeaves];
+  // Contribution of each value of each leaf to the detection result.
+  std::vector<float> detection_terms_;
+
+  // Stores the last calculated moments.
   float last_first_moment_[kLeaves];
   float last_second_moment_[kLeaves];
 
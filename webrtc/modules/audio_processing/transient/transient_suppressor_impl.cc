@@ -28,6 +28,12 @@
 #include "modules/audio_processing/transient/windows_private.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/logging.h"
+#include "rtc_base/system/arch.h"
+#include "system_wrappers/include/cpu_features_wrapper.h"
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#include <emmintrin.h>
+#endif
 
 namespace webrtc {
 
@@ -40,6 +46,14 @@ static const size_t kMaxVoiceBin = 60;
 
 namespace {
 
+bool IsSse2Available() {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  return GetCPUInfo(kSSE2) != 0;
+#else
+  return false;
+#endif
+}
+
 float ComplexMagnitude(float a, float b) {
   return std::abs(a) + std::abs(b);
 }
@@ -47,7 +61,8 @@ float ComplexMagnitude(float a, float b) {
 }  // namespace
 
 TransientSuppressorImpl::TransientSuppressorImpl()
-    : data_length_(0),
+    : use_sse2_(IsSse2Available()),
+      data_length_(0),
       detection_length_(0),
       analysis_length_(0),
       buffer_delay_(0),
@@ -242,10 +257,7 @@ void TransientSuppressorImpl::Suppress(float* in_ptr,
   fft_buffer_[analysis_length_ + 1] = 0.f;
   fft_buffer_[1] = 0.f;
 
-  for (size_t i = 0; i < complex_analysis_length_; ++i) {
-    magnitudes_[i] =
-        ComplexMagnitude(fft_buffer_[i * 2], fft_buffer_[i * 2 + 1]);
-  }
+  ComputeMagnitudes();
   // Restore audio if necessary.
   if (suppression_enabled_) {
     if (use_hard_restoration_) {
@@ -349,6 +361,28 @@ void TransientSuppressorImpl::UpdateBuffers(float* data) {
   }
 }
 
+void TransientSuppressorImpl::ComputeMagnitudes() {
+  size_t i = 0;
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (use_sse2_) {
+    const __m128 sign_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+    for (; i + 4 <= complex_analysis_length_; i += 4) {
+      const __m128 low =
+          _mm_and_ps(_mm_loadu_ps(&fft_buffer_[i * 2]), sign_mask);
+      const __m128 high =
+          _mm_and_ps(_mm_loadu_ps(&fft_buffer_[i * 2 + 4]), sign_mask);
+      const __m128 real = _mm_shuffle_ps(low, high, _MM_SHUFFLE(2, 0, 2, 0));
+      const __m128 imag = _mm_shuffle_ps(low, high, _MM_SHUFFLE(3, 1, 3, 1));
+      _mm_storeu_ps(&magnitudes_[i], _mm_add_ps(real, imag));
+    }
+  }
+#endif
+  for (; i < complex_analysis_length_; ++i) {
+    magnitudes_[i] =
+        ComplexMagnitude(fft_buffer_[i * 2], fft_buffer_[i * 2 + 1]);
+  }
+}
+
 // Restores the unvoiced signal if a click is present.
 // Attenuates by a certain factor every peak in the |fft_buffer_| that exceeds
 // the spectral mean. The attenuation depends on |detector_smoothed_|.
@@ -392,7 +426,49 @@ void TransientSuppressorImpl::SoftRestoration(float* spectral_mean) {
   // previous spectral mean and lower than a factor of the block mean
   // we adjust them. The factor is a double sigmoid that has a minimum in the
   // voice frequency range (300Hz - 3kHz).
-  for (size_t i = 0; i < complex_analysis_length_; ++i) {
+  size_t i = 0;
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (use_sse2_) {
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 detector_smoothed = _mm_set1_ps(detector_smoothed_);
+    const __m128 block_mean = _mm_set1_ps(block_frequency_mean);
+    for (; i + 4 <= complex_analysis_length_; i += 4) {
+      const __m128 magnitudes = _mm_loadu_ps(&magnitudes_[i]);
+      const __m128 mean = _mm_loadu_ps(&spectral_mean[i]);
+      __m128 restore = _mm_and_ps(_mm_cmpgt_ps(magnitudes, mean),
+                                  _mm_cmpgt_ps(magnitudes, zero));
+      if (!using_reference_) {
+        restore = _mm_and_ps(
+            restore, _mm_cmplt_ps(magnitudes,
+                                  _mm_mul_ps(block_mean,
+                                             _mm_loadu_ps(&mean_factor_[i]))));
+      }
+      if (_mm_movemask_ps(restore) == 0) {
+        continue;
+      }
+      const __m128 new_magnitudes = _mm_sub_ps(
+          magnitudes,
+          _mm_mul_ps(detector_smoothed, _mm_sub_ps(magnitudes, mean)));
+      const __m128 ratio = _mm_div_ps(new_magnitudes, magnitudes);
+      _mm_storeu_ps(&magnitudes_[i],
+                    _mm_or_ps(_mm_and_ps(restore, new_magnitudes),
+                              _mm_andnot_ps(restore, magnitudes)));
+      // Each ratio and condition applies to a pair of interleaved values.
+      for (size_t k = 0; k < 2; ++k) {
+        const __m128 pair_ratio = k == 0 ? _mm_unpacklo_ps(ratio, ratio)
+                                         : _mm_unpackhi_ps(ratio, ratio);
+        const __m128 pair_restore = k == 0 ? _mm_unpacklo_ps(restore, restore)
+                                           : _mm_unpackhi_ps(restore, restore);
+        float* fft = &fft_buffer_[i * 2 + k * 4];
+        const __m128 values = _mm_loadu_ps(fft);
+        _mm_storeu_ps(fft, _mm_or_ps(_mm_and_ps(pair_restore,
+                                                _mm_mul_ps(values, pair_ratio)),
+                                     _mm_andnot_ps(pair_restore, values)));
+      }
+    }
+  }
+#endif
+  for (; i < complex_analysis_length_; ++i) {
     if (magnitudes_[i] > spectral_mean[i] && magnitudes_[i] > 0 &&
         (using_reference_ ||
          magnitudes_[i] < block_frequency_mean * mean_factor_[i])) {
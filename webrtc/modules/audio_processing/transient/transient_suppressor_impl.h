@@ -71,9 +71,12 @@ class TransientSuppressorImpl : public TransientSuppressor {
 
   void UpdateBuffers(float* data);
 
+  void ComputeMagnitudes();
   void HardRestoration(float* spectral_mean);
   void SoftRestoration(float* spectral_mean);
 
+  const bool use_sse2_;
+
   std::unique_ptr<TransientDetector> detector_;
 
   size_t data_length_;
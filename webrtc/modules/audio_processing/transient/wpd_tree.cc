@@ -10,12 +10,95 @@
 
 #include "modules/audio_processing/transient/wpd_tree.h"
 
+#include <math.h>
 #include <string.h>
 
-#include "modules/audio_processing/transient/wpd_node.h"
 #include "rtc_base/checks.h"
+#include "rtc_base/system/arch.h"
+#include "system_wrappers/include/cpu_features_wrapper.h"
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#include <emmintrin.h>
+#endif
 
 namespace webrtc {
+namespace {
+
+bool IsSse2Available() {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  return GetCPUInfo(kSSE2) != 0;
+#else
+  return false;
+#endif
+}
+
+// Number of output samples computed together.
+constexpr size_t kBlockSize = 4;
+
+// Filters a node and keeps the absolute values of the odd output samples.
+// |even| and |odd| hold the even and odd samples of the node, preceded by
+// |padded_length| / 2 past samples each, and |coefficients| the reversed
+// coefficients. The products are summed in the same order as FIRFilterSSE2,
+// which was previously used, so that the results are unchanged.
+void FilterAndDecimate(const float* even,
+                       const float* odd,
+                       const float* coefficients,
+                       size_t padded_length,
+                       size_t out_length,
+                       float* out) {
+  for (size_t k = 0; k < out_length; ++k) {
+    float sums[4] = {0.f, 0.f, 0.f, 0.f};
+    for (size_t m = 0; m < padded_length; m += 4) {
+      sums[0] += even[k + 1 + m / 2] * coefficients[m];
+      sums[1] += odd[k + 1 + m / 2] * coefficients[m + 1];
+      sums[2] += even[k + 2 + m / 2] * coefficients[m + 2];
+      sums[3] += odd[k + 2 + m / 2] * coefficients[m + 3];
+    }
+    out[k] = fabsf((sums[0] + sums[2]) + (sums[1] + sums[3]));
+  }
+}
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+// Same as FilterAndDecimate(), computing kBlockSize output samples at a time.
+// |even| and |odd| must be readable up to the end of the last block.
+void FilterAndDecimateSse2(const float* even,
+                           const float* odd,
+                           const float* coefficients,
+                           size_t padded_length,
+                           size_t out_length,
+                           float* out) {
+  const __m128 sign_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+  for (size_t k = 0; k < out_length; k += kBlockSize) {
+    __m128 sum0 = _mm_setzero_ps();
+    __m128 sum1 = _mm_setzero_ps();
+    __m128 sum2 = _mm_setzero_ps();
+    __m128 sum3 = _mm_setzero_ps();
+    for (size_t m = 0; m < padded_length; m += 4) {
+      const float* even_ptr = &even[k + 1 + m / 2];
+      const float* odd_ptr = &odd[k + 1 + m / 2];
+      sum0 = _mm_add_ps(sum0, _mm_mul_ps(_mm_loadu_ps(even_ptr),
+                                         _mm_set1_ps(coefficients[m])));
+      sum1 = _mm_add_ps(sum1, _mm_mul_ps(_mm_loadu_ps(odd_ptr),
+                                         _mm_set1_ps(coefficients[m + 1])));
+      sum2 = _mm_add_ps(sum2, _mm_mul_ps(_mm_loadu_ps(even_ptr + 1),
+                                         _mm_set1_ps(coefficients[m + 2])));
+      sum3 = _mm_add_ps(sum3, _mm_mul_ps(_mm_loadu_ps(odd_ptr + 1),
+                                         _mm_set1_ps(coefficients[m + 3])));
+    }
+    const __m128 sum =
+        _mm_add_ps(_mm_add_ps(sum0, sum2), _mm_add_ps(sum1, sum3));
+    if (k + kBlockSize <= out_length) {
+      _mm_storeu_ps(&out[k], _mm_and_ps(sum, sign_mask));
+    } else {
+      float block[kBlockSize];
+      _mm_storeu_ps(block, _mm_and_ps(sum, sign_mask));
+      memcpy(&out[k], block, (out_length - k) * sizeof(*out));
+    }
+  }
+}
+#endif
+
+}  // namespace
 
 WPDTree::WPDTree(size_t data_length,
                  const float* high_pass_coefficients,
@@ -24,52 +107,50 @@ WPDTree::WPDTree(size_t data_length,
                  int levels)
     : data_length_(data_length),
       levels_(levels),
-      num_nodes_((1 << (levels + 1)) - 1) {
+      num_nodes_((1 << (levels + 1)) - 1),
+      use_sse2_(IsSse2Available()),
+      padded_coefficients_length_((coefficients_length + 3) & ~size_t{3}),
+      history_length_(padded_coefficients_length_),
+      low_pass_coefficients_(padded_coefficients_length_, 0.f),
+      high_pass_coefficients_(padded_coefficients_length_, 0.f),
+      // Size is 1 more, so we can use the array as 1-based.
+      node_offsets_(num_nodes_ + 1, 0),
+      even_samples_((history_length_ + data_length) / 2 + kBlockSize - 1, 0.f),
+      odd_samples_((history_length_ + data_length) / 2 + kBlockSize - 1, 0.f) {
   RTC_DCHECK_GT(data_length, (static_cast<size_t>(1) << levels));
+  RTC_DCHECK_EQ(data_length % (static_cast<size_t>(1) << levels), 0);
   RTC_DCHECK(high_pass_coefficients);
   RTC_DCHECK(low_pass_coefficients);
+  RTC_DCHECK_GT(coefficients_length, 0);
   RTC_DCHECK_GT(levels, 0);
-  // Size is 1 more, so we can use the array as 1-based. nodes_[0] is never
-  // allocated.
-  nodes_.reset(new std::unique_ptr<WPDNode>[num_nodes_ + 1]);
-
-  // Create the first node
-  const float kRootCoefficient = 1.f;  // Identity Coefficient.
-  nodes_[1].reset(new WPDNode(data_length, &kRootCoefficient, 1));
-  // Variables used to create the rest of the nodes.
-  size_t index = 1;
-  size_t index_left_child = 0;
-  size_t index_right_child = 0;
-
-  int num_nodes_at_curr_level = 0;
-
-  // Branching each node in each level to create its children. The last level is
-  // not branched (all the nodes of that level are leaves).
-  for (int current_level = 0; current_level < levels; ++current_level) {
-    num_nodes_at_curr_level = 1 << current_level;
-    for (int i = 0; i < num_nodes_at_curr_level; ++i) {
-      index = (1 << current_level) + i;
-      // Obtain the index of the current node children.
-      index_left_child = index * 2;
-      index_right_child = index_left_child + 1;
-      nodes_[index_left_child].reset(new WPDNode(nodes_[index]->length() / 2,
-                                                 low_pass_coefficients,
-                                                 coefficients_length));
-      nodes_[index_right_child].reset(new WPDNode(nodes_[index]->length() / 2,
-                                                  high_pass_coefficients,
-                                                  coefficients_length));
+  // The coefficients are reversed to compensate for the order in which the
+  // input samples are acquired (most recent last).
+  const size_t padding = padded_coefficients_length_ - coefficients_length;
+  for (size_t i = 0; i < coefficients_length; ++i) {
+    low_pass_coefficients_[i + padding] =
+        low_pass_coefficients[coefficients_length - i - 1];
+    high_pass_coefficients_[i + padding] =
+        high_pass_coefficients[coefficients_length - i - 1];
+  }
+
+  size_t offset = 0;
+  for (int level = 0; level <= levels; ++level) {
+    for (int i = 0; i < NumberOfNodesAtLevel(level); ++i) {
+      node_offsets_[(1 << level) + i] = offset + history_length_;
+      offset += history_length_ + NodeLength(level);
     }
   }
+  nodes_.resize(offset, 0.f);
 }
 
 WPDTree::~WPDTree() {}
 
-WPDNode* WPDTree::NodeAt(int level, int index) {
+const float* WPDTree::NodeData(int level, int index) const {
   if (level < 0 || level > levels_ || index < 0 || index >= 1 << level) {
     return NULL;
   }
 
-  return nodes_[(1 << level) + index].get();
+  return &nodes_[node_offsets_[(1 << level) + index]];
 }
 
 int WPDTree::Update(const float* data, size_t data_length) {
@@ -77,37 +158,44 @@ int WPDTree::Update(const float* data, size_t data_length) {
     return -1;
   }
 
-  // Update the root node.
-  int update_result = nodes_[1]->set_data(data, data_length);
-  if (update_result != 0) {
-    return -1;
-  }
-
-  // Variables used to update the rest of the nodes.
-  size_t index = 1;
-  size_t index_left_child = 0;
-  size_t index_right_child = 0;
-
-  int num_nodes_at_curr_level = 0;
+  // Update the root node, keeping the end of its previous data as history.
+  float* root = &nodes_[node_offsets_[1]];
+  memmove(root - history_length_, root - history_length_ + data_length_,
+          history_length_ * sizeof(*root));
+  memcpy(root, data, data_length_ * sizeof(*root));
 
   for (int current_level = 0; current_level < levels_; ++current_level) {
-    num_nodes_at_curr_level = 1 << current_level;
-    for (int i = 0; i < num_nodes_at_curr_level; ++i) {
-      index = (1 << current_level) + i;
-      // Obtain the index of the current node children.
-      index_left_child = index * 2;
-      index_right_child = index_left_child + 1;
-
-      update_result = nodes_[index_left_child]->Update(nodes_[index]->data(),
-                                                       nodes_[index]->length());
-      if (update_result != 0) {
-        return -1;
+    const size_t parent_length = NodeLength(current_level);
+    const size_t child_length = NodeLength(current_level + 1);
+    for (int i = 0; i < NumberOfNodesAtLevel(current_level); ++i) {
+      const int index = (1 << current_level) + i;
+      const float* parent = &nodes_[node_offsets_[index]] - history_length_;
+      const size_t half_length = (history_length_ + parent_length) / 2;
+      for (size_t j = 0; j < half_length; ++j) {
+        even_samples_[j] = parent[2 * j];
+        odd_samples_[j] = parent[2 * j + 1];
       }
 
-      update_result = nodes_[index_right_child]->Update(
-          nodes_[index]->data(), nodes_[index]->length());
-      if (update_result != 0) {
-        return -1;
+      // The left child holds the approximation coefficients, and the right
+      // child the detail coefficients.
+      for (int child = 0; child < 2; ++child) {
+        float* data = &nodes_[node_offsets_[2 * index + child]];
+        memmove(data - history_length_, data - history_length_ + child_length,
+                history_length_ * sizeof(*data));
+        const float* coefficients = child == 0
+                                        ? low_pass_coefficients_.data()
+                                        : high_pass_coefficients_.data();
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+        if (use_sse2_) {
+          FilterAndDecimateSse2(even_samples_.data(), odd_samples_.data(),
+                                coefficients, padded_coefficients_length_,
+                                child_length, data);
+          continue;
+        }
+#endif
+        FilterAndDecimate(even_samples_.data(), odd_samples_.data(),
+                          coefficients, padded_coefficients_length_,
+                          child_length, data);
       }
     }
   }
@@ -13,9 +13,7 @@
 
 #include <stddef.h>
 
-#include <memory>
-
-#include "modules/audio_processing/transient/wpd_node.h"
+#include <vector>
 
 namespace webrtc {
 
@@ -23,21 +21,24 @@ namespace webrtc {
 //
 // The root node contains all the data provided; for each node in the tree, the
 // left child contains the approximation coefficients extracted from the node,
-// and the right child contains the detail coefficients.
+// and the right child contains the detail coefficients. Each node other than
+// the root stores the absolute values of the odd samples of its filtered
+// parent, so only those samples are computed.
 // It preserves its state, so it can be multiple-called.
 //
 // The number of nodes in the tree will be 2 ^ levels - 1.
 //
 // Implementation details: Since the tree always will be a complete binary tree,
-// it is implemented using a single linear array instead of managing the
-// relationships in each node. For convience is better to use a array that
-// starts in 1 (instead of 0). Taking that into account, the following formulas
-// apply:
+// all the nodes are stored one after the other in a single buffer, in the
+// order of a linear array that starts in 1 (instead of 0). Taking that into
+// account, the following formulas apply:
 // Root node index: 1.
 // Node(Level, Index in that level): 2 ^ Level + (Index in that level).
 // Left Child: Current node index * 2.
 // Right Child: Current node index * 2 + 1.
 // Parent: Current Node Index / 2 (Integer division).
+// Each node is preceded by the last samples of its previous data, which are
+// the filter state of its children.
 class WPDTree {
  public:
   // Creates a WPD tree using the data length and coefficients provided.
@@ -46,12 +47,14 @@ class WPDTree {
           const float* low_pass_coefficients,
           size_t coefficients_length,
           int levels);
+  WPDTree(const WPDTree&) = delete;
+  WPDTree& operator=(const WPDTree&) = delete;
   ~WPDTree();
 
   // Returns the number of nodes at any given level.
   static int NumberOfNodesAtLevel(int level) { return 1 << level; }
 
-  // Returns a pointer to the node at the given level and index(of that level).
+  // Returns the data of the node at the given level and index(of that level).
   // Level goes from 0 to levels().
   // Index goes from 0 to the number of NumberOfNodesAtLevel(level) - 1.
   //
@@ -63,10 +66,13 @@ class WPDTree {
   // Parent: (Current node level - 1, Current node index / 2) (Integer division)
   //
   // If level or index are out of bounds the function will return NULL.
-  WPDNode* NodeAt(int level, int index);
+  const float* NodeData(int level, int index) const;
+
+  // Returns the length of the data of each node at the given level.
+  size_t NodeLength(int level) const { return data_length_ >> level; }
 
   // Updates all the nodes of the tree with the new data. |data_length| must be
-  // teh same that was used for the creation of the tree.
+  // the same that was used for the creation of the tree.
   // Returns 0 if correct, and -1 otherwise.
   int Update(const float* data, size_t data_length);
 
@@ -81,10 +87,25 @@ class WPDTree {
   int num_leaves() const { return 1 << levels_; }
 
  private:
-  size_t data_length_;
-  int levels_;
-  int num_nodes_;
-  std::unique_ptr<std::unique_ptr<WPDNode>[]> nodes_;
+  const size_t data_length_;
+  const int levels_;
+  const int num_nodes_;
+  const bool use_sse2_;
+  // Number of filter coefficients rounded up to a multiple of four, and number
+  // of past samples stored before the data of each node.
+  const size_t padded_coefficients_length_;
+  const size_t history_length_;
+  // Reversed low and high pass coefficients, preceded by zeros up to
+  // |padded_coefficients_length_|.
+  std::vector<float> low_pass_coefficients_;
+  std::vector<float> high_pass_coefficients_;
+  std::vector<float> nodes_;
+  // Offset of the data of each node in |nodes_|, indexed from 1.
+  std::vector<size_t> node_offsets_;
+  // Even and odd samples of the node being decomposed, with its history,
+  // followed by padding for the last block of the filter.
+  std::vector<float> even_samples_;
+  std::vector<float> odd_samples_;
 };
 
 }  // namespace webrtc
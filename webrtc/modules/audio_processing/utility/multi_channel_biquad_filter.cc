@@ -0,0 +1,355 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_processing/utility/multi_channel_biquad_filter.h"
+
+#include <algorithm>
+
+#include "rtc_base/checks.h"
+#include "rtc_base/system/arch.h"
+#include "system_wrappers/include/cpu_features_wrapper.h"
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#include <emmintrin.h>
+#endif
+
+namespace webrtc {
+namespace {
+
+constexpr size_t kBlockSize = 4;
+
+bool IsSse2Available() {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  return GetCPUInfo(kSSE2) != 0;
+#else
+  return false;
+#endif
+}
+
+std::vector<CascadedBiQuadFilter::BiQuadCoefficients> ToCoefficients(
+    const std::vector<CascadedBiQuadFilter::BiQuadParam>& biquad_params) {
+  std::vector<CascadedBiQuadFilter::BiQuadCoefficients> coefficients;
+  coefficients.reserve(biquad_params.size());
+  for (const auto& param : biquad_params) {
+    coefficients.push_back(CascadedBiQuadFilter::BiQuad(param).coefficients);
+  }
+  return coefficients;
+}
+
+// Runs the biquad recursion on one block from the given state and returns
+// the outputs.
+std::array<float, kBlockSize> RunBlock(
+    const CascadedBiQuadFilter::BiQuadCoefficients& c,
+    const std::array<double, kBlockSize>& x,
+    double x1,
+    double x2,
+    double y1,
+    double y2) {
+  std::array<float, kBlockSize> y;
+  for (size_t k = 0; k < kBlockSize; ++k) {
+    const double out =
+        c.b[0] * x[k] + c.b[1] * x1 + c.b[2] * x2 - c.a[0] * y1 - c.a[1] * y2;
+    x2 = x1;
+    x1 = x[k];
+    y2 = y1;
+    y1 = out;
+    y[k] = static_cast<float>(out);
+  }
+  return y;
+}
+
+template <typename BlockCoefficients>
+std::vector<BlockCoefficients> ComputeBlockCoefficients(
+    const std::vector<CascadedBiQuadFilter::BiQuadCoefficients>&
+        coefficients) {
+  std::vector<BlockCoefficients> block_coefficients(coefficients.size());
+  for (size_t b = 0; b < coefficients.size(); ++b) {
+    const auto& c = coefficients[b];
+    BlockCoefficients& bc = block_coefficients[b];
+    for (size_t j = 0; j < kBlockSize; ++j) {
+      std::array<double, kBlockSize> x = {};
+      x[j] = 1.0;
+      bc.input[j] = RunBlock(c, x, 0.0, 0.0, 0.0, 0.0);
+    }
+    const std::array<double, kBlockSize> zeros = {};
+    bc.x1 = RunBlock(c, zeros, 1.0, 0.0, 0.0, 0.0);
+    bc.x2 = RunBlock(c, zeros, 0.0, 1.0, 0.0, 0.0);
+    bc.y1 = RunBlock(c, zeros, 0.0, 0.0, 1.0, 0.0);
+    bc.y2 = RunBlock(c, zeros, 0.0, 0.0, 0.0, 1.0);
+  }
+  return block_coefficients;
+}
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+// Applies one biquad to |num_steps| time steps of four channels, with one
+// channel per lane. The operations are the same as in
+// CascadedBiQuadFilter::ApplyBiQuad.
+inline void ApplyBiQuadSse2(const CascadedBiQuadFilter::BiQuadCoefficients& c,
+                            size_t num_steps,
+                            __m128* v,
+                            __m128* x1,
+                            __m128* x2,
+                            __m128* y1,
+                            __m128* y2) {
+  const __m128 b0 = _mm_set1_ps(c.b[0]);
+  const __m128 b1 = _mm_set1_ps(c.b[1]);
+  const __m128 b2 = _mm_set1_ps(c.b[2]);
+  const __m128 a0 = _mm_set1_ps(c.a[0]);
+  const __m128 a1 = _mm_set1_ps(c.a[1]);
+  for (size_t k = 0; k < num_steps; ++k) {
+    const __m128 tmp = v[k];
+    __m128 y = _mm_mul_ps(b0, tmp);
+    y = _mm_add_ps(y, _mm_mul_ps(b1, *x1));
+    y = _mm_add_ps(y, _mm_mul_ps(b2, *x2));
+    y = _mm_sub_ps(y, _mm_mul_ps(a0, *y1));
+    y = _mm_sub_ps(y, _mm_mul_ps(a1, *y2));
+    *x2 = *x1;
+    *x1 = tmp;
+    *y2 = *y1;
+    *y1 = y;
+    v[k] = y;
+  }
+}
+#endif
+
+}  // namespace
+
+MultiChannelBiQuadFilter::MultiChannelBiQuadFilter(
+    const CascadedBiQuadFilter::BiQuadCoefficients& coefficients,
+    size_t num_biquads,
+    size_t num_channels,
+    bool use_block_form_for_mono)
+    : coefficients_(num_biquads, coefficients),
+      block_coefficients_(
+          ComputeBlockCoefficients<BlockCoefficients>(coefficients_)),
+      use_block_form_for_mono_(use_block_form_for_mono),
+      use_sse2_(IsSse2Available()) {
+  SetNumChannels(num_channels);
+}
+
+MultiChannelBiQuadFilter::MultiChannelBiQuadFilter(
+    const std::vector<CascadedBiQuadFilter::BiQuadParam>& biquad_params,
+    size_t num_channels,
+    bool use_block_form_for_mono)
+    : coefficients_(ToCoefficients(biquad_params)),
+      block_coefficients_(
+          ComputeBlockCoefficients<BlockCoefficients>(coefficients_)),
+      use_block_form_for_mono_(use_block_form_for_mono),
+      use_sse2_(IsSse2Available()) {
+  SetNumChannels(num_channels);
+}
+
+MultiChannelBiQuadFilter::MultiChannelBiQuadFilter(
+    const std::vector<CascadedBiQuadFilter::BiQuadCoefficients>& coefficients,
+    size_t num_channels,
+    bool use_block_form_for_mono)
+    : coefficients_(coefficients),
+      block_coefficients_(
+          ComputeBlockCoefficients<BlockCoefficients>(coefficients_)),
+      use_block_form_for_mono_(use_block_form_for_mono),
+      use_sse2_(IsSse2Available()) {
+  SetNumChannels(num_channels);
+}
+
+MultiChannelBiQuadFilter::~MultiChannelBiQuadFilter() = default;
+
+void MultiChannelBiQuadFilter::Process(rtc::ArrayView<float* const> channels,
+                                       size_t num_frames) {
+  RTC_DCHECK_EQ(num_channels_, channels.size());
+  size_t ch = 0;
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (use_sse2_) {
+    if (num_channels_ == 1 && use_block_form_for_mono_) {
+      ProcessSingleChannelSse2(channels[0], num_frames);
+      return;
+    }
+    // A group with fewer than four channels leaves some lanes unused, which
+    // still beats the scalar recursion for two or more channels.
+    for (; ch + 1 < num_channels_; ch += kBlockSize) {
+      ProcessChannelsSse2(channels, ch,
+                          std::min(kBlockSize, num_channels_ - ch),
+                          num_frames);
+    }
+  }
+#endif
+  for (; ch < num_channels_; ++ch) {
+    ProcessChannel(channels[ch], ch, num_frames);
+  }
+}
+
+void MultiChannelBiQuadFilter::Process(rtc::ArrayView<float> y) {
+  RTC_DCHECK_EQ(1, num_channels_);
+  float* channel = y.data();
+  Process(rtc::ArrayView<float* const>(&channel, 1), y.size());
+}
+
+void MultiChannelBiQuadFilter::Reset() {
+  std::fill(x1_.begin(), x1_.end(), 0.f);
+  std::fill(x2_.begin(), x2_.end(), 0.f);
+  std::fill(y1_.begin(), y1_.end(), 0.f);
+  std::fill(y2_.begin(), y2_.end(), 0.f);
+}
+
+void MultiChannelBiQuadFilter::SetNumChannels(size_t num_channels) {
+  num_channels_ = num_channels;
+  // The states are padded to a whole number of SIMD lane groups.
+  state_stride_ = (num_channels_ + kBlockSize - 1) / kBlockSize * kBlockSize;
+  const size_t size = coefficients_.size() * state_stride_;
+  x1_.resize(size);
+  x2_.resize(size);
+  y1_.resize(size);
+  y2_.resize(size);
+  Reset();
+}
+
+void MultiChannelBiQuadFilter::ProcessChannel(float* y,
+                                              size_t channel,
+                                              size_t num_frames) {
+  for (size_t b = 0; b < coefficients_.size(); ++b) {
+    const auto* c_b = coefficients_[b].b;
+    const auto* c_a = coefficients_[b].a;
+    const size_t index = b * state_stride_ + channel;
+    float m_x0 = x1_[index];
+    float m_x1 = x2_[index];
+    float m_y0 = y1_[index];
+    float m_y1 = y2_[index];
+    for (size_t k = 0; k < num_frames; ++k) {
+      const float tmp = y[k];
+      y[k] = c_b[0] * tmp + c_b[1] * m_x0 + c_b[2] * m_x1 - c_a[0] * m_y0 -
+             c_a[1] * m_y1;
+      m_x1 = m_x0;
+      m_x0 = tmp;
+      m_y1 = m_y0;
+      m_y0 = y[k];
+    }
+    x1_[index] = m_x0;
+    x2_[index] = m_x1;
+    y1_[index] = m_y0;
+    y2_[index] = m_y1;
+  }
+}
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+void MultiChannelBiQuadFilter::ProcessChannelsSse2(
+    rtc::ArrayView<float* const> channels,
+    size_t first_channel,
+    size_t num_group_channels,
+    size_t num_frames) {
+  RTC_DCHECK_LE(2, num_group_channels);
+  RTC_DCHECK_LE(num_group_channels, kBlockSize);
+  // The unused lanes of a partial group filter a copy of the last channel of
+  // the group. Their outputs are stored before those of the real channel,
+  // which then overwrites them.
+  const size_t last = first_channel + num_group_channels - 1;
+  float* const c0 = channels[first_channel];
+  float* const c1 = channels[first_channel + 1];
+  float* const c2 = channels[std::min(first_channel + 2, last)];
+  float* const c3 = channels[std::min(first_channel + 3, last)];
+
+  for (size_t b = 0; b < coefficients_.size(); ++b) {
+    const size_t index = b * state_stride_ + first_channel;
+    __m128 x1 = _mm_loadu_ps(&x1_[index]);
+    __m128 x2 = _mm_loadu_ps(&x2_[index]);
+    __m128 y1 = _mm_loadu_ps(&y1_[index]);
+    __m128 y2 = _mm_loadu_ps(&y2_[index]);
+
+    // Transposes blocks of four samples so that each vector holds one time
+    // step of the four channels.
+    size_t k = 0;
+    for (; k + kBlockSize <= num_frames; k += kBlockSize) {
+      __m128 v[kBlockSize] = {_mm_loadu_ps(&c0[k]), _mm_loadu_ps(&c1[k]),
+                              _mm_loadu_ps(&c2[k]), _mm_loadu_ps(&c3[k])};
+      _MM_TRANSPOSE4_PS(v[0], v[1], v[2], v[3]);
+      ApplyBiQuadSse2(coefficients_[b], kBlockSize, v, &x1, &x2, &y1, &y2);
+      _MM_TRANSPOSE4_PS(v[0], v[1], v[2], v[3]);
+      _mm_storeu_ps(&c3[k], v[3]);
+      _mm_storeu_ps(&c2[k], v[2]);
+      _mm_storeu_ps(&c1[k], v[1]);
+      _mm_storeu_ps(&c0[k], v[0]);
+    }
+
+    const size_t num_remaining = num_frames - k;
+    if (num_remaining > 0) {
+      __m128 v[kBlockSize];
+      for (size_t j = 0; j < num_remaining; ++j) {
+        v[j] = _mm_setr_ps(c0[k + j], c1[k + j], c2[k + j], c3[k + j]);
+      }
+      ApplyBiQuadSse2(coefficients_[b], num_remaining, v, &x1, &x2, &y1, &y2);
+      for (size_t j = 0; j < num_remaining; ++j) {
+        float out[kBlockSize];
+        _mm_storeu_ps(out, v[j]);
+        c3[k + j] = out[3];
+        c2[k + j] = out[2];
+        c1[k + j] = out[1];
+        c0[k + j] = out[0];
+      }
+    }
+
+    _mm_storeu_ps(&x1_[index], x1);
+    _mm_storeu_ps(&x2_[index], x2);
+    _mm_storeu_ps(&y1_[index], y1);
+    _mm_storeu_ps(&y2_[index], y2);
+  }
+}
+
+void MultiChannelBiQuadFilter::ProcessSingleChannelSse2(float* y,
+                                                        size_t num_frames) {
+  const size_t num_blocks = num_frames / kBlockSize;
+  for (size_t b = 0; b < coefficients_.size(); ++b) {
+    const BlockCoefficients& bc = block_coefficients_[b];
+    const __m128 c_in0 = _mm_loadu_ps(bc.input[0].data());
+    const __m128 c_in1 = _mm_loadu_ps(bc.input[1].data());
+    const __m128 c_in2 = _mm_loadu_ps(bc.input[2].data());
+    const __m128 c_in3 = _mm_loadu_ps(bc.input[3].data());
+    const __m128 c_x1 = _mm_loadu_ps(bc.x1.data());
+    const __m128 c_x2 = _mm_loadu_ps(bc.x2.data());
+    const __m128 c_y1 = _mm_loadu_ps(bc.y1.data());
+    const __m128 c_y2 = _mm_loadu_ps(bc.y2.data());
+
+    // The state values are kept broadcast to all lanes.
+    __m128 x1 = _mm_set1_ps(x1_[b * state_stride_]);
+    __m128 x2 = _mm_set1_ps(x2_[b * state_stride_]);
+    __m128 y1 = _mm_set1_ps(y1_[b * state_stride_]);
+    __m128 y2 = _mm_set1_ps(y2_[b * state_stride_]);
+    for (size_t n = 0; n < num_blocks; ++n) {
+      float* block = &y[n * kBlockSize];
+      const __m128 x = _mm_loadu_ps(block);
+      __m128 out = _mm_mul_ps(c_in0, _mm_shuffle_ps(x, x, 0x00));
+      out = _mm_add_ps(out, _mm_mul_ps(c_in1, _mm_shuffle_ps(x, x, 0x55)));
+      out = _mm_add_ps(out, _mm_mul_ps(c_in2, _mm_shuffle_ps(x, x, 0xAA)));
+      out = _mm_add_ps(out, _mm_mul_ps(c_in3, _mm_shuffle_ps(x, x, 0xFF)));
+      out = _mm_add_ps(out, _mm_mul_ps(c_x1, x1));
+      out = _mm_add_ps(out, _mm_mul_ps(c_x2, x2));
+      // The feedback terms are added last to shorten the dependency chain
+      // between consecutive blocks.
+      out = _mm_add_ps(out, _mm_add_ps(_mm_mul_ps(c_y1, y1),
+                                       _mm_mul_ps(c_y2, y2)));
+      x1 = _mm_shuffle_ps(x, x, 0xFF);
+      x2 = _mm_shuffle_ps(x, x, 0xAA);
+      y1 = _mm_shuffle_ps(out, out, 0xFF);
+      y2 = _mm_shuffle_ps(out, out, 0xAA);
+      _mm_storeu_ps(block, out);
+    }
+    x1_[b * state_stride_] = _mm_cvtss_f32(x1);
+    x2_[b * state_stride_] = _mm_cvtss_f32(x2);
+    y1_[b * state_stride_] = _mm_cvtss_f32(y1);
+    y2_[b * state_stride_] = _mm_cvtss_f32(y2);
+  }
+
+  // The samples that do not fill a block go through the sample-serial
+  // recursion.
+  const size_t num_processed = num_blocks * kBlockSize;
+  if (num_processed < num_frames) {
+    ProcessChannel(&y[num_processed], 0, num_frames - num_processed);
+  }
+}
+#endif
+
+}  // namespace webrtc
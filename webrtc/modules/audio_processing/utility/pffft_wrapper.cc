@@ -10,7 +10,12 @@
 
 #include "modules/audio_processing/utility/pffft_wrapper.h"
 
+#include <map>
+#include <utility>
+
 #include "rtc_base/checks.h"
+#include "rtc_base/synchronization/mutex.h"
+#include "rtc_base/thread_annotations.h"
 #include "third_party/pffft/src/pffft.h"
 
 namespace webrtc {
@@ -24,6 +29,47 @@ float* AllocatePffftBuffer(size_t size) {
   return static_cast<float*>(pffft_aligned_malloc(size * sizeof(float)));
 }
 
+// Process-wide registry of PFFFT setups. A setup only depends on the FFT size
+// and type and it is not modified by the transforms, hence it can be shared by
+// any number of Pffft instances, also across threads. A setup is destroyed
+// when the last instance using it is destroyed.
+class PffftSetupRegistry {
+ public:
+  static PffftSetupRegistry* GetInstance() {
+    // Never destroyed to avoid destruction order issues at exit.
+    static PffftSetupRegistry* const registry = new PffftSetupRegistry();
+    return registry;
+  }
+
+  PffftSetupRegistry(const PffftSetupRegistry&) = delete;
+  PffftSetupRegistry& operator=(const PffftSetupRegistry&) = delete;
+
+  // Returns the setup for the given FFT size and type, which is created if no
+  // other instance is using it.
+  std::shared_ptr<PFFFT_Setup> GetSetup(size_t fft_size,
+                                        Pffft::FftType fft_type) {
+    MutexLock lock(&mutex_);
+    std::weak_ptr<PFFFT_Setup>& entry = setups_[{fft_size, fft_type}];
+    std::shared_ptr<PFFFT_Setup> setup = entry.lock();
+    if (!setup) {
+      setup.reset(
+          pffft_new_setup(fft_size, fft_type == Pffft::FftType::kReal
+                                        ? PFFFT_REAL
+                                        : PFFFT_COMPLEX),
+          pffft_destroy_setup);
+      entry = setup;
+    }
+    return setup;
+  }
+
+ private:
+  PffftSetupRegistry() = default;
+
+  Mutex mutex_;
+  std::map<std::pair<size_t, Pffft::FftType>, std::weak_ptr<PFFFT_Setup>>
+      setups_ RTC_GUARDED_BY(mutex_);
+};
+
 }  // namespace
 
 Pffft::FloatBuffer::FloatBuffer(size_t fft_size, FftType fft_type)
@@ -45,9 +91,8 @@ rtc::ArrayView<float> Pffft::FloatBuffer::GetView() {
 Pffft::Pffft(size_t fft_size, FftType fft_type)
     : fft_size_(fft_size),
       fft_type_(fft_type),
-      pffft_status_(pffft_new_setup(
-          fft_size_,
-          fft_type == Pffft::FftType::kReal ? PFFFT_REAL : PFFFT_COMPLEX)),
+      pffft_status_(
+          PffftSetupRegistry::GetInstance()->GetSetup(fft_size_, fft_type_)),
       scratch_buffer_(
           AllocatePffftBuffer(GetBufferSize(fft_size_, fft_type_))) {
   RTC_DCHECK(pffft_status_);
@@ -55,7 +100,6 @@ Pffft::Pffft(size_t fft_size, FftType fft_type)
 }
 
 Pffft::~Pffft() {
-  pffft_destroy_setup(pffft_status_);
   pffft_aligned_free(scratch_buffer_);
 }
 
@@ -98,10 +142,10 @@ void Pffft::ForwardTransform(const FloatBuffer& in,
   RTC_DCHECK_EQ(in.size(), out->size());
   RTC_DCHECK(scratch_buffer_);
   if (ordered) {
-    pffft_transform_ordered(pffft_status_, in.const_data(), out->data(),
+    pffft_transform_ordered(pffft_status_.get(), in.const_data(), out->data(),
                             scratch_buffer_, PFFFT_FORWARD);
   } else {
-    pffft_transform(pffft_status_, in.const_data(), out->data(),
+    pffft_transform(pffft_status_.get(), in.const_data(), out->data(),
                     scratch_buffer_, PFFFT_FORWARD);
   }
 }
@@ -113,10 +157,10 @@ void Pffft::BackwardTransform(const FloatBuffer& in,
   RTC_DCHECK_EQ(in.size(), out->size());
   RTC_DCHECK(scratch_buffer_);
   if (ordered) {
-    pffft_transform_ordered(pffft_status_, in.const_data(), out->data(),
+    pffft_transform_ordered(pffft_status_.get(), in.const_data(), out->data(),
                             scratch_buffer_, PFFFT_BACKWARD);
   } else {
-    pffft_transform(pffft_status_, in.const_data(), out->data(),
+    pffft_transform(pffft_status_.get(), in.const_data(), out->data(),
                     scratch_buffer_, PFFFT_BACKWARD);
   }
 }
@@ -128,7 +172,7 @@ void Pffft::FrequencyDomainConvolve(const FloatBuffer& fft_x,
   RTC_DCHECK_EQ(fft_x.size(), GetBufferSize(fft_size_, fft_type_));
   RTC_DCHECK_EQ(fft_x.size(), fft_y.size());
   RTC_DCHECK_EQ(fft_x.size(), out->size());
-  pffft_zconvolve_accumulate(pffft_status_, fft_x.const_data(),
+  pffft_zconvolve_accumulate(pffft_status_.get(), fft_x.const_data(),
                              fft_y.const_data(), out->data(), scaling);
 }
 
@@ -21,7 +21,9 @@ struct PFFFT_Setup;
 namespace webrtc {
 
 // Pretty-Fast Fast Fourier Transform (PFFFT) wrapper class.
-// Not thread safe.
+// Not thread safe. The PFFFT setup, which holds the twiddle factors, is shared
+// by all the instances with the same FFT size and type, whereas each instance
+// owns its work buffer.
 class Pffft {
  public:
   enum class FftType { kReal, kComplex };
@@ -85,7 +87,7 @@ class Pffft {
  private:
   const size_t fft_size_;
   const FftType fft_type_;
-  PFFFT_Setup* pffft_status_;
+  const std::shared_ptr<PFFFT_Setup> pffft_status_;
   float* const scratch_buffer_;
 };
 
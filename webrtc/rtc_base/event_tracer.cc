@@ -32,6 +32,11 @@
 // This is a guesstimate that should be enough in most cases.
 static const size_t kEventLoggerArgsStrBufferInitialSize = 256;
 static const size_t kTraceArgBufferLength = 32;
+// The trace_event.h macros pass at most two arguments.
+static const int kMaxTraceEventArgs = 2;
+// Events queued between two writes of the logging thread before the queue
+// has to grow.
+static const size_t kTraceEventQueueInitialCapacity = 1024;
 
 namespace webrtc {
 
@@ -104,9 +109,19 @@ class EventLogger final {
                      uint64_t timestamp,
                      int pid,
                      rtc::PlatformThreadId thread_id) {
-    std::vector<TraceArg> args(num_args);
+    // The event is built in place and queued without allocating, unless the
+    // queue has to grow or an argument string has to be copied.
+    RTC_CHECK_LE(num_args, kMaxTraceEventArgs);
+    TraceEvent event;
+    event.name = name;
+    event.category_enabled = category_enabled;
+    event.phase = phase;
+    event.num_args = num_args;
+    event.timestamp = timestamp;
+    event.pid = pid;
+    event.tid = thread_id;
     for (int i = 0; i < num_args; ++i) {
-      TraceArg& arg = args[i];
+      TraceArg& arg = event.args[i];
       arg.name = arg_names[i];
       arg.type = arg_types[i];
       arg.value.as_uint = arg_values[i];
@@ -121,8 +136,7 @@ class EventLogger final {
       }
     }
     webrtc::MutexLock lock(&mutex_);
-    trace_events_.push_back(
-        {name, category_enabled, phase, args, timestamp, 1, thread_id});
+    trace_events_.push_back(event);
   }
 
   // The TraceEvent format is documented here:
@@ -132,9 +146,11 @@ class EventLogger final {
     static const int kLoggingIntervalMs = 100;
     fprintf(output_file_, "{ \"traceEvents\": [\n");
     bool has_logged_event = false;
+    // Swapped with the queue, so that both keep their capacity.
+    std::vector<TraceEvent> events;
+    events.reserve(kTraceEventQueueInitialCapacity);
     while (true) {
       bool shutting_down = shutdown_event_.Wait(kLoggingIntervalMs);
-      std::vector<TraceEvent> events;
       {
         webrtc::MutexLock lock(&mutex_);
         trace_events_.swap(events);
@@ -143,10 +159,11 @@ class EventLogger final {
       args_str.reserve(kEventLoggerArgsStrBufferInitialSize);
       for (TraceEvent& e : events) {
         args_str.clear();
-        if (!e.args.empty()) {
+        if (e.num_args > 0) {
           args_str += ", \"args\": {";
           bool is_first_argument = true;
-          for (TraceArg& arg : e.args) {
+          for (int i = 0; i < e.num_args; ++i) {
+            TraceArg& arg = e.args[i];
             if (!is_first_argument)
               args_str += ",";
             is_first_argument = false;
@@ -180,6 +197,7 @@ class EventLogger final {
                 e.phase, e.timestamp, e.pid, e.tid, args_str.c_str());
         has_logged_event = true;
       }
+      events.clear();
       if (shutting_down)
         break;
     }
@@ -202,6 +220,7 @@ class EventLogger final {
       // stale events in the queue, hence the vector needs to be cleared to not
       // log events from a previous logging session (which may be days old).
       trace_events_.clear();
+      trace_events_.reserve(kTraceEventQueueInitialCapacity);
     }
     // Enable event logging (fast-path). This should be disabled since starting
     // shouldn't be done twice.
@@ -251,7 +270,8 @@ class EventLogger final {
     const char* name;
     const unsigned char* category_enabled;
     char phase;
-    std::vector<TraceArg> args;
+    int num_args;
+    TraceArg args[kMaxTraceEventArgs];
     uint64_t timestamp;
     int pid;
     rtc::PlatformThreadId tid;
@@ -0,0 +1,187 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/memory/allocation_guard.h"
+
+#if defined(WEBRTC_ALLOCATION_GUARD)
+
+#include <errno.h>
+#include <stdlib.h>
+
+#include <atomic>
+#include <new>
+
+#if defined(WEBRTC_POSIX)
+#include <unistd.h>
+#endif
+
+// The thread-local state is accessed from within malloc(), hence it must not
+// be allocated lazily by the dynamic loader.
+#if defined(__GNUC__)
+#define WEBRTC_GUARD_TLS \
+  static thread_local __attribute__((tls_model("initial-exec")))
+#else
+#define WEBRTC_GUARD_TLS static thread_local
+#endif
+
+namespace webrtc {
+namespace {
+
+WEBRTC_GUARD_TLS int g_real_time_depth = 0;
+WEBRTC_GUARD_TLS size_t g_real_time_allocations = 0;
+std::atomic<bool> g_abort_on_allocation(false);
+
+void OnAllocation() {
+  if (g_real_time_depth == 0) {
+    return;
+  }
+  ++g_real_time_allocations;
+  if (g_abort_on_allocation.load(std::memory_order_relaxed)) {
+    // Leave the section so that crash handlers are free to allocate.
+    g_real_time_depth = 0;
+    // Logging would allocate, hence the message is written directly.
+    static const char kMessage[] =
+        "Heap allocation inside a real-time section.\n";
+#if defined(WEBRTC_POSIX)
+    ssize_t unused = write(STDERR_FILENO, kMessage, sizeof(kMessage) - 1);
+    (void)unused;
+#endif
+    abort();
+  }
+}
+
+}  // namespace
+
+ScopedRealTimeSection::ScopedRealTimeSection() {
+  ++g_real_time_depth;
+}
+
+ScopedRealTimeSection::~ScopedRealTimeSection() {
+  --g_real_time_depth;
+}
+
+size_t RealTimeAllocationCount() {
+  return g_real_time_allocations;
+}
+
+void ResetRealTimeAllocationCount() {
+  g_real_time_allocations = 0;
+}
+
+void SetAbortOnRealTimeAllocation(bool abort) {
+  g_abort_on_allocation.store(abort, std::memory_order_relaxed);
+}
+
+}  // namespace webrtc
+
+#if defined(__GLIBC__)
+// glibc exports its allocator under these names, which allows malloc() to be
+// wrapped without dlsym(), which itself may allocate.
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t num, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+
+void* malloc(size_t size) noexcept {
+  webrtc::OnAllocation();
+  return __libc_malloc(size);
+}
+
+void* calloc(size_t num, size_t size) noexcept {
+  webrtc::OnAllocation();
+  return __libc_calloc(num, size);
+}
+
+void* realloc(void* ptr, size_t size) noexcept {
+  webrtc::OnAllocation();
+  return __libc_realloc(ptr, size);
+}
+
+void* memalign(size_t alignment, size_t size) noexcept {
+  webrtc::OnAllocation();
+  return __libc_memalign(alignment, size);
+}
+
+void* aligned_alloc(size_t alignment, size_t size) noexcept {
+  webrtc::OnAllocation();
+  return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void** ptr, size_t alignment, size_t size) noexcept {
+  if (alignment % sizeof(void*) != 0 ||
+      (alignment & (alignment - 1)) != 0) {
+    return EINVAL;
+  }
+  webrtc::OnAllocation();
+  void* mem = __libc_memalign(alignment, size);
+  if (!mem) {
+    return ENOMEM;
+  }
+  *ptr = mem;
+  return 0;
+}
+}  // extern "C"
+#else
+// Without glibc, only the C++ allocations are tracked.
+void* operator new(size_t size) {
+  webrtc::OnAllocation();
+  void* ptr = malloc(size == 0 ? 1 : size);
+  if (!ptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+void* operator new[](size_t size) {
+  return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+  webrtc::OnAllocation();
+  return malloc(size == 0 ? 1 : size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+  return operator new(size, std::nothrow);
+}
+
+void operator delete(void* ptr) noexcept {
+  free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+  free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+  free(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept {
+  free(ptr);
+}
+#endif  // defined(__GLIBC__)
+
+#else  // defined(WEBRTC_ALLOCATION_GUARD)
+
+namespace webrtc {
+
+size_t RealTimeAllocationCount() {
+  return 0;
+}
+
+void ResetRealTimeAllocationCount() {}
+
+void SetAbortOnRealTimeAllocation(bool abort) {}
+
+}  // namespace webrtc
+
+#endif  // defined(WEBRTC_ALLOCATION_GUARD)
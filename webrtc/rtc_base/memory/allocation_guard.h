@@ -0,0 +1,60 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef RTC_BASE_MEMORY_ALLOCATION_GUARD_H_
+#define RTC_BASE_MEMORY_ALLOCATION_GUARD_H_
+
+// Debug tracker for heap allocations made by real-time audio code.
+//
+// When built with WEBRTC_ALLOCATION_GUARD defined (see the
+// WEBRTC_ALLOCATION_GUARD CMake option), the heap allocation functions are
+// replaced by wrappers that check whether the calling thread is inside a
+// ScopedRealTimeSection. Each such allocation is counted per thread and,
+// if SetAbortOnRealTimeAllocation(true) was called, aborts the process so
+// that the offending call stack can be inspected in a debugger.
+//
+// On glibc, malloc(), calloc(), realloc() and the aligned variants are
+// interposed, which also covers operator new. Elsewhere, only the global
+// operator new is replaced.
+//
+// Without WEBRTC_ALLOCATION_GUARD, ScopedRealTimeSection is empty and the
+// functions below are no-ops.
+
+#include <stddef.h>
+
+namespace webrtc {
+
+// Marks the current thread as real-time for the lifetime of the object.
+// Sections may be nested.
+class ScopedRealTimeSection {
+ public:
+#if defined(WEBRTC_ALLOCATION_GUARD)
+  ScopedRealTimeSection();
+  ~ScopedRealTimeSection();
+#else
+  ScopedRealTimeSection() {}
+#endif
+  ScopedRealTimeSection(const ScopedRealTimeSection&) = delete;
+  ScopedRealTimeSection& operator=(const ScopedRealTimeSection&) = delete;
+};
+
+// Returns the number of heap allocations made by the current thread inside a
+// real-time section since the thread started or since the last call to
+// ResetRealTimeAllocationCount(). Always zero without WEBRTC_ALLOCATION_GUARD.
+size_t RealTimeAllocationCount();
+void ResetRealTimeAllocationCount();
+
+// Makes any later heap allocation inside a real-time section abort the
+// process instead of only being counted. Disabled by default.
+void SetAbortOnRealTimeAllocation(bool abort);
+
+}  // namespace webrtc
+
+#endif  // RTC_BASE_MEMORY_ALLOCATION_GUARD_H_
@@ -0,0 +1,186 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef RTC_BASE_MPSC_QUEUE_H_
+#define RTC_BASE_MPSC_QUEUE_H_
+
+#include <stddef.h>
+
+#include <atomic>
+#include <memory>
+#include <utility>
+
+#include "rtc_base/checks.h"
+#include "rtc_base/swap_queue.h"
+
+namespace webrtc {
+
+// A bounded, lock-free, multiple-producer single-consumer queue with
+// preallocated slots. Unlike SwapQueue, which only supports one producer, any
+// number of threads may insert elements concurrently. Producers write the new
+// element in place in a reserved slot, which means that no memory is allocated
+// or deallocated after construction as long as T does not allocate when being
+// written to.
+//
+// Each slot holds a sequence number that tells whether it is free for the
+// producer of a given position or holds an element for the consumer. Producers
+// reserve positions using a compare-and-swap on the write position, and the
+// consumer never blocks. An element is visible to the consumer only after it
+// has been completely written.
+//
+// The capacity is rounded up to a power of two.
+template <typename T,
+          typename QueueItemVerifier = SwapQueueItemVerifier<T>>
+class MpscQueue {
+ public:
+  // Creates a queue of at least size |size| and fills it with copies of
+  // |prototype|.
+  MpscQueue(size_t size, const T& prototype)
+      : MpscQueue(size, prototype, QueueItemVerifier()) {}
+
+  // Same as above and accepts an item verification functor.
+  MpscQueue(size_t size,
+            const T& prototype,
+            const QueueItemVerifier& queue_item_verifier)
+      : queue_item_verifier_(queue_item_verifier),
+        mask_(RoundUpToPowerOfTwo(size) - 1),
+        slots_(new Slot[mask_ + 1]) {
+    RTC_DCHECK_LT(0, size);
+    for (size_t k = 0; k <= mask_; ++k) {
+      slots_[k].sequence.store(k, std::memory_order_relaxed);
+      slots_[k].item = prototype;
+      RTC_DCHECK(queue_item_verifier_(slots_[k].item));
+    }
+  }
+
+  // Resets the queue to have zero content. May only be called by the consumer
+  // and not while any producer is inserting.
+  void Clear() {
+    while (Remove([](T*) {})) {
+    }
+  }
+
+  // Reserves a slot and calls |write| with a pointer to the element in it. The
+  // element holds the contents of a previously removed element, which allows
+  // the producer to reuse its storage. Returns false and does not call |write|
+  // if the queue is full.
+  // May be called concurrently by any number of producers.
+  template <typename Writer>
+  bool Insert(Writer&& write) {
+    size_t position = write_position_.load(std::memory_order_relaxed);
+    Slot* slot;
+    for (;;) {
+      slot = &slots_[position & mask_];
+      const size_t sequence = slot->sequence.load(std::memory_order_acquire);
+      if (sequence == position) {
+        if (write_position_.compare_exchange_weak(position, position + 1,
+                                                  std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (sequence < position) {
+        // The slot still holds an element from the previous lap.
+        return false;
+      } else {
+        position = write_position_.load(std::memory_order_relaxed);
+      }
+    }
+
+    write(&slot->item);
+    RTC_DCHECK(queue_item_verifier_(slot->item));
+
+    // Release memory ordering publishes the written element to the consumer.
+    slot->sequence.store(position + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Swaps |input| into a free slot. Returns false and leaves |input| untouched
+  // if the queue is full. On success, |input| holds the contents of a
+  // previously removed element.
+  // May be called concurrently by any number of producers.
+  bool Insert(T* input) {
+    RTC_DCHECK(input);
+    RTC_DCHECK(queue_item_verifier_(*input));
+    return Insert([input](T* item) {
+      using std::swap;
+      swap(*input, *item);
+    });
+  }
+
+  // Calls |read| with a pointer to the oldest element and then releases its
+  // slot to the producers. Returns false and does not call |read| if the queue
+  // is empty.
+  // May only be called by the consumer.
+  template <typename Reader>
+  bool Remove(Reader&& read) {
+    Slot* slot = &slots_[read_position_ & mask_];
+    // Acquire memory ordering ensures that the element is completely written.
+    if (slot->sequence.load(std::memory_order_acquire) != read_position_ + 1) {
+      return false;
+    }
+
+    read(&slot->item);
+    RTC_DCHECK(queue_item_verifier_(slot->item));
+
+    // Release memory ordering ensures that the consumer is done with the
+    // element before a producer reuses the slot.
+    slot->sequence.store(read_position_ + mask_ + 1, std::memory_order_release);
+    ++read_position_;
+    return true;
+  }
+
+  // Swaps the oldest element into |output|. Returns false and leaves |output|
+  // untouched if the queue is empty.
+  // May only be called by the consumer.
+  bool Remove(T* output) {
+    RTC_DCHECK(output);
+    RTC_DCHECK(queue_item_verifier_(*output));
+    return Remove([output](T* item) {
+      using std::swap;
+      swap(*output, *item);
+    });
+  }
+
+  // Returns the number of slots in the queue.
+  size_t capacity() const { return mask_ + 1; }
+
+ private:
+  struct Slot {
+    std::atomic<size_t> sequence{0};
+    T item;
+  };
+
+  static size_t RoundUpToPowerOfTwo(size_t size) {
+    size_t capacity = 1;
+    while (capacity < size) {
+      capacity <<= 1;
+    }
+    return capacity;
+  }
+
+  QueueItemVerifier queue_item_verifier_;
+  const size_t mask_;
+  const std::unique_ptr<Slot[]> slots_;
+
+  // Only accessed by the single consumer. Kept on a separate cache line from
+  // the write position to avoid false sharing between the consumer and the
+  // producers.
+  size_t read_position_ = 0;
+  char padding_[64];
+
+  // Accessed by all producers.
+  std::atomic<size_t> write_position_{0};
+
+  MpscQueue(const MpscQueue&) = delete;
+  MpscQueue& operator=(const MpscQueue&) = delete;
+};
+
+}  // namespace webrtc
+
+#endif  // RTC_BASE_MPSC_QUEUE_H_
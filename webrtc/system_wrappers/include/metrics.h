@@ -17,6 +17,7 @@
 #include <memory>
 #include <string>
 
+#include "absl/strings/string_view.h"
 #include "rtc_base/atomic_ops.h"
 #include "rtc_base/checks.h"
 
@@ -368,28 +369,29 @@ enum { kMinRunTimeInSeconds = 10 };
 class Histogram;
 
 // Functions for getting pointer to histogram (constructs or finds the named
-// histogram).
+// histogram). The name is only copied if metrics are enabled, so that the
+// lookups made while they are disabled do not allocate.
 
 // Get histogram for counters.
-Histogram* HistogramFactoryGetCounts(const std::string& name,
+Histogram* HistogramFactoryGetCounts(absl::string_view name,
                                      int min,
                                      int max,
                                      int bucket_count);
 
 // Get histogram for counters with linear bucket spacing.
-Histogram* HistogramFactoryGetCountsLinear(const std::string& name,
+Histogram* HistogramFactoryGetCountsLinear(absl::string_view name,
                                            int min,
                                            int max,
                                            int bucket_count);
 
 // Get histogram for enumerators.
 // |boundary| should be above the max enumerator sample.
-Histogram* HistogramFactoryGetEnumeration(const std::string& name,
+Histogram* HistogramFactoryGetEnumeration(absl::string_view name,
                                           int boundary);
 
 // Get sparse histogram for enumerators.
 // |boundary| should be above the max enumerator sample.
-Histogram* SparseHistogramFactoryGetEnumeration(const std::string& name,
+Histogram* SparseHistogramFactoryGetEnumeration(absl::string_view name,
                                                 int boundary);
 
 // Function for adding a |sample| to a histogram.
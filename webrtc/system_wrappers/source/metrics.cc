@@ -222,7 +222,7 @@ RtcHistogramMap* GetMap() {
 // Creates (or finds) histogram.
 // The returned histogram pointer is cached (and used for adding samples in
 // subsequent calls).
-Histogram* HistogramFactoryGetCounts(const std::string& name,
+Histogram* HistogramFactoryGetCounts(absl::string_view name,
                                      int min,
                                      int max,
                                      int bucket_count) {
@@ -235,7 +235,7 @@ Histogram* HistogramFactoryGetCounts(const std::string& name,
 // Creates (or finds) histogram.
 // The returned histogram pointer is cached (and used for adding samples in
 // subsequent calls).
-Histogram* HistogramFactoryGetCountsLinear(const std::string& name,
+Histogram* HistogramFactoryGetCountsLinear(absl::string_view name,
                                            int min,
                                            int max,
                                            int bucket_count) {
@@ -243,24 +243,24 @@ Histogram* HistogramFactoryGetCountsLinear(const std::string& name,
   if (!map)
     return nullptr;
 
-  return map->GetCountsHistogram(name, min, max, bucket_count);
+  return map->GetCountsHistogram(std::string(name), min, max, bucket_count);
 }
 
 // Histogram with linearly spaced buckets.
 // Creates (or finds) histogram.
 // The returned histogram pointer is cached (and used for adding samples in
 // subsequent calls).
-Histogram* HistogramFactoryGetEnumeration(const std::string& name,
+Histogram* HistogramFactoryGetEnumeration(absl::string_view name,
                                           int boundary) {
   RtcHistogramMap* map = GetMap();
   if (!map)
     return nullptr;
 
-  return map->GetEnumerationHistogram(name, boundary);
+  return map->GetEnumerationHistogram(std::string(name), boundary);
 }
 
 // Our default implementation reuses the non-sparse histogram.
-Histogram* SparseHistogramFactoryGetEnumeration(const std::string& name,
+Histogram* SparseHistogramFactoryGetEnumeration(absl::string_view name,
                                                 int boundary) {
   return HistogramFactoryGetEnumeration(name, boundary);
 }